@@ -3,15 +3,2456 @@
 // Description:
 // ============================================================================
 #include <gtest/gtest.h>
-#include "foo.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "applyEngine.hpp"
+#include "batchApply.hpp"
+#include "colorPairAllocator.hpp"
+#include "commandLine.hpp"
+#include "cursesFunctions.hpp"
+#include "daemonProtocol.hpp"
+#include "fileOperations.hpp"
+#include "fileWatcher.hpp"
+#include "frameStats.hpp"
+#include "inputSession.hpp"
+#include "overlayStack.hpp"
+#include "paletteIndex.hpp"
+#include "programStates.hpp"
+#include "renderBackends.hpp"
+#include "themeClusters.hpp"
+#include "themeDaemon.hpp"
+#include "themeDetector.hpp"
+#include "themeGrid.hpp"
+#include "themeImport.hpp"
+#include "themeLibrary.hpp"
+#include "uringBackend.hpp"
 
 
 
-// ===== FooConstructed ========================================================
-//
+// ===== FrameBudgetTests =====================================================
+// Scripted frames drawn to a curses screen on /dev/null. The tests are built
+// with _FRAMESTATS set to 1 and hold each frame to the operator new calls
+// and terminal writes it may make.
 // ============================================================================
-TEST(FooClassTests, FooConstructed)
+class FrameBudgetTests : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    setenv("LINES", "60", 1);
+    setenv("COLUMNS", "160", 1);
+    m_output = fopen("/dev/null", "w");
+    m_input = fopen("/dev/null", "r");
+    m_screen = newterm("xterm-256color", m_output, m_input);
+    set_term(m_screen);
+    m_log.open("/dev/null");
+
+    initializeWins(m_wins, m_backend, m_log);
+    defineWins(m_wins, m_log);
+    drawWins();
+    setFrameStatsFd(fileno(m_output));
+  }
+
+  void TearDown() override
+  {
+    for(std::unordered_map<int, CursesWindow*>::iterator it = m_wins.begin();
+        it != m_wins.end(); it++)
+      {
+        it->second->deleteWindow();
+        delete it->second;
+      }
+
+    endwin();
+    delscreen(m_screen);
+    fclose(m_output);
+    fclose(m_input);
+    setFrameStatsFd(STDOUT_FILENO);
+  }
+
+  void drawWins()
+  {
+    printHelpWin(m_wins, m_log);
+    printSavedFilesWin(m_wins, m_log);
+    printSavedThemesWin(m_wins, m_log);
+    refreshWins(m_wins);
+    doupdate();
+  }
+
+  CursesBackend m_backend;
+  std::unordered_map<int, CursesWindow*> m_wins;
+  std::ofstream m_log;
+  FILE* m_output;
+  FILE* m_input;
+  SCREEN* m_screen;
+};
+
+
+
+// ===== CountsRepaint ========================================================
+// The hooks are in: a forced repaint writes to the terminal, and a new long
+// string is counted as two allocations, the string and its characters.
+// ============================================================================
+TEST_F(FrameBudgetTests, CountsRepaint)
+{
+  FrameStats stats;
+
+  resetFrameStats();
+  clearok(curscr, true);
+  drawWins();
+  delete new std::string(64, 'x');
+  getFrameStats(stats);
+
+  EXPECT_EQ(2u, stats.numAllocs);
+  EXPECT_EQ(2u, stats.numFrees);
+  EXPECT_LT(0u, stats.numWrites);
+  EXPECT_LT(0u, stats.writeBytes);
+} // end of "CountsRepaint"
+
+
+
+// ===== IdleRedraw ===========================================================
+// A frame with no input refreshes the windows and must cost nothing.
+// ============================================================================
+TEST_F(FrameBudgetTests, IdleRedraw)
+{
+  FrameStats stats;
+
+  resetFrameStats();
+  refreshWins(m_wins);
+  doupdate();
+  getFrameStats(stats);
+
+  EXPECT_EQ(0u, stats.numAllocs);
+  EXPECT_EQ(0u, stats.numWrites);
+} // end of "IdleRedraw"
+
+
+
+// ===== UnchangedRedraw ======================================================
+// Reprinting the windows with what they already show allocates nothing and
+// sends nothing to the terminal.
+// ============================================================================
+TEST_F(FrameBudgetTests, UnchangedRedraw)
+{
+  FrameStats stats;
+
+  resetFrameStats();
+  drawWins();
+  getFrameStats(stats);
+
+  EXPECT_EQ(0u, stats.numAllocs);
+  EXPECT_EQ(0u, stats.numWrites);
+} // end of "UnchangedRedraw"
+
+
+
+// ===== STPageFormatting =====================================================
+// Once its strings have grown, formatting a page of saved themes reuses them
+// instead of allocating, also for names too long for the small string buffer
+// and for collapsed groups of duplicate themes with their hidden counts.
+// ============================================================================
+TEST_F(FrameBudgetTests, STPageFormatting)
+{
+  std::vector<LibraryEntry> entries;
+  std::vector<std::string> outputStrings;
+  ThemeLibrary library;
+  FrameStats stats;
+
+  // groups of three themes share a palette
+  for(int i = 0; i < 600; i++)
+    {
+      Palette palette("", _THEMEPALETTESIZE);
+      LibraryEntry entry;
+      const int group = i / 3;
+
+      for(size_t j = 0; j < _THEMEPALETTESIZE; j++)
+        {
+          palette.setColor(j, ((group * 53 + j * 17) % 256) << 16 |
+                           ((group * 101) % 256) << 8 | ((group * 29 + j * 13) % 256));
+        }
+
+      entry.name = "a-theme-name-longer-than-sso-" + std::to_string(1000 + i);
+      palette.pack(entry.value);
+      entries.push_back(entry);
+    }
+
+  library.buildEntries(entries);
+  ThemeClusters clusters(library);
+
+  clusters.buildClusters();
+  clusters.setIsCollapsed(true);
+  ASSERT_TRUE(clusters.getIsCollapsed());
+
+  for(int stStringPos = 0; stStringPos < 100; stStringPos += 20)
+    {
+      createSTOutputStrings(m_wins, clusters, stStringPos, outputStrings, m_log);
+    }
+
+  resetFrameStats();
+
+  for(int stStringPos = 0; stStringPos < 100; stStringPos += 20)
+    {
+      createSTOutputStrings(m_wins, clusters, stStringPos, outputStrings, m_log);
+    }
+
+  getFrameStats(stats);
+
+  ASSERT_FALSE(outputStrings.empty());
+  EXPECT_EQ(0u, stats.numAllocs);
+  EXPECT_EQ("81. a-theme...(+2)", outputStrings.at(0).substr(0, 11) + "..." +
+            outputStrings.at(0).substr(outputStrings.at(0).length() - 4));
+  EXPECT_LE(outputStrings.at(0).length(), (size_t)_STWINMAXCOLS);
+} // end of "STPageFormatting"
+
+
+
+// ===== MemoryBackendTests ===================================================
+// The windows laid out and printed headless, to a MemoryBackend screen.
+// ============================================================================
+class MemoryBackendTests : public ::testing::Test {
+protected:
+  MemoryBackendTests() : m_backend(60, 160) {}
+
+  void SetUp() override
+  {
+    m_log.open("/dev/null");
+    initializeWins(m_wins, m_backend, m_log);
+    defineWins(m_wins, m_log);
+    drawWins();
+  }
+
+  void TearDown() override
+  {
+    for(std::unordered_map<int, CursesWindow*>::iterator it = m_wins.begin();
+        it != m_wins.end(); it++)
+      {
+        it->second->deleteWindow();
+        delete it->second;
+      }
+  }
+
+  void drawWins()
+  {
+    printHelpWin(m_wins, m_log);
+    printSavedFilesWin(m_wins, m_log);
+    printSavedThemesWin(m_wins, m_log);
+    refreshWins(m_wins);
+    m_backend.update();
+  }
+
+  // the line of the screen the text is on, or -1
+  int findLine(const std::string& text)
+  {
+    int numLines = 0;
+    int numCols = 0;
+    std::string line;
+
+    m_backend.getScreenSize(numLines, numCols);
+
+    for(int i = 0; i < numLines; i++)
+      {
+        m_backend.getLine(i, line);
+
+        if(line.find(text) != std::string::npos)
+          {
+            return i;
+          }
+      }
+
+    return -1;
+  }
+
+  MemoryBackend m_backend;
+  std::unordered_map<int, CursesWindow*> m_wins;
+  std::ofstream m_log;
+};
+
+
+
+// ===== LayoutAndHitTesting ==================================================
+// The saved themes window is laid out where a 60x160 terminal shows it, and
+// a click on its right arrow finds the arrow.
+// ============================================================================
+TEST_F(MemoryBackendTests, LayoutAndHitTesting)
+{
+  const CursesWindow* stWin = m_wins.at(_SAVEDTHEMESWIN);
+  const CursesWindow* arrowWin = m_wins.at(_RARROWSAVEDTHEMESWIN);
+  std::string line;
+
+  ASSERT_TRUE(stWin->getIsOpen());
+  EXPECT_EQ(stWin->getStartY() + _STWINMINLINEOFFSET,
+            findLine(std::string(stTitle)));
+  EXPECT_EQ(_RARROWSAVEDTHEMESWIN, checkButtonClick(m_wins, 36, 29, m_log));
+
+  m_backend.getLine(arrowWin->getStartY(), line);
+  EXPECT_NE(' ', line.at(arrowWin->getStartX() + 1));
+} // end of "LayoutAndHitTesting"
+
+
+
+// ===== ResizedLayouts =======================================================
+// Across terminal sizes every arrow is hit where it's drawn, and the windows
+// the layout drops aren't left on the screen.
+// ============================================================================
+TEST_F(MemoryBackendTests, ResizedLayouts)
+{
+  const int sizes[][2] = {{30, 100}, {70, 200}, {20, 60}, {60, 160}};
+  const int arrows[] = {_LARROWSAVEDFILESWIN,
+                        _RARROWSAVEDFILESWIN,
+                        _LARROWSAVEDTHEMESWIN,
+                        _RARROWSAVEDTHEMESWIN};
+
+  for(int i = 0; i < 4; i++)
+    {
+      m_backend.setScreenSize(sizes[i][0], sizes[i][1]);
+      defineWins(m_wins, m_log);
+      drawWins();
+
+      EXPECT_EQ(sizes[i][0], m_wins.at(_MAINWIN)->getNumLines());
+      EXPECT_EQ(sizes[i][1], m_wins.at(_MAINWIN)->getNumCols());
+
+      for(int j = 0; j < 4; j++)
+        {
+          const CursesWindow* arrowWin = m_wins.at(arrows[j]);
+
+          if(arrowWin->getIsOpen() == true)
+            {
+              EXPECT_EQ(arrows[j], checkButtonClick(m_wins,
+                                                    arrowWin->getStartY(),
+                                                    arrowWin->getStartX(),
+                                                    m_log));
+            }
+        }
+
+      if(m_wins.at(_SAVEDTHEMESWIN)->getIsOpen() == false)
+        {
+          EXPECT_EQ(-1, findLine(std::string(stTitle)));
+        }
+    }
+} // end of "ResizedLayouts"
+
+
+
+// ===== RecordsCalls =========================================================
+// A redraw is recorded call by call, and redrawing a thousand frames records
+// the same calls every frame.
+// ============================================================================
+TEST_F(MemoryBackendTests, RecordsCalls)
+{
+  m_backend.clearCalls();
+  drawWins();
+
+  const std::vector<DrawCall> calls = m_backend.getCalls();
+
+  ASSERT_FALSE(calls.empty());
+  EXPECT_EQ(_DRAWUPDATE, calls.back().op);
+
+  for(int i = 0; i < 1000; i++)
+    {
+      m_backend.clearCalls();
+      drawWins();
+      ASSERT_EQ(calls.size(), m_backend.getCalls().size());
+    }
+
+  EXPECT_EQ(1002, m_backend.getNumUpdates());
+} // end of "RecordsCalls"
+
+
+
+// ===== AddFilePrompt ========================================================
+// The add file prompt opens over the saved files window, takes the keys it
+// is handed, and closes on Enter or a click outside of it, putting the
+// screen under it back without reprinting a window.
+// ============================================================================
+TEST_F(MemoryBackendTests, AddFilePrompt)
+{
+  FrameArena arena;
+  std::vector<CursesWindow*> sfStringWins;
+  ThemeGrid stGrid(&m_backend);
+  OverlayStack overlays(m_wins, sfStringWins, stGrid);
+  HWSFAddFileState state(arena, overlays);
+  std::vector<std::string> screen(60);
+  std::string line;
+
+  for(size_t i = 0; i < screen.size(); i++)
+    {
+      m_backend.getLine(i, screen.at(i));
+    }
+
+  state.openState(m_wins, m_log);
+  state.stageState();
+  m_backend.update();
+  ASSERT_TRUE(m_wins.at(_USERINPUTWIN)->getIsOpen());
+  EXPECT_EQ(2, overlays.getNumOverlays());
+  EXPECT_NE(-1, findLine(std::string(_hwSFAddFileWin)));
+
+  EXPECT_TRUE(state.handleInput(m_wins, {'a', -1, -1, 1}, m_log));
+  EXPECT_TRUE(state.handleInput(m_wins, {'b', -1, -1, 1}, m_log));
+  EXPECT_TRUE(state.handleInput(m_wins, {KEY_LEFT, -1, -1, 1}, m_log));
+  EXPECT_TRUE(state.handleInput(m_wins, {'x', -1, -1, 1}, m_log));
+  EXPECT_EQ("axb", state.getOutputString());
+
+  const CursesWindow* promptWin = m_wins.at(_SFPROMPTWIN);
+
+  EXPECT_TRUE(state.handleInput(m_wins,
+                                {KEY_MOUSE, promptWin->getStartY() + 1,
+                                 promptWin->getStartX() + 1, 1},
+                                m_log));
+  EXPECT_FALSE(state.handleInput(m_wins, {KEY_MOUSE, 0, 0, 1}, m_log));
+
+  m_backend.clearCalls();
+  state.closeState(m_wins);
+  m_backend.update();
+  EXPECT_FALSE(m_wins.at(_USERINPUTWIN)->getIsOpen());
+  EXPECT_EQ(0, overlays.getNumOverlays());
+
+  for(size_t i = 0; i < m_backend.getCalls().size(); i++)
+    {
+      EXPECT_NE(_DRAWPRINT, m_backend.getCalls().at(i).op);
+      EXPECT_NE(_DRAWERASE, m_backend.getCalls().at(i).op);
+    }
+
+  for(size_t i = 0; i < screen.size(); i++)
+    {
+      m_backend.getLine(i, line);
+      EXPECT_EQ(screen.at(i), line);
+    }
+
+  // opening it again starts from an empty string, and Enter closes it
+  state.openState(m_wins, m_log);
+  EXPECT_TRUE(state.getOutputString().empty());
+  EXPECT_FALSE(state.handleInput(m_wins, {'\n', -1, -1, 1}, m_log));
+  state.closeState(m_wins);
+} // end of "AddFilePrompt"
+
+
+
+// ===== ScrollsSavedFiles ====================================================
+// Scrolling the saved files a line moves their line windows in place and
+// prints only the line scrolled in. A page or more builds the windows
+// again, and the scroll stops at the first and last line.
+// ============================================================================
+TEST_F(MemoryBackendTests, ScrollsSavedFiles)
+{
+  std::vector<CursesWindow*> sfStringWins;
+  std::vector<std::string> sfStrings;
+  std::vector<std::string> sfThemes;
+  std::vector<std::string> sfOutput;
+  int sfStringPos = 0;
+  int numPrints = 0;
+  int numOpens = 0;
+  std::string line;
+  std::string nextLine;
+
+  for(int i = 0; i < 1000; i++)
+    {
+      sfStrings.push_back("/home/mine/file" + std::to_string(i) + ".ext");
+      sfThemes.push_back("theme");
+    }
+
+  defineSFStringWins(m_wins, sfStringWins, sfStrings, sfStringPos, m_log);
+  createSFOutputStrings(m_wins, sfStringWins, sfStrings, sfThemes, sfOutput, m_log);
+  printSavedFilesStrings(m_wins, sfStringWins, sfOutput, sfStringPos, 0, -1, m_log);
+  refreshSFStringWins(sfStringWins, m_log);
+  m_backend.update();
+
+  const int numWins = sfStringWins.size();
+  const int firstLine = sfStringWins.front()->getStartY();
+  const int startX = sfStringWins.front()->getStartX();
+  const int numCols = sfStringWins.front()->getNumCols();
+
+  ASSERT_GT(numWins, 2);
+  m_backend.getLine(firstLine + 1, nextLine);
+
+  m_backend.clearCalls();
+  EXPECT_TRUE(scrollSFLines(m_wins, sfStringWins, sfOutput, sfStringPos, 1, m_log));
+  refreshSFStringWins(sfStringWins, m_log);
+  m_backend.update();
+  EXPECT_EQ(1, sfStringPos);
+
+  for(size_t i = 0; i < m_backend.getCalls().size(); i++)
+    {
+      numPrints += m_backend.getCalls().at(i).op == _DRAWPRINT;
+      numOpens += m_backend.getCalls().at(i).op == _DRAWOPEN;
+    }
+
+  EXPECT_EQ(1, numPrints);
+  EXPECT_EQ(0, numOpens);
+  m_backend.getLine(firstLine, line);
+  EXPECT_EQ(nextLine.substr(startX, numCols), line.substr(startX, numCols));
+  m_backend.getLine(firstLine + numWins - 1, line);
+  EXPECT_NE(std::string::npos, line.find(sfOutput.at(numWins)));
+
+  EXPECT_TRUE(scrollSFLines(m_wins, sfStringWins, sfOutput, sfStringPos, -2, m_log));
+  EXPECT_EQ(0, sfStringPos);
+  EXPECT_FALSE(scrollSFLines(m_wins, sfStringWins, sfOutput, sfStringPos, -1, m_log));
+
+  EXPECT_TRUE(scrollSFLines(m_wins, sfStringWins, sfOutput, sfStringPos, 5000, m_log));
+  EXPECT_EQ(1000 - numWins, sfStringPos);
+  EXPECT_EQ(numWins, (int)sfStringWins.size());
+  EXPECT_FALSE(scrollSFLines(m_wins, sfStringWins, sfOutput, sfStringPos, 1, m_log));
+  refreshSFStringWins(sfStringWins, m_log);
+  m_backend.update();
+  m_backend.getLine(firstLine + numWins - 1, line);
+  EXPECT_NE(std::string::npos, line.find(sfOutput.back()));
+
+  for(size_t i = 0; i < sfStringWins.size(); i++)
+    {
+      sfStringWins.at(i)->deleteWindow();
+      delete sfStringWins.at(i);
+    }
+} // end of "ScrollsSavedFiles"
+
+
+// ===== PagesSavedThemes =====================================================
+// Paging the saved themes within the band printed into the pad only moves
+// its viewport: nothing is printed or opened, and one pad region is staged.
+// A click on the first theme of the new page finds it.
+// ============================================================================
+TEST_F(MemoryBackendTests, PagesSavedThemes)
+{
+  ThemeLibrary library;
+  ThemeClusters clusters(library);
+  ThemeGrid stGrid(&m_backend);
+  std::vector<std::string> names;
+  int stStringPos = 0;
+  int numPrints = 0;
+  int numOpens = 0;
+  int numErases = 0;
+  int numPadStages = 0;
+  std::string line;
+
+  // numbered so they sort in the order they are added
+  for(int i = 0; i < 500; i++)
+    {
+      names.push_back("theme" + std::to_string(1000 + i));
+    }
+
+  library.build(names);
+  stGrid.defineGrid(m_wins);
+  stGrid.showPage(m_wins, clusters, stStringPos, m_log);
+  stGrid.stageGrid();
+  m_backend.update();
+  ASSERT_TRUE(stGrid.getIsOpen());
+  EXPECT_EQ(0, stGrid.getBandPos());
+
+  m_backend.clearCalls();
+  shiftSTRight(m_wins, stGrid, clusters, stStringPos, m_log);
+  stGrid.stageGrid();
+  m_backend.update();
+  EXPECT_EQ(stGrid.getNumLines(), stStringPos);
+  EXPECT_EQ(0, stGrid.getBandPos());
+
+  for(size_t i = 0; i < m_backend.getCalls().size(); i++)
+    {
+      numPrints += m_backend.getCalls().at(i).op == _DRAWPRINT;
+      numOpens += m_backend.getCalls().at(i).op == _DRAWOPEN;
+      numErases += m_backend.getCalls().at(i).op == _DRAWERASE;
+      numPadStages += m_backend.getCalls().at(i).op == _DRAWSTAGEPAD;
+    }
+
+  EXPECT_EQ(0, numPrints);
+  EXPECT_EQ(0, numOpens);
+  EXPECT_EQ(0, numErases);
+  EXPECT_EQ(1, numPadStages);
+
+  const std::string firstTheme = std::to_string(stStringPos + 1) + ". " + names.at(stStringPos);
+
+  m_backend.getLine(stGrid.getStartY(), line);
+  EXPECT_EQ(firstTheme, line.substr(stGrid.getStartX(), firstTheme.length()));
+  EXPECT_EQ(0, stGrid.checkClick(stGrid.getStartY(), stGrid.getStartX()));
+  EXPECT_EQ(-1, stGrid.checkClick(stGrid.getStartY(),
+                                  stGrid.getStartX() + firstTheme.length()));
+
+  // paging back to the first page is a move as well, and stops there
+  shiftSTLeft(m_wins, stGrid, clusters, stStringPos, m_log);
+  shiftSTLeft(m_wins, stGrid, clusters, stStringPos, m_log);
+  EXPECT_EQ(0, stStringPos);
+  EXPECT_EQ(0, stGrid.getBandPos());
+
+  stGrid.deleteGrid();
+  EXPECT_FALSE(stGrid.getIsOpen());
+} // end of "PagesSavedThemes"
+
+
+
+// ===== MatchesCurses ========================================================
+// The windows drawn to a MemoryBackend look as they do on a curses screen,
+// character for character and attribute for attribute. The box corners are
+// line drawing characters on the curses screen and are skipped.
+// ============================================================================
+TEST_F(FrameBudgetTests, MatchesCurses)
+{
+  MemoryBackend memoryBackend(60, 160);
+  std::unordered_map<int, CursesWindow*> memoryWins;
+  int numLines = 0;
+  int numCols = 0;
+
+  initializeWins(memoryWins, memoryBackend, m_log);
+  defineWins(memoryWins, m_log);
+  printHelpWin(memoryWins, m_log);
+  printSavedFilesWin(memoryWins, m_log);
+  printSavedThemesWin(memoryWins, m_log);
+  refreshWins(memoryWins);
+  memoryBackend.update();
+
+  getmaxyx(curscr, numLines, numCols);
+  ASSERT_EQ(60, numLines);
+  ASSERT_EQ(160, numCols);
+
+  for(int i = 0; i < numLines; i++)
+    {
+      for(int j = 0; j < numCols; j++)
+        {
+          const chtype cursesCell = mvwinch(curscr, i, j);
+          const MemoryCell& memoryCell = memoryBackend.getCell(i, j);
+
+          if((cursesCell & A_ALTCHARSET) == 0)
+            {
+              ASSERT_EQ((char)(cursesCell & A_CHARTEXT), memoryCell.ch)
+                << "at " << i << ", " << j;
+              ASSERT_EQ(cursesCell & A_ATTRIBUTES, memoryCell.attributes)
+                << "at " << i << ", " << j;
+            }
+        }
+    }
+
+  for(std::unordered_map<int, CursesWindow*>::iterator it = memoryWins.begin();
+      it != memoryWins.end(); it++)
+    {
+      it->second->deleteWindow();
+      delete it->second;
+    }
+} // end of "MatchesCurses"
+
+
+
+// ===== ColorPairAllocatorTests ==============================================
+// An allocator capped at three pairs and three color slots on an
+// xterm-256color screen on /dev/null, which can redefine its colors.
+// ============================================================================
+class ColorPairAllocatorTests : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    m_output = fopen("/dev/null", "w");
+    m_input = fopen("/dev/null", "r");
+    m_screen = newterm("xterm-256color", m_output, m_input);
+    set_term(m_screen);
+    start_color();
+    m_allocator.initialize(_FIRSTPAIR, 3);
+  }
+
+  void TearDown() override
+  {
+    endwin();
+    delscreen(m_screen);
+    fclose(m_output);
+    fclose(m_input);
+  }
+
+  // the color slots the pair draws with, as foreground * 1000 + background
+  int pairColors(const int pair)
+  {
+    short foreground;
+    short background;
+
+    pair_content(pair, &foreground, &background);
+
+    return foreground * 1000 + background;
+  }
+
+  // whether the color slot holds the RGB color
+  bool holdsColor(const short color,
+                  const uint32_t rgb)
+  {
+    short red;
+    short green;
+    short blue;
+
+    color_content(color, &red, &green, &blue);
+
+    return red == (int)((rgb >> 16) & 0xff) * 1000 / 255 &&
+      green == (int)((rgb >> 8) & 0xff) * 1000 / 255 &&
+      blue == (int)(rgb & 0xff) * 1000 / 255;
+  }
+
+  static constexpr int _FIRSTPAIR = 10;
+  ColorPairAllocator m_allocator;
+  FILE* m_output;
+  FILE* m_input;
+  SCREEN* m_screen;
+};
+
+
+
+// ===== EvictsLeastRecentlyUsed ==============================================
+// Pairs and color slots are handed out lowest first and reused as is. Once
+// they run out the least recently used are redefined, but never one of the
+// colors of the pair being defined, and a pair whose color was evicted is
+// defined again with the color's new slot.
+// ============================================================================
+TEST_F(ColorPairAllocatorTests, EvictsLeastRecentlyUsed)
+{
+  const uint32_t a = 0x102030;
+  const uint32_t b = 0x405060;
+  const uint32_t c = 0x708090;
+  const uint32_t d = 0xa0b0c0;
+  const uint32_t e = 0xd0e0f0;
+
+  ASSERT_TRUE(m_allocator.getCanChangeColor());
+  ASSERT_EQ(3, m_allocator.getNumPairs());
+
+  // free slots, lowest first: colors a 16, b 17, c 18
+  EXPECT_EQ(_FIRSTPAIR, m_allocator.getPair(a, b));
+  EXPECT_EQ(_FIRSTPAIR + 1, m_allocator.getPair(a, c));
+  EXPECT_EQ(16017, pairColors(_FIRSTPAIR));
+  EXPECT_EQ(16018, pairColors(_FIRSTPAIR + 1));
+  EXPECT_TRUE(holdsColor(18, c));
+  EXPECT_EQ(2u, m_allocator.getNumPairInits());
+  EXPECT_EQ(3u, m_allocator.getNumColorInits());
+
+  // reused without redefining anything, which makes c the oldest color
+  EXPECT_EQ(_FIRSTPAIR, m_allocator.getPair(a, b));
+  EXPECT_EQ(2u, m_allocator.getNumPairInits());
+  EXPECT_EQ(3u, m_allocator.getNumColorInits());
+
+  // d takes the slot of c, the least recently used color
+  EXPECT_EQ(_FIRSTPAIR + 2, m_allocator.getPair(d, b));
+  EXPECT_EQ(18017, pairColors(_FIRSTPAIR + 2));
+  EXPECT_TRUE(holdsColor(18, d));
+  EXPECT_EQ(4u, m_allocator.getNumColorInits());
+
+  // a is now the oldest color but is in the pair being defined, so e takes
+  // the slot of d instead. the pair of a and c, the oldest pair, is reused.
+  EXPECT_EQ(_FIRSTPAIR + 1, m_allocator.getPair(a, e));
+  EXPECT_EQ(16018, pairColors(_FIRSTPAIR + 1));
+  EXPECT_TRUE(holdsColor(16, a));
+  EXPECT_TRUE(holdsColor(18, e));
+  EXPECT_EQ(4u, m_allocator.getNumPairInits());
+  EXPECT_EQ(5u, m_allocator.getNumColorInits());
+
+  // d lost its slot: it takes b's, the oldest color, and b then takes a's.
+  // the pair keeps its number and is defined with the new slots.
+  EXPECT_EQ(_FIRSTPAIR + 2, m_allocator.getPair(d, b));
+  EXPECT_EQ(17016, pairColors(_FIRSTPAIR + 2));
+  EXPECT_TRUE(holdsColor(17, d));
+  EXPECT_TRUE(holdsColor(16, b));
+  EXPECT_EQ(5u, m_allocator.getNumPairInits());
+  EXPECT_EQ(7u, m_allocator.getNumColorInits());
+} // end of "EvictsLeastRecentlyUsed"
+
+
+
+// ===== InputSessionTests ====================================================
+// Sessions read from a curses screen whose input is a pipe the tests write
+// keys to.
+// ============================================================================
+class InputSessionTests : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    setenv("LINES", "24", 1);
+    setenv("COLUMNS", "80", 1);
+    ASSERT_EQ(0, pipe(m_pipe));
+    m_output = fopen("/dev/null", "w");
+    m_input = fdopen(m_pipe[0], "r");
+    m_screen = newterm("xterm-256color", m_output, m_input);
+    set_term(m_screen);
+    nodelay(stdscr, true);
+    m_path = ::testing::TempDir() + "inputSession.rec";
+  }
+
+  void TearDown() override
+  {
+    endwin();
+    delscreen(m_screen);
+    fclose(m_output);
+    fclose(m_input);
+    close(m_pipe[1]);
+    remove(m_path.c_str());
+  }
+
+  // reads a frame's key and screen size, as the main loop does
+  void readFrame(InputSession& session,
+                 std::vector<int>& frames)
+  {
+    int numLines = 0;
+    int numCols = 0;
+
+    session.beginFrame();
+    frames.push_back(session.readInput(stdscr));
+    session.readScreenSize(numLines, numCols);
+    frames.push_back(numLines);
+    frames.push_back(numCols);
+    session.waitFrame();
+  }
+
+  int m_pipe[2];
+  FILE* m_output;
+  FILE* m_input;
+  SCREEN* m_screen;
+  std::string m_path;
+};
+
+
+
+// ===== ReplaysRecording =====================================================
+// A fast replay hands back the keys and screen sizes of a recording on the
+// frames they were read in, then finishes.
+// ============================================================================
+TEST_F(InputSessionTests, ReplaysRecording)
+{
+  std::vector<int> recorded;
+  std::vector<int> replayed;
+
+  {
+    InputSession session;
+
+    ASSERT_TRUE(session.openRecord(m_path));
+    session.start();
+    ASSERT_EQ(2, write(m_pipe[1], "ab", 2));
+    readFrame(session, recorded);
+    readFrame(session, recorded);
+    readFrame(session, recorded);
+    resize_term(30, 100);
+    readFrame(session, recorded);
+    ASSERT_EQ(1, write(m_pipe[1], "q", 1));
+    readFrame(session, recorded);
+  }
+
+  resize_term(40, 120);
+
+  InputSession session;
+
+  ASSERT_TRUE(session.openReplay(m_path, true));
+  session.start();
+
+  for(int i = 0; i < 5; i++)
+    {
+      EXPECT_FALSE(session.getIsFinished());
+      readFrame(session, replayed);
+    }
+
+  EXPECT_EQ(recorded, replayed);
+  EXPECT_EQ('a', replayed.at(0));
+  EXPECT_EQ(24, replayed.at(1));
+  EXPECT_EQ(30, replayed.at(10));
+
+  session.beginFrame();
+  EXPECT_TRUE(session.getIsFinished());
+} // end of "ReplaysRecording"
+
+
+
+// ===== CoalescesFrameInput =================================================
+// A frame reads all the input waiting, keeps keys and button 1 presses in
+// order, and counts repeated presses on a cell as one click.
+// ============================================================================
+TEST_F(InputSessionTests, CoalescesFrameInput)
+{
+  const char burst[] = "j\033[<0;10;5M\033[<0;10;5m\033[<0;10;5M\033[<0;10;5m"
+    "\033[<0;11;5M\033[<0;11;5mk";
+  InputSession session;
+  FrameInput frameInput;
+
+  keypad(stdscr, true);
+  mousemask(ALL_MOUSE_EVENTS, NULL);
+  mouseinterval(0);
+  session.start();
+  ASSERT_EQ((ssize_t)strlen(burst), write(m_pipe[1], burst, strlen(burst)));
+  session.readFrame(stdscr, frameInput);
+
+  ASSERT_EQ(4u, frameInput.events.size());
+  EXPECT_EQ('j', frameInput.events.at(0).input);
+  EXPECT_EQ(KEY_MOUSE, frameInput.events.at(1).input);
+  EXPECT_EQ(4, frameInput.events.at(1).mouseLine);
+  EXPECT_EQ(9, frameInput.events.at(1).mouseCol);
+  EXPECT_EQ(2, frameInput.events.at(1).count);
+  EXPECT_EQ(10, frameInput.events.at(2).mouseCol);
+  EXPECT_EQ(1, frameInput.events.at(2).count);
+  EXPECT_EQ('k', frameInput.events.at(3).input);
+  EXPECT_EQ(0, frameInput.numResizes);
+
+  session.readFrame(stdscr, frameInput);
+  EXPECT_TRUE(frameInput.events.empty());
+} // end of "CoalescesFrameInput"
+
+
+
+// ===== RejectsOtherFiles ====================================================
+// A file that isn't a recorded session isn't replayed.
+// ============================================================================
+TEST_F(InputSessionTests, RejectsOtherFiles)
+{
+  InputSession session;
+  std::ofstream outFile(m_path.c_str());
+
+  outFile << "TSLIB002";
+  outFile.close();
+
+  EXPECT_FALSE(session.openReplay(m_path, true));
+  EXPECT_FALSE(session.openReplay(m_path + ".missing", true));
+  EXPECT_EQ(_SESSIONLIVE, session.getMode());
+} // end of "RejectsOtherFiles"
+
+
+
+// ===== ApplyEngineTests =====================================================
+// Themes applied to files in a fresh temporary directory.
+// ============================================================================
+class ApplyEngineTests : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    std::string dirTemplate = ::testing::TempDir() + "applyEngineXXXXXX";
+
+    ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+    m_dir = dirTemplate + "/";
+    m_log.open("/dev/null");
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(m_dir);
+  }
+
+  void writeFile(const std::string& name,
+                 const std::string& contents)
+  {
+    std::ofstream outFile((m_dir + name).c_str());
+
+    outFile << contents;
+  }
+
+  std::string readFile(const std::string& name)
+  {
+    std::ifstream inFile((m_dir + name).c_str());
+
+    return std::string(std::istreambuf_iterator<char>(inFile),
+                       std::istreambuf_iterator<char>());
+  }
+
+  int countEntries()
+  {
+    return std::distance(std::filesystem::directory_iterator(m_dir),
+                         std::filesystem::directory_iterator());
+  }
+
+  std::string m_dir;
+  std::ofstream m_log;
+};
+
+
+
+// ===== RewriterSpans ========================================================
+// Each rewriter reports one span over the theme name of its key's value,
+// inside its section if it has one, and none when the theme is in use.
+// ============================================================================
+TEST_F(ApplyEngineTests, RewriterSpans)
+{
+  const std::string toml = "[general]\nimport = [\"~/themes/dracula.toml\"]\n";
+  const std::string ini = "gtk-theme-name=Top\n[Settings]\ngtk-theme-name = Adwaita\n";
+  const std::string kitty = "font_size 11\ninclude themes/nord.conf\n";
+  std::vector<RewriteSpan> spans;
+
+  const ThemeRewriter* rewriter = findThemeRewriter("alacritty.toml");
+
+  ASSERT_NE(nullptr, rewriter);
+  EXPECT_TRUE(rewriter->findEdits(toml.data(), toml.length(), "gruvbox", spans));
+  ASSERT_EQ(1u, spans.size());
+  EXPECT_EQ(toml.find("dracula"), spans.at(0).offset);
+  EXPECT_EQ(7u, spans.at(0).length);
+  EXPECT_EQ("gruvbox", spans.at(0).replacement);
+
+  spans.clear();
+  rewriter = findThemeRewriter("settings.ini");
+  ASSERT_NE(nullptr, rewriter);
+  EXPECT_TRUE(rewriter->findEdits(ini.data(), ini.length(), "Arc", spans));
+  ASSERT_EQ(1u, spans.size());
+  EXPECT_EQ(ini.find("Adwaita"), spans.at(0).offset);
+
+  spans.clear();
+  rewriter = findThemeRewriter("kitty.conf");
+  ASSERT_NE(nullptr, rewriter);
+  EXPECT_TRUE(rewriter->findEdits(kitty.data(), kitty.length(), "nord", spans));
+  EXPECT_TRUE(spans.empty());
+  EXPECT_FALSE(rewriter->findEdits(kitty.data(), 12, "nord", spans));
+  EXPECT_EQ(nullptr, findThemeRewriter("notes.txt"));
+} // end of "RewriterSpans"
+
+
+
+// ===== ReplacesFileSafely ===================================================
+// A file is replaced with its owner's mode whatever the umask, through a
+// temporary file of its own. A link left where the old fixed temporary name
+// was is neither followed nor removed, and no temporary file is left behind.
+// ============================================================================
+TEST_F(ApplyEngineTests, ReplacesFileSafely)
+{
+  struct stat fileStat;
+
+  writeFile("kitty.conf", "font_size 11\ninclude themes/dracula.conf\n");
+  writeFile("victim", "keep\n");
+  ASSERT_EQ(0, chmod((m_dir + "kitty.conf").c_str(), 0640));
+  ASSERT_EQ(0, symlink((m_dir + "victim").c_str(), (m_dir + "kitty.conf.themeswitcher").c_str()));
+
+  const mode_t oldMask = umask(077);
+  const int result = applyThemeToFile(m_dir + "kitty.conf", "nord", m_log);
+
+  umask(oldMask);
+
+  EXPECT_EQ(_APPLYWRITTEN, result);
+  EXPECT_EQ("font_size 11\ninclude themes/nord.conf\n", readFile("kitty.conf"));
+  ASSERT_EQ(0, stat((m_dir + "kitty.conf").c_str(), &fileStat));
+  EXPECT_EQ(0640u, fileStat.st_mode & 07777);
+  EXPECT_EQ("keep\n", readFile("victim"));
+  EXPECT_EQ(3, countEntries());
+
+  EXPECT_EQ(_APPLYUNCHANGED, applyThemeToFile(m_dir + "kitty.conf", "nord", m_log));
+  EXPECT_EQ(_APPLYUNSUPPORTED, applyThemeToFile(m_dir + "victim", "nord", m_log));
+} // end of "ReplacesFileSafely"
+
+
+
+// ===== AppliesSharedFileOnce ================================================
+// A file reached through a link and its own path (and listed twice) is
+// rewritten once, and every path naming it reports that write.
+// ============================================================================
+TEST_F(ApplyEngineTests, AppliesSharedFileOnce)
+{
+  std::vector<std::string> paths;
+  std::vector<int> results;
+
+  writeFile("kitty.conf", "include themes/dracula.conf\n");
+  writeFile("alacritty.toml", "import = [\"themes/dracula.toml\"]\n");
+  ASSERT_EQ(0, symlink((m_dir + "kitty.conf").c_str(), (m_dir + "link.conf").c_str()));
+
+  paths.push_back(m_dir + "kitty.conf");
+  paths.push_back(m_dir + "link.conf");
+  paths.push_back(m_dir + "alacritty.toml");
+  paths.push_back(m_dir + "kitty.conf");
+  applyThemeToFiles(paths, "nord", results, m_log);
+
+  ASSERT_EQ(paths.size(), results.size());
+
+  for(size_t i = 0; i < results.size(); i++)
+    {
+      EXPECT_EQ(_APPLYWRITTEN, results.at(i)) << paths.at(i);
+    }
+
+  EXPECT_EQ("include themes/nord.conf\n", readFile("kitty.conf"));
+  EXPECT_EQ("import = [\"themes/nord.toml\"]\n", readFile("alacritty.toml"));
+  EXPECT_EQ(3, countEntries());
+} // end of "AppliesSharedFileOnce"
+
+
+
+// ===== LogsWorkerResults ====================================================
+// Files left to the thread pool log their results to the caller's log, the
+// failures with their reason.
+// ============================================================================
+TEST_F(ApplyEngineTests, LogsWorkerResults)
+{
+  std::vector<std::string> paths;
+  std::vector<int> results;
+  std::ofstream log((m_dir + "apply.log").c_str());
+
+  writeFile("kitty.conf", "include themes/dracula.conf\n");
+  writeFile("alacritty.toml", "import = [\"themes/dracula.toml\"]\n");
+
+  paths.push_back(m_dir + "kitty.conf");
+  paths.push_back(m_dir + "missing.conf");
+  paths.push_back(m_dir + "alacritty.toml");
+  applyThemeToFiles(paths, "nord", results, log);
+  log.close();
+
+  ASSERT_EQ(3u, results.size());
+  EXPECT_EQ(_APPLYWRITTEN, results.at(0));
+  EXPECT_EQ(_APPLYFAILED, results.at(1));
+  EXPECT_EQ(_APPLYWRITTEN, results.at(2));
+
+  const std::string logged = readFile("apply.log");
+
+  EXPECT_NE(std::string::npos, logged.find("Apply: can't resolve " + m_dir + "missing.conf\n"))
+    << logged;
+} // end of "LogsWorkerResults"
+
+
+
+// ===== RefusesShrunkFile ====================================================
+// A file that is shorter than its mapping when its unchanged regions are
+// copied fails the write rather than reading the mapping past its end.
+// ============================================================================
+TEST_F(ApplyEngineTests, RefusesShrunkFile)
+{
+  const std::string original(256 * 1024, 'x');
+  const std::vector<RewriteSpan> spans;
+
+  writeFile("shrunk", original.substr(0, 32 * 1024));
+  writeFile("whole", original);
+
+  const int srcFd = open((m_dir + "shrunk").c_str(), O_RDONLY);
+  const int wholeFd = open((m_dir + "whole").c_str(), O_RDONLY);
+  const int dstFd = open((m_dir + "copy").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+  ASSERT_NE(-1, srcFd);
+  ASSERT_NE(-1, wholeFd);
+  ASSERT_NE(-1, dstFd);
+  EXPECT_EQ(-1, writeRewrittenFile(srcFd, original.data(), original.length(), spans, dstFd));
+  EXPECT_EQ(0, writeRewrittenFile(wholeFd, original.data(), original.length(), spans, dstFd));
+
+  close(srcFd);
+  close(wholeFd);
+  close(dstFd);
+} // end of "RefusesShrunkFile"
+
+
+
+// ===== AppliesSavedFileStore ===============================================
+// The apply command reads a saved file store written with "\r\n" line ends
+// and stray spaces from the configuration directory of a temporary HOME,
+// applies the theme to every file in it, and refuses theme names that would
+// reach outside the themes directory. Paths added to a new store land in it
+// one per line.
+// ============================================================================
+TEST_F(ApplyEngineTests, AppliesSavedFileStore)
+{
+  const char* names[3] = {"HOME", "XDG_CONFIG_HOME", "XDG_RUNTIME_DIR"};
+  std::string oldValues[3];
+  bool isSet[3];
+  std::vector<std::string> savedFiles;
+
+  for(int i = 0; i < 3; i++)
+    {
+      const char* value = getenv(names[i]);
+
+      isSet[i] = value != nullptr;
+      oldValues[i] = isSet[i] == true ? value : "";
+    }
+
+  // no daemon listens in the temporary runtime directory
+  setenv("HOME", m_dir.substr(0, m_dir.length() - 1).c_str(), 1);
+  unsetenv("XDG_CONFIG_HOME");
+  setenv("XDG_RUNTIME_DIR", (m_dir + "run").c_str(), 1);
+
+  writeFile("kitty.conf", "include themes/dracula.conf\n");
+  writeFile("alacritty.toml", "import = [\"themes/dracula.toml\"]\n");
+  ASSERT_TRUE(std::filesystem::create_directories(m_dir + ".config/themeswitcher"));
+  writeFile(".config/themeswitcher/savedFiles", "  " + m_dir + "kitty.conf \t\r\n# notes\r\n\r\n" +
+            m_dir + "alacritty.toml\r\n");
+
+  ASSERT_EQ(m_dir + ".config/themeswitcher/savedFiles", savedFilesStorePath());
+  ASSERT_TRUE(readSavedFiles(savedFilesStorePath(), savedFiles));
+  ASSERT_EQ(2u, savedFiles.size());
+  EXPECT_EQ(m_dir + "kitty.conf", savedFiles.at(0));
+  EXPECT_EQ(m_dir + "alacritty.toml", savedFiles.at(1));
+
+  EXPECT_EQ(_CLISUCCESS, runApplyCommand("nord"));
+  EXPECT_EQ("include themes/nord.conf\n", readFile("kitty.conf"));
+  EXPECT_EQ("import = [\"themes/nord.toml\"]\n", readFile("alacritty.toml"));
+
+  const char* badNames[] = {"", "../../.bashrc", "a/b", "nord\nextra", ".hidden",
+                            "-nord", "no..rd", "nord theme"};
+
+  for(const char* badName : badNames)
+    {
+      EXPECT_FALSE(checkThemeName(badName)) << badName;
+      EXPECT_EQ(_CLIUSAGE, runApplyCommand(badName)) << badName;
+    }
+
+  EXPECT_FALSE(checkThemeName(std::string(_THEMENAMEMAX + 1, 'a')));
+  EXPECT_TRUE(checkThemeName("Catppuccin-Mocha_2.0+"));
+  EXPECT_EQ("include themes/nord.conf\n", readFile("kitty.conf"));
+
+  // a theme name that skipped the command line check is refused by the engine
+  EXPECT_EQ(_APPLYFAILED, applyThemeToFile(m_dir + "kitty.conf", "../gruvbox", m_log));
+  EXPECT_EQ("include themes/nord.conf\n", readFile("kitty.conf"));
+
+  savedFiles.clear();
+  EXPECT_TRUE(appendSavedFile(m_dir + "new/savedFiles", m_dir + "kitty.conf"));
+  EXPECT_TRUE(appendSavedFile(m_dir + "new/savedFiles", m_dir + "alacritty.toml"));
+  EXPECT_FALSE(appendSavedFile(m_dir + "new/savedFiles", "two\nlines"));
+  ASSERT_TRUE(readSavedFiles(m_dir + "new/savedFiles", savedFiles));
+  ASSERT_EQ(2u, savedFiles.size());
+  EXPECT_EQ(m_dir + "alacritty.toml", savedFiles.at(1));
+
+  for(int i = 0; i < 3; i++)
+    {
+      if(isSet[i] == true)
+        {
+          setenv(names[i], oldValues[i].c_str(), 1);
+        }
+      else
+        {
+          unsetenv(names[i]);
+        }
+    }
+} // end of "AppliesSavedFileStore"
+
+
+
+// ===== UringReplacesFileSafely ==============================================
+// Files applied through io_uring get exclusive temporary files of their own,
+// so a link at the old fixed temporary name is left alone, and a file whose
+// mode the umask would trim is replaced with its own mode all the same.
+// ============================================================================
+TEST_F(ApplyEngineTests, UringReplacesFileSafely)
+{
+  std::vector<std::string> paths;
+  std::vector<int> results(2, _APPLYFAILED);
+  std::vector<size_t> fallbackFiles;
+  struct stat fileStat;
+
+  writeFile("kitty.conf", "include themes/dracula.conf\n");
+  writeFile("alacritty.toml", "import = [\"themes/dracula.toml\"]\n");
+  writeFile("victim", "keep\n");
+  ASSERT_EQ(0, chmod((m_dir + "kitty.conf").c_str(), 0640));
+  ASSERT_EQ(0, chmod((m_dir + "alacritty.toml").c_str(), 0664));
+  ASSERT_EQ(0, symlink((m_dir + "victim").c_str(), (m_dir + "kitty.conf.themeswitcher").c_str()));
+
+  paths.push_back(m_dir + "kitty.conf");
+  paths.push_back(m_dir + "alacritty.toml");
+  ASSERT_EQ(0, stat(m_dir.c_str(), &fileStat));
+
+  const mode_t oldMask = umask(022);
+  const std::vector<dev_t> devices(2, fileStat.st_dev);
+  const bool isUringUsed = applyThemeToFilesUring(paths, devices, "nord", results,
+                                                  fallbackFiles, m_log);
+
+  // the file the umask would trim is left to the synchronous path
+  for(size_t i = 0; i < fallbackFiles.size(); i++)
+    {
+      results.at(fallbackFiles.at(i)) = applyThemeToFile(paths.at(fallbackFiles.at(i)),
+                                                         "nord", m_log);
+    }
+
+  umask(oldMask);
+
+  if(isUringUsed == false)
+    {
+      GTEST_SKIP() << "io_uring isn't available here";
+    }
+
+  ASSERT_EQ(1u, fallbackFiles.size());
+  EXPECT_EQ(1u, fallbackFiles.at(0));
+
+  EXPECT_EQ(_APPLYWRITTEN, results.at(0));
+  EXPECT_EQ(_APPLYWRITTEN, results.at(1));
+  EXPECT_EQ("include themes/nord.conf\n", readFile("kitty.conf"));
+  EXPECT_EQ("import = [\"themes/nord.toml\"]\n", readFile("alacritty.toml"));
+  ASSERT_EQ(0, stat((m_dir + "kitty.conf").c_str(), &fileStat));
+  EXPECT_EQ(0640u, fileStat.st_mode & 07777);
+  ASSERT_EQ(0, stat((m_dir + "alacritty.toml").c_str(), &fileStat));
+  EXPECT_EQ(0664u, fileStat.st_mode & 07777);
+  EXPECT_EQ("keep\n", readFile("victim"));
+  EXPECT_EQ(4, countEntries());
+} // end of "UringReplacesFileSafely"
+
+
+
+// ===== UringAppliesInWindows ================================================
+// More files than a filesystem's starting window are applied over several
+// batches on its ring, with none left to the synchronous path.
+// ============================================================================
+TEST_F(ApplyEngineTests, UringAppliesInWindows)
+{
+  const size_t numFiles = 40;
+  std::vector<std::string> paths;
+  std::vector<int> results(numFiles, _APPLYFAILED);
+  std::vector<size_t> fallbackFiles;
+  struct stat dirStat;
+
+  ASSERT_EQ(0, stat(m_dir.c_str(), &dirStat));
+
+  for(size_t i = 0; i < numFiles; i++)
+    {
+      const std::string name = "kitty" + std::to_string(i) + ".conf";
+
+      writeFile(name, "include themes/dracula.conf\n");
+      ASSERT_EQ(0, chmod((m_dir + name).c_str(), 0600));
+      paths.push_back(m_dir + name);
+    }
+
+  const std::vector<dev_t> devices(numFiles, dirStat.st_dev);
+
+  if(applyThemeToFilesUring(paths, devices, "nord", results, fallbackFiles, m_log) == false)
+    {
+      GTEST_SKIP() << "io_uring isn't available here";
+    }
+
+  EXPECT_TRUE(fallbackFiles.empty());
+
+  for(size_t i = 0; i < numFiles; i++)
+    {
+      EXPECT_EQ(_APPLYWRITTEN, results.at(i)) << paths.at(i);
+      EXPECT_EQ("include themes/nord.conf\n", readFile("kitty" + std::to_string(i) + ".conf"));
+    }
+
+  EXPECT_EQ((int)numFiles, countEntries());
+} // end of "UringAppliesInWindows"
+
+
+
+// ===== UringBatchesPastWindow ===============================================
+// A filesystem's window bounds the files in flight, not the batches, so
+// hundreds of files take a handful of submissions while a starting window
+// is still small, and a file too big for the read buffer falls back.
+// ============================================================================
+TEST_F(ApplyEngineTests, UringBatchesPastWindow)
+{
+  const size_t numFiles = 600;
+  const std::string logPath = ::testing::TempDir() + "uringBatches.log";
+  std::vector<std::string> paths;
+  std::vector<int> results(numFiles + 1, _APPLYFAILED);
+  std::vector<size_t> fallbackFiles;
+  struct stat dirStat;
+
+  ASSERT_EQ(0, stat(m_dir.c_str(), &dirStat));
+
+  for(size_t i = 0; i < numFiles; i++)
+    {
+      const std::string name = "kitty" + std::to_string(i) + ".conf";
+
+      writeFile(name, "include themes/dracula.conf\n");
+      ASSERT_EQ(0, chmod((m_dir + name).c_str(), 0600));
+      paths.push_back(m_dir + name);
+    }
+
+  writeFile("big.conf", "include themes/dracula.conf\n" + std::string(_URINGREADSIZE, '#'));
+  ASSERT_EQ(0, chmod((m_dir + "big.conf").c_str(), 0600));
+  paths.push_back(m_dir + "big.conf");
+
+  const std::vector<dev_t> devices(numFiles + 1, dirStat.st_dev);
+  std::ofstream log(logPath);
+
+  if(applyThemeToFilesUring(paths, devices, "nord", results, fallbackFiles, log) == false)
+    {
+      GTEST_SKIP() << "io_uring isn't available here";
+    }
+
+  log.close();
+  ASSERT_EQ(1u, fallbackFiles.size());
+  EXPECT_EQ(numFiles, fallbackFiles.at(0));
+
+  for(size_t i = 0; i < numFiles; i++)
+    {
+      EXPECT_EQ(_APPLYWRITTEN, results.at(i)) << paths.at(i);
+      EXPECT_EQ("include themes/nord.conf\n", readFile("kitty" + std::to_string(i) + ".conf"));
+    }
+
+  std::ifstream logFile(logPath);
+  const std::string logText((std::istreambuf_iterator<char>(logFile)),
+                            std::istreambuf_iterator<char>());
+  const size_t took = logText.find("io_uring took ");
+
+  ASSERT_NE(std::string::npos, took);
+  EXPECT_GE(20, std::stoi(logText.substr(took + 14))) << logText;
+  unlink(logPath.c_str());
+} // end of "UringBatchesPastWindow"
+
+
+
+// ===== DaemonSocketChecks ===================================================
+// The daemon's socket directory is created for its user alone and refused
+// once anyone else may enter it, and a peer of the same user is trusted.
+// ============================================================================
+TEST(DaemonProtocolTests, DaemonSocketChecks)
+{
+  std::string dirTemplate = ::testing::TempDir() + "daemonXXXXXX";
+  int fds[2];
+
+  ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+
+  const std::string socketDir = dirTemplate + "/run";
+  const std::string socketPath = socketDir + "/themeswitcher.sock";
+
+  EXPECT_FALSE(checkDaemonSocketDir(socketPath, false));
+  EXPECT_TRUE(checkDaemonSocketDir(socketPath, true));
+  EXPECT_TRUE(checkDaemonSocketDir(socketPath, false));
+  ASSERT_EQ(0, chmod(socketDir.c_str(), 0755));
+  EXPECT_FALSE(checkDaemonSocketDir(socketPath, true));
+  ASSERT_EQ(0, rmdir(socketDir.c_str()));
+  ASSERT_EQ(0, symlink(dirTemplate.c_str(), socketDir.c_str()));
+  EXPECT_FALSE(checkDaemonSocketDir(socketPath, true));
+
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  EXPECT_TRUE(checkDaemonPeer(fds[0]));
+  close(fds[0]);
+  close(fds[1]);
+
+  std::filesystem::remove_all(dirTemplate);
+} // end of "DaemonSocketChecks"
+
+
+
+// ===== ServesPastStuckClient ================================================
+// A client that sends requests and never reads the answers doesn't hold up
+// the daemon: another client is still answered and can stop it.
+// ============================================================================
+TEST(DaemonProtocolTests, ServesPastStuckClient)
+{
+  std::string dirTemplate = ::testing::TempDir() + "daemonXXXXXX";
+
+  ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+
+  const std::string socketPath = dirTemplate + "/run/themeswitcher.sock";
+  const std::string storePath = dirTemplate + "/savedFiles";
+  std::ofstream store(storePath.c_str());
+  std::ofstream log("/dev/null");
+  struct sockaddr_un address;
+  int code;
+  std::string response;
+
+  // every status answer is about 20 KiB
+  for(int i = 0; i < 100; i++)
+    {
+      store << dirTemplate << "/" << std::string(180, 'f') << i << ".conf\n";
+    }
+
+  store.close();
+
+  ThemeDaemon daemon(socketPath, storePath);
+
+  ASSERT_TRUE(daemon.start(log));
+
+  std::thread server(&ThemeDaemon::run, &daemon, std::ref(log));
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, socketPath.c_str(), socketPath.length());
+
+  const int stuckFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  const int liveFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  const struct timeval timeout = {2, 0};
+
+  ASSERT_EQ(0, connect(stuckFd, (struct sockaddr*)&address, sizeof(address)));
+  ASSERT_EQ(0, connect(liveFd, (struct sockaddr*)&address, sizeof(address)));
+  ASSERT_EQ(0, setsockopt(liveFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)));
+
+  // megabytes of answers the stuck client never reads
+  for(int i = 0; i < 200; i++)
+    {
+      ASSERT_TRUE(writeDaemonMessage(stuckFd, _DAEMONSTATUS, ""));
+    }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const bool isPingAnswered = writeDaemonMessage(liveFd, _DAEMONPING, "") &&
+    readDaemonMessage(liveFd, code, response);
+
+  EXPECT_TRUE(isPingAnswered);
+
+  // either way, let the daemon go
+  close(stuckFd);
+  EXPECT_TRUE(writeDaemonMessage(liveFd, _DAEMONQUIT, ""));
+
+  if(isPingAnswered == false)
+    {
+      readDaemonMessage(liveFd, code, response);
+    }
+
+  EXPECT_TRUE(readDaemonMessage(liveFd, code, response));
+  EXPECT_EQ(_DAEMONOK, code);
+  close(liveFd);
+  server.join();
+  daemon.stop();
+
+  std::filesystem::remove_all(dirTemplate);
+} // end of "ServesPastStuckClient"
+
+
+
+// ===== ActsAsHomeOwner ======================================================
+// Run as root, a batch updates a home with its owner's permissions, so a
+// file the owner can't write is left alone while the owner's own file is
+// rewritten.
+// ============================================================================
+TEST_F(ApplyEngineTests, ActsAsHomeOwner)
+{
+  if(geteuid() != 0)
+    {
+      GTEST_SKIP() << "needs root to hand the home to another user";
+    }
+
+  const uid_t nobody = 65534;
+  std::vector<BatchEntry> entries(1);
+  BatchReport report;
+
+  ASSERT_EQ(0, mkdir((m_dir + "locked").c_str(), 0700));
+  writeFile("locked/kitty.conf", "include themes/dracula.conf\n");
+  writeFile("kitty.conf", "include themes/dracula.conf\n");
+  ASSERT_EQ(0, chown((m_dir + "kitty.conf").c_str(), nobody, nobody));
+  ASSERT_EQ(0, chown(m_dir.c_str(), nobody, nobody));
+  ASSERT_EQ(0, chmod(m_dir.c_str(), 0755));
+
+  entries.at(0).root = m_dir;
+  entries.at(0).theme = "nord";
+  entries.at(0).files.push_back("locked/kitty.conf");
+  entries.at(0).files.push_back("kitty.conf");
+  runBatchApply(entries, 1, _BATCHDEVICELIMIT, report, m_log);
+
+  EXPECT_EQ(1, report.numResults[_APPLYWRITTEN]);
+  EXPECT_EQ(1, report.numResults[_APPLYFAILED]);
+  EXPECT_EQ("include themes/dracula.conf\n", readFile("locked/kitty.conf"));
+  EXPECT_EQ("include themes/nord.conf\n", readFile("kitty.conf"));
+} // end of "ActsAsHomeOwner"
+
+
+
+// ===== FindsNames ===========================================================
+// Names are found across block boundaries, and names that aren't stored,
+// including the empty name and names past the last one, are not.
+// ============================================================================
+TEST(ThemeLibraryTests, FindsNames)
+{
+  ThemeLibrary library;
+  std::vector<std::string> names;
+
+  EXPECT_EQ(-1, library.find(""));
+  EXPECT_EQ(-1, library.find("nord"));
+
+  for(int i = 0; i < _LIBRARYRESTART * 3 + 5; i++)
+    {
+      names.push_back("theme" + std::to_string(1000 + i));
+    }
+
+  library.build(names);
+
+  ASSERT_EQ((int)names.size(), library.getNumEntries());
+
+  for(size_t i = 0; i < names.size(); i++)
+    {
+      EXPECT_EQ((int)i, library.find(names.at(i)));
+    }
+
+  EXPECT_EQ(-1, library.find(""));
+  EXPECT_EQ(-1, library.find("a"));
+  EXPECT_EQ(-1, library.find("theme1000a"));
+  EXPECT_EQ(-1, library.find("theme"));
+  EXPECT_EQ(-1, library.find("zzz"));
+} // end of "FindsNames"
+
+
+
+// ===== RoundTripsEntries ====================================================
+// A library keeps the first entry of each repeated name, sorted, and loads
+// back from disk exactly as it was saved; a damaged file is refused and
+// leaves the library as it was.
+// ============================================================================
+TEST(ThemeLibraryTests, RoundTripsEntries)
+{
+  std::string dirTemplate = ::testing::TempDir() + "libraryXXXXXX";
+  std::vector<LibraryEntry> entries;
+  std::vector<LibraryEntry> loadedEntries;
+  ThemeLibrary library;
+  ThemeLibrary loaded;
+  std::string value;
+
+  ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+
+  const std::string path = dirTemplate + "/themes.lib";
+
+  for(int i = 40; i >= 0; i--)
+    {
+      LibraryEntry entry;
+
+      entry.name = "theme" + std::to_string(1000 + i);
+      entry.value = i % 3 == 0 ? "" : std::string("\x01\x02\x00", 3) + std::to_string(i);
+      entries.push_back(entry);
+    }
+
+  entries.push_back(LibraryEntry{"theme1005", "later"});
+  entries.insert(entries.begin(), LibraryEntry{"theme1007", "first"});
+  library.buildEntries(entries);
+
+  ASSERT_EQ(41, library.getNumEntries());
+  EXPECT_EQ("theme1000", library.at(0));
+  EXPECT_EQ("theme1040", library.at(40));
+  ASSERT_TRUE(library.getValue(library.find("theme1007"), value));
+  EXPECT_EQ("first", value);
+  ASSERT_TRUE(library.getValue(library.find("theme1005"), value));
+  EXPECT_EQ(std::string("\x01\x02\x00", 3) + "5", value);
+
+  ASSERT_TRUE(library.save(path));
+  ASSERT_TRUE(loaded.load(path));
+  ASSERT_EQ(library.getNumEntries(), loaded.getNumEntries());
+  library.getEntries(0, library.getNumEntries(), entries);
+  loaded.getEntries(0, loaded.getNumEntries(), loadedEntries);
+  ASSERT_EQ(entries.size(), loadedEntries.size());
+
+  for(size_t i = 0; i < entries.size(); i++)
+    {
+      EXPECT_EQ(entries.at(i).name, loadedEntries.at(i).name);
+      EXPECT_EQ(entries.at(i).value, loadedEntries.at(i).value);
+      EXPECT_EQ((int)i, loaded.find(entries.at(i).name));
+    }
+
+  // a truncated file is refused
+  std::string contents;
+
+  {
+    std::ifstream inFile(path.c_str(), std::ios::binary);
+
+    contents.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+  }
+
+  {
+    std::ofstream outFile(path.c_str(), std::ios::binary | std::ios::trunc);
+
+    outFile.write(contents.data(), contents.length() - 1);
+  }
+
+  EXPECT_FALSE(loaded.load(path));
+  EXPECT_EQ(41, loaded.getNumEntries());
+  EXPECT_FALSE(loaded.load(dirTemplate + "/missing.lib"));
+
+  std::filesystem::remove_all(dirTemplate);
+} // end of "RoundTripsEntries"
+
+
+
+// ===== SavesSafely ==========================================================
+// Saving goes through a temporary file of its own: a link left where the old
+// fixed temporary name was is neither followed nor removed, nothing else is
+// left beside the library, and a library can't be saved where there is no
+// directory.
+// ============================================================================
+TEST(ThemeLibraryTests, SavesSafely)
+{
+  std::string dirTemplate = ::testing::TempDir() + "libraryXXXXXX";
+  std::vector<LibraryEntry> entries;
+  ThemeLibrary library;
+  ThemeLibrary loaded;
+
+  ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+
+  const std::string path = dirTemplate + "/themes.lib";
+  const std::string victim = dirTemplate + "/victim";
+
+  {
+    std::ofstream outFile(victim.c_str());
+
+    outFile << "keep\n";
+  }
+
+  ASSERT_EQ(0, symlink(victim.c_str(), (path + ".themeswitcher").c_str()));
+  entries.push_back(LibraryEntry{"nord", "value"});
+  library.buildEntries(entries);
+
+  ASSERT_TRUE(library.save(path));
+  ASSERT_TRUE(library.save(path));
+  ASSERT_TRUE(loaded.load(path));
+  EXPECT_NE(-1, loaded.find("nord"));
+  EXPECT_EQ(3, std::distance(std::filesystem::directory_iterator(dirTemplate),
+                             std::filesystem::directory_iterator()));
+
+  std::ifstream inFile(victim.c_str());
+  const std::string kept((std::istreambuf_iterator<char>(inFile)),
+                         std::istreambuf_iterator<char>());
+
+  EXPECT_EQ("keep\n", kept);
+  EXPECT_FALSE(library.save(dirTemplate + "/missing/themes.lib"));
+
+  std::filesystem::remove_all(dirTemplate);
+} // end of "SavesSafely"
+
+
+
+// ===== ThemeImportTests =====================================================
+// Theme directories and tar archives imported from a fresh temporary
+// directory into an empty library.
+// ============================================================================
+class ThemeImportTests : public ::testing::Test {
+protected:
+  void SetUp() override
+  {
+    std::string dirTemplate = ::testing::TempDir() + "themeImportXXXXXX";
+
+    ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+    m_dir = dirTemplate + "/";
+    m_log.open("/dev/null");
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(m_dir);
+  }
+
+  void writeFile(const std::string& name,
+                 const std::string& contents)
+  {
+    std::ofstream outFile((m_dir + name).c_str(), std::ios::binary);
+
+    outFile << contents;
+  }
+
+  // a kitty theme whose 16 colors all differ from every other seed's
+  static std::string kittyTheme(const int seed)
+  {
+    std::string theme;
+    char line[64];
+
+    for(int i = 0; i < 16; i++)
+      {
+        snprintf(line, sizeof(line), "color%d #%02x%02x%02x\n", i, seed, i * 16, 255 - i);
+        theme += line;
+      }
+
+    return theme;
+  }
+
+  // a ustar header and the member's contents padded to whole blocks
+  static void appendTarMember(std::string& archive,
+                              const std::string& name,
+                              const std::string& contents,
+                              const char type)
+  {
+    std::string header(512, '\0');
+    unsigned checksum = 0;
+    char field[16];
+
+    header.replace(0, std::min((size_t)100, name.length()), name, 0, 100);
+    snprintf(field, sizeof(field), "%07o", 0644);
+    header.replace(100, 8, field, 8);
+    snprintf(field, sizeof(field), "%011o", (unsigned)contents.length());
+    header.replace(124, 12, field, 12);
+    header.replace(148, 8, 8, ' ');
+    header[156] = type;
+    header.replace(257, 6, "ustar", 6);
+    header.replace(263, 2, "00", 2);
+
+    for(size_t i = 0; i < header.length(); i++)
+      {
+        checksum += (unsigned char)header[i];
+      }
+
+    snprintf(field, sizeof(field), "%06o", checksum);
+    header.replace(148, 7, field, 7);
+    archive += header;
+    archive += contents;
+    archive.append((512 - contents.length() % 512) % 512, '\0');
+  }
+
+  std::string m_dir;
+  std::ofstream m_log;
+};
+
+
+
+// ===== ReadsTarMembers ======================================================
+// GNU long names and pax path records rename the member that follows them,
+// padding is skipped whatever a member's size, and a pax header too large
+// to hold only a name is skipped without giving up on the archive.
+// ============================================================================
+TEST_F(ThemeImportTests, ReadsTarMembers)
+{
+  const std::string longName = std::string(120, 'd') + "/deep.conf";
+  const std::string paxRecord = " path=pax/renamed.conf\n";
+  const std::string bigRecord = " comment=" + std::string(_IMPORTMAXLINE + 100, 'c') + "\n";
+  std::vector<std::string> sources(1, m_dir + "themes.tar");
+  ThemeLibrary library;
+  ImportReport report;
+  std::string archive;
+
+  appendTarMember(archive, "themes/plain.conf", kittyTheme(1), '0');
+  appendTarMember(archive, "././@LongLink", longName + '\0', 'L');
+  appendTarMember(archive, longName.substr(0, 100), kittyTheme(2), '0');
+  appendTarMember(archive, "PaxHeaders/renamed", std::to_string(paxRecord.length() + 2) +
+                  paxRecord, 'x');
+  appendTarMember(archive, "themes/short.conf", kittyTheme(3), '0');
+  appendTarMember(archive, "PaxHeaders/kept", std::to_string(bigRecord.length() + 4) +
+                  bigRecord, 'x');
+  appendTarMember(archive, "themes/kept.conf", kittyTheme(4), '0');
+  appendTarMember(archive, "themes/notes.txt", "no colors here\n", '0');
+  archive.append(1024, '\0');
+  writeFile("themes.tar", archive);
+
+  importThemes(sources, 1, library, report, m_log);
+
+  EXPECT_TRUE(report.errors.empty());
+  EXPECT_EQ(5, report.numFiles);
+  EXPECT_EQ(1, report.numUnparsed);
+  EXPECT_EQ(4, report.numThemes);
+  EXPECT_NE(-1, library.find("plain"));
+  EXPECT_NE(-1, library.find("deep"));
+  EXPECT_NE(-1, library.find("renamed"));
+  EXPECT_EQ(-1, library.find("short"));
+  EXPECT_NE(-1, library.find("kept"));
+} // end of "ReadsTarMembers"
+
+
+
+// ===== RejectsBrokenArchives ================================================
+// An archive that ends inside a member or without its end of archive marker
+// is reported, keeping the themes read before the break.
+// ============================================================================
+TEST_F(ThemeImportTests, RejectsBrokenArchives)
+{
+  std::vector<std::string> sources;
+  ThemeLibrary library;
+  ImportReport report;
+  std::string archive;
+
+  appendTarMember(archive, "themes/whole.conf", kittyTheme(1), '0');
+  writeFile("unended.tar", archive);
+  appendTarMember(archive, "themes/cut.conf", kittyTheme(2), '0');
+  archive.resize(archive.length() - 300);
+  writeFile("truncated.tar", archive);
+  writeFile("text.tar", std::string(1024, 'x'));
+
+  sources.push_back(m_dir + "unended.tar");
+  sources.push_back(m_dir + "truncated.tar");
+  sources.push_back(m_dir + "text.tar");
+  importThemes(sources, 1, library, report, m_log);
+
+  ASSERT_EQ(3u, report.errors.size());
+  std::sort(report.errors.begin(), report.errors.end());
+  EXPECT_EQ(m_dir + "text.tar isn't a tar archive", report.errors.at(0));
+  EXPECT_EQ(m_dir + "truncated.tar is truncated", report.errors.at(1));
+  EXPECT_EQ(m_dir + "unended.tar ends without an end of archive marker", report.errors.at(2));
+
+  // both archives hold the same first theme, which is kept once
+  EXPECT_EQ(1, report.numThemes);
+  EXPECT_EQ(1, report.numDuplicates);
+  EXPECT_NE(-1, library.find("whole"));
+  EXPECT_EQ(-1, library.find("cut"));
+} // end of "RejectsBrokenArchives"
+
+
+
+// ===== ImportsDotfiles ======================================================
+// Hidden theme files such as .Xresources are imported while VCS metadata
+// directories are not walked.
+// ============================================================================
+TEST_F(ThemeImportTests, ImportsDotfiles)
+{
+  std::vector<std::string> sources(1, m_dir + "collection");
+  ThemeLibrary library;
+  ImportReport report;
+  std::string xresources;
+
+  for(int i = 0; i < 16; i++)
+    {
+      char line[64];
+
+      snprintf(line, sizeof(line), "*.color%d: #%02x%02x%02x\n", i, 9, i * 16, i);
+      xresources += line;
+    }
+
+  ASSERT_EQ(0, mkdir((m_dir + "collection").c_str(), 0755));
+  ASSERT_EQ(0, mkdir((m_dir + "collection/.git").c_str(), 0755));
+  ASSERT_EQ(0, mkdir((m_dir + "collection/.themes").c_str(), 0755));
+  writeFile("collection/.Xresources", xresources);
+  writeFile("collection/.git/tracked.conf", kittyTheme(1));
+  writeFile("collection/.themes/hidden.conf", kittyTheme(2));
+  writeFile("collection/visible.conf", kittyTheme(3));
+
+  importThemes(sources, 2, library, report, m_log);
+
+  EXPECT_TRUE(report.errors.empty());
+  EXPECT_EQ(3, report.numFiles);
+  EXPECT_EQ(3, report.numThemes);
+  EXPECT_NE(-1, library.find(".Xresources"));
+  EXPECT_NE(-1, library.find("hidden"));
+  EXPECT_NE(-1, library.find("visible"));
+  EXPECT_EQ(-1, library.find("tracked"));
+} // end of "ImportsDotfiles"
+
+
+
+// ===== RoundTripsFormats ====================================================
+// Every notation format writes parses back to the same colors, and colors
+// that are only partly written are refused without touching the entry.
+// ============================================================================
+TEST(PaletteTests, RoundTripsFormats)
+{
+  const int formats[5] = {_HEXCOLOR, _BAREHEXCOLOR, _0XHEXCOLOR, _RGBCOLOR, _XRGBCOLOR};
+  std::mt19937 random(29);
+  Palette palette("random", 64);
+  Palette parsed("parsed", 64);
+  std::string output;
+
+  for(size_t i = 0; i < palette.getNumColors(); i++)
+    {
+      palette.setColor(i, random() & 0xffffff);
+    }
+
+  for(int f = 0; f < 5; f++)
+    {
+      size_t start = 0;
+
+      palette.format(formats[f], output);
+
+      for(size_t i = 0; i < palette.getNumColors(); i++)
+        {
+          const size_t end = std::min(output.find('\n', start), output.length());
+          const std::string color = output.substr(start, end - start);
+
+          ASSERT_TRUE(parsed.parseColor(i, color)) << color;
+          EXPECT_EQ(palette.getColor(i), parsed.getColor(i)) << color;
+          start = end + 1;
+        }
+
+      EXPECT_EQ(output.length() + 1, start);
+    }
+
+  Palette single("single", 1);
+
+  EXPECT_TRUE(single.parseColor(0, " 'rgb( 1 , 2 , 3 )';"));
+  EXPECT_EQ(0x010203u, single.getColor(0));
+  EXPECT_TRUE(single.parseColor(0, "#abc"));
+  EXPECT_EQ(0xaabbccu, single.getColor(0));
+
+  const char* broken[] = {
+    "rgb(abc)", "rgb(,,)", "rgb(1,2", "rgb(1,2,3", "rgb(1,2,)", "rgb(1 2 3)",
+    "rgb(256,0,0)", "rgb(-1,0,0)", "rgb(1,2,3)x", "rgb(1,2,3,4)", "#12345",
+    "#ggg", "rgb:1/2/3", "0x", ""
+  };
+
+  for(const char* color : broken)
+    {
+      EXPECT_FALSE(single.parseColor(0, color)) << color;
+      EXPECT_EQ(0xaabbccu, single.getColor(0)) << color;
+    }
+
+  EXPECT_FALSE(single.parseColor(1, "#000000"));
+} // end of "RoundTripsFormats"
+
+
+
+// ===== MatchesXtermBruteForce ===============================================
+// The nearest xterm color of each of a few thousand random colors is as near
+// in OKLab as the nearest found by measuring against every xterm color one
+// at a time.
+// ============================================================================
+TEST(PaletteTests, MatchesXtermBruteForce)
+{
+  const size_t numColors = 4096;
+  std::mt19937 random(256);
+  Palette palette("random", numColors);
+  Palette xterm("xterm", 240);
+  std::vector<float> lightness, aAxis, bAxis;
+  std::vector<float> xtermLightness, xtermA, xtermB;
+  std::vector<uint8_t> indexes;
+
+  for(size_t i = 0; i < numColors; i++)
+    {
+      palette.setColor(i, random() & 0xffffff);
+    }
+
+  // the first colors are the xterm colors, which must each map to themselves
+  for(int i = 0; i < 240; i++)
+    {
+      xterm.setColor(i, xterm256Color(i + 16));
+      palette.setColor(i, xterm256Color(i + 16));
+    }
+
+  palette.findXterm256(indexes);
+  palette.findOklab(lightness, aAxis, bAxis);
+  xterm.findOklab(xtermLightness, xtermA, xtermB);
+  ASSERT_EQ(numColors, indexes.size());
+
+  for(size_t i = 0; i < numColors; i++)
+    {
+      float nearest = INFINITY;
+      float found = INFINITY;
+
+      for(int j = 0; j < 240; j++)
+        {
+          const float dl = xtermLightness[j] - lightness[i];
+          const float da = xtermA[j] - aAxis[i];
+          const float db = xtermB[j] - bAxis[i];
+          const float distance = dl * dl + da * da + db * db;
+
+          nearest = std::min(nearest, distance);
+
+          if(j + 16 == indexes[i])
+            {
+              found = distance;
+            }
+        }
+
+      ASSERT_GE(indexes[i], 16);
+      EXPECT_LE(found, nearest + 1e-6f) << std::hex << palette.getColor(i);
+
+      if(i < 240)
+        {
+          EXPECT_EQ(xterm256Color(i + 16), xterm256Color(indexes[i])) << i;
+        }
+    }
+} // end of "MatchesXtermBruteForce"
+
+
+
+// ===== ParsesDialects =======================================================
+// The same palette written in each supported notation parses to the same
+// colors, with the text colors defaulting to bright white on black.
+// ============================================================================
+TEST(PaletteParserTests, ParsesDialects)
+{
+  static const char* ansiNames[8] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"
+  };
+  std::string kitty = "# kitty\nforeground #eeeeee\n";
+  std::string xresources = "! Xresources\nURxvt*background: #111111\n";
+  std::string toml = "[colors.primary]\nbackground = '#111111'\n";
+  std::string yaml = "colors:\n  primary:\n    foreground: '0xeeeeee'\n";
+  std::vector<std::string> tomlHalves(2);
+  std::vector<std::string> yamlHalves(2);
+  PaletteParser parser;
+  Palette palette;
+  char line[64];
+
+  for(int i = 0; i < 16; i++)
+    {
+      const unsigned color = (i * 16) << 16 | (255 - i * 16) << 8 | i;
+
+      snprintf(line, sizeof(line), "color%d #%06x\n", i, color);
+      kitty += line;
+      snprintf(line, sizeof(line), "*.color%d: #%06x\n", i, color);
+      xresources += line;
+      snprintf(line, sizeof(line), "%s = \"#%06x\"\n", ansiNames[i % 8], color);
+      tomlHalves.at(i / 8) += line;
+      snprintf(line, sizeof(line), "    %s: '0x%06x'\n", ansiNames[i % 8], color);
+      yamlHalves.at(i / 8) += line;
+    }
+
+  toml += "[colors.normal]\n" + tomlHalves.at(0) + "[colors.bright]\n" + tomlHalves.at(1);
+  yaml += "  normal:\n" + yamlHalves.at(0) + "  bright:\n" + yamlHalves.at(1);
+
+  const std::string dialects[4] = {kitty, xresources, toml, yaml};
+  const bool hasForeground[4] = {true, false, false, true};
+
+  for(int i = 0; i < 4; i++)
+    {
+      parser.feed(dialects[i].data(), dialects[i].length());
+      ASSERT_TRUE(parser.finish(palette)) << dialects[i];
+      ASSERT_EQ(_THEMEPALETTESIZE, palette.getNumColors());
+
+      for(int j = 0; j < 16; j++)
+        {
+          EXPECT_EQ((uint32_t)((j * 16) << 16 | (255 - j * 16) << 8 | j), palette.getColor(j))
+            << dialects[i];
+        }
+
+      EXPECT_EQ(hasForeground[i] ? 0xeeeeeeu : palette.getColor(15),
+                palette.getColor(_PALETTEFOREGROUND));
+      EXPECT_EQ(hasForeground[i] ? palette.getColor(0) : 0x111111u,
+                palette.getColor(_PALETTEBACKGROUND));
+    }
+
+  // base16 slots fill both halves of the ANSI colors and the text colors
+  const std::string base16 =
+    "scheme: \"test\"\nbase00: \"101010\"\nbase03: \"303030\"\nbase05: \"505050\"\n"
+    "base07: \"707070\"\nbase08: \"800000\"\nbase0A: \"a0a000\"\nbase0B: \"00b000\"\n"
+    "base0C: \"00c0c0\"\nbase0D: \"0000d0\"\nbase0E: \"e000e0\"\n";
+
+  parser.feed(base16.data(), base16.length());
+  ASSERT_TRUE(parser.finish(palette));
+  EXPECT_EQ(0x101010u, palette.getColor(0));
+  EXPECT_EQ(0x303030u, palette.getColor(8));
+  EXPECT_EQ(0x0000d0u, palette.getColor(4));
+  EXPECT_EQ(0x0000d0u, palette.getColor(12));
+  EXPECT_EQ(0x505050u, palette.getColor(_PALETTEFOREGROUND));
+  EXPECT_EQ(0x101010u, palette.getColor(_PALETTEBACKGROUND));
+
+  // fifteen colors aren't a palette, and the parser starts over afterwards
+  const std::string partial = kitty.substr(0, kitty.find("color15"));
+
+  parser.feed(partial.data(), partial.length());
+  EXPECT_FALSE(parser.finish(palette));
+  parser.feed(kitty.data(), kitty.length());
+  EXPECT_TRUE(parser.finish(palette));
+} // end of "ParsesDialects"
+
+
+
+// ===== SplitsLinesAcrossChunks ==============================================
+// A theme read in _IMPORTCHUNKSIZE chunks, or a byte at a time, parses the
+// same as in one piece: lines split between chunks are joined, and a line
+// too long to hold a color is dropped without taking the next line with it.
+// ============================================================================
+TEST(PaletteParserTests, SplitsLinesAcrossChunks)
+{
+  std::string theme = "# " + std::string(_IMPORTCHUNKSIZE - 10, '-') + "\n";
+  PaletteParser parser;
+  Palette whole;
+  Palette chunked;
+  char line[64];
+
+  for(int i = 0; i < 16; i++)
+    {
+      snprintf(line, sizeof(line), "color%d #%06x\n", i, i * 0x0f0f0f);
+      theme += line;
+
+      if(i == 7)
+        {
+          theme += "title " + std::string(_IMPORTMAXLINE * 2, 'x') + "\n";
+        }
+    }
+
+  // the 64 KiB boundary falls inside the first color lines
+  ASSERT_LT(theme.find("color0"), _IMPORTCHUNKSIZE);
+  ASSERT_GT(theme.find("color1 "), _IMPORTCHUNKSIZE);
+
+  parser.feed(theme.data(), theme.length());
+  ASSERT_TRUE(parser.finish(whole));
+
+  for(size_t pos = 0; pos < theme.length(); pos += _IMPORTCHUNKSIZE)
+    {
+      parser.feed(theme.data() + pos, std::min(_IMPORTCHUNKSIZE, theme.length() - pos));
+    }
+
+  ASSERT_TRUE(parser.finish(chunked));
+
+  for(int i = 0; i < _THEMEPALETTESIZE; i++)
+    {
+      EXPECT_EQ(whole.getColor(i), chunked.getColor(i));
+    }
+
+  EXPECT_EQ(0x0f0f0fu * 8, chunked.getColor(8));
+
+  for(size_t pos = 0; pos < theme.length(); pos++)
+    {
+      parser.feed(theme.data() + pos, 1);
+    }
+
+  ASSERT_TRUE(parser.finish(chunked));
+  EXPECT_EQ(0x0f0f0fu * 15, chunked.getColor(15));
+
+  // the last line needs no newline
+  theme.pop_back();
+  parser.feed(theme.data(), theme.length());
+  ASSERT_TRUE(parser.finish(chunked));
+  EXPECT_EQ(0x0f0f0fu * 15, chunked.getColor(15));
+} // end of "SplitsLinesAcrossChunks"
+
+
+
+// ===== DetectsDirectives ====================================================
+// Each directive is recognized at the start of a line and only as a whole
+// key, the theme is the last component of its value, and the first
+// directive in the file wins.
+// ============================================================================
+TEST(ThemeDetectorTests, DetectsDirectives)
+{
+  struct DetectCase {
+    const char* contents;
+    int directive;
+    const char* theme;
+  };
+  static const DetectCase cases[] = {
+    {"import = [\"~/.config/alacritty/themes/dracula.toml\"]\n", _ALACRITTYIMPORT,
+     "dracula.toml"},
+    {"font_size 11\n  include themes/nord.conf\n", _KITTYINCLUDE, "nord.conf"},
+    {"#include \"/home/user/.Xresources.d/gruvbox\"\n", _XRESOURCESINCLUDE, "gruvbox"},
+    {"(load-theme 'modus-vivendi t)\n", _EMACSLOADTHEME, "modus-vivendi"},
+    {"colors = colors.DoomOne\n", _QTILECOLORS, "DoomOne"},
+    {"include a.conf\ninclude b.conf\n", _KITTYINCLUDE, "a.conf"},
+    {"# include themes/nord.conf\n", -1, ""},
+    {"includes = themes/nord.conf\n", -1, ""},
+    {"if colors == colors.DoomOne:\n", -1, ""},
+    {"include\n", -1, ""},
+    {"", -1, ""}
+  };
+  const ThemeDetector& detector = themeDetector();
+
+  for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+      std::string theme;
+
+      EXPECT_EQ(cases[i].directive, detector.detect(cases[i].contents,
+                                                    strlen(cases[i].contents), theme))
+        << cases[i].contents;
+
+      if(cases[i].directive != -1)
+        {
+          EXPECT_EQ(cases[i].theme, theme) << cases[i].contents;
+        }
+    }
+} // end of "DetectsDirectives"
+
+
+
+// ===== DetectsFileThemes ====================================================
+// Saved files are scanned whether they are read whole or mapped, and files
+// that can't be read or hold no directive get no theme.
+// ============================================================================
+TEST(ThemeDetectorTests, DetectsFileThemes)
+{
+  std::string dirTemplate = ::testing::TempDir() + "detectorXXXXXX";
+  std::vector<std::string> paths;
+  std::vector<std::string> themes;
+  std::ofstream log("/dev/null");
+
+  ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+
+  const std::string large = std::string(128 * 1024, '\n') + "include themes/large.conf\n";
+
+  paths.push_back(dirTemplate + "/small.conf");
+  paths.push_back(dirTemplate + "/large.conf");
+  paths.push_back(dirTemplate + "/plain.conf");
+  paths.push_back(dirTemplate + "/missing.conf");
+  std::ofstream(paths.at(0).c_str()) << "include themes/small.conf\n";
+  std::ofstream(paths.at(1).c_str()) << large;
+  std::ofstream(paths.at(2).c_str()) << "font_size 11\n";
+
+  for(int i = 0; i < 100; i++)
+    {
+      paths.push_back(paths.at(i % 4));
+    }
+
+  detectFileThemes(paths, themes, log);
+
+  ASSERT_EQ(paths.size(), themes.size());
+
+  for(size_t i = 0; i < paths.size(); i++)
+    {
+      static const char* expected[4] = {"small.conf", "large.conf", "", ""};
+
+      EXPECT_EQ(expected[i % 4], themes.at(i)) << paths.at(i);
+    }
+
+  std::filesystem::remove_all(dirTemplate);
+} // end of "DetectsFileThemes"
+
+
+
+// ===== MatchesBruteForce ====================================================
+// Nearest neighbor and radius queries over clustered fingerprints return
+// exactly what measuring every fingerprint does, in the same order, while
+// the tree measures only part of them.
+// ============================================================================
+TEST(PaletteIndexTests, MatchesBruteForce)
+{
+  const int numClusters = 40;
+  const int clusterSize = 25;
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> centers(-100, 100);
+  std::uniform_int_distribution<int> noise(-3, 3);
+  std::vector<int8_t> fingerprints;
+  std::vector<int8_t> center(_FINGERPRINTSIZE, 0);
+  std::vector<IndexMatch> matches;
+  PaletteIndex index;
+
+  index.findNearest(center.data(), 3, matches);
+  EXPECT_TRUE(matches.empty());
+
+  for(int i = 0; i < numClusters; i++)
+    {
+      for(int j = 0; j < _FINGERPRINTCOORDS; j++)
+        {
+          center.at(j) = centers(random);
+        }
+
+      for(int j = 0; j < clusterSize; j++)
+        {
+          for(int k = 0; k < _FINGERPRINTSIZE; k++)
+            {
+              fingerprints.push_back(k < _FINGERPRINTCOORDS ? center.at(k) + noise(random) : 0);
+            }
+        }
+    }
+
+  index.build(fingerprints);
+  ASSERT_EQ(numClusters * clusterSize, index.getNumFingerprints());
+
+  // every distance from a query, sorted as the index sorts its matches
+  auto bruteForce = [&](const int8_t* query) {
+    std::vector<IndexMatch> all;
+
+    for(int id = 0; id < index.getNumFingerprints(); id++)
+      {
+        int sum = 0;
+
+        for(int k = 0; k < _FINGERPRINTSIZE; k++)
+          {
+            const int difference = query[k] - fingerprints.at(id * _FINGERPRINTSIZE + k);
+            sum += difference * difference;
+          }
+
+        all.push_back(IndexMatch{id, sqrtf((float)sum)});
+      }
+
+    std::sort(all.begin(), all.end(), [](const IndexMatch& left, const IndexMatch& right)
+              { return left.distance < right.distance ||
+                  (left.distance == right.distance && left.id < right.id); });
+
+    return all;
+  };
+
+  for(int i = 0; i < numClusters; i += 7)
+    {
+      std::vector<int8_t> query(index.getFingerprint(i * clusterSize),
+                                index.getFingerprint(i * clusterSize) + _FINGERPRINTSIZE);
+
+      query.at(0) += 2;
+
+      const std::vector<IndexMatch> all = bruteForce(query.data());
+
+      index.findNearest(query.data(), 5, matches);
+      ASSERT_EQ(5u, matches.size());
+      EXPECT_LT(index.getNumVisited(), index.getNumFingerprints());
+
+      for(size_t j = 0; j < matches.size(); j++)
+        {
+          EXPECT_EQ(all.at(j).id, matches.at(j).id);
+          EXPECT_FLOAT_EQ(all.at(j).distance, matches.at(j).distance);
+        }
+
+      const float radius = all.at(clusterSize / 2).distance;
+
+      index.findWithinRadius(query.data(), radius, matches);
+      EXPECT_LT(index.getNumVisited(), index.getNumFingerprints());
+
+      size_t numInside = 0;
+
+      while(numInside < all.size() && all.at(numInside).distance <= radius)
+        {
+          numInside++;
+        }
+
+      ASSERT_EQ(numInside, matches.size());
+
+      for(size_t j = 0; j < matches.size(); j++)
+        {
+          EXPECT_EQ(all.at(j).id, matches.at(j).id);
+        }
+    }
+
+  index.findNearest(center.data(), index.getNumFingerprints() + 10, matches);
+  EXPECT_EQ(index.getNumFingerprints(), (int)matches.size());
+} // end of "MatchesBruteForce"
+
+
+
+// ===== FingerprintsPalettes =================================================
+// A palette's fingerprint doesn't depend on its name, a 16 color palette
+// gets white on black text colors, and fewer colors can't be fingerprinted.
+// ============================================================================
+TEST(PaletteIndexTests, FingerprintsPalettes)
+{
+  Palette ansi("first", _ANSICOLORS);
+  Palette full("second", _THEMEPALETTESIZE);
+  Palette tinted("third", _THEMEPALETTESIZE);
+  int8_t ansiPrint[_FINGERPRINTSIZE];
+  int8_t fullPrint[_FINGERPRINTSIZE];
+  int8_t tintedPrint[_FINGERPRINTSIZE];
+
+  for(size_t i = 0; i < _ANSICOLORS; i++)
+    {
+      const uint32_t color = (i * 16) << 16 | (255 - i * 16) << 8 | (i * 8);
+
+      ansi.setColor(i, color);
+      full.setColor(i, color);
+      tinted.setColor(i, color);
+    }
+
+  full.setColor(_PALETTEFOREGROUND, ansi.getColor(15));
+  full.setColor(_PALETTEBACKGROUND, ansi.getColor(0));
+  tinted.setColor(_PALETTEFOREGROUND, 0xffffff);
+  tinted.setColor(_PALETTEBACKGROUND, 0x202020);
+
+  ASSERT_TRUE(fingerprintPalette(ansi, ansiPrint));
+  ASSERT_TRUE(fingerprintPalette(full, fullPrint));
+  ASSERT_TRUE(fingerprintPalette(tinted, tintedPrint));
+  EXPECT_EQ(0, memcmp(ansiPrint, fullPrint, sizeof(ansiPrint)));
+  EXPECT_NE(0, memcmp(ansiPrint, tintedPrint, sizeof(ansiPrint)));
+  EXPECT_EQ(0, memcmp(ansiPrint, tintedPrint, _ANSICOLORS * 3));
+
+  for(int i = _FINGERPRINTCOORDS; i < _FINGERPRINTSIZE; i++)
+    {
+      EXPECT_EQ(0, ansiPrint[i]);
+    }
+
+  EXPECT_FALSE(fingerprintPalette(Palette("short", 8), ansiPrint));
+} // end of "FingerprintsPalettes"
+
+
+
+// ===== ReportsChangedFiles ==================================================
+// A watched file's change is reported with the theme detected after it, for
+// files passed to start(), files added later, and files whose directory is
+// removed and created again.
+// ============================================================================
+TEST(FileWatcherTests, ReportsChangedFiles)
 {
-  Foo foo(1);
-  EXPECT_EQ(1, foo.getVal());
-} // end of "FooConstructed"
+  std::string dirTemplate = ::testing::TempDir() + "watcherXXXXXX";
+  std::ofstream log("/dev/null");
+  FileWatcher watcher([](const std::string& path) {
+    std::ifstream inFile(path.c_str());
+    std::string theme;
+
+    std::getline(inFile, theme);
+    return theme;
+  });
+
+  // the theme reported for fileIndex before a few seconds pass, or "" if none
+  auto waitForTheme = [&watcher](const int fileIndex) {
+    std::vector<FileThemeDelta> deltas;
+
+    for(int i = 0; i < 300; i++)
+      {
+        watcher.takeDeltas(deltas);
+
+        for(size_t j = 0; j < deltas.size(); j++)
+          {
+            if(deltas.at(j).fileIndex == fileIndex)
+              {
+                return deltas.at(j).theme;
+              }
+          }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+
+    return std::string();
+  };
+
+  ASSERT_NE(nullptr, mkdtemp(&dirTemplate[0]));
+
+  const std::string firstPath = dirTemplate + "/kitty.conf";
+  const std::string laterDir = dirTemplate + "/later";
+  const std::string laterPath = laterDir + "/alacritty.toml";
+
+  std::ofstream(firstPath.c_str()) << "dracula\n";
+  ASSERT_EQ(0, mkdir(laterDir.c_str(), 0755));
+  ASSERT_TRUE(watcher.start(std::vector<std::string>(1, firstPath), log));
+  EXPECT_EQ(1, watcher.getNumWatches());
+
+  std::ofstream(firstPath.c_str()) << "nord\n";
+  EXPECT_EQ("nord", waitForTheme(0));
+
+  ASSERT_EQ(1, watcher.addFile(laterPath));
+  EXPECT_EQ(2, watcher.getNumWatches());
+  std::ofstream(laterPath.c_str()) << "gruvbox\n";
+  EXPECT_EQ("gruvbox", waitForTheme(1));
+
+  // the directory is replaced, and watched again once it is back
+  std::filesystem::remove_all(laterDir);
+  ASSERT_EQ(0, mkdir(laterDir.c_str(), 0755));
+  std::ofstream(laterPath.c_str()) << "solarized\n";
+  EXPECT_EQ("solarized", waitForTheme(1));
+  std::ofstream(laterPath.c_str()) << "monokai\n";
+  EXPECT_EQ("monokai", waitForTheme(1));
+
+  watcher.stop();
+  std::filesystem::remove_all(dirTemplate);
+} // end of "ReportsChangedFiles"
@@ -8,7 +8,10 @@
 enum CursesColors {
   none,
   _WHITE_TEXT,
-  _BLACK_TEXT
+  _BLACK_TEXT,
+
+  // first pair handed out by the ColorPairAllocator for theme previews
+  _PREVIEWPAIRSTART
 };
 
 // window index constants
@@ -42,13 +45,17 @@ enum _WINS {
   _HWSTREMOVETHEME,
   _HWSTEDITTHEME,
   _HWSTVIEWTHEME,
+  _PREVIEWWIN,
 
   // file operation wins
   _SFPROMPTWIN,
   _STPROMPTWIN,
 
   // user input window
-  _USERINPUTWIN
+  _USERINPUTWIN,
+
+  // the number of windows
+  _NUMWINS
 };
 
 // _PROMPTWIN DIMENSIONS
@@ -73,6 +80,12 @@ const unsigned int _HELPWINLINEOFFSET = 2;
 const unsigned int _HWBUTTONCOLS = 19;
 const unsigned int _HWBUTTONLINES = 1;
 
+// _PREVIEWWIN (inside _HELPWIN, below the saved theme buttons)
+const unsigned int _PREVIEWWINLINEOFFSET = 3;
+const unsigned int _PREVIEWWINCOLOFFSET = 3;
+const unsigned int _PREVIEWWINMINLINES = 5;
+const unsigned int _PREVIEWSWATCHCOLS = 5;
+
 // _SAVEDFILESWIN DIMENSIONS
 const unsigned int _SAVEDFILESWINSTARTY = _PROMPTWINSTARTY + _PROMPTWINMAXLINES + 1;
 const unsigned int _SAVEDFILESWINSTARTX = 3;
@@ -104,4 +117,9 @@ const unsigned int _STWINMINCOLOFFSET = 3;
 const unsigned int _STWINMAXCOLOFFSET = 3;
 const unsigned int _STWINMAXCOLS = 30;
 
+// SAVED THEME GRID OFFSETS
+const unsigned int _STGRIDLINEOFFSET = 4;
+const unsigned int _STGRIDCOLGAP = 2;
+const unsigned int _STPADMAXPAGES = 8;
+
 #endif // _CURSESWINCONSTS_HPP
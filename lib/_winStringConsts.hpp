@@ -1,37 +1,37 @@
 #ifndef _WINSTRINGCONSTS_HPP
 #define _WINSTRINGCONSTS_HPP
-#include <string>
+#include <string_view>
 
 // helpwin
-const std::string _hwSFAddFile = "     Add File      ";
-const std::string _hwSFEditFilePath = "   Edit File Path  ";
-const std::string _hwSFViewFilePath = "   View File Path  ";
-const std::string _hwSFRemoveFile = "    Remove File    ";
-const std::string _hwSFAddTheme = "  Add File Theme   ";
-const std::string _hwSFEditTheme = "  Edit File Theme  ";
-const std::string _hwSFRemoveTheme = " Remove File Theme ";
-const std::string _hwSTAddTheme = "     Add Theme     ";
-const std::string _hwSTARemoveTheme = "     Add Theme     ";
-const std::string _hwSTRemoveTheme = "   Remove Theme    ";
-const std::string _hwSTEditTheme =   "     Edit Theme    ";
-const std::string _hwSTViewTheme = "    View Theme     ";
+constexpr std::string_view _hwSFAddFile = "     Add File      ";
+constexpr std::string_view _hwSFEditFilePath = "   Edit File Path  ";
+constexpr std::string_view _hwSFViewFilePath = "   View File Path  ";
+constexpr std::string_view _hwSFRemoveFile = "    Remove File    ";
+constexpr std::string_view _hwSFAddTheme = "  Add File Theme   ";
+constexpr std::string_view _hwSFEditTheme = "  Edit File Theme  ";
+constexpr std::string_view _hwSFRemoveTheme = " Remove File Theme ";
+constexpr std::string_view _hwSTAddTheme = "     Add Theme     ";
+constexpr std::string_view _hwSTARemoveTheme = "     Add Theme     ";
+constexpr std::string_view _hwSTRemoveTheme = "   Remove Theme    ";
+constexpr std::string_view _hwSTEditTheme =   "     Edit Theme    ";
+constexpr std::string_view _hwSTViewTheme = "    View Theme     ";
 
 // other prompts
-const std::string _hwSFAddFileWin = "Enter Full Path To File: ";
+constexpr std::string_view _hwSFAddFileWin = "Enter Full Path To File: ";
 
 // _SAVEDFILESWIN
-const std::string sfTitle = "SAVED FILES:";
-const std::string sfThemeTitle = "CURRENT THEME:";
-const std::string sfLeftArrow = "_LARROWSAVEDFILESWIN";
-const std::string sfRightArrow = "_RARROWSAVEDFILESWIN";
+constexpr std::string_view sfTitle = "SAVED FILES:";
+constexpr std::string_view sfThemeTitle = "CURRENT THEME:";
+constexpr std::string_view sfLeftArrow = "_LARROWSAVEDFILESWIN";
+constexpr std::string_view sfRightArrow = "_RARROWSAVEDFILESWIN";
 
 // _SAVEDTHEMESWIN
-const std::string stTitle = "SAVED THEMES:";
-const std::string stLeftArrow = "_LARROWSAVEDTHEMESWIN";
-const std::string stRightArrow = "_RARROWSAVEDTHEMESWIN";
+constexpr std::string_view stTitle = "SAVED THEMES:";
+constexpr std::string_view stLeftArrow = "_LARROWSAVEDTHEMESWIN";
+constexpr std::string_view stRightArrow = "_RARROWSAVEDTHEMESWIN";
 
 // arrows
-const std::string leftArrow = " < ";
-const std::string rightArrow = " > ";
+constexpr std::string_view leftArrow = " < ";
+constexpr std::string_view rightArrow = " > ";
 
 #endif // _WINSTRINGCONSTS_HPP
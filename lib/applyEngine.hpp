@@ -0,0 +1,45 @@
+/*
+  File:
+   applyEngine.hpp
+
+  Description:
+   Applies a theme to saved configuration files. The ThemeRewriter for a file
+   reports its edits as spans over the mapped original and only the spans are
+   built in memory; unchanged regions are handed to the kernel with
+   copy_file_range() or gathered straight from the mapping with writev().
+*/
+#ifndef APPLYENGINE_HPP
+#define APPLYENGINE_HPP
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "themeRewriters.hpp"
+
+// results of applying a theme to a single file
+enum ApplyResults {
+  _APPLYUNCHANGED,      // the file already uses the theme, nothing written
+  _APPLYWRITTEN,        // the file was rewritten with the theme
+  _APPLYUNSUPPORTED,    // no rewriter handles the file or it has no theme key
+  _APPLYFAILED          // the file couldn't be read or written
+};
+
+int applyThemeToFile(const std::string& path,
+                     const std::string& theme,
+                     std::ostream& log);
+void applyThemeToFiles(const std::vector<std::string>& paths,
+                       const std::string& theme,
+                       std::vector<int>& results,
+                       std::ofstream& log);
+bool makeApplyTempName(const std::string& name,
+                       std::string& tempName);
+int openApplyTempFile(const int dirFd,
+                      const std::string& name,
+                      std::string& tempName);
+int writeRewrittenFile(const int srcFd,
+                       const char* data,
+                       const size_t length,
+                       const std::vector<RewriteSpan>& spans,
+                       const int dstFd);
+
+#endif // APPLYENGINE_HPP
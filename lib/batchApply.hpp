@@ -0,0 +1,59 @@
+/*
+  File:
+   batchApply.hpp
+
+  Description:
+   Applies themes to the dotfiles of many users in one pass. A manifest lists
+   a user root, the theme to apply and the files under that root; the work is
+   shared by a work stealing thread pool that gives every filesystem its own
+   adaptive limit on the homes updated at once, and every result is merged
+   into a single report. Run as root, each home is updated with the file
+   permissions of the user who owns it.
+*/
+#ifndef BATCHAPPLY_HPP
+#define BATCHAPPLY_HPP
+#include <fstream>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+#include "applyEngine.hpp"
+
+// most homes updated at once on one filesystem unless told otherwise
+const int _BATCHDEVICELIMIT = 4;
+
+// one manifest line: "<user root> <theme> <file> [file ...]", files relative
+// to the root
+struct BatchEntry {
+  std::string root;
+  std::string theme;
+  std::vector<std::string> files;
+};
+
+// results of a single filesystem
+struct BatchDeviceReport {
+  dev_t device;
+  int numEntries;
+  int numResults[_APPLYFAILED + 1];
+};
+
+struct BatchReport {
+  int numEntries;
+  int numFiles;
+  int numResults[_APPLYFAILED + 1];
+  double elapsedMs;
+  std::vector<BatchDeviceReport> devices;
+  std::vector<std::string> failures;
+};
+
+void formatBatchReport(const BatchReport& report,
+                       std::string& output);
+bool readBatchManifest(const std::string& manifestPath,
+                       std::vector<BatchEntry>& entries,
+                       std::vector<std::string>& errors);
+void runBatchApply(const std::vector<BatchEntry>& entries,
+                   const int numThreads,
+                   const int perDeviceLimit,
+                   BatchReport& report,
+                   std::ofstream& log);
+
+#endif // BATCHAPPLY_HPP
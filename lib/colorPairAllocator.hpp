@@ -0,0 +1,71 @@
+/*
+  File:
+   colorPairAllocator.hpp
+
+  Description:
+   The class definition for the ColorPairAllocator class. Curses has a small,
+   fixed number of color pair and color slots, so the allocator hands them out
+   by RGB value and reuses the least recently used ones once they run out.
+   Previewing theme after theme then redefines only the colors that actually
+   changed instead of growing until init_pair() fails.
+*/
+#ifndef COLORPAIRALLOCATOR_HPP
+#define COLORPAIRALLOCATOR_HPP
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// never hand out more pairs or color slots than this, whatever the terminal
+// reports. a preview needs a few dozen of each.
+const int _MAXALLOCATORSLOTS = 256;
+
+class ColorPairAllocator {
+public:
+  // constructors
+  ColorPairAllocator();
+
+  // member functions
+  void initialize(const int firstPair,
+                  const int maxSlots = _MAXALLOCATORSLOTS);
+  int getPair(const uint32_t foreground,
+              const uint32_t background);
+
+  // getters
+  int getNumPairs() const;
+  int getNumColors() const;
+  bool getCanChangeColor() const;
+  unsigned long getNumPairInits() const;
+  unsigned long getNumColorInits() const;
+
+private:
+  struct ColorSlot {
+    short color;
+    std::list<uint32_t>::iterator lru;
+  };
+
+  struct PairSlot {
+    short pair;
+    short foreground;
+    short background;
+    std::list<uint64_t>::iterator lru;
+  };
+
+  // member functions
+  short getColor(const uint32_t rgb);
+
+  // member variables
+  bool m_canChangeColor;
+  int m_numColors;
+  int m_numPairs;
+  std::vector<short> m_freeColors;
+  std::vector<short> m_freePairs;
+  std::list<uint32_t> m_colorLru;
+  std::list<uint64_t> m_pairLru;
+  std::unordered_map<uint32_t, ColorSlot> m_colors;
+  std::unordered_map<uint64_t, PairSlot> m_pairs;
+  unsigned long m_numPairInits;
+  unsigned long m_numColorInits;
+};
+
+#endif // COLORPAIRALLOCATOR_HPP
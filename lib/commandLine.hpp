@@ -0,0 +1,40 @@
+/*
+  File:
+   commandLine.hpp
+
+  Description:
+   The headless command line interface. When themeswitcher is started with a
+   command it runs the command and exits without creating the log file or
+   initializing curses, so it can be used from login scripts and hooks, or
+   starts and drives the long running daemon.
+*/
+#ifndef COMMANDLINE_HPP
+#define COMMANDLINE_HPP
+#include <string>
+
+// process exit statuses of the command line interface
+enum CommandLineStatuses {
+  _CLISUCCESS,          // the command completed
+  _CLIFAILED,           // the command ran but at least one file failed
+  _CLIUSAGE             // the command or its arguments are invalid
+};
+
+// themes printed by the similar command when no count is given
+const int _SIMILARTHEMES = 10;
+
+int runApplyCommand(const std::string& theme);
+int runBatchCommand(const int argc,
+                    char** argv);
+int runCommandLine(const int argc,
+                   char** argv);
+int runCtlCommand(const int argc,
+                  char** argv);
+int runDaemonCommand();
+int runDuplicatesCommand();
+int runImportCommand(const int argc,
+                     char** argv);
+int runSimilarCommand(const std::string& theme,
+                      const int count);
+int runThemesCommand(const std::string& prefix);
+
+#endif // COMMANDLINE_HPP
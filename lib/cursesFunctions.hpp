@@ -1,11 +1,19 @@
 #ifndef CURSESFUNCTIONS_HPP
 #define CURSESFUNCTIONS_HPP
 #include <ncurses.h>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include "_cursesWinConsts.hpp"
+#include "colorPairAllocator.hpp"
 #include "cursesWindow.hpp"
+#include "fileWatcher.hpp"
+#include "frameArena.hpp"
 #include "log.hpp"
+#include "palette.hpp"
+#include "themeClusters.hpp"
+#include "themeGrid.hpp"
+#include "themeLibrary.hpp"
 #include "typeConversions.hpp"
 #include "_winStringConsts.hpp"
 
@@ -22,60 +30,40 @@ void checkSFClick(const std::unordered_map<int, CursesWindow*>& wins,
                   const int& mouseCol,
                   int& highlightWinNum,
                   std::ofstream& log);
-void checkSTClick(const std::unordered_map<int, CursesWindow*>& wins,
-                  const std::vector<CursesWindow*>& stStringWins,
-                  const int& mouseLine,
-                  const int& mouseCol,
-                  int& highlightWinNum,
-                  std::ofstream& log);
 bool checkWindowClick(std::unordered_map<int, CursesWindow*>& wins,
                       const int win,
-                      MEVENT& mouse,
-                      int& mouseLine,
-                      int& mouseCol,
+                      const int mouseLine,
+                      const int mouseCol,
                       const int yOffsetStart,
                       const int yOffsetEnd,
                       const int xOffsetStart,
                       const int xOffsetEnd,
                       std::ofstream& log);
 void clearSFStringWins(const std::vector<CursesWindow*>& sfStringWins);
-void clearSTStringWins(const std::vector<CursesWindow*>& stStringWins);
 void clearWins(const std::unordered_map<int, CursesWindow*>& wins);
-std::vector<std::string> createSFOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
-                                               std::vector<CursesWindow*>& sfStringWins,
-                                               const std::vector<std::string>& savedFileStrings,
-                                               const std::vector<std::string>& currThemes,
-                                               std::ofstream& log);
-std::vector<std::string> createSTOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
-                                               const std::vector<std::string>& stStrings,
-                                               const int& stStringPos,
-                                               std::ofstream& log);
+void createSFOutputString(const int fileIndex,
+                          const std::string_view fileString,
+                          const std::string_view themeString,
+                          const int maxCols,
+                          std::string& outString);
+void createSFOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
+                           const std::vector<CursesWindow*>& sfStringWins,
+                           const std::vector<std::string>& savedFileStrings,
+                           const std::vector<std::string>& currThemes,
+                           std::vector<std::string>& outputStrings,
+                           std::ofstream& log);
+void createSTOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
+                           const ThemeClusters& clusters,
+                           const int& stStringPos,
+                           std::vector<std::string>& outputStrings,
+                           std::ofstream& log);
 void createUserInputWin(std::unordered_map<int, CursesWindow*>& wins,
                         const int startY,
                         const int startX,
                         const int numLines,
                         const int numCols,
                         std::ofstream& log);
-void defineArrowWin(std::unordered_map<int, CursesWindow*>& wins,
-                    const int mainWin,
-                    const int arrowWin,
-                    const std::string winName,
-                    const int startY,
-                    const int startX,
-                    const int numLines,
-                    const int numCols,
-                    std::ofstream& log);
-void defineHelpWin(std::unordered_map<int, CursesWindow*>& wins,
-                   const int& maxLines,
-                   const int& maxCols);
 void definePromptTitle(std::vector<std::string>& promptStrings);
-void definePromptWin(std::unordered_map<int, CursesWindow*>& wins,
-                     const int& maxLines,
-                     const int& maxCols);
-void defineSavedFilesWin(std::unordered_map<int, CursesWindow*>& wins,
-                         const int& maxLines,
-                         const int& maxCols,
-                         std::ofstream& log);
 void defineSavedThemesWin(std::unordered_map<int, CursesWindow*>& wins,
                           const int& maxLines,
                           const int& maxCols,
@@ -87,11 +75,6 @@ void defineSFStringWins(const std::unordered_map<int, CursesWindow*>& wins,
                         const std::vector<std::string>& savedFileStrings,
                         const int& sfStringPos,
                         std::ofstream& log);
-void defineSTStringWins(const std::unordered_map<int, CursesWindow*>& wins,
-                        std::vector<CursesWindow*>& stStringWins,
-                        const std::vector<std::string>& savedSTStrings,
-                        const int& stStringPos,
-                        std::ofstream& log);
 void defineWins(std::unordered_map<int, CursesWindow*>& wins,
                 std::ofstream& log);
 void drawBoxes(const std::unordered_map<int, CursesWindow*>& wins,
@@ -99,30 +82,35 @@ void drawBoxes(const std::unordered_map<int, CursesWindow*>& wins,
 void drawSFStringBoxes(const std::unordered_map<int, CursesWindow*>& wins,
                        const std::vector<CursesWindow*> & sfStringWins,
                        std::ofstream& log);
-void drawSTStringBoxes(const std::unordered_map<int, CursesWindow*>& wins,
-                       const std::vector<CursesWindow*> & stStringWins,
-                       std::ofstream& log);
+const Palette* findPreviewPalette(std::unordered_map<std::string, Palette>& palettes,
+                                  const ThemeLibrary& library,
+                                  const int stPreviewNum);
 void flashButton(const std::unordered_map<int, CursesWindow*>& wins,
                  const int win,
-                 std::string outString,
+                 const std::string_view outString,
                  const int colorStart,
                  const int colorFlash,
                  std::ofstream& log);
 void initializeCurses();
 void initializeWins(std::unordered_map<int, CursesWindow*>& wins,
+                    RenderBackend& backend,
                     std::ofstream& log);
 void printButtonWin(const std::unordered_map<int, CursesWindow*>& wins,
                     const int win,
-                    std::string outString,
+                    const std::string_view outString,
                     const int colorPair,
                     std::ofstream& log);
 void printHelpWin(std::unordered_map<int, CursesWindow*>& wins,
                   std::ofstream& log);
 void printNumberedStrings(std::unordered_map<int, CursesWindow*>& wins,
                           std::ofstream& log);
+void printPreviewWin(const std::unordered_map<int, CursesWindow*>& wins,
+                     const Palette* palette,
+                     ColorPairAllocator& colorPairs,
+                     std::ofstream& log);
 void printPrompt(std::unordered_map<int, CursesWindow*>& wins,
                  const int win,
-                 const std::string& prompt,
+                 const std::string_view prompt,
                  std::ofstream& log);
 void printPromptWin(const std::unordered_map<int, CursesWindow*>& wins,
                     const std::vector<std::string>& promptStrings,
@@ -135,17 +123,11 @@ void printSavedFilesWin(std::unordered_map<int, CursesWindow*>& wins,
                         std::ofstream& log);
 void printSavedFilesStrings(std::unordered_map<int, CursesWindow*>& wins,
                             std::vector<CursesWindow*>& sfStringWins,
-                            std::vector<std::string> outputStrings,
+                            const std::vector<std::string>& outputStrings,
                             const int& sfStringPos,
                             const int& currStartWin,
                             const int& highlightWinNum,
                             std::ofstream& log);
-void printSavedThemesStrings(const std::unordered_map<int, CursesWindow*>& wins,
-                             std::vector<CursesWindow*>& stStringWins,
-                             const std::vector<std::string>& stStrings,
-                             const int& stStringPos,
-                             const int& stHighlightNum,
-                             std::ofstream& log);
 void printSavedThemesWin(const std::unordered_map<int, CursesWindow*>& wins,
                          std::ofstream& log);
 void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
@@ -155,12 +137,17 @@ void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
                     const int& stringIndex,
                     const int& yOffset,
                     int& xOffset,
+                    FrameArena& arena,
                     std::ofstream& log);
 void refreshSFStringWins(const std::vector<CursesWindow*>& sfStringWins,
                          std::ofstream& log);
-void refreshSTStringWins(const std::vector<CursesWindow*>& stStringWins,
-                         std::ofstream& log);
 void refreshWins(const std::unordered_map<int, CursesWindow*>& wins);
+bool scrollSFLines(const std::unordered_map<int, CursesWindow*>& wins,
+                   std::vector<CursesWindow*>& sfStringWins,
+                   const std::vector<std::string>& outputStrings,
+                   int& sfStringPos,
+                   const int numLines,
+                   std::ofstream& log);
 void shiftSFLeft(const std::unordered_map<int, CursesWindow*>& wins,
                  std::vector<CursesWindow*>& sfStringWins,
                  const std::vector<std::string>& outputStrings,
@@ -171,14 +158,21 @@ void shiftSFRight(const std::unordered_map<int, CursesWindow*>& wins,
                   const std::vector<std::string>& outputStrings,
                   int& sfStringPos,
                   std::ofstream& log);
-void shiftSTLeft(std::unordered_map<int, CursesWindow*>& wins,
-                 std::vector<CursesWindow*>& stStringWins,
-                 const std::vector<std::string>& outputStrings,
+void shiftSTLeft(const std::unordered_map<int, CursesWindow*>& wins,
+                 ThemeGrid& stGrid,
+                 const ThemeClusters& clusters,
                  int& stStringPos,
                  std::ofstream& log);
-void shiftSTRight(std::unordered_map<int, CursesWindow*>& wins,
-                  std::vector<CursesWindow*>& stStringWins,
-                  const std::vector<std::string>& outputStrings,
-                  int& outputStringPos,
+void shiftSTRight(const std::unordered_map<int, CursesWindow*>& wins,
+                  ThemeGrid& stGrid,
+                  const ThemeClusters& clusters,
+                  int& stStringPos,
                   std::ofstream& log);
+bool updateSFOutputStrings(const std::vector<CursesWindow*>& sfStringWins,
+                           const std::vector<std::string>& sfStrings,
+                           std::vector<std::string>& currThemes,
+                           std::vector<std::string>& outputStrings,
+                           const std::vector<FileThemeDelta>& deltas,
+                           const int& sfStringPos,
+                           std::ofstream& log);
 #endif // CURSESFUNCTIONS_HPP
@@ -3,41 +3,72 @@
    cursesWindow.hpp
 
   Description:
-   The class definition for the CursesWindow base class.
+   The class definition for the CursesWindow base class. A CursesWindow is
+   a window of the interface and its place on the screen, or a pad drawn
+   off the screen and shown a region at a time; it draws through the
+   RenderBackend it was given, ncurses or memory.
 */
 #ifndef CURSESWINDOW_HPP
 #define CURSESWINDOW_HPP
 #include <curses.h>
 #include <string>
+#include <string_view>
+#include "renderBackends.hpp"
 
 class CursesWindow {
 public:
   // constructors
-  CursesWindow(WINDOW* win = nullptr,
-               const std::string& windowName = "",
-               const int& numLines = 0,
-               const int& numCols = 0,
-               const int& startY = 0,
-               const int& startX = 0);
+  explicit CursesWindow(RenderBackend* backend = nullptr);
 
   // destructor
   ~CursesWindow();
 
   // member functions
-  void defineWindow(WINDOW* win,
-                    const std::string& windowName,
+  void attributesOff(const attr_t attributes);
+  void attributesOn(const attr_t attributes);
+  bool createPad(const std::string& windowName,
+                 const int& numLines,
+                 const int& numCols);
+  bool createScreenWindow(const std::string& windowName);
+  bool createWindow(const std::string& windowName,
                     const int& numLines,
                     const int& numCols,
                     const int& startY,
                     const int& startX);
-  void createWindow(const int& numLines,
+  void defineWindow(WINDOW* win,
+                    const std::string& windowName,
+                    const int& numLines,
                     const int& numCols,
                     const int& startY,
                     const int& startX);
   void deleteWindow();
-  WINDOW* createWindow();
+  void drawBox(const chtype vertical,
+               const chtype horizontal);
+  void eraseWindow();
+  void moveCursor(const int line,
+                  const int col);
+  bool moveWindow(const int startY,
+                  const int startX);
+  void printString(const int line,
+                   const int col,
+                   const std::string_view text);
+  bool resizeWindow(const int numLines,
+                    const int numCols);
+  void setAttributes(const attr_t attributes);
+  void setBackground(const chtype background);
+  void stagePad(const int padLine,
+                const int padCol,
+                const int startY,
+                const int startX,
+                const int numLines,
+                const int numCols);
+  void stageWindow();
+  void touchLines(const int line,
+                  const int numLines);
 
   // getters
+  RenderBackend* getBackend() const;
+  bool getIsOpen() const;
   WINDOW* getWindow();
   const std::string& getWindowName() const;
   const int& getNumCols() const;
@@ -46,6 +77,7 @@ public:
   const int& getStartX() const;
 
   // setters
+  void setBackend(RenderBackend* backend);
   void setWindow(WINDOW* window);
   void setWindowName(const std::string& winName);
   void setNumLines(const int& numLines);
@@ -55,12 +87,14 @@ public:
 
 private:
   // member variables
+  RenderBackend* m_backend;
   WINDOW* m_window;
   std::string m_windowName;
   int m_numLines;
   int m_numCols;
   int m_startY;
   int m_startX;
+  bool m_isOpen;
 };
 
 #endif // CURSESWINDOW_HPP
@@ -0,0 +1,80 @@
+/*
+  File:
+   daemonProtocol.hpp
+
+  Description:
+   The request/response protocol spoken over the daemon's Unix socket and the
+   DaemonClient class used by the command line interface (and anything else
+   that wants to drive a running daemon). Every message is a fixed 8 byte
+   header followed by a text payload, so a request costs a single write and
+   a response a header read plus one payload read.
+*/
+#ifndef DAEMONPROTOCOL_HPP
+#define DAEMONPROTOCOL_HPP
+#include <cstdint>
+#include <string>
+
+// request codes
+enum DaemonRequests {
+  _DAEMONPING,          // no payload, answers _DAEMONOK
+  _DAEMONAPPLY,         // payload is the theme, answers the apply counts
+  _DAEMONSTATUS,        // no payload, answers "theme\tpath" lines
+  _DAEMONRELOAD,        // re-reads the saved file store
+  _DAEMONQUIT,          // stops the daemon
+  _NUMDAEMONREQUESTS
+};
+
+// response codes
+enum DaemonResponses {
+  _DAEMONOK,
+  _DAEMONERROR
+};
+
+// largest payload either side accepts
+const uint32_t _DAEMONMAXPAYLOAD = 4 * 1024 * 1024;
+
+struct DaemonHeader {
+  uint32_t length;      // payload bytes following the header
+  uint16_t code;        // a DaemonRequests or DaemonResponses value
+  uint16_t reserved;
+};
+
+class DaemonClient {
+public:
+  // constructors
+  DaemonClient();
+
+  // destructor
+  ~DaemonClient();
+
+  // member functions
+  bool connectTo(const std::string& socketPath);
+  void disconnect();
+  bool request(const int code,
+               const std::string& payload,
+               int& responseCode,
+               std::string& response);
+
+  // getters
+  bool isConnected() const;
+
+private:
+  // member variables
+  int m_fd;
+};
+
+bool appendDaemonMessage(std::string& output,
+                         const int code,
+                         const std::string& payload);
+bool checkDaemonPeer(const int fd);
+bool checkDaemonSocketDir(const std::string& socketPath,
+                          const bool create);
+std::string daemonSocketPath();
+bool readDaemonMessage(const int fd,
+                       int& code,
+                       std::string& payload);
+bool writeDaemonMessage(const int fd,
+                        const int code,
+                        const std::string& payload);
+
+#endif // DAEMONPROTOCOL_HPP
@@ -0,0 +1,61 @@
+/*
+  File:
+   deviceScheduler.hpp
+
+  Description:
+   The class definition for the DeviceScheduler class. Saved files can live on
+   local disks, NFS or FUSE mounts with very different latencies, so each
+   filesystem (st_dev) gets its own concurrency window, sized by AIMD on the
+   latency observed there: the window grows by one per round trip while
+   operations stay fast and is halved when they slow down. A slow mount then
+   holds only its own few slots instead of every worker.
+*/
+#ifndef DEVICESCHEDULER_HPP
+#define DEVICESCHEDULER_HPP
+#include <mutex>
+#include <sys/types.h>
+#include <vector>
+
+// largest window any single filesystem may grow to unless told otherwise
+const int _DEVICEMAXWINDOW = 16;
+
+// window a filesystem starts with
+const double _DEVICESTARTWINDOW = 2.0;
+
+// an operation slower than this many times the fastest one seen on its
+// filesystem (and slower than _DEVICEMINSLOWMS) counts as congestion
+const double _DEVICESLOWFACTOR = 4.0;
+const double _DEVICEMINSLOWMS = 5.0;
+
+class DeviceScheduler {
+public:
+  // constructors
+  explicit DeviceScheduler(const int maxWindow = _DEVICEMAXWINDOW);
+
+  // member functions
+  int addDevice(const dev_t device);
+  void release(const int deviceIndex,
+               const double latencyMs);
+  bool tryAcquire(const int deviceIndex);
+
+  // getters
+  dev_t getDevice(const int deviceIndex) const;
+  int getNumDevices() const;
+  double getWindow(const int deviceIndex) const;
+
+private:
+  struct DeviceState {
+    dev_t device;
+    int inFlight;
+    double window;
+    double fastestMs;
+    int sinceDecrease;
+  };
+
+  // member variables
+  mutable std::mutex m_mutex;
+  std::vector<DeviceState> m_devices;
+  int m_maxWindow;
+};
+
+#endif // DEVICESCHEDULER_HPP
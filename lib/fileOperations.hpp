@@ -5,6 +5,13 @@
 
 
 
+bool appendSavedFile(const std::string& storePath,
+                     const std::string& path);
+std::string detectFileTheme(const std::string& path);
 int hwSFAddFile(std::vector<std::string> sfStrings);
+bool readSavedFiles(const std::string& storePath,
+                    std::vector<std::string>& savedFiles);
+std::string savedFilesStorePath();
+std::string themeLibraryStorePath();
 
 #endif // FILEOPERATIONS_HPP
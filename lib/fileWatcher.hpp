@@ -0,0 +1,75 @@
+/*
+  File:
+   fileWatcher.hpp
+
+  Description:
+   The class definition for the FileWatcher class. A FileWatcher runs a
+   background thread over an inotify descriptor and re-detects the current
+   theme of a saved file only when that file changes on disk.
+*/
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// a single current theme change for the file at fileIndex in sfStrings
+struct FileThemeDelta {
+  int fileIndex;
+  std::string theme;
+};
+
+// signature of the function used to re-detect a changed file's theme
+typedef std::string (*ThemeDetectFunc)(const std::string& path);
+
+class FileWatcher {
+public:
+  // constructors
+  explicit FileWatcher(ThemeDetectFunc detectFunc);
+
+  // destructor
+  ~FileWatcher();
+
+  // member functions
+  int addFile(const std::string& path);
+  bool start(const std::vector<std::string>& paths,
+             std::ofstream& log);
+  void stop();
+  bool takeDeltas(std::vector<FileThemeDelta>& deltas);
+
+  // getters
+  int getNumWatches() const;
+  bool isRunning() const;
+
+private:
+  // member functions
+  bool addPath(const int fileIndex,
+               const std::string& path);
+  void retryOrphans(std::vector<char>& isDirty,
+                    std::vector<int>& dirtyFiles);
+  void watchLoop();
+
+  // member variables
+  ThemeDetectFunc m_detectFunc;
+  int m_inotifyFd;
+  int m_wakeFd[2];
+  std::thread m_thread;
+  std::atomic<bool> m_running;
+  std::atomic<bool> m_hasDeltas;
+  std::mutex m_deltaMutex;
+  std::vector<FileThemeDelta> m_deltas;
+  // guards m_paths, m_watches and m_orphans, which addFile() changes while
+  // the watcher thread reads them
+  mutable std::mutex m_watchMutex;
+  std::vector<std::string> m_paths;
+  // watch descriptor -> (file name in the watched directory -> file indexes)
+  std::unordered_map<int, std::unordered_map<std::string, std::vector<int>>> m_watches;
+  // files whose directory is missing, retried until it is back
+  std::vector<int> m_orphans;
+};
+
+#endif // FILEWATCHER_HPP
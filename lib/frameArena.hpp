@@ -0,0 +1,46 @@
+/*
+  File:
+   frameArena.hpp
+
+  Description:
+   The class definition for the FrameArena class. A FrameArena is a bump
+   allocator over a fixed buffer for the strings a frame of the main loop
+   builds and throws away, such as the numbered prefix of a saved theme
+   line. Allocating is a pointer bump, freeing does nothing, and reset()
+   takes the whole buffer back at the start of the next frame, so the hot
+   path never reaches malloc() and reuses the same cache lines every frame.
+   A frame that outgrows the buffer falls back to the heap until it is
+   reset. Nothing allocated from the arena may outlive the frame.
+*/
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+// the bytes a frame can allocate before falling back to the heap
+const size_t _FRAMEARENASIZE = 16 * 1024;
+
+// a string whose characters live in a FrameArena
+typedef std::pmr::string FrameString;
+
+class FrameArena {
+public:
+  // constructors
+  FrameArena();
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // member functions
+  void reset();
+
+  // getters
+  std::pmr::memory_resource* getResource();
+
+private:
+  // member variables
+  alignas(std::max_align_t) char m_buffer[_FRAMEARENASIZE];
+  std::pmr::monotonic_buffer_resource m_resource;
+};
+
+#endif // FRAMEARENA_HPP
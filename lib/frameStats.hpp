@@ -0,0 +1,42 @@
+/*
+  File:
+   frameStats.hpp
+
+  Description:
+   Per frame accounting of the heap and the terminal. Built with
+   _FRAMESTATS set to 1 (make FRAMESTATS=1), the program replaces the global
+   operator new and operator delete with versions that count every
+   allocation and free, and wraps write() to count the calls and bytes sent
+   to the terminal. The main loop logs the counts of each iteration and
+   starts the next from zero, and the unit tests hold scripted frames to a
+   budget, such as no allocations and no output for a redraw that changes
+   nothing. The counts are kept per thread, so the file watcher's work never
+   shows up in a frame. Built without it the hooks are left out and the
+   counts stay zero.
+*/
+#ifndef FRAMESTATS_HPP
+#define FRAMESTATS_HPP
+#include <cstddef>
+#include <fstream>
+
+#ifndef _FRAMESTATS
+#define _FRAMESTATS 0
+#endif
+
+// the counts of one frame
+struct FrameStats {
+  size_t numAllocs;
+  size_t allocBytes;
+  size_t numFrees;
+  size_t numWrites;
+  size_t writeBytes;
+};
+
+void getFrameStats(FrameStats& stats);
+void logFrameStats(const int frameNum,
+                   const FrameStats& stats,
+                   std::ofstream& log);
+void resetFrameStats();
+void setFrameStatsFd(const int fd);
+
+#endif // FRAMESTATS_HPP
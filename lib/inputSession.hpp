@@ -0,0 +1,138 @@
+/*
+  File:
+   inputSession.hpp
+
+  Description:
+   The class definition for the InputSession class, where the interactive
+   loops read their input and wait out their frames. Each frame drains all
+   the input waiting, up to _MAXFRAMEINPUT events or a resize report, and
+   coalesces it: the screen size is checked once a frame, mouse releases
+   and motion are dropped, and repeated button 1 presses or wheel steps on
+   the same cell become one event with a count, so a burst is handled and
+   drawn once.
+   Live, it reads curses.
+   Recording (themeswitcher record <file>), it also writes every key, mouse
+   event and screen size change to the file with the frame it was read in
+   and the microseconds since the session started, as a few varints each;
+   idle frames write nothing. Replaying (themeswitcher replay <file>), it
+   reads that file instead of the terminal and hands the same input back on
+   the same frames, at the recorded times or, with --fast, without waiting
+   between frames, and times every frame that read input into a histogram
+   of power of two microsecond buckets, so the same session can be timed
+   across builds.
+*/
+#ifndef INPUTSESSION_HPP
+#define INPUTSESSION_HPP
+#include <chrono>
+#include <cstdint>
+#include <curses.h>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// identifies a recorded session file and its format version
+const char _RECORDMAGIC[] = "TSREC001";
+
+// microseconds a live frame sleeps before reading input again
+const int _FRAMEDELAY = 15000;
+
+// frame time histogram buckets, the last holding everything over 2^23 us
+const int _NUMFRAMEBUCKETS = 24;
+
+// the most keys and mouse events a frame reads, the rest wait for the next
+const int _MAXFRAMEINPUT = 256;
+
+enum InputSessionModes {
+  _SESSIONLIVE,
+  _SESSIONRECORD,
+  _SESSIONREPLAY
+};
+
+enum InputEventTypes {
+  _EVENTKEY,            // a wgetch() code other than ERR
+  _EVENTMOUSE,          // a getmouse() event: line, column and button state
+  _EVENTSIZE            // a new screen size: lines and columns
+};
+
+// an input of a recorded session
+struct InputEvent {
+  uint32_t frame;
+  uint64_t time;
+  int type;             // an InputEventTypes value
+  uint32_t values[3];
+};
+
+// a key, a button 1 click or a wheel scroll of a frame; the line and column
+// are -1 for keys
+struct FrameEvent {
+  int input;            // the key, KEY_MOUSE for a click, KEY_SR or KEY_SF
+                        // for a wheel scroll up or down
+  int mouseLine;
+  int mouseCol;
+  int count;            // the presses of a click or steps of a scroll, 1 for
+                        // keys
+};
+
+// the input of a frame, drained and coalesced
+struct FrameInput {
+  std::vector<FrameEvent> events;
+  int numResizes;
+};
+
+class InputSession {
+public:
+  // constructors
+  InputSession();
+
+  // member functions
+  void beginFrame();
+  bool openRecord(const std::string& path);
+  bool openReplay(const std::string& path,
+                  const bool isFast);
+  void readFrame(WINDOW* window,
+                 FrameInput& frameInput);
+  int readInput(WINDOW* window);
+  int readMouse(MEVENT& mouse);
+  void readScreenSize(int& numLines,
+                      int& numCols);
+  void start();
+  void waitFrame();
+  void writeFrameTimes(std::ostream& out) const;
+
+  // getters
+  bool getIsFinished() const;
+  int getMode() const;
+  int getNumFrames() const;
+
+private:
+  // member functions
+  void endFrame();
+  bool takeEvent(const int type,
+                 InputEvent& event);
+  void writeEvent(const int type,
+                  const uint32_t value0,
+                  const uint32_t value1,
+                  const uint32_t value2);
+
+  // member variables
+  int m_mode;
+  bool m_isFast;
+  std::ofstream m_recordFile;
+  std::vector<InputEvent> m_events;
+  size_t m_nextEvent;
+  uint32_t m_frame;
+  uint32_t m_lastFrame;
+  uint64_t m_lastTime;
+  int m_numLines;
+  int m_numCols;
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::time_point m_frameStart;
+  bool m_isInputFrame;
+  uint64_t m_frameBuckets[_NUMFRAMEBUCKETS];
+  uint64_t m_numInputFrames;
+  uint64_t m_inputFrameTime;
+  uint64_t m_maxFrameTime;
+};
+
+#endif // INPUTSESSION_HPP
@@ -0,0 +1,51 @@
+/*
+  File:
+   overlayStack.hpp
+
+  Description:
+   The class definition for the OverlayStack class. An OverlayStack keeps
+   the prompts and dialogs open over the main screen, such as _SFPROMPTWIN
+   and _USERINPUTWIN, in the order they were opened, and stages them over
+   whatever a frame redrew beneath them, top one last. The windows of the
+   main screen keep their contents while they are covered, so closing an
+   overlay marks the lines it covered as changed in each window on them and
+   stages them again, in screen order, instead of reprinting the windows;
+   curses then writes out only the cells the overlay had covered.
+*/
+#ifndef OVERLAYSTACK_HPP
+#define OVERLAYSTACK_HPP
+#include <unordered_map>
+#include <vector>
+#include "cursesWindow.hpp"
+#include "themeGrid.hpp"
+
+class OverlayStack {
+public:
+  // constructors
+  OverlayStack(const std::unordered_map<int, CursesWindow*>& wins,
+               const std::vector<CursesWindow*>& sfStringWins,
+               ThemeGrid& stGrid);
+
+  // member functions
+  void closeOverlay(CursesWindow* window);
+  void openOverlay(CursesWindow* window);
+  void stageOverlays();
+
+  // getters
+  bool getIsOverlay(const CursesWindow* window) const;
+  int getNumOverlays() const;
+
+private:
+  // member functions
+  void restoreLayer(CursesWindow* layer,
+                    const int startY,
+                    const int numLines);
+
+  // member variables
+  const std::unordered_map<int, CursesWindow*>& m_wins;
+  const std::vector<CursesWindow*>& m_sfStringWins;
+  ThemeGrid& m_stGrid;
+  std::vector<CursesWindow*> m_overlays;
+};
+
+#endif // OVERLAYSTACK_HPP
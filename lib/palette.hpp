@@ -0,0 +1,81 @@
+/*
+  File:
+   palette.hpp
+
+  Description:
+   The class definition for the Palette class. A Palette is the color table of
+   a theme, stored as separate packed red, green and blue arrays so conversions
+   run as straight loops over whole channels instead of per color string
+   formatting.
+*/
+#ifndef PALETTE_HPP
+#define PALETTE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// color notations used by the configuration files of supported programs
+enum ColorFormats {
+  _HEXCOLOR,            // #rrggbb      (alacritty, kitty, css)
+  _BAREHEXCOLOR,        // rrggbb       (foot, some lua themes)
+  _0XHEXCOLOR,          // 0xrrggbb     (older alacritty yaml)
+  _RGBCOLOR,            // rgb(r, g, b) (gtk css, waybar)
+  _XRGBCOLOR,           // rgb:rr/gg/bb (Xresources)
+  _XTERM256COLOR,       // nearest xterm 256 color index
+  _NUMCOLORFORMATS
+};
+
+// palette sizes
+const size_t _ANSICOLORS = 16;
+const size_t _XTERMCOLORS = 256;
+
+// a 16 color theme may carry its default text colors after the ANSI colors
+const size_t _PALETTEFOREGROUND = 16;
+const size_t _PALETTEBACKGROUND = 17;
+const size_t _THEMEPALETTESIZE = 18;
+
+class Palette {
+public:
+  // constructors
+  explicit Palette(const std::string& name = "",
+                   const size_t numColors = 0);
+
+  // member functions
+  bool parseColor(const size_t index,
+                  const std::string& color);
+  void findOklab(std::vector<float>& lightness,
+                 std::vector<float>& aAxis,
+                 std::vector<float>& bAxis) const;
+  void findXterm256(std::vector<uint8_t>& indexes) const;
+  void format(const int colorFormat,
+              std::string& output,
+              const char separator = '\n') const;
+  void pack(std::string& output) const;
+  bool unpack(const std::string& packed);
+
+  // getters
+  const std::string& getName() const;
+  size_t getNumColors() const;
+  uint32_t getColor(const size_t index) const;
+  const uint8_t* getReds() const;
+  const uint8_t* getGreens() const;
+  const uint8_t* getBlues() const;
+
+  // setters
+  void setName(const std::string& name);
+  void setNumColors(const size_t numColors);
+  void setColor(const size_t index,
+                const uint32_t rgb);
+
+private:
+  // member variables
+  std::string m_name;
+  std::vector<uint8_t> m_reds;
+  std::vector<uint8_t> m_greens;
+  std::vector<uint8_t> m_blues;
+};
+
+uint32_t xterm256Color(const int index);
+
+#endif // PALETTE_HPP
@@ -0,0 +1,90 @@
+/*
+  File:
+   paletteIndex.hpp
+
+  Description:
+   Palette fingerprints and the PaletteIndex class, a vantage point tree over
+   them. A fingerprint is the OKLab coordinates of a theme's 18 colors
+   quantized to small integers, so two themes that look the same have equal
+   or nearby fingerprints whatever they are named. The tree answers nearest
+   neighbor and radius queries while measuring the distance to only a small
+   part of the fingerprints, using the triangle inequality to skip whole
+   subtrees.
+*/
+#ifndef PALETTEINDEX_HPP
+#define PALETTEINDEX_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "palette.hpp"
+
+// the three OKLab coordinates of every theme color, zero padded to a whole
+// number of 16 byte vectors so the distance loop is vectorized
+const int _FINGERPRINTCOORDS = _THEMEPALETTESIZE * 3;
+const int _FINGERPRINTSIZE = 64;
+
+// OKLab units per fingerprint step. 1/100 is half of a just noticeable color
+// difference, and every coordinate still fits in an int8_t.
+const float _FINGERPRINTSCALE = 100.0f;
+
+// a query result: the id of an indexed fingerprint and its distance from the
+// query in fingerprint steps
+struct IndexMatch {
+  int id;
+  float distance;
+};
+
+class PaletteIndex {
+public:
+  // constructors
+  PaletteIndex();
+
+  // member functions
+  void build(const std::vector<int8_t>& fingerprints);
+  void findNearest(const int8_t* query,
+                   const int count,
+                   std::vector<IndexMatch>& matches) const;
+  void findWithinRadius(const int8_t* query,
+                        const float radius,
+                        std::vector<IndexMatch>& matches) const;
+
+  // getters
+  const int8_t* getFingerprint(const int id) const;
+  int getNumFingerprints() const;
+  int getNumVisited() const;
+
+private:
+  int buildNode(std::vector<IndexMatch>& items,
+                const int first,
+                const int last);
+  float distance(const int8_t* query,
+                 const int id) const;
+  void searchNearest(const int node,
+                     const int8_t* query,
+                     const int count,
+                     std::vector<IndexMatch>& matches) const;
+  void searchRadius(const int node,
+                    const int8_t* query,
+                    const float radius,
+                    std::vector<IndexMatch>& matches) const;
+
+  // a tree node. fingerprints closer to the vantage point than threshold
+  // are in the inside subtree, the rest in the outside subtree.
+  struct Node {
+    int id;
+    float threshold;
+    int inside;
+    int outside;
+  };
+
+  // member variables
+  std::vector<int8_t> m_fingerprints;
+  std::vector<Node> m_nodes;
+  int m_root;
+  mutable int m_numVisited;
+};
+
+bool fingerprintPalette(const Palette& palette,
+                        int8_t* fingerprint);
+
+#endif // PALETTEINDEX_HPP
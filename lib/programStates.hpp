@@ -1,3 +1,17 @@
+/*
+  File:
+   programStates.hpp
+
+  Description:
+   The ProgramState interface and the program states built on it. A program
+   state is a prompt or dialog the main loop opens over the main screen. It
+   has no loop of its own: each frame the main loop hands it the frame's
+   input, one event at a time, until it says it has closed, and has it stage
+   its windows last, so it shares the main loop's input batching, frame
+   timing and single doupdate(), and the file watcher keeps being serviced
+   while it is open. Its windows are overlays on an OverlayStack, which puts
+   the screen under them back when they close.
+*/
 #ifndef PROGRAMSTATES_HPP
 #define PROGRAMSTATES_HPP
 #include <fstream>
@@ -12,11 +26,53 @@
 #include "cursesFunctions.hpp"
 #include "cursesWindow.hpp"
 #include "fileOperations.hpp"
+#include "frameArena.hpp"
+#include "inputSession.hpp"
 #include "log.hpp"
+#include "overlayStack.hpp"
+
+class ProgramState {
+public:
+  // destructor
+  virtual ~ProgramState() {}
+
+  // member functions
+  virtual void closeState(std::unordered_map<int, CursesWindow*>& wins) = 0;
+  virtual bool handleInput(std::unordered_map<int, CursesWindow*>& wins,
+                           const FrameEvent& event,
+                           std::ofstream& log) = 0;
+  virtual void openState(std::unordered_map<int, CursesWindow*>& wins,
+                         std::ofstream& log) = 0;
+  virtual void stageState() = 0;
+};
+
+// the prompt the add file button opens over the saved files window
+class HWSFAddFileState : public ProgramState {
+public:
+  // constructors
+  HWSFAddFileState(FrameArena& arena,
+                   OverlayStack& overlays);
+
+  // member functions
+  void closeState(std::unordered_map<int, CursesWindow*>& wins);
+  bool handleInput(std::unordered_map<int, CursesWindow*>& wins,
+                   const FrameEvent& event,
+                   std::ofstream& log);
+  void openState(std::unordered_map<int, CursesWindow*>& wins,
+                 std::ofstream& log);
+  void stageState();
+
+  // getters
+  const std::string& getOutputString() const;
 
-void enterHWSFAddFileState(std::unordered_map<int, CursesWindow*>& wins,
-                           MEVENT& mouse,
-                           int& mouseLine,
-                           int& mouseCol,
-                           std::ofstream& log);
+private:
+  // member variables
+  FrameArena& m_arena;
+  OverlayStack& m_overlays;
+  std::string m_outputString;
+  int m_stringIndex;
+  int m_startY;
+  int m_xOffset;
+  int m_numCols;
+};
 #endif // PROGRAMSTATES_HPP
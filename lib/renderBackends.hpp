@@ -0,0 +1,280 @@
+/*
+  File:
+   renderBackends.hpp
+
+  Description:
+   The RenderBackend interface the CursesWindow class draws through, and its
+   two backends. CursesBackend is ncurses. MemoryBackend keeps every window
+   and pad as a grid of cells and composes them onto a screen of cells as
+   ncurses would, recording each call it is given, so the layout, hit
+   testing and formatting of cursesFunctions.cpp run headless, many screens
+   to a process and thousands of frames a second, with no terminal behind
+   them.
+*/
+#ifndef RENDERBACKENDS_HPP
+#define RENDERBACKENDS_HPP
+#include <curses.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class CursesWindow;
+
+class RenderBackend {
+public:
+  // destructor
+  virtual ~RenderBackend() {}
+
+  // member functions
+  virtual void attributesOff(CursesWindow& window,
+                             const attr_t attributes) = 0;
+  virtual void attributesOn(CursesWindow& window,
+                            const attr_t attributes) = 0;
+  virtual void closeWindow(CursesWindow& window) = 0;
+  virtual void drawBox(CursesWindow& window,
+                       const chtype vertical,
+                       const chtype horizontal) = 0;
+  virtual void eraseWindow(CursesWindow& window) = 0;
+  virtual bool moveWindow(CursesWindow& window,
+                          const int startY,
+                          const int startX) = 0;
+  virtual void moveCursor(CursesWindow& window,
+                          const int line,
+                          const int col) = 0;
+  virtual bool openPad(CursesWindow& window,
+                       const int numLines,
+                       const int numCols) = 0;
+  virtual bool openScreen(CursesWindow& window) = 0;
+  virtual bool openWindow(CursesWindow& window,
+                          const int numLines,
+                          const int numCols,
+                          const int startY,
+                          const int startX) = 0;
+  virtual void printString(CursesWindow& window,
+                           const int line,
+                           const int col,
+                           const std::string_view text) = 0;
+  virtual bool resizeWindow(CursesWindow& window,
+                            const int numLines,
+                            const int numCols) = 0;
+  virtual void setAttributes(CursesWindow& window,
+                             const attr_t attributes) = 0;
+  virtual void setBackground(CursesWindow& window,
+                             const chtype background) = 0;
+  virtual void stagePad(CursesWindow& window,
+                        const int padLine,
+                        const int padCol,
+                        const int startY,
+                        const int startX,
+                        const int numLines,
+                        const int numCols) = 0;
+  virtual void stageWindow(CursesWindow& window) = 0;
+  virtual void touchLines(CursesWindow& window,
+                          const int line,
+                          const int numLines) = 0;
+  virtual void update() = 0;
+
+  // getters
+  virtual void getScreenSize(int& numLines,
+                             int& numCols) const = 0;
+};
+
+// draws to the terminal through ncurses, which must be initialized first
+class CursesBackend : public RenderBackend {
+public:
+  // member functions
+  void attributesOff(CursesWindow& window,
+                     const attr_t attributes);
+  void attributesOn(CursesWindow& window,
+                    const attr_t attributes);
+  void closeWindow(CursesWindow& window);
+  void drawBox(CursesWindow& window,
+               const chtype vertical,
+               const chtype horizontal);
+  void eraseWindow(CursesWindow& window);
+  bool moveWindow(CursesWindow& window,
+                  const int startY,
+                  const int startX);
+  void moveCursor(CursesWindow& window,
+                  const int line,
+                  const int col);
+  bool openPad(CursesWindow& window,
+               const int numLines,
+               const int numCols);
+  bool openScreen(CursesWindow& window);
+  bool openWindow(CursesWindow& window,
+                  const int numLines,
+                  const int numCols,
+                  const int startY,
+                  const int startX);
+  void printString(CursesWindow& window,
+                   const int line,
+                   const int col,
+                   const std::string_view text);
+  bool resizeWindow(CursesWindow& window,
+                    const int numLines,
+                    const int numCols);
+  void setAttributes(CursesWindow& window,
+                     const attr_t attributes);
+  void setBackground(CursesWindow& window,
+                     const chtype background);
+  void stagePad(CursesWindow& window,
+                const int padLine,
+                const int padCol,
+                const int startY,
+                const int startX,
+                const int numLines,
+                const int numCols);
+  void stageWindow(CursesWindow& window);
+  void touchLines(CursesWindow& window,
+                  const int line,
+                  const int numLines);
+  void update();
+
+  // getters
+  void getScreenSize(int& numLines,
+                     int& numCols) const;
+};
+
+// the calls a MemoryBackend records
+enum DrawOps {
+  _DRAWOPEN,
+  _DRAWCLOSE,
+  _DRAWRESIZE,
+  _DRAWMOVE,
+  _DRAWERASE,
+  _DRAWBOX,
+  _DRAWPRINT,
+  _DRAWATTRIBUTES,
+  _DRAWSTAGE,
+  _DRAWSTAGEPAD,
+  _DRAWTOUCH,
+  _DRAWUPDATE
+};
+
+// a recorded call: its window, compared only by address, and the line,
+// column and length it covered where they apply
+struct DrawCall {
+  int op;               // a DrawOps value
+  const CursesWindow* window;
+  int line;
+  int col;
+  int length;
+};
+
+// a character on a window or the screen, with the attributes it's drawn in
+struct MemoryCell {
+  char ch;
+  attr_t attributes;
+};
+
+// draws to grids of cells in memory, for tests and benchmarks
+class MemoryBackend : public RenderBackend {
+public:
+  // constructors
+  MemoryBackend(const int numLines,
+                const int numCols);
+
+  // member functions
+  void attributesOff(CursesWindow& window,
+                     const attr_t attributes);
+  void attributesOn(CursesWindow& window,
+                    const attr_t attributes);
+  void clearCalls();
+  void closeWindow(CursesWindow& window);
+  void drawBox(CursesWindow& window,
+               const chtype vertical,
+               const chtype horizontal);
+  void eraseWindow(CursesWindow& window);
+  bool moveWindow(CursesWindow& window,
+                  const int startY,
+                  const int startX);
+  void moveCursor(CursesWindow& window,
+                  const int line,
+                  const int col);
+  bool openPad(CursesWindow& window,
+               const int numLines,
+               const int numCols);
+  bool openScreen(CursesWindow& window);
+  bool openWindow(CursesWindow& window,
+                  const int numLines,
+                  const int numCols,
+                  const int startY,
+                  const int startX);
+  void printString(CursesWindow& window,
+                   const int line,
+                   const int col,
+                   const std::string_view text);
+  bool resizeWindow(CursesWindow& window,
+                    const int numLines,
+                    const int numCols);
+  void setAttributes(CursesWindow& window,
+                     const attr_t attributes);
+  void setBackground(CursesWindow& window,
+                     const chtype background);
+  void setScreenSize(const int numLines,
+                     const int numCols);
+  void stagePad(CursesWindow& window,
+                const int padLine,
+                const int padCol,
+                const int startY,
+                const int startX,
+                const int numLines,
+                const int numCols);
+  void stageWindow(CursesWindow& window);
+  void touchLines(CursesWindow& window,
+                  const int line,
+                  const int numLines);
+  void update();
+
+  // getters
+  const std::vector<DrawCall>& getCalls() const;
+  const MemoryCell& getCell(const int line,
+                            const int col) const;
+  void getLine(const int line,
+               std::string& text) const;
+  int getNumUpdates() const;
+  int getNumWindows() const;
+  void getScreenSize(int& numLines,
+                     int& numCols) const;
+
+private:
+  struct MemoryWindow {
+    int numLines;
+    int numCols;
+    int startY;
+    int startX;
+    int cursorY;
+    int cursorX;
+    attr_t attributes;
+    chtype background;
+    bool isPad;
+    std::vector<MemoryCell> cells;
+    std::vector<int> firstChanged;      // per line, as curses' firstchar
+    std::vector<int> lastChanged;       // per line, as curses' lastchar
+  };
+
+  // member functions
+  MemoryWindow* findWindow(const CursesWindow& window);
+  void markChanged(MemoryWindow& memoryWindow,
+                   const int line,
+                   const int firstCol,
+                   const int lastCol);
+  void markWindowChanged(MemoryWindow& memoryWindow);
+  void recordCall(const CursesWindow& window,
+                  const int op,
+                  const int line,
+                  const int col,
+                  const int length);
+
+  // member variables
+  std::unordered_map<const CursesWindow*, MemoryWindow> m_windows;
+  std::vector<MemoryCell> m_screen;
+  std::vector<DrawCall> m_calls;
+  int m_numLines;
+  int m_numCols;
+  int m_numUpdates;
+};
+
+#endif // RENDERBACKENDS_HPP
@@ -1,7 +1,9 @@
 #ifndef TESTINGINTERFACE_HPP
 #define TESTINGINTERFACE_HPP
+#include <unordered_map>
 #include <vector>
 #include "log.hpp"
+#include "palette.hpp"
 #include "typeConversions.hpp"
 
 void initSTStrings(std::vector<std::string>& testStrings,
@@ -14,6 +16,9 @@ void initTestFilesStringVector(std::vector<std::string>& testStrings,
 void initTestCurrThemesStringVector(std::vector<std::string>& testStrings,
                                const int numStrings,
                                std::ofstream& log);
+void initTestPalettes(const std::vector<std::string>& themeNames,
+                      std::unordered_map<std::string, Palette>& palettes,
+                      std::ofstream& log);
 void printTestStringVectorToLog(const std::vector<std::string>& strings,
                                 std::ofstream& log);
 
@@ -0,0 +1,84 @@
+/*
+  File:
+   themeClusters.hpp
+
+  Description:
+   The class definition for the ThemeClusters class. ThemeClusters groups the
+   themes of a ThemeLibrary whose palettes are the same or look the same, by
+   indexing every palette's fingerprint in a PaletteIndex and gathering the
+   themes within _NEARDUPLICATEDELTA of each unclaimed theme, in name order.
+   The first theme of a group represents it, so the _SAVEDTHEMESWIN can list
+   one theme per group, and the index answers "themes like this one" without
+   comparing against the whole library. The index and the groups are only
+   built when they are first needed; until then the clusters list every
+   theme.
+*/
+#ifndef THEMECLUSTERS_HPP
+#define THEMECLUSTERS_HPP
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "paletteIndex.hpp"
+#include "themeLibrary.hpp"
+
+// the largest average OKLab difference per color of near duplicate themes
+const float _NEARDUPLICATEDELTA = 0.02f;
+
+// a theme found by a query: its library index and its average OKLab
+// difference per color from the queried theme
+struct ClusterMember {
+  int entry;
+  float delta;
+};
+
+class ThemeClusters {
+public:
+  // constructors
+  explicit ThemeClusters(const ThemeLibrary& library);
+
+  // member functions
+  void buildClusters(const float maxDelta = _NEARDUPLICATEDELTA);
+  void buildIndex();
+  bool findSimilar(const int entry,
+                   const int count,
+                   std::vector<ClusterMember>& similar) const;
+  void getClusters(std::vector<std::vector<ClusterMember> >& clusters) const;
+  void getVisibleNames(const int first,
+                       const int count,
+                       std::vector<std::string>& names) const;
+
+  // getters
+  int getClusterSize(const int entry) const;
+  bool getIsClustered() const;
+  bool getIsCollapsed() const;
+  bool getIsExact(const int entry) const;
+  int getNumClusters() const;
+  int getNumExact() const;
+  int getNumNear() const;
+  int getNumVisible() const;
+  int getNumVisited() const;
+  int getVisible(const int visibleIndex) const;
+
+  // setters
+  void setIsCollapsed(const bool isCollapsed);
+
+private:
+  // member variables
+  const ThemeLibrary* m_library;
+  PaletteIndex m_index;
+  std::vector<int> m_fingerprintEntries;
+  std::vector<int> m_entryFingerprints;
+  std::vector<int> m_leaders;
+  std::vector<float> m_deltas;
+  std::vector<uint8_t> m_isExact;
+  std::vector<int> m_clusterSizes;
+  std::vector<int> m_representatives;
+  int m_numClusters;
+  int m_numExact;
+  int m_numNear;
+  bool m_isIndexed;
+  bool m_isClustered;
+  bool m_isCollapsed;
+};
+
+#endif // THEMECLUSTERS_HPP
@@ -0,0 +1,71 @@
+/*
+  File:
+   themeDaemon.hpp
+
+  Description:
+   The class definition for the ThemeDaemon class. The daemon keeps the saved
+   file store and the current theme of every saved file (kept fresh by a
+   FileWatcher) resident, and serves requests from any number of clients over
+   a Unix socket, so repeated switches skip process startup, store loading and
+   theme detection altogether.
+*/
+#ifndef THEMEDAEMON_HPP
+#define THEMEDAEMON_HPP
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fileWatcher.hpp"
+
+// the bytes of one client connection waiting in each direction
+struct DaemonConnection {
+  std::string input;    // received but not yet handled
+  std::string output;   // responses not yet sent
+};
+
+class ThemeDaemon {
+public:
+  // constructors
+  ThemeDaemon(const std::string& socketPath,
+              const std::string& storePath);
+
+  // destructor
+  ~ThemeDaemon();
+
+  // member functions
+  bool start(std::ofstream& log);
+  void run(std::ofstream& log);
+  void stop();
+
+  // getters
+  const std::vector<std::string>& getSavedFiles() const;
+  const std::vector<std::string>& getCurrThemes() const;
+
+private:
+  // member functions
+  void acceptClient();
+  void handleRequest(const int code,
+                     const std::string& payload,
+                     int& responseCode,
+                     std::string& response,
+                     std::ofstream& log);
+  bool loadStore(std::ofstream& log);
+  bool readClient(const int fd,
+                  std::ofstream& log);
+  void takeThemeDeltas();
+  bool writeClient(const int fd);
+
+  // member variables
+  std::string m_socketPath;
+  std::string m_storePath;
+  int m_listenFd;
+  bool m_running;
+  std::vector<std::string> m_savedFiles;
+  std::vector<std::string> m_currThemes;
+  std::vector<FileThemeDelta> m_deltas;
+  FileWatcher m_fileWatcher;
+  // client descriptor -> its pending bytes
+  std::unordered_map<int, DaemonConnection> m_clients;
+};
+
+#endif // THEMEDAEMON_HPP
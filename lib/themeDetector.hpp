@@ -0,0 +1,63 @@
+/*
+  File:
+   themeDetector.hpp
+
+  Description:
+   The class definition for the ThemeDetector class. Every known theme
+   directive is compiled into a single Aho-Corasick automaton so a saved
+   configuration file is scanned once, front to back, and the scan stops at the
+   first directive found.
+*/
+#ifndef THEMEDETECTOR_HPP
+#define THEMEDETECTOR_HPP
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// the theme directives the detector recognizes
+enum ThemeDirectives {
+  _ALACRITTYIMPORT,     // import = ["~/.config/alacritty/themes/name.toml"]
+  _KITTYINCLUDE,        // include themes/name.conf
+  _XRESOURCESINCLUDE,   // #include "/home/user/.Xresources.d/name"
+  _EMACSLOADTHEME,      // (load-theme 'name t)
+  _QTILECOLORS,         // colors = colors.name
+  _NUMTHEMEDIRECTIVES
+};
+
+class ThemeDetector {
+public:
+  // constructors
+  ThemeDetector();
+
+  // member functions
+  int detect(const char* data,
+             const size_t length,
+             std::string& theme) const;
+  int detectFile(const std::string& path,
+                 std::string& theme) const;
+
+private:
+  // member functions
+  void addPattern(const std::string& pattern,
+                  const int directive);
+  void build();
+  bool extractTheme(const char* data,
+                    const size_t length,
+                    const size_t keyStart,
+                    const int directive,
+                    std::string& theme) const;
+
+  // member variables
+  std::vector<std::string> m_patterns;
+  std::vector<uint16_t> m_next;    // dense transition table, state * 256 + byte
+  std::vector<int8_t> m_output;    // directive recognized on entering a state
+  int m_numStates;
+};
+
+const ThemeDetector& themeDetector();
+void detectFileThemes(const std::vector<std::string>& paths,
+                      std::vector<std::string>& themes,
+                      std::ofstream& log);
+
+#endif // THEMEDETECTOR_HPP
@@ -0,0 +1,75 @@
+/*
+  File:
+   themeGrid.hpp
+
+  Description:
+   The class definition for the ThemeGrid class. A ThemeGrid shows the saved
+   themes of the _SAVEDTHEMESWIN as a grid of columns, _STWINMAXCOLS wide,
+   printed into a pad off the screen. The pad holds a band of the grid,
+   the whole of it when the themes fill no more than _STPADMAXPAGES pages,
+   and the viewport staged onto the screen is a region of it, so paging
+   within the band moves the viewport and copies it with pnoutrefresh()
+   instead of printing anything. Only paging past the band prints the band
+   again, around the new page, so the pad stays small however many themes
+   are saved.
+*/
+#ifndef THEMEGRID_HPP
+#define THEMEGRID_HPP
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cursesWindow.hpp"
+#include "themeClusters.hpp"
+
+class ThemeGrid {
+public:
+  // constructors
+  explicit ThemeGrid(RenderBackend* backend = nullptr);
+
+  // member functions
+  int checkClick(const int mouseLine,
+                 const int mouseCol) const;
+  void defineGrid(const std::unordered_map<int, CursesWindow*>& wins);
+  void deleteGrid();
+  void printHighlight(const int highlightNum);
+  void resetGrid();
+  void showPage(const std::unordered_map<int, CursesWindow*>& wins,
+                const ThemeClusters& clusters,
+                const int stStringPos,
+                std::ofstream& log);
+  void stageGrid();
+
+  // getters
+  int getBandPos() const;
+  bool getIsOpen() const;
+  int getNumLines() const;
+  int getNumCols() const;
+  const CursesWindow& getPad() const;
+  int getStartY() const;
+  int getStartX() const;
+
+private:
+  // member functions
+  void printBand(const std::unordered_map<int, CursesWindow*>& wins,
+                 const ThemeClusters& clusters,
+                 const int bandPos,
+                 std::ofstream& log);
+  void printTheme(const int pos,
+                  const int colorPair);
+
+  // member variables
+  CursesWindow m_pad;
+  std::vector<std::string> m_bandStrings;
+  std::vector<std::string> m_pageStrings;
+  int m_bandPos;
+  int m_bandEnd;
+  int m_pagePos;
+  int m_highlightPos;
+  int m_startY;
+  int m_startX;
+  int m_numLines;
+  int m_numGridCols;
+};
+
+#endif // THEMEGRID_HPP
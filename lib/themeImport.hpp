@@ -0,0 +1,73 @@
+/*
+  File:
+   themeImport.hpp
+
+  Description:
+   Imports theme collections into the saved themes library. Theme directories
+   and plain .tar archives are walked by a pool of threads, every file is
+   read in fixed size chunks through a streaming PaletteParser, palettes with
+   identical colors are kept once by content hash, and all new themes are
+   merged into the library and saved with a single atomic write.
+*/
+#ifndef THEMEIMPORT_HPP
+#define THEMEIMPORT_HPP
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "palette.hpp"
+#include "themeLibrary.hpp"
+
+// bytes read from a file or archive at a time
+const size_t _IMPORTCHUNKSIZE = 64 * 1024;
+
+// longer lines can't hold a color and are skipped
+const size_t _IMPORTMAXLINE = 4096;
+
+// larger files aren't themes and aren't read
+const size_t _IMPORTMAXFILESIZE = 1024 * 1024;
+
+class PaletteParser {
+public:
+  // constructors
+  PaletteParser();
+
+  // member functions
+  void feed(const char* data,
+            const size_t length);
+  bool finish(Palette& palette);
+  void reset();
+
+private:
+  void parseLine(const char* line,
+                 size_t length);
+
+  // member variables
+  std::string m_line;
+  bool m_isLineTooLong;
+  int m_sectionOffset;
+  Palette m_scratch;
+  uint32_t m_colors[_THEMEPALETTESIZE];
+  uint32_t m_foundMask;
+};
+
+struct ImportReport {
+  int numFiles;
+  int numThemes;
+  int numDuplicates;
+  int numExisting;
+  int numUnparsed;
+  double elapsedMs;
+  std::vector<std::string> errors;
+};
+
+void formatImportReport(const ImportReport& report,
+                        std::string& output);
+void importThemes(const std::vector<std::string>& sources,
+                  const int numThreads,
+                  ThemeLibrary& library,
+                  ImportReport& report,
+                  std::ofstream& log);
+
+#endif // THEMEIMPORT_HPP
@@ -0,0 +1,78 @@
+/*
+  File:
+   themeLibrary.hpp
+
+  Description:
+   The class definition for the ThemeLibrary class, the saved themes library.
+   Theme names are kept sorted and prefix compressed: each name stores only
+   the length of the prefix it shares with the name before it and the rest of
+   its bytes, followed by the theme's value (its packed palette, if known).
+   Every _LIBRARYRESTART names a name is stored whole and its offset kept in
+   a sparse index, so a lookup binary searches the index and decodes at most
+   one block, and a page of names is decoded sequentially from the block it
+   starts in. The same table is the on-disk format.
+*/
+#ifndef THEMELIBRARY_HPP
+#define THEMELIBRARY_HPP
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// names per block; the first name of a block is stored whole
+const int _LIBRARYRESTART = 16;
+
+// identifies a library file and its format version
+const char _LIBRARYMAGIC[] = "TSLIB002";
+
+// a theme name and its value
+struct LibraryEntry {
+  std::string name;
+  std::string value;
+};
+
+class ThemeLibrary {
+public:
+  // constructors
+  ThemeLibrary();
+
+  // member functions
+  std::string at(const int index) const;
+  void build(std::vector<std::string> names);
+  void buildEntries(std::vector<LibraryEntry> entries);
+  int find(const std::string& name) const;
+  void findPrefix(const std::string& prefix,
+                  int& first,
+                  int& last) const;
+  void getEntries(const int first,
+                  const int count,
+                  std::vector<LibraryEntry>& entries) const;
+  bool getName(const int index,
+               std::string& name) const;
+  void getRange(const int first,
+                const int count,
+                std::vector<std::string>& names) const;
+  bool getValue(const int index,
+                std::string& value) const;
+  bool load(const std::string& path);
+  int lowerBound(const std::string& key) const;
+  bool save(const std::string& path) const;
+
+  // getters
+  int getNumEntries() const;
+
+private:
+  int compareBlockKey(const int block,
+                      const std::string& key) const;
+  bool decodeEntry(size_t& offset,
+                   std::string& name,
+                   std::string* value) const;
+  int seek(const std::string& key,
+           std::string& name) const;
+
+  // member variables
+  std::string m_data;
+  std::vector<uint32_t> m_blockOffsets;
+  int m_numEntries;
+};
+
+#endif // THEMELIBRARY_HPP
@@ -0,0 +1,82 @@
+/*
+  File:
+   themeRewriters.hpp
+
+  Description:
+   The ThemeRewriter plugin interface used by the apply engine and the
+   format-aware rewriters built on it. A rewriter never builds a new copy of a
+   file, it only reports the edits needed to apply a theme as spans over the
+   original file contents.
+*/
+#ifndef THEMEREWRITERS_HPP
+#define THEMEREWRITERS_HPP
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// longest theme name a rewriter writes into a file
+const size_t _THEMENAMEMAX = 128;
+
+// replace length bytes at offset of the original file with replacement
+struct RewriteSpan {
+  size_t offset;
+  size_t length;
+  std::string replacement;
+};
+
+class ThemeRewriter {
+public:
+  // destructor
+  virtual ~ThemeRewriter() {}
+
+  // member functions
+  virtual const std::string& getName() const = 0;
+  virtual bool handlesFile(const std::string& path) const = 0;
+  virtual bool findEdits(const char* data,
+                         const size_t length,
+                         const std::string& theme,
+                         std::vector<RewriteSpan>& spans) const = 0;
+};
+
+// rewrites the theme value of a "key <separator> value" line, optionally only
+// inside an INI/TOML style [section]. covers TOML, YAML, INI, Xresources,
+// kitty, Lua and Python assignments.
+class KeyValueRewriter : public ThemeRewriter {
+public:
+  // constructors
+  KeyValueRewriter(const std::string& name,
+                   const std::vector<std::string>& fileSuffixes,
+                   const std::string& key,
+                   const char separator,
+                   const std::string& componentSeparators,
+                   const std::string& section = "");
+
+  // member functions
+  const std::string& getName() const;
+  bool handlesFile(const std::string& path) const;
+  bool findEdits(const char* data,
+                 const size_t length,
+                 const std::string& theme,
+                 std::vector<RewriteSpan>& spans) const;
+
+private:
+  // member functions
+  bool findValue(const char* line,
+                 const size_t lineLength,
+                 size_t& valueStart,
+                 size_t& valueEnd) const;
+
+  // member variables
+  std::string m_name;
+  std::vector<std::string> m_fileSuffixes;
+  std::string m_key;
+  char m_separator;
+  std::string m_componentSeparators;
+  std::string m_section;
+};
+
+bool checkThemeName(const std::string& theme);
+const std::vector<const ThemeRewriter*>& themeRewriters();
+const ThemeRewriter* findThemeRewriter(const std::string& path);
+
+#endif // THEMEREWRITERS_HPP
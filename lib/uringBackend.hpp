@@ -0,0 +1,82 @@
+/*
+  File:
+   uringBackend.hpp
+
+  Description:
+   An io_uring backend for applying a theme to many small files. Applying a
+   theme costs an open, fstat, read, write, fsync, close and rename per file,
+   so with thousands of saved files the switch is bound by syscall count. The
+   IoUring class is a minimal wrapper over the raw io_uring syscalls and
+   applyThemeToFilesUring() queues each file's operations as linked
+   submissions on direct descriptors, each filesystem on its own ring with as
+   many files in flight as its concurrency window allows.
+*/
+#ifndef URINGBACKEND_HPP
+#define URINGBACKEND_HPP
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+// submission queue entries, the completion queue is twice as large
+const unsigned _URINGENTRIES = 1024;
+
+// direct descriptor slots, one per file in flight
+const unsigned _URINGFILESLOTS = 256;
+
+// files larger than this are left to applyThemeToFile()
+const unsigned _URINGREADSIZE = 16 * 1024;
+
+class IoUring {
+public:
+  // constructors
+  IoUring();
+  ~IoUring();
+
+  // member functions
+  io_uring_sqe* getSqe();
+  bool popCqe(uint64_t& userData,
+              int& res);
+  bool setup(const unsigned entries,
+             const unsigned numFileSlots);
+  bool submitAndWait(const unsigned numCompletions);
+
+  // getters
+  unsigned getNumFileSlots() const;
+  unsigned getNumSqes() const;
+  unsigned getNumSubmits() const;
+
+private:
+  // member variables
+  int m_fd;
+  void* m_sqRing;
+  size_t m_sqRingSize;
+  void* m_cqRing;
+  size_t m_cqRingSize;
+  io_uring_sqe* m_sqes;
+  size_t m_sqesSize;
+  unsigned* m_sqTail;
+  unsigned* m_sqArray;
+  unsigned m_sqMask;
+  unsigned m_numSqes;
+  unsigned* m_cqHead;
+  unsigned* m_cqTail;
+  unsigned m_cqMask;
+  io_uring_cqe* m_cqes;
+  unsigned m_sqPending;
+  unsigned m_numFileSlots;
+  unsigned m_numSubmits;
+};
+
+bool applyThemeToFilesUring(const std::vector<std::string>& paths,
+                            const std::vector<dev_t>& devices,
+                            const std::string& theme,
+                            std::vector<int>& results,
+                            std::vector<size_t>& fallbackFiles,
+                            std::ofstream& log);
+
+#endif // URINGBACKEND_HPP
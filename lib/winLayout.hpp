@@ -0,0 +1,167 @@
+/*
+  File:
+   winLayout.hpp
+
+  Description:
+   The layout of the main windows and their buttons as a compile time table.
+   Each widget places its lines and its columns with a LayoutSpan measured
+   from an anchor, the screen or a widget earlier in the table, so
+   solveLayout() finds every rectangle in one pass over the table and a
+   resize costs a table walk instead of a chain of hand written geometry.
+   A widget is shown only if its anchors are shown and it fits its minimum
+   size inside the screen.
+*/
+#ifndef WINLAYOUT_HPP
+#define WINLAYOUT_HPP
+#include <string_view>
+#include "_cursesWinConsts.hpp"
+#include "_winStringConsts.hpp"
+
+// where a span starts
+enum LayoutPositions {
+  _ANCHORSTART,         // offset from the start of the anchor
+  _ANCHOREND,           // offset from one past the end of the anchor
+  _SCREENEND            // size plus offset before the end of the screen
+};
+
+// how long a span is
+enum LayoutSizes {
+  _FIXEDSIZE,           // size
+  _HALFSIZE,            // half of the screen left after the start, less size
+  _FILLSIZE             // the screen left after the start, less size
+};
+
+// the placement of a widget along the lines or the columns of the screen
+struct LayoutSpan {
+  int anchor;           // a _WINS value, _MAINWIN for the screen
+  int position;         // a LayoutPositions value
+  int offset;
+  int sizeRule;         // a LayoutSizes value
+  int size;
+  int minSize;          // the widget is hidden if the span is shorter
+  int maxSize;          // the span is cut to this length, 0 if unlimited
+};
+
+struct WidgetLayout {
+  int id;               // a _WINS value
+  int dependency;       // a _WINS value that must be shown too, or -1
+  LayoutSpan lines;
+  LayoutSpan cols;
+  std::string_view name;
+  std::string_view label;
+};
+
+// a solved widget
+struct LayoutRect {
+  int startY;
+  int startX;
+  int numLines;
+  int numCols;
+  bool isVisible;
+};
+
+// the columns of a row of two help buttons
+constexpr int _HWLEFTCOL = 4;
+constexpr int _HWRIGHTCOL = _HWLEFTCOL + _HWBUTTONCOLS + 2;
+
+// the widgets in the order they are solved; a widget's anchors come first
+constexpr WidgetLayout _WINLAYOUT[] = {
+  { _PROMPTWIN, -1,
+    { _MAINWIN, _ANCHORSTART, _PROMPTWINSTARTY, _FIXEDSIZE, _PROMPTWINMAXLINES, 1, 0 },
+    { _MAINWIN, _ANCHORSTART, _PROMPTWINSTARTX, _FILLSIZE, _PROMPTWINSTARTX, 1, 0 },
+    "_PROMPTWIN", "" },
+  { _SAVEDFILESWIN, -1,
+    { _MAINWIN, _ANCHORSTART, _SAVEDFILESWINSTARTY, _HALFSIZE, 1,
+      _SAVEDFILESWINMINLINES + 2, 0 },
+    { _MAINWIN, _ANCHORSTART, _SAVEDFILESWINSTARTX, _FILLSIZE,
+      _HELPWINMINCOLS + _HELPWINCOLOFFSET + _SFWINMAXCOLOFFSET, _SAVEDFILESWINMINCOLS + 1, 0 },
+    "_SAVEDFILESWIN", "" },
+  { _LARROWSAVEDFILESWIN, -1,
+    { _SAVEDFILESWIN, _ANCHORSTART, 2, _FIXEDSIZE, 1, 1, 0 },
+    { _SAVEDFILESWIN, _ANCHORSTART, (int)sfTitle.length() + 8, _FIXEDSIZE,
+      (int)leftArrow.length(), 1, 0 },
+    sfLeftArrow, leftArrow },
+  { _RARROWSAVEDFILESWIN, -1,
+    { _SAVEDFILESWIN, _ANCHORSTART, 2, _FIXEDSIZE, 1, 1, 0 },
+    { _LARROWSAVEDFILESWIN, _ANCHOREND, 1, _FIXEDSIZE, (int)rightArrow.length(), 1, 0 },
+    sfRightArrow, rightArrow },
+  { _SAVEDTHEMESWIN, -1,
+    { _SAVEDFILESWIN, _ANCHOREND, 1, _FILLSIZE, _HELPWINLINEOFFSET,
+      _SAVEDTHEMESWINMINLINES, 0 },
+    { _MAINWIN, _ANCHORSTART, _SAVEDTHEMESWINSTARTX, _FILLSIZE,
+      _HELPWINMINCOLS + _HELPWINCOLOFFSET + _STWINMAXCOLOFFSET, _SAVEDTHEMESWINMINCOLS + 1, 0 },
+    "_SAVEDTHEMESWIN", "" },
+  { _LARROWSAVEDTHEMESWIN, -1,
+    { _SAVEDTHEMESWIN, _ANCHORSTART, 2, _FIXEDSIZE, 1, 1, 0 },
+    { _SAVEDTHEMESWIN, _ANCHORSTART, (int)stTitle.length() + 8, _FIXEDSIZE,
+      (int)leftArrow.length(), 1, 0 },
+    stLeftArrow, leftArrow },
+  { _RARROWSAVEDTHEMESWIN, -1,
+    { _SAVEDTHEMESWIN, _ANCHORSTART, 2, _FIXEDSIZE, 1, 1, 0 },
+    { _LARROWSAVEDTHEMESWIN, _ANCHOREND, 1, _FIXEDSIZE, (int)rightArrow.length(), 1, 0 },
+    stRightArrow, rightArrow },
+  { _HELPWIN, _SAVEDTHEMESWIN,
+    { _MAINWIN, _ANCHORSTART, _HELPWINSTARTY, _FILLSIZE, _HELPWINLINEOFFSET,
+      _HELPWINMINLINES + 1, 0 },
+    { _MAINWIN, _SCREENEND, _HELPWINCOLOFFSET, _FIXEDSIZE, _HELPWINMINCOLS, 1, 0 },
+    "_HELPWIN", "" },
+  { _HWSFADDFILE, -1,
+    { _HELPWIN, _ANCHORSTART, 4, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWLEFTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFAddFile, _hwSFAddFile },
+  { _HWSFEDITFILEPATH, -1,
+    { _HELPWIN, _ANCHORSTART, 6, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWLEFTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFEditFilePath, _hwSFEditFilePath },
+  { _HWSFVIEWFILEPATH, -1,
+    { _HELPWIN, _ANCHORSTART, 8, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWLEFTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFViewFilePath, _hwSFViewFilePath },
+  { _HWSFREMOVEFILE, -1,
+    { _HELPWIN, _ANCHORSTART, 10, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWLEFTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFRemoveFile, _hwSFRemoveFile },
+  { _HWSFADDTHEME, -1,
+    { _HELPWIN, _ANCHORSTART, 4, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWRIGHTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFAddTheme, _hwSFAddTheme },
+  { _HWSFEDITTHEME, -1,
+    { _HELPWIN, _ANCHORSTART, 6, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWRIGHTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFEditTheme, _hwSFEditTheme },
+  { _HWSFREMOVETHEME, -1,
+    { _HELPWIN, _ANCHORSTART, 8, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWRIGHTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSFRemoveTheme, _hwSFRemoveTheme },
+  { _HWSTADDTHEME, -1,
+    { _SAVEDTHEMESWIN, _ANCHORSTART, 4, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWLEFTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSTAddTheme, _hwSTAddTheme },
+  { _HWSTEDITTHEME, -1,
+    { _SAVEDTHEMESWIN, _ANCHORSTART, 6, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWLEFTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSTEditTheme, _hwSTEditTheme },
+  { _HWSTREMOVETHEME, -1,
+    { _SAVEDTHEMESWIN, _ANCHORSTART, 4, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWRIGHTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSTRemoveTheme, _hwSTRemoveTheme },
+  { _HWSTVIEWTHEME, -1,
+    { _SAVEDTHEMESWIN, _ANCHORSTART, 6, _FIXEDSIZE, _HWBUTTONLINES, 1, 0 },
+    { _HELPWIN, _ANCHORSTART, _HWRIGHTCOL, _FIXEDSIZE, _HWBUTTONCOLS, 1, 0 },
+    _hwSTViewTheme, _hwSTViewTheme },
+  { _PREVIEWWIN, -1,
+    { _HWSTEDITTHEME, _ANCHORSTART, _PREVIEWWINLINEOFFSET, _FILLSIZE,
+      _HELPWINLINEOFFSET + 1, _PREVIEWWINMINLINES, 0 },
+    { _HELPWIN, _ANCHORSTART, _PREVIEWWINCOLOFFSET, _FIXEDSIZE,
+      _HELPWINMINCOLS - _PREVIEWWINCOLOFFSET * 2, 1, 0 },
+    "_PREVIEWWIN", "" }
+};
+
+constexpr int _NUMWIDGETS = sizeof(_WINLAYOUT) / sizeof(_WINLAYOUT[0]);
+
+std::string_view findWidgetLabel(const int id);
+void solveLayout(const int maxLines,
+                 const int maxCols,
+                 LayoutRect* rects);
+
+#endif // WINLAYOUT_HPP
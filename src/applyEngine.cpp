@@ -0,0 +1,751 @@
+/*
+  File:
+   applyEngine.cpp
+
+  Description:
+   The implementation of the applyEngine.hpp functions.
+*/
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/random.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include "applyEngine.hpp"
+#include "deviceScheduler.hpp"
+#include "uringBackend.hpp"
+
+// unchanged regions at least this large are copied inside the kernel with
+// copy_file_range() instead of being gathered into a writev()
+const size_t _COPYRANGEMIN = 64 * 1024;
+
+// most files applied at once across all filesystems
+const size_t _APPLYMAXTHREADS = 16;
+
+// names tried for a temporary file before giving up
+const int _APPLYTEMPTRIES = 16;
+
+// state shared by the workers of one applyThemeToFilesThreaded() call
+struct ApplyShared {
+  const std::vector<std::string>* paths;
+  const std::string* theme;
+  std::vector<int>* results;
+  std::vector<std::string> messages;
+  DeviceScheduler scheduler;
+  std::vector<std::vector<size_t>> deviceFiles;
+  std::vector<size_t> nextFiles;
+  size_t numUnstarted;
+  int nextDevice;
+  std::mutex mutex;
+  std::condition_variable released;
+};
+
+
+
+/*
+  Function:
+   writeIovecs
+
+  Description:
+   Writes every gathered region with as few writev() calls as possible,
+   handling partial writes, then clears the gathered regions.
+
+  Input/Output:
+   iovs                 - a reference to the vector of gathered regions.
+
+  Input:
+   fd                   - the descriptor to write to.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if every byte was written.
+*/
+static bool writeIovecs(std::vector<struct iovec>& iovs,
+                        const int fd)
+{
+  size_t first = 0;
+
+  while(first < iovs.size())
+    {
+      const int count = std::min(iovs.size() - first, (size_t)IOV_MAX);
+      ssize_t written = writev(fd, &iovs.at(first), count);
+
+      if(written < 0)
+        {
+          if(errno == EINTR)
+            {
+              continue;
+            }
+
+          iovs.clear();
+          return false;
+        }
+
+      // skip fully written regions and trim a partially written one
+      while(first < iovs.size() && (size_t)written >= iovs.at(first).iov_len)
+        {
+          written -= iovs.at(first).iov_len;
+          first++;
+        }
+
+      if(written > 0)
+        {
+          iovs.at(first).iov_base = (char*)iovs.at(first).iov_base + written;
+          iovs.at(first).iov_len -= written;
+        }
+    }
+
+  iovs.clear();
+  return true;
+} // end of "writeIovecs"
+
+
+
+/*
+  Function:
+   openApplyTempFile
+
+  Description:
+   Creates a new temporary file beside the incoming file, in the directory
+   open on dirFd. The file is created with O_EXCL and O_NOFOLLOW under a
+   random name (see makeApplyTempName()), so it is never a file or link that
+   was already there, whoever else can write to the directory.
+
+  Input:
+   dirFd                - the descriptor of the file's directory.
+
+   name                 - a reference to a constant string containing the
+                          file's name in the directory.
+
+  Output:
+   tempName             - a reference to a string that receives the name of
+                          the temporary file in the directory.
+
+  Returns:
+   int                  - the descriptor of the temporary file, opened for
+                          writing, or -1.
+*/
+int openApplyTempFile(const int dirFd,
+                      const std::string& name,
+                      std::string& tempName)
+{
+  for(int i = 0; i < _APPLYTEMPTRIES; i++)
+    {
+      if(makeApplyTempName(name, tempName) == false)
+        {
+          return -1;
+        }
+
+      const int fd = openat(dirFd, tempName.c_str(),
+                            O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+
+      if(fd != -1 || errno != EEXIST)
+        {
+          return fd;
+        }
+    }
+
+  return -1;
+} // end of "openApplyTempFile"
+
+
+
+/*
+  Function:
+   applyWorker
+
+  Description:
+   Applies files until none are left to start. Filesystems are visited round
+   robin and a file is only started when its filesystem's window has room, so
+   a worker passes over a congested mount to files on the others. What each
+   file logs is kept in shared.messages for the caller to write out.
+
+  Input/Output:
+   shared               - a reference to the state shared by the workers.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void applyWorker(ApplyShared& shared)
+{
+  const int numDevices = shared.deviceFiles.size();
+  std::unique_lock<std::mutex> lock(shared.mutex);
+
+  while(shared.numUnstarted > 0)
+    {
+      int device = -1;
+
+      for(int i = 0; i < numDevices && device == -1; i++)
+        {
+          const int candidate = (shared.nextDevice + i) % numDevices;
+
+          if(shared.nextFiles.at(candidate) < shared.deviceFiles.at(candidate).size() &&
+             shared.scheduler.tryAcquire(candidate) == true)
+            {
+              device = candidate;
+            }
+        }
+
+      if(device == -1)
+        {
+          shared.released.wait(lock);
+          continue;
+        }
+
+      const size_t fileIndex = shared.deviceFiles.at(device).at(shared.nextFiles.at(device)++);
+
+      shared.numUnstarted--;
+      shared.nextDevice = (device + 1) % numDevices;
+      lock.unlock();
+
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      // the log stream isn't thread safe, each file logs to its own message
+      std::ostringstream fileLog;
+
+      shared.results->at(fileIndex) = applyThemeToFile(shared.paths->at(fileIndex),
+                                                       *shared.theme,
+                                                       fileLog);
+      shared.messages.at(fileIndex) = fileLog.str();
+      shared.scheduler.release(device, std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count());
+
+      lock.lock();
+      shared.released.notify_all();
+    }
+} // end of "applyWorker"
+
+
+
+/*
+  Function:
+   makeApplyTempName
+
+  Description:
+   Names a temporary file for rewriting the incoming file: the file's name
+   with ".themeswitcher-" and 16 random hex digits, so another writer of the
+   directory can't guess it in advance and two appliers never share one.
+
+  Input:
+   name                 - a reference to a constant string containing the
+                          name of the file being rewritten.
+
+  Output:
+   tempName             - a reference to a string that receives the name.
+
+  Returns:
+   bool                 - false if no random bytes could be read.
+*/
+bool makeApplyTempName(const std::string& name,
+                       std::string& tempName)
+{
+  unsigned long long suffix = 0;
+  char hex[17];
+
+  if(getrandom(&suffix, sizeof(suffix), 0) != (ssize_t)sizeof(suffix))
+    {
+      return false;
+    }
+
+  snprintf(hex, sizeof(hex), "%016llx", suffix);
+  tempName = name + ".themeswitcher-" + hex;
+
+  return true;
+} // end of "makeApplyTempName"
+
+
+
+/*
+  Function:
+   writeRewrittenFile
+
+  Description:
+   Writes the original file with the incoming spans applied to dstFd. Only the
+   replacement strings are built in memory. Large unchanged regions are copied
+   by the kernel (shared outright on filesystems that support reflinks) and
+   small ones are gathered from the mapping into a single writev(), so the
+   original contents are never copied into a new string.
+
+  Input:
+   srcFd                - the descriptor of the original file.
+
+   data                 - a pointer to the mapped original file contents.
+
+   length               - the number of bytes in data.
+
+   spans                - a reference to a constant vector of non-overlapping
+                          edits sorted by offset.
+
+   dstFd                - the descriptor of the file to write, positioned at
+                          its start.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - 0 on success, -1 if a write failed or the original
+                          file is shorter than length.
+*/
+int writeRewrittenFile(const int srcFd,
+                       const char* data,
+                       const size_t length,
+                       const std::vector<RewriteSpan>& spans,
+                       const int dstFd)
+{
+  std::vector<struct iovec> iovs;
+  bool useCopyRange = true;
+  size_t pos = 0;
+
+  for(size_t i = 0; i <= spans.size(); i++)
+    {
+      const size_t regionEnd = i < spans.size() ? spans.at(i).offset : length;
+
+      // the unchanged region before the next span
+      if(regionEnd - pos >= _COPYRANGEMIN && useCopyRange == true)
+        {
+          if(writeIovecs(iovs, dstFd) == false)
+            {
+              return -1;
+            }
+
+          loff_t offset = pos;
+
+          while(offset < (loff_t)regionEnd)
+            {
+              ssize_t copied = copy_file_range(srcFd, &offset, dstFd, nullptr,
+                                               regionEnd - offset, 0);
+
+              // the file ended early, it shrank since it was mapped and the
+              // mapping past its new end can't be read either
+              if(copied == 0)
+                {
+                  return -1;
+                }
+
+              if(copied < 0)
+                {
+                  if(errno == EINTR)
+                    {
+                      continue;
+                    }
+
+                  // unsupported here, gather the rest of the file instead
+                  useCopyRange = false;
+                  break;
+                }
+            }
+
+          pos = offset;
+        }
+
+      if(regionEnd > pos)
+        {
+          struct iovec iov;
+          iov.iov_base = (void*)(data + pos);
+          iov.iov_len = regionEnd - pos;
+          iovs.push_back(iov);
+        }
+
+      if(i < spans.size())
+        {
+          if(!spans.at(i).replacement.empty())
+            {
+              struct iovec iov;
+              iov.iov_base = (void*)spans.at(i).replacement.data();
+              iov.iov_len = spans.at(i).replacement.length();
+              iovs.push_back(iov);
+            }
+
+          pos = spans.at(i).offset + spans.at(i).length;
+        }
+    }
+
+  return writeIovecs(iovs, dstFd) == true ? 0 : -1;
+} // end of "writeRewrittenFile"
+
+
+
+/*
+  Function:
+   applyThemeToFile
+
+  Description:
+   Applies the incoming theme to a single saved file. The file's rewriter finds
+   the edits over a read only mapping of the file, and when there is something
+   to change the result is written to a new temporary file beside the
+   original, given the original's owner and mode, synced, and renamed over it
+   so the file is never left half written. Linked dotfiles are rewritten where
+   they actually live. Once resolved, the file, the temporary file and the
+   rename are all reached through a descriptor of the file's directory and no
+   further links are followed, so a link planted beside the file can't
+   redirect the write.
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the file to rewrite.
+
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+   log                  - a reference to the output stream the result is
+                          logged to.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - an ApplyResults value.
+*/
+int applyThemeToFile(const std::string& path,
+                     const std::string& theme,
+                     std::ostream& log)
+{
+  const ThemeRewriter* rewriter = findThemeRewriter(path);
+  char resolved[PATH_MAX];
+  struct stat fileStat;
+  std::vector<RewriteSpan> spans;
+
+  if(checkThemeName(theme) == false)
+    {
+      log << "Apply: invalid theme name for " << path << std::endl;
+      return _APPLYFAILED;
+    }
+
+  if(rewriter == nullptr)
+    {
+      log << "Apply: no rewriter for " << path << std::endl;
+      return _APPLYUNSUPPORTED;
+    }
+
+  if(realpath(path.c_str(), resolved) == nullptr)
+    {
+      log << "Apply: can't resolve " << path << std::endl;
+      return _APPLYFAILED;
+    }
+
+  const std::string realPath = resolved;
+  const size_t nameStart = realPath.rfind('/') + 1;
+  const std::string dirPath = nameStart == 1 ? "/" : realPath.substr(0, nameStart - 1);
+  const std::string name = realPath.substr(nameStart);
+  const int dirFd = open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+
+  if(dirFd == -1)
+    {
+      log << "Apply: can't open " << dirPath << std::endl;
+      return _APPLYFAILED;
+    }
+
+  const int srcFd = openat(dirFd, name.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+
+  if(srcFd == -1)
+    {
+      close(dirFd);
+      log << "Apply: can't open " << realPath << std::endl;
+      return _APPLYFAILED;
+    }
+
+  if(fstat(srcFd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode) ||
+     fileStat.st_size == 0)
+    {
+      close(srcFd);
+      close(dirFd);
+      return _APPLYUNSUPPORTED;
+    }
+
+  const size_t length = fileStat.st_size;
+  void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, srcFd, 0);
+
+  if(mapped == MAP_FAILED)
+    {
+      close(srcFd);
+      close(dirFd);
+      log << "Apply: can't map " << realPath << std::endl;
+      return _APPLYFAILED;
+    }
+
+  const char* data = (const char*)mapped;
+  int result = _APPLYUNCHANGED;
+
+  if(rewriter->findEdits(data, length, theme, spans) == false)
+    {
+      result = _APPLYUNSUPPORTED;
+    }
+  else if(!spans.empty())
+    {
+      std::string tempName;
+      int dstFd = openApplyTempFile(dirFd, name, tempName);
+
+      result = _APPLYFAILED;
+
+      if(dstFd != -1)
+        {
+          if(fchown(dstFd, fileStat.st_uid, fileStat.st_gid) == -1)
+            {
+              // keep the new owner when not allowed to change it
+            }
+
+          // after the fchown(), which clears the set-user-ID bits, and free of
+          // the umask the file was created under
+          bool isWritten = fchmod(dstFd, fileStat.st_mode & 07777) == 0 &&
+            writeRewrittenFile(srcFd, data, length, spans, dstFd) == 0 &&
+            fsync(dstFd) == 0;
+
+          if(close(dstFd) == -1)
+            {
+              isWritten = false;
+            }
+
+          if(isWritten == true &&
+             renameat(dirFd, tempName.c_str(), dirFd, name.c_str()) == 0)
+            {
+              result = _APPLYWRITTEN;
+            }
+          else
+            {
+              unlinkat(dirFd, tempName.c_str(), 0);
+            }
+        }
+    }
+
+  munmap(mapped, length);
+  close(srcFd);
+  close(dirFd);
+
+  log << "Apply: " << rewriter->getName() << " " << realPath << " -> " << theme
+      << " (" << result << ")" << std::endl;
+
+  return result;
+} // end of "applyThemeToFile"
+
+
+
+/*
+  Function:
+   applyThemeToFilesThreaded
+
+  Description:
+   Applies the incoming theme to every incoming file with a pool of threads.
+   Files are grouped by the filesystem they live on and each group runs with
+   its own adaptive concurrency window (see DeviceScheduler), so a slow NFS or
+   FUSE mount never holds up files on local disks and the whole switch takes
+   about as long as the slowest filesystem's own share of the work.
+
+  Input:
+   paths                - a reference to a constant vector of the paths of the
+                          files to rewrite.
+
+   devices              - a reference to a constant vector sized to paths of
+                          the filesystem (st_dev) each file lives on.
+
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   results              - a reference to a vector sized to paths that
+                          receives the ApplyResults value of each file.
+
+  Returns:
+   NONE
+*/
+static void applyThemeToFilesThreaded(const std::vector<std::string>& paths,
+                                      const std::vector<dev_t>& devices,
+                                      const std::string& theme,
+                                      std::vector<int>& results,
+                                      std::ofstream& log)
+{
+  ApplyShared shared;
+
+  shared.paths = &paths;
+  shared.theme = &theme;
+  shared.results = &results;
+  shared.messages.resize(paths.size());
+  shared.numUnstarted = paths.size();
+  shared.nextDevice = 0;
+
+  for(size_t i = 0; i < paths.size(); i++)
+    {
+      const size_t deviceIndex = shared.scheduler.addDevice(devices.at(i));
+
+      if(deviceIndex == shared.deviceFiles.size())
+        {
+          shared.deviceFiles.push_back(std::vector<size_t>());
+          shared.nextFiles.push_back(0);
+        }
+
+      shared.deviceFiles.at(deviceIndex).push_back(i);
+    }
+
+  const size_t numThreads = std::min(paths.size(), _APPLYMAXTHREADS);
+  std::vector<std::thread> threads;
+
+  for(size_t i = 1; i < numThreads; i++)
+    {
+      threads.push_back(std::thread(applyWorker, std::ref(shared)));
+    }
+
+  applyWorker(shared);
+
+  for(size_t i = 0; i < threads.size(); i++)
+    {
+      threads.at(i).join();
+    }
+
+  for(size_t i = 0; i < shared.messages.size(); i++)
+    {
+      log << shared.messages.at(i);
+    }
+
+  for(int i = 0; i < shared.scheduler.getNumDevices(); i++)
+    {
+      log << "Apply: device " << shared.scheduler.getDevice(i) << " "
+          << shared.deviceFiles.at(i).size() << " files, final window "
+          << shared.scheduler.getWindow(i) << std::endl;
+    }
+} // end of "applyThemeToFilesThreaded"
+
+
+
+/*
+  Function:
+   applyThemeToFiles
+
+  Description:
+   Applies the incoming theme to every incoming file. Where the kernel has
+   io_uring the files are read and replaced with batched submissions (see
+   applyThemeToFilesUring()), and the files it leaves behind, or all of them
+   without io_uring, are spread over a thread pool. Either way each
+   filesystem stays within its own concurrency window. Paths that
+   resolve to the same file (links, repeated entries) are applied once and
+   share that result, so two writers never race to replace one file.
+
+  Input:
+   paths                - a reference to a constant vector of the paths of the
+                          files to rewrite.
+
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   results              - a reference to a vector that receives the
+                          ApplyResults value of each file.
+
+  Returns:
+   NONE
+*/
+void applyThemeToFiles(const std::vector<std::string>& paths,
+                       const std::string& theme,
+                       std::vector<int>& results,
+                       std::ofstream& log)
+{
+  std::map<std::pair<dev_t, ino_t>, size_t> seenFiles;
+  std::vector<std::string> uniquePaths;
+  std::vector<dev_t> uniqueDevices;
+  std::vector<int> uniqueResults;
+  std::vector<size_t> owners(paths.size());
+
+  // one entry per underlying file, unreadable paths stay apart and fail alone
+  for(size_t i = 0; i < paths.size(); i++)
+    {
+      struct stat fileStat;
+      dev_t device = 0;
+
+      if(stat(paths.at(i).c_str(), &fileStat) == 0)
+        {
+          const std::pair<dev_t, ino_t> key(fileStat.st_dev, fileStat.st_ino);
+          const auto seen = seenFiles.find(key);
+
+          if(seen != seenFiles.end())
+            {
+              owners.at(i) = seen->second;
+              continue;
+            }
+
+          seenFiles[key] = uniquePaths.size();
+          device = fileStat.st_dev;
+        }
+
+      owners.at(i) = uniquePaths.size();
+      uniquePaths.push_back(paths.at(i));
+      uniqueDevices.push_back(device);
+    }
+
+  uniqueResults.assign(uniquePaths.size(), _APPLYFAILED);
+
+  // nothing to overlap
+  if(uniquePaths.size() <= 1)
+    {
+      for(size_t i = 0; i < uniquePaths.size(); i++)
+        {
+          uniqueResults.at(i) = applyThemeToFile(uniquePaths.at(i), theme, log);
+        }
+    }
+  else
+    {
+      std::vector<size_t> fallbackFiles;
+
+      if(applyThemeToFilesUring(uniquePaths, uniqueDevices, theme, uniqueResults,
+                                fallbackFiles, log) == false)
+        {
+          for(size_t i = 0; i < uniquePaths.size(); i++)
+            {
+              fallbackFiles.push_back(i);
+            }
+        }
+
+      std::vector<std::string> fallbackPaths;
+      std::vector<dev_t> fallbackDevices;
+      std::vector<int> fallbackResults(fallbackFiles.size(), _APPLYFAILED);
+
+      for(size_t i = 0; i < fallbackFiles.size(); i++)
+        {
+          fallbackPaths.push_back(uniquePaths.at(fallbackFiles.at(i)));
+          fallbackDevices.push_back(uniqueDevices.at(fallbackFiles.at(i)));
+        }
+
+      if(fallbackFiles.empty() == false)
+        {
+          applyThemeToFilesThreaded(fallbackPaths, fallbackDevices, theme, fallbackResults, log);
+        }
+
+      for(size_t i = 0; i < fallbackFiles.size(); i++)
+        {
+          uniqueResults.at(fallbackFiles.at(i)) = fallbackResults.at(i);
+        }
+    }
+
+  results.assign(paths.size(), _APPLYFAILED);
+
+  for(size_t i = 0; i < paths.size(); i++)
+    {
+      results.at(i) = uniqueResults.at(owners.at(i));
+    }
+
+  for(size_t i = 0; i < paths.size(); i++)
+    {
+      log << "Apply: " << paths.at(i) << " -> " << theme << " (" << results.at(i) << ")"
+          << std::endl;
+    }
+} // end of "applyThemeToFiles"
@@ -0,0 +1,578 @@
+/*
+  File:
+   batchApply.cpp
+
+  Description:
+   The implementation of the batchApply.hpp functions.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <sys/fsuid.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <thread>
+#include <unistd.h>
+#include "batchApply.hpp"
+#include "deviceScheduler.hpp"
+#include "fileOperations.hpp"
+
+// a manifest entry waiting in a worker's queue
+struct BatchTask {
+  size_t entryIndex;
+  int deviceIndex;
+};
+
+// a worker's queue. the owner takes tasks from the back, thieves from the
+// front, so an owner keeps working through the homes it was dealt while
+// thieves take the ones it would reach last.
+struct BatchQueue {
+  std::mutex mutex;
+  std::deque<BatchTask> tasks;
+};
+
+// state shared by the workers of one runBatchApply() call
+struct BatchShared {
+  const std::vector<BatchEntry>* entries;
+  std::vector<std::unique_ptr<BatchQueue>> queues;
+  std::unique_ptr<DeviceScheduler> scheduler;
+  std::atomic<size_t> numRemaining;
+};
+
+
+
+/*
+  Function:
+   takeTask
+
+  Description:
+   Removes a task whose filesystem's window has room from the incoming queue,
+   taking a slot in it. Tasks on busy filesystems are skipped, not waited for.
+
+  Input/Output:
+   queue                - a reference to the queue to search.
+
+   shared               - a reference to the state shared by the workers.
+
+  Input:
+   fromBack             - true to search from the back (the owner), false
+                          to search from the front (a thief).
+
+  Output:
+   task                 - the task taken.
+
+  Returns:
+   bool                 - true if a task was taken.
+*/
+static bool takeTask(BatchQueue& queue,
+                     BatchShared& shared,
+                     const bool fromBack,
+                     BatchTask& task)
+{
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  const size_t numTasks = queue.tasks.size();
+
+  for(size_t i = 0; i < numTasks; i++)
+    {
+      const size_t index = fromBack ? numTasks - 1 - i : i;
+      const BatchTask& candidate = queue.tasks.at(index);
+
+      if(shared.scheduler->tryAcquire(candidate.deviceIndex) == true)
+        {
+          task = candidate;
+          queue.tasks.erase(queue.tasks.begin() + index);
+          return true;
+        }
+    }
+
+  return false;
+} // end of "takeTask"
+
+
+
+/*
+  Function:
+   setFileCredentials
+
+  Description:
+   Sets the user and group the calling thread's file accesses are checked
+   against. Unlike setuid(), setfsuid() changes only the calling thread, so
+   each worker can act as the owner of the home it is updating while the
+   others act as theirs.
+
+  Input:
+   uid                  - the user to act as.
+
+   gid                  - the group to act as.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the thread now acts as uid and gid.
+*/
+static bool setFileCredentials(const uid_t uid,
+                               const gid_t gid)
+{
+  setfsgid(gid);
+  setfsuid(uid);
+
+  // an invalid id changes nothing and returns the current one
+  return (uid_t)setfsuid(-1) == uid && (gid_t)setfsgid(-1) == gid;
+} // end of "setFileCredentials"
+
+
+
+/*
+  Function:
+   applyBatchEntry
+
+  Description:
+   Applies an entry's theme to each of its files. The batch usually runs as
+   root, so when it does the files are resolved, read and replaced with the
+   file permissions of the user who owns the home, and a link or file the
+   user planted can only lead to what that user could write anyway. A file
+   that resolves outside its user root (through a symbolic link in the home,
+   for example) is refused as well.
+
+  Input:
+   entry                - a reference to the constant entry to apply.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   numResults           - counts of each ApplyResults value, added to.
+
+   failures             - a reference to a vector the failed paths are
+                          appended to, with the reason.
+
+  Returns:
+   NONE
+*/
+static void applyBatchEntry(const BatchEntry& entry,
+                            int* numResults,
+                            std::vector<std::string>& failures,
+                            std::ofstream& log)
+{
+  char resolved[PATH_MAX];
+  struct stat rootStat;
+
+  if(realpath(entry.root.c_str(), resolved) == nullptr ||
+     stat(resolved, &rootStat) == -1)
+    {
+      numResults[_APPLYFAILED] += entry.files.size();
+      failures.push_back(entry.root + ": user root not found");
+      return;
+    }
+
+  const bool isPrivileged = geteuid() == 0;
+
+  if(isPrivileged == true &&
+     setFileCredentials(rootStat.st_uid, rootStat.st_gid) == false)
+    {
+      setFileCredentials(geteuid(), getegid());
+      numResults[_APPLYFAILED] += entry.files.size();
+      failures.push_back(entry.root + ": can't act as the owner of the user root");
+      return;
+    }
+
+  std::string rootPrefix = resolved;
+
+  if(rootPrefix != "/")
+    {
+      rootPrefix.push_back('/');
+    }
+
+  for(size_t i = 0; i < entry.files.size(); i++)
+    {
+      const std::string path = entry.root + "/" + entry.files.at(i);
+
+      if(realpath(path.c_str(), resolved) == nullptr)
+        {
+          numResults[_APPLYFAILED]++;
+          failures.push_back(path + ": not found");
+          continue;
+        }
+
+      if(std::string(resolved).compare(0, rootPrefix.length(), rootPrefix) != 0)
+        {
+          numResults[_APPLYFAILED]++;
+          failures.push_back(path + ": resolves outside the user root");
+          continue;
+        }
+
+      const int result = applyThemeToFile(resolved, entry.theme, log);
+
+      numResults[result]++;
+
+      if(result == _APPLYFAILED)
+        {
+          failures.push_back(path + ": write failed");
+        }
+    }
+
+  if(isPrivileged == true)
+    {
+      setFileCredentials(geteuid(), getegid());
+    }
+} // end of "applyBatchEntry"
+
+
+
+/*
+  Function:
+   batchWorker
+
+  Description:
+   Runs tasks until every task is done: first from its own queue, then stolen
+   from the others. When every remaining task is on a filesystem already at
+   its window the worker sleeps briefly and tries again.
+
+  Input/Output:
+   shared               - a reference to the state shared by the workers.
+
+  Input:
+   workerIndex          - the index of the worker's own queue.
+
+  Output:
+   report               - the worker's own report, merged by the caller.
+
+  Returns:
+   NONE
+*/
+static void batchWorker(BatchShared& shared,
+                        const size_t workerIndex,
+                        BatchReport& report)
+{
+  const size_t numQueues = shared.queues.size();
+
+  // the log stream isn't thread safe, so per file results are not logged
+  std::ofstream workerLog;
+
+  while(shared.numRemaining.load() > 0)
+    {
+      BatchTask task;
+      bool hasTask = takeTask(*shared.queues.at(workerIndex), shared, true, task);
+
+      for(size_t i = 1; i < numQueues && hasTask == false; i++)
+        {
+          hasTask = takeTask(*shared.queues.at((workerIndex + i) % numQueues),
+                             shared, false, task);
+        }
+
+      if(hasTask == false)
+        {
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+          continue;
+        }
+
+      const BatchEntry& entry = shared.entries->at(task.entryIndex);
+      BatchDeviceReport& device = report.devices.at(task.deviceIndex);
+
+      int numResults[_APPLYFAILED + 1] = { 0 };
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      applyBatchEntry(entry, numResults, report.failures, workerLog);
+
+      // the latency of a home is the time per file, so homes with many files
+      // don't look like congestion
+      const double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+      shared.scheduler->release(task.deviceIndex,
+                                elapsedMs / std::max((size_t)1, entry.files.size()));
+      shared.numRemaining--;
+
+      device.numEntries++;
+
+      for(int i = 0; i <= _APPLYFAILED; i++)
+        {
+          device.numResults[i] += numResults[i];
+        }
+    }
+} // end of "batchWorker"
+
+
+
+/*
+  Function:
+   formatBatchReport
+
+  Description:
+   Formats the incoming report as text: the totals, one line per filesystem
+   and one line per failed file.
+
+  Input:
+   report               - a reference to the constant report.
+
+  Output:
+   output               - a reference to a string that receives the text.
+
+  Returns:
+   NONE
+*/
+void formatBatchReport(const BatchReport& report,
+                       std::string& output)
+{
+  std::ostringstream stream;
+
+  stream << "homes: " << report.numEntries << " files: " << report.numFiles
+         << " written: " << report.numResults[_APPLYWRITTEN]
+         << " unchanged: " << report.numResults[_APPLYUNCHANGED]
+         << " unsupported: " << report.numResults[_APPLYUNSUPPORTED]
+         << " failed: " << report.numResults[_APPLYFAILED]
+         << " time: " << (long)report.elapsedMs << "ms\n";
+
+  for(size_t i = 0; i < report.devices.size(); i++)
+    {
+      const BatchDeviceReport& device = report.devices.at(i);
+
+      stream << "  device " << major(device.device) << ":" << minor(device.device)
+             << " homes: " << device.numEntries
+             << " written: " << device.numResults[_APPLYWRITTEN]
+             << " unchanged: " << device.numResults[_APPLYUNCHANGED]
+             << " unsupported: " << device.numResults[_APPLYUNSUPPORTED]
+             << " failed: " << device.numResults[_APPLYFAILED] << "\n";
+    }
+
+  for(size_t i = 0; i < report.failures.size(); i++)
+    {
+      stream << "FAILED " << report.failures.at(i) << "\n";
+    }
+
+  output = stream.str();
+} // end of "formatBatchReport"
+
+
+
+/*
+  Function:
+   readBatchManifest
+
+  Description:
+   Reads a batch manifest. Each line is a user root, a theme and one or more
+   files relative to the root, separated by whitespace. Blank lines and lines
+   starting with '#' are skipped.
+
+  Input:
+   manifestPath         - a reference to a constant string containing the path
+                          of the manifest.
+
+  Output:
+   entries              - a reference to a vector the entries are appended to.
+
+   errors               - a reference to a vector that receives a message for
+                          each malformed line.
+
+  Returns:
+   bool                 - true if the manifest was read, even with errors.
+*/
+bool readBatchManifest(const std::string& manifestPath,
+                       std::vector<BatchEntry>& entries,
+                       std::vector<std::string>& errors)
+{
+  std::vector<std::string> lines;
+
+  if(readSavedFiles(manifestPath, lines) == false)
+    {
+      return false;
+    }
+
+  for(size_t i = 0; i < lines.size(); i++)
+    {
+      std::istringstream stream(lines.at(i));
+      BatchEntry entry;
+      std::string file;
+
+      stream >> entry.root >> entry.theme;
+
+      while(stream >> file)
+        {
+          entry.files.push_back(file);
+        }
+
+      if(entry.root.empty())
+        {
+          continue;
+        }
+
+      if(entry.files.empty())
+        {
+          errors.push_back("manifest: missing theme or files: " + lines.at(i));
+          continue;
+        }
+
+      if(checkThemeName(entry.theme) == false)
+        {
+          errors.push_back("manifest: invalid theme name: " + lines.at(i));
+          continue;
+        }
+
+      entries.push_back(entry);
+    }
+
+  return true;
+} // end of "readBatchManifest"
+
+
+
+/*
+  Function:
+   runBatchApply
+
+  Description:
+   Applies every manifest entry. Entries are grouped by the filesystem their
+   user root lives on and dealt round robin to the workers' queues, so each
+   worker starts with a mix of filesystems. Each filesystem gets an adaptive
+   window of homes updated at once (see DeviceScheduler), never more than
+   perDeviceLimit, which keeps a slow disk from being thrashed while the
+   workers steal homes on other disks.
+
+  Input:
+   entries              - a reference to a constant vector of the entries.
+
+   numThreads           - the number of workers, or 0 for one per hardware
+                          thread.
+
+   perDeviceLimit       - the most homes updated at once on one filesystem.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   report               - a reference to the report that receives the results.
+
+  Returns:
+   NONE
+*/
+void runBatchApply(const std::vector<BatchEntry>& entries,
+                   const int numThreads,
+                   const int perDeviceLimit,
+                   BatchReport& report,
+                   std::ofstream& log)
+{
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<std::vector<size_t>> deviceEntries;
+  std::vector<dev_t> devices;
+  BatchShared shared;
+
+  report.numEntries = entries.size();
+  report.numFiles = 0;
+  report.devices.clear();
+  report.failures.clear();
+  std::fill(report.numResults, report.numResults + _APPLYFAILED + 1, 0);
+
+  // group the entries by filesystem
+  for(size_t i = 0; i < entries.size(); i++)
+    {
+      struct stat rootStat;
+      const dev_t device = stat(entries.at(i).root.c_str(), &rootStat) == 0 ?
+        rootStat.st_dev : 0;
+      const size_t deviceIndex = std::find(devices.begin(), devices.end(), device) -
+        devices.begin();
+
+      if(deviceIndex == devices.size())
+        {
+          devices.push_back(device);
+          deviceEntries.push_back(std::vector<size_t>());
+        }
+
+      deviceEntries.at(deviceIndex).push_back(i);
+      report.numFiles += entries.at(i).files.size();
+    }
+
+  size_t workers = numThreads > 0 ? numThreads : std::thread::hardware_concurrency();
+  workers = std::max((size_t)1, std::min(workers, entries.size()));
+
+  shared.entries = &entries;
+  shared.scheduler.reset(new DeviceScheduler(perDeviceLimit));
+  shared.numRemaining = entries.size();
+
+  for(size_t i = 0; i < workers; i++)
+    {
+      shared.queues.push_back(std::unique_ptr<BatchQueue>(new BatchQueue()));
+    }
+
+  // deal the entries round robin, one filesystem after another
+  size_t nextQueue = 0;
+
+  for(size_t i = 0; i < devices.size(); i++)
+    {
+      shared.scheduler->addDevice(devices.at(i));
+
+      for(size_t j = 0; j < deviceEntries.at(i).size(); j++)
+        {
+          BatchTask task;
+          task.entryIndex = deviceEntries.at(i).at(j);
+          task.deviceIndex = i;
+          shared.queues.at(nextQueue)->tasks.push_back(task);
+          nextQueue = (nextQueue + 1) % workers;
+        }
+    }
+
+  // every worker fills its own report, merged once all are done
+  BatchDeviceReport emptyDevice;
+  std::vector<BatchReport> workerReports(workers);
+  std::vector<std::thread> threads;
+
+  emptyDevice.numEntries = 0;
+  std::fill(emptyDevice.numResults, emptyDevice.numResults + _APPLYFAILED + 1, 0);
+
+  for(size_t i = 0; i < devices.size(); i++)
+    {
+      emptyDevice.device = devices.at(i);
+      report.devices.push_back(emptyDevice);
+    }
+
+  for(size_t i = 0; i < workers; i++)
+    {
+      workerReports.at(i).devices = report.devices;
+    }
+
+  for(size_t i = 1; i < workers && !entries.empty(); i++)
+    {
+      threads.push_back(std::thread(batchWorker, std::ref(shared), i,
+                                    std::ref(workerReports.at(i))));
+    }
+
+  if(!entries.empty())
+    {
+      batchWorker(shared, 0, workerReports.at(0));
+    }
+
+  for(size_t i = 0; i < threads.size(); i++)
+    {
+      threads.at(i).join();
+    }
+
+  for(size_t i = 0; i < workers; i++)
+    {
+      for(size_t j = 0; j < devices.size(); j++)
+        {
+          const BatchDeviceReport& workerDevice = workerReports.at(i).devices.at(j);
+
+          report.devices.at(j).numEntries += workerDevice.numEntries;
+
+          for(int k = 0; k <= _APPLYFAILED; k++)
+            {
+              report.devices.at(j).numResults[k] += workerDevice.numResults[k];
+              report.numResults[k] += workerDevice.numResults[k];
+            }
+        }
+
+      report.failures.insert(report.failures.end(),
+                             workerReports.at(i).failures.begin(),
+                             workerReports.at(i).failures.end());
+    }
+
+  report.elapsedMs = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+
+  log << "Batch: " << report.numEntries << " homes on " << devices.size()
+      << " filesystems in " << report.elapsedMs << "ms" << std::endl;
+} // end of "runBatchApply"
@@ -0,0 +1,303 @@
+/*
+  File:
+   colorPairAllocator.cpp
+
+  Description:
+   The implementation of the colorPairAllocator.hpp class.
+*/
+#include <algorithm>
+#include <ncurses.h>
+#include "colorPairAllocator.hpp"
+#include "palette.hpp"
+
+
+
+/*
+  Function:
+   ColorPairAllocator Constructor
+
+  Description:
+   Creates an allocator with no slots. initialize() must be called after
+   curses has started colors.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+ColorPairAllocator::ColorPairAllocator()
+  : m_canChangeColor(false),
+    m_numColors(0),
+    m_numPairs(0),
+    m_numPairInits(0),
+    m_numColorInits(0)
+{
+} // end of "ColorPairAllocator Constructor"
+
+
+
+/*
+  Function:
+   initialize
+
+  Description:
+   Reads the terminal's color capabilities and makes every pair from firstPair
+   up available. Pairs below firstPair are left to the fixed interface colors.
+   When the terminal can redefine colors, slots 16 and up are redefined to the
+   exact RGB values asked for. The 16 ANSI colors are never touched since the
+   interface and the shell depend on them.
+
+  Input:
+   firstPair            - the first color pair the allocator may define.
+
+   maxSlots             - the most pairs, and the most color slots, handed out
+                          before the least recently used ones are reused.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ColorPairAllocator::initialize(const int firstPair,
+                                    const int maxSlots)
+{
+  m_freeColors.clear();
+  m_freePairs.clear();
+  m_colorLru.clear();
+  m_pairLru.clear();
+  m_colors.clear();
+  m_pairs.clear();
+
+  if(has_colors() == false)
+    {
+      m_numColors = 0;
+      m_numPairs = 0;
+      return;
+    }
+
+  m_numColors = COLORS;
+  m_canChangeColor = can_change_color() && COLORS > (int)_ANSICOLORS;
+
+  const int lastPair = std::min(COLOR_PAIRS, firstPair + maxSlots);
+
+  // free lists are used from the back, so hand out the lowest slots first
+  for(int i = lastPair - 1; i >= firstPair; i--)
+    {
+      m_freePairs.push_back(i);
+    }
+
+  m_numPairs = m_freePairs.size();
+
+  if(m_canChangeColor == true)
+    {
+      const int lastColor = std::min(COLORS, (int)_ANSICOLORS + maxSlots);
+
+      for(int i = lastColor - 1; i >= (int)_ANSICOLORS; i--)
+        {
+          m_freeColors.push_back(i);
+        }
+    }
+} // end of "initialize"
+
+
+
+/*
+  Function:
+   getPair
+
+  Description:
+   Returns a color pair that draws foreground on background. A pair already
+   holding the two colors is reused as is; otherwise a free pair, or the least
+   recently used one, is redefined.
+
+  Input:
+   foreground           - the text color as 0xrrggbb.
+
+   background           - the background color as 0xrrggbb.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the color pair number, or 0 (the terminal default) if
+                          the terminal has no colors.
+*/
+int ColorPairAllocator::getPair(const uint32_t foreground,
+                                const uint32_t background)
+{
+  if(m_numPairs == 0)
+    {
+      return 0;
+    }
+
+  const short fg = getColor(foreground);
+  const short bg = getColor(background);
+  const uint64_t key = ((uint64_t)foreground << 32) | background;
+  std::unordered_map<uint64_t, PairSlot>::iterator it = m_pairs.find(key);
+
+  if(it != m_pairs.end())
+    {
+      m_pairLru.splice(m_pairLru.begin(), m_pairLru, it->second.lru);
+
+      // one of the pair's colors was evicted and now lives in another slot
+      if(it->second.foreground != fg || it->second.background != bg)
+        {
+          init_pair(it->second.pair, fg, bg);
+          it->second.foreground = fg;
+          it->second.background = bg;
+          m_numPairInits++;
+        }
+
+      return it->second.pair;
+    }
+
+  PairSlot slot;
+
+  if(m_freePairs.empty())
+    {
+      std::unordered_map<uint64_t, PairSlot>::iterator oldest = m_pairs.find(m_pairLru.back());
+      slot.pair = oldest->second.pair;
+      m_pairs.erase(oldest);
+      m_pairLru.pop_back();
+    }
+  else
+    {
+      slot.pair = m_freePairs.back();
+      m_freePairs.pop_back();
+    }
+
+  init_pair(slot.pair, fg, bg);
+  m_numPairInits++;
+  slot.foreground = fg;
+  slot.background = bg;
+  m_pairLru.push_front(key);
+  slot.lru = m_pairLru.begin();
+  m_pairs.insert(std::make_pair(key, slot));
+
+  return slot.pair;
+} // end of "getPair"
+
+
+
+/*
+  Function:
+   getColor
+
+  Description:
+   Returns the curses color number used to draw the incoming RGB color. On
+   terminals that can redefine colors this is an exact slot handed out like
+   the pairs; elsewhere it is the closest color the terminal already has.
+
+  Input:
+   rgb                  - the color as 0xrrggbb.
+
+  Output:
+   NONE
+
+  Returns:
+   short                - the curses color number.
+*/
+short ColorPairAllocator::getColor(const uint32_t rgb)
+{
+  std::unordered_map<uint32_t, ColorSlot>::iterator it = m_colors.find(rgb);
+
+  if(it != m_colors.end())
+    {
+      if(m_canChangeColor == true)
+        {
+          m_colorLru.splice(m_colorLru.begin(), m_colorLru, it->second.lru);
+        }
+
+      return it->second.color;
+    }
+
+  const int red = (rgb >> 16) & 0xff;
+  const int green = (rgb >> 8) & 0xff;
+  const int blue = rgb & 0xff;
+  ColorSlot slot;
+  slot.lru = m_colorLru.end();
+
+  if(m_canChangeColor == true)
+    {
+      if(m_freeColors.empty())
+        {
+          std::unordered_map<uint32_t, ColorSlot>::iterator oldest =
+            m_colors.find(m_colorLru.back());
+          slot.color = oldest->second.color;
+          m_colors.erase(oldest);
+          m_colorLru.pop_back();
+        }
+      else
+        {
+          slot.color = m_freeColors.back();
+          m_freeColors.pop_back();
+        }
+
+      init_color(slot.color, red * 1000 / 255, green * 1000 / 255, blue * 1000 / 255);
+      m_numColorInits++;
+      m_colorLru.push_front(rgb);
+      slot.lru = m_colorLru.begin();
+    }
+  else if(m_numColors >= (int)_XTERMCOLORS)
+    {
+      Palette palette("", 1);
+      std::vector<uint8_t> indexes;
+
+      palette.setColor(0, rgb);
+      palette.findXterm256(indexes);
+      slot.color = indexes.at(0);
+    }
+  else
+    {
+      // the closest of the 8 basic colors, using the bright variant when the
+      // terminal has one and the color is light
+      slot.color = (red > 0x7f ? COLOR_RED : 0) | (green > 0x7f ? COLOR_GREEN : 0) |
+        (blue > 0x7f ? COLOR_BLUE : 0);
+
+      if(m_numColors >= (int)_ANSICOLORS && std::max(red, std::max(green, blue)) > 0xbf)
+        {
+          slot.color += 8;
+        }
+    }
+
+  m_colors.insert(std::make_pair(rgb, slot));
+
+  return slot.color;
+} // end of "getColor"
+
+
+
+int ColorPairAllocator::getNumPairs() const
+{
+  return m_numPairs;
+} // end of "getNumPairs"
+
+
+
+int ColorPairAllocator::getNumColors() const
+{
+  return m_numColors;
+} // end of "getNumColors"
+
+
+
+bool ColorPairAllocator::getCanChangeColor() const
+{
+  return m_canChangeColor;
+} // end of "getCanChangeColor"
+
+
+
+unsigned long ColorPairAllocator::getNumPairInits() const
+{
+  return m_numPairInits;
+} // end of "getNumPairInits"
+
+
+
+unsigned long ColorPairAllocator::getNumColorInits() const
+{
+  return m_numColorInits;
+} // end of "getNumColorInits"
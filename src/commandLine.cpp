@@ -0,0 +1,703 @@
+/*
+  File:
+   commandLine.cpp
+
+  Description:
+   The implementation of the commandLine.hpp functions.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <vector>
+#include "applyEngine.hpp"
+#include "batchApply.hpp"
+#include "commandLine.hpp"
+#include "daemonProtocol.hpp"
+#include "fileOperations.hpp"
+#include "themeClusters.hpp"
+#include "themeDaemon.hpp"
+#include "themeImport.hpp"
+#include "themeLibrary.hpp"
+
+
+
+/*
+  Function:
+   requestDaemon
+
+  Description:
+   Sends one request over a connected client and prints the daemon's answer:
+   failures on stderr, status output on stdout.
+
+  Input/Output:
+   client               - a reference to a client connected to the daemon.
+
+  Input:
+   code                 - a DaemonRequests value.
+
+   payload              - a reference to a constant string containing the
+                          request payload.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+static int requestDaemon(DaemonClient& client,
+                         const int code,
+                         const std::string& payload)
+{
+  int responseCode;
+  std::string response;
+
+  if(client.request(code, payload, responseCode, response) == false)
+    {
+      fprintf(stderr, "themeswitcher: lost connection to the daemon\n");
+      return _CLIFAILED;
+    }
+
+  if(responseCode != _DAEMONOK)
+    {
+      fprintf(stderr, "themeswitcher: %s\n", response.c_str());
+      return _CLIFAILED;
+    }
+
+  if(code == _DAEMONAPPLY)
+    {
+      // "written unchanged unsupported failed" then one failed path per line
+      const size_t countsEnd = response.find('\n');
+      size_t lineStart = countsEnd == std::string::npos ? response.length() : countsEnd + 1;
+      int status = _CLISUCCESS;
+
+      while(lineStart < response.length())
+        {
+          size_t lineEnd = response.find('\n', lineStart);
+
+          if(lineEnd == std::string::npos)
+            {
+              lineEnd = response.length();
+            }
+
+          fprintf(stderr, "themeswitcher: failed to apply %s to %s\n", payload.c_str(),
+                  response.substr(lineStart, lineEnd - lineStart).c_str());
+          status = _CLIFAILED;
+          lineStart = lineEnd + 1;
+        }
+
+      return status;
+    }
+
+  fwrite(response.data(), 1, response.length(), stdout);
+
+  return _CLISUCCESS;
+} // end of "requestDaemon"
+
+
+
+/*
+  Function:
+   runApplyCommand
+
+  Description:
+   Applies the incoming theme to every file in the saved file store and
+   returns as soon as the last file is written. A running daemon does the work
+   from its resident store; otherwise the store is read here. Only failures
+   are reported, on stderr, so a no-op apply prints nothing. Theme names
+   outside the characters checkThemeName() allows are refused.
+
+  Input:
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runApplyCommand(const std::string& theme)
+{
+  DaemonClient client;
+
+  if(checkThemeName(theme) == false)
+    {
+      fprintf(stderr, "themeswitcher: invalid theme name\n");
+      return _CLIUSAGE;
+    }
+
+  if(client.connectTo(daemonSocketPath()) == true)
+    {
+      return requestDaemon(client,
+                           _DAEMONAPPLY,
+                           theme);
+    }
+
+  const std::string storePath = savedFilesStorePath();
+  std::vector<std::string> savedFiles;
+
+  // the apply engine logs every file, which nothing reads in headless mode
+  std::ofstream log;
+
+  if(storePath.empty() || readSavedFiles(storePath, savedFiles) == false)
+    {
+      fprintf(stderr, "themeswitcher: can't read saved files from %s\n",
+              storePath.empty() ? "$HOME/.config/themeswitcher/savedFiles" :
+              storePath.c_str());
+      return _CLIFAILED;
+    }
+
+  std::vector<int> results;
+  int status = _CLISUCCESS;
+
+  applyThemeToFiles(savedFiles, theme, results, log);
+
+  for(size_t i = 0; i < savedFiles.size(); i++)
+    {
+      if(results.at(i) == _APPLYFAILED)
+        {
+          fprintf(stderr, "themeswitcher: failed to apply %s to %s\n",
+                  theme.c_str(), savedFiles.at(i).c_str());
+          status = _CLIFAILED;
+        }
+    }
+
+  return status;
+} // end of "runApplyCommand"
+
+
+
+/*
+  Function:
+   runCtlCommand
+
+  Description:
+   Sends one request to the running daemon and prints its answer.
+
+     ctl ping | status | reload | quit | apply <theme>
+
+  Input:
+   argc                 - the number of arguments, starting with "ctl".
+
+   argv                 - the arguments.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runCtlCommand(const int argc,
+                  char** argv)
+{
+  static const char* requestNames[_NUMDAEMONREQUESTS] = {
+    "ping", "apply", "status", "reload", "quit"
+  };
+  int code = -1;
+  std::string payload;
+
+  for(int i = 0; argc >= 2 && i < _NUMDAEMONREQUESTS; i++)
+    {
+      if(strcmp(argv[1], requestNames[i]) == 0)
+        {
+          code = i;
+        }
+    }
+
+  if(code == -1 || (code == _DAEMONAPPLY) != (argc == 3) || argc > 3)
+    {
+      fprintf(stderr, "usage: themeswitcher ctl ping|status|reload|quit|apply <theme>\n");
+      return _CLIUSAGE;
+    }
+
+  if(code == _DAEMONAPPLY)
+    {
+      payload = argv[2];
+
+      if(checkThemeName(payload) == false)
+        {
+          fprintf(stderr, "themeswitcher: invalid theme name\n");
+          return _CLIUSAGE;
+        }
+    }
+
+  DaemonClient client;
+
+  if(client.connectTo(daemonSocketPath()) == false)
+    {
+      fprintf(stderr, "themeswitcher: no daemon listening on %s\n",
+              daemonSocketPath().c_str());
+      return _CLIFAILED;
+    }
+
+  return requestDaemon(client,
+                       code,
+                       payload);
+} // end of "runCtlCommand"
+
+
+
+/*
+  Function:
+   runDaemonCommand
+
+  Description:
+   Runs the daemon in the foreground until it is told to quit or receives
+   SIGINT or SIGTERM.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runDaemonCommand()
+{
+  ThemeDaemon daemon(daemonSocketPath(), savedFilesStorePath());
+  std::ofstream log;
+
+  if(daemon.start(log) == false)
+    {
+      fprintf(stderr, "themeswitcher: can't listen on %s\n", daemonSocketPath().c_str());
+      return _CLIFAILED;
+    }
+
+  daemon.run(log);
+  daemon.stop();
+
+  return _CLISUCCESS;
+} // end of "runDaemonCommand"
+
+
+
+/*
+  Function:
+   runBatchCommand
+
+  Description:
+   Applies the themes of a multi user manifest and prints the aggregated
+   report.
+
+     batch <manifest> [--threads N] [--per-device N]
+
+  Input:
+   argc                 - the number of arguments, starting with "batch".
+
+   argv                 - the arguments.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runBatchCommand(const int argc,
+                    char** argv)
+{
+  int numThreads = 0;
+  int perDeviceLimit = _BATCHDEVICELIMIT;
+  bool isUsage = argc < 2 || argc % 2 != 0;
+
+  for(int i = 2; i + 1 < argc && isUsage == false; i += 2)
+    {
+      const int value = atoi(argv[i + 1]);
+
+      if(strcmp(argv[i], "--threads") == 0 && value > 0)
+        {
+          numThreads = value;
+        }
+      else if(strcmp(argv[i], "--per-device") == 0 && value > 0)
+        {
+          perDeviceLimit = value;
+        }
+      else
+        {
+          isUsage = true;
+        }
+    }
+
+  if(isUsage == true)
+    {
+      fprintf(stderr, "usage: themeswitcher batch <manifest> [--threads N] [--per-device N]\n");
+      return _CLIUSAGE;
+    }
+
+  std::vector<BatchEntry> entries;
+  std::vector<std::string> errors;
+
+  if(readBatchManifest(argv[1], entries, errors) == false)
+    {
+      fprintf(stderr, "themeswitcher: can't read manifest %s\n", argv[1]);
+      return _CLIFAILED;
+    }
+
+  for(size_t i = 0; i < errors.size(); i++)
+    {
+      fprintf(stderr, "themeswitcher: %s\n", errors.at(i).c_str());
+    }
+
+  BatchReport report;
+  std::string output;
+  std::ofstream log;
+
+  runBatchApply(entries, numThreads, perDeviceLimit, report, log);
+  formatBatchReport(report, output);
+  fwrite(output.data(), 1, output.length(), stdout);
+
+  return report.numResults[_APPLYFAILED] == 0 && errors.empty() ? _CLISUCCESS : _CLIFAILED;
+} // end of "runBatchCommand"
+
+
+
+/*
+  Function:
+   runImportCommand
+
+  Description:
+   Imports the themes of theme directories, .tar archives and theme files
+   into the saved themes library and prints the report. The library is
+   written once, after every source has been read.
+
+     import <source> [source ...] [--threads N]
+
+  Input:
+   argc                 - the number of arguments, starting with "import".
+
+   argv                 - the arguments.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runImportCommand(const int argc,
+                     char** argv)
+{
+  std::vector<std::string> sources;
+  int numThreads = 0;
+
+  for(int i = 1; i < argc; i++)
+    {
+      if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+        {
+          numThreads = atoi(argv[++i]);
+        }
+      else if(argv[i][0] == '-')
+        {
+          sources.clear();
+          break;
+        }
+      else
+        {
+          sources.push_back(argv[i]);
+        }
+    }
+
+  if(sources.empty())
+    {
+      fprintf(stderr, "usage: themeswitcher import <directory|archive.tar|file>... [--threads N]\n");
+      return _CLIUSAGE;
+    }
+
+  const std::string libraryPath = themeLibraryStorePath();
+  struct stat libraryStat;
+  ThemeLibrary library;
+
+  // never replace a library that exists but can't be read
+  if(libraryPath.empty() ||
+     (library.load(libraryPath) == false && stat(libraryPath.c_str(), &libraryStat) == 0))
+    {
+      fprintf(stderr, "themeswitcher: can't read the theme library %s\n", libraryPath.c_str());
+      return _CLIFAILED;
+    }
+
+  ImportReport report;
+  std::string output;
+  std::ofstream log;
+
+  importThemes(sources, numThreads, library, report, log);
+
+  for(size_t i = 0; i < report.errors.size(); i++)
+    {
+      fprintf(stderr, "themeswitcher: %s\n", report.errors.at(i).c_str());
+    }
+
+  if(report.numThemes > 0)
+    {
+      mkdir(libraryPath.substr(0, libraryPath.find_last_of('/')).c_str(), 0700);
+
+      if(library.save(libraryPath) == false)
+        {
+          fprintf(stderr, "themeswitcher: can't write the theme library %s\n",
+                  libraryPath.c_str());
+          return _CLIFAILED;
+        }
+    }
+
+  formatImportReport(report, output);
+  fwrite(output.data(), 1, output.length(), stdout);
+
+  return report.errors.empty() ? _CLISUCCESS : _CLIFAILED;
+} // end of "runImportCommand"
+
+
+
+/*
+  Function:
+   runThemesCommand
+
+  Description:
+   Prints the names in the saved themes library that start with the incoming
+   prefix, one per line.
+
+     themes [prefix]
+
+  Input:
+   prefix               - a reference to a constant string containing the
+                          prefix; an empty prefix lists every theme.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runThemesCommand(const std::string& prefix)
+{
+  ThemeLibrary library;
+  int first;
+  int last;
+
+  if(library.load(themeLibraryStorePath()) == false)
+    {
+      fprintf(stderr, "themeswitcher: can't read the theme library %s\n",
+              themeLibraryStorePath().c_str());
+      return _CLIFAILED;
+    }
+
+  library.findPrefix(prefix, first, last);
+
+  std::vector<std::string> names;
+
+  library.getRange(first, last - first, names);
+
+  for(size_t i = 0; i < names.size(); i++)
+    {
+      printf("%s\n", names.at(i).c_str());
+    }
+
+  return _CLISUCCESS;
+} // end of "runThemesCommand"
+
+
+
+/*
+  Function:
+   runDuplicatesCommand
+
+  Description:
+   Prints every group of saved themes with the same or nearly the same
+   colors. The first theme of a group is the one the saved themes list
+   shows; the others follow it marked "=" for identical colors or "~" with
+   their average OKLab difference per color.
+
+     duplicates
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runDuplicatesCommand()
+{
+  ThemeLibrary library;
+  ThemeClusters clusters(library);
+  std::vector<std::vector<ClusterMember> > groups;
+
+  if(library.load(themeLibraryStorePath()) == false)
+    {
+      fprintf(stderr, "themeswitcher: can't read the theme library %s\n",
+              themeLibraryStorePath().c_str());
+      return _CLIFAILED;
+    }
+
+  clusters.buildClusters();
+  clusters.getClusters(groups);
+
+  for(size_t i = 0; i < groups.size(); i++)
+    {
+      printf("%s\n", library.at(groups.at(i).front().entry).c_str());
+
+      for(size_t j = 1; j < groups.at(i).size(); j++)
+        {
+          const ClusterMember& member = groups.at(i).at(j);
+
+          if(clusters.getIsExact(member.entry))
+            {
+              printf("  = %s\n", library.at(member.entry).c_str());
+            }
+          else
+            {
+              printf("  ~ %s (%.3f)\n", library.at(member.entry).c_str(), member.delta);
+            }
+        }
+    }
+
+  printf("%d themes, %d exact and %d near duplicates in %d groups\n",
+         library.getNumEntries(), clusters.getNumExact(), clusters.getNumNear(),
+         clusters.getNumClusters());
+
+  return _CLISUCCESS;
+} // end of "runDuplicatesCommand"
+
+
+
+/*
+  Function:
+   runSimilarCommand
+
+  Description:
+   Prints the saved themes whose colors look most like the incoming theme's,
+   most similar first, with their average OKLab difference per color.
+
+     similar <theme> [count]
+
+  Input:
+   theme                - a reference to a constant string naming a theme in
+                          the saved themes library.
+
+   count                - the number of themes to print.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value.
+*/
+int runSimilarCommand(const std::string& theme,
+                      const int count)
+{
+  ThemeLibrary library;
+  ThemeClusters clusters(library);
+  std::vector<ClusterMember> similar;
+
+  if(library.load(themeLibraryStorePath()) == false)
+    {
+      fprintf(stderr, "themeswitcher: can't read the theme library %s\n",
+              themeLibraryStorePath().c_str());
+      return _CLIFAILED;
+    }
+
+  const int entry = library.find(theme);
+
+  if(entry < 0)
+    {
+      fprintf(stderr, "themeswitcher: no saved theme named %s\n", theme.c_str());
+      return _CLIFAILED;
+    }
+
+  clusters.buildIndex();
+
+  if(clusters.findSimilar(entry, count, similar) == false)
+    {
+      fprintf(stderr, "themeswitcher: %s has no palette to compare\n", theme.c_str());
+      return _CLIFAILED;
+    }
+
+  for(size_t i = 0; i < similar.size(); i++)
+    {
+      printf("%.3f %s\n", similar.at(i).delta, library.at(similar.at(i).entry).c_str());
+    }
+
+  return _CLISUCCESS;
+} // end of "runSimilarCommand"
+
+
+
+/*
+  Function:
+   runCommandLine
+
+  Description:
+   Runs the command given on the command line.
+
+     themeswitcher apply <theme>
+     themeswitcher batch <manifest> [--threads N] [--per-device N]
+     themeswitcher daemon
+     themeswitcher ctl <request> [theme]
+     themeswitcher import <source> [source ...] [--threads N]
+     themeswitcher themes [prefix]
+     themeswitcher duplicates
+     themeswitcher similar <theme> [count]
+
+   record and replay start the interface instead and are handled in main().
+
+  Input:
+   argc                 - the number of command line arguments.
+
+   argv                 - the command line arguments.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - a CommandLineStatuses value to exit with.
+*/
+int runCommandLine(const int argc,
+                   char** argv)
+{
+  if(argc == 3 && strcmp(argv[1], "apply") == 0 && argv[2][0] != '\0')
+    {
+      return runApplyCommand(argv[2]);
+    }
+  else if(argc >= 2 && strcmp(argv[1], "batch") == 0)
+    {
+      return runBatchCommand(argc - 1,
+                             argv + 1);
+    }
+  else if(argc == 2 && strcmp(argv[1], "daemon") == 0)
+    {
+      return runDaemonCommand();
+    }
+  else if(argc >= 2 && strcmp(argv[1], "ctl") == 0)
+    {
+      return runCtlCommand(argc - 1,
+                           argv + 1);
+    }
+  else if(argc >= 2 && strcmp(argv[1], "import") == 0)
+    {
+      return runImportCommand(argc - 1,
+                              argv + 1);
+    }
+  else if((argc == 2 || argc == 3) && strcmp(argv[1], "themes") == 0)
+    {
+      return runThemesCommand(argc == 3 ? argv[2] : "");
+    }
+  else if(argc == 2 && strcmp(argv[1], "duplicates") == 0)
+    {
+      return runDuplicatesCommand();
+    }
+  else if((argc == 3 || (argc == 4 && atoi(argv[3]) > 0)) &&
+          strcmp(argv[1], "similar") == 0)
+    {
+      return runSimilarCommand(argv[2],
+                               argc == 4 ? atoi(argv[3]) : _SIMILARTHEMES);
+    }
+
+  fprintf(stderr, "usage: themeswitcher [apply <theme> | batch <manifest> | daemon |\n"
+          "                      ctl <request> | import <source>... | themes [prefix] |\n"
+          "                      duplicates | similar <theme> [count] |\n"
+          "                      record <file> | replay <file> [--fast]]\n");
+
+  return _CLIUSAGE;
+} // end of "runCommandLine"
@@ -6,9 +6,13 @@
    Function implementations for the cursesFunctions.hpp header file.
 */
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include "cursesFunctions.hpp"
+#include "winLayout.hpp"
 #include <unistd.h>
 
 
@@ -54,10 +58,10 @@ int checkButtonClick(std::unordered_map<int, CursesWindow*>& wins,
                      std::ofstream& log)
 {
   int buttonNum = -1;
-  if(wins.at(_MAINWIN)->getWindow() == nullptr ||
-     wins.at(_SAVEDFILESWIN)->getWindow() == nullptr ||
-     wins.at(_SAVEDTHEMESWIN)->getWindow() == nullptr ||
-     wins.at(_HELPWIN)->getWindow() == nullptr)
+  if(wins.at(_MAINWIN)->getIsOpen() == false ||
+     wins.at(_SAVEDFILESWIN)->getIsOpen() == false ||
+     wins.at(_SAVEDTHEMESWIN)->getIsOpen() == false ||
+     wins.at(_HELPWIN)->getIsOpen() == false)
     {
       return buttonNum;
     }
@@ -244,7 +248,7 @@ void checkSFClick(const std::unordered_map<int, CursesWindow*>& wins,
                   int& highlightWinNum,
                   std::ofstream& log)
 {
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr &&
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen() &&
      !outputStrings.empty())
     {
       int maxLines = wins.at(_SAVEDFILESWIN)->getNumLines();
@@ -270,76 +274,25 @@ void checkSFClick(const std::unordered_map<int, CursesWindow*>& wins,
 
 
 
-void checkSTClick(const std::unordered_map<int, CursesWindow*>& wins,
-                  const std::vector<CursesWindow*>& stStringWins,
-                  const int& mouseLine,
-                  const int& mouseCol,
-                  int& highlightWinNum,
-                  std::ofstream& log)
-{
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr && !stStringWins.empty())
-    {
-      for(int i = 0; i < stStringWins.size(); i ++)
-        {
-          int maxLines = stStringWins.at(i)->getNumLines();
-          int maxCols = stStringWins.at(i)->getNumCols();
-          getmaxyx(stStringWins.at(i)->getWindow(), maxLines, maxCols);
-          const int startY = stStringWins.at(i)->getStartY();
-          const int startX = stStringWins.at(i)->getStartX();
-
-          if((mouseLine == startY) && ((mouseCol >= startX) &&
-                                       (mouseCol < startX + maxCols)))
-            {
-              highlightWinNum = i;
-            }
-          else
-            {
-              highlightWinNum = -1;
-            }
-
-          if(highlightWinNum != -1)
-            {
-              break;
-            }
-        }
-    }
-} // end of "checkSTClick"
-
-
-
 bool checkWindowClick(std::unordered_map<int, CursesWindow*>& wins,
                       const int win,
-                      MEVENT& mouse,
-                      int& mouseLine,
-                      int& mouseCol,
+                      const int mouseLine,
+                      const int mouseCol,
                       const int yOffsetStart,
                       const int yOffsetEnd,
                       const int xOffsetStart,
                       const int xOffsetEnd,
                       std::ofstream& log)
 {
-  mouseLine = -1;
-  mouseCol = -1;
-
-  if(getmouse(&mouse) == OK)
+  // return to previous state if user clicked out of the _SFPROMPTWIN
+  if((mouseLine <= wins.at(win)->getStartY() - yOffsetStart) ||
+     (mouseLine > wins.at(win)->getStartY() +
+      wins.at(win)->getNumLines()  - yOffsetEnd) ||
+     ((mouseCol <= wins.at(win)->getStartX()  - xOffsetStart) ||
+      (mouseCol > wins.at(win)->getStartX() +
+       wins.at(win)->getNumCols() - xOffsetEnd)))
     {
-      // check if a mouse click is detected and operate depending click location
-      if(mouse.bstate & BUTTON1_PRESSED)
-        {
-          mouseLine = mouse.y;
-          mouseCol = mouse.x;
-
-          // return to previous state if user clicked out of the _SFPROMPTWIN
-          if((mouseLine <= wins.at(win)->getStartY() - yOffsetStart) ||
-             (mouseLine > wins.at(win)->getStartY() +
-              wins.at(win)->getNumLines()  - yOffsetEnd) ||
-             ((mouseCol <= wins.at(win)->getStartX()  - xOffsetStart) ||
-              (mouseCol > wins.at(win)->getStartX() +
-               wins.at(win)->getNumCols() - xOffsetEnd)))
-            {
-              return false;
-            }
-        }
+      return false;
     }
 
     return true;
@@ -377,7 +330,7 @@ void clearWins(const std::unordered_map<int, CursesWindow*>& wins)
   std::unordered_map<int, CursesWindow*>::const_iterator it;
   for(it = wins.begin(); it != wins.end(); it++)
     {
-      werase(it->second->getWindow());
+      it->second->eraseWindow();
     }
 } // end of "clearWins"
 
@@ -387,9 +340,9 @@ void clearSFStringWins(const std::vector<CursesWindow*>& sfStringWins)
 {
   for(int i = 0; i < sfStringWins.size(); i++)
     {
-      if(sfStringWins.at(i)->getWindow() != nullptr)
+      if(sfStringWins.at(i)->getIsOpen())
         {
-          werase(sfStringWins.at(i)->getWindow());
+          sfStringWins.at(i)->eraseWindow();
         }
     }
 } // end of "clearWins"
@@ -397,139 +350,345 @@ void clearSFStringWins(const std::vector<CursesWindow*>& sfStringWins)
 
 
 
-void clearSTStringWins(const std::vector<CursesWindow*>& stStringWins)
+/*
+  Function:
+   createSFOutputString
+
+  Description:
+   Formats a single numbered saved file line, padding or truncating the file
+   path so the current theme is right aligned in a line of maxCols columns.
+   The line is written over outString, reusing its storage.
+
+  Input:
+   fileIndex                - the index of the file in the saved files list.
+
+   fileString               - a view of the saved file path.
+
+   themeString              - a view of the file's current theme.
+
+   maxCols                  - the number of columns of a saved file window.
+
+  Output:
+   outString                - a reference to a string that receives the
+                              formatted output line.
+
+  Returns:
+   NONE
+*/
+void createSFOutputString(const int fileIndex,
+                          const std::string_view fileString,
+                          const std::string_view themeString,
+                          const int maxCols,
+                          std::string& outString)
 {
-  for(int i = 0; i < stStringWins.size(); i++)
+  const std::string_view dots = "...";
+  const std::string countString = intToStr(fileIndex + 1) + ". ";
+  const int totalFileLength = fileString.length() + dots.length() +
+    themeString.length() + countString.length();
+
+  outString.assign(countString);
+
+  if(totalFileLength > maxCols)
     {
-      if(stStringWins.at(i)->getWindow() != nullptr)
+      const size_t difference = totalFileLength - maxCols;
+
+      outString.append(dots);
+
+      if(difference + dots.length() < fileString.length())
         {
-          werase(stStringWins.at(i)->getWindow());
+          outString.append(fileString.substr(difference + dots.length()));
         }
+
+      outString.append(dots);
     }
-} // end of "clearWins"
+  else
+    {
+      outString.append(fileString);
+      outString.append(maxCols - themeString.length() - countString.length() -
+                       fileString.length(), '.');
+    }
+
+  outString.append(themeString);
+} // end of "createSFOutputString"
+
+
+
+/*
+  Function:
+   createSFOutputStrings
+
+  Description:
+   Formats every saved file line for the current width of the saved file
+   line windows, reusing the strings already in outputStrings.
+
+  Input:
+   wins                     - A reference to a const unordered map
+                              <int, CursesWindow*> type that contains pointers
+                              to all currently allocated CursesWindow objects
+                              that can be indexed by key values in the file
+                              _cursesWinConsts.hpp.
+
+   sfStringWins             - a reference to a constant vector of the allocated
+                              saved file line windows.
 
+   sfStrings                - a reference to a constant vector of strings
+                              containing the saved file paths.
 
-std::vector<std::string> createSFOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
-                                               std::vector<CursesWindow*>& sfStringWins,
-                                               const std::vector<std::string>& sfStrings,
-                                               const std::vector<std::string>& currThemes,
-                                               std::ofstream& log)
+   currThemes               - a reference to a constant vector of the current
+                              theme of each saved file.
+
+  Output:
+   outputStrings            - a reference to a vector that receives the
+                              formatted lines, or is emptied if the saved file
+                              windows aren't shown.
+
+  Returns:
+   NONE
+*/
+void createSFOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
+                           const std::vector<CursesWindow*>& sfStringWins,
+                           const std::vector<std::string>& sfStrings,
+                           const std::vector<std::string>& currThemes,
+                           std::vector<std::string>& outputStrings,
+                           std::ofstream& log)
 {
-  std::vector<std::string> outputStrings;
+  int maxLines = 0;
+  int maxCols = 0;
+
+  if(sfStrings.empty() || currThemes.empty() ||
+     wins.at(_SAVEDFILESWIN)->getIsOpen() == false ||
+     sfStringWins.empty() || sfStringWins.at(0)->getIsOpen() == false)
+    {
+      outputStrings.clear();
+      return;
+    }
 
-  if(sfStrings.empty() || currThemes.empty())
+  maxLines = sfStringWins.at(0)->getNumLines();
+  maxCols = sfStringWins.at(0)->getNumCols();
+  outputStrings.resize(sfStrings.size());
+
+  for(size_t i = 0; i < sfStrings.size(); i++)
     {
-      return outputStrings;
+      createSFOutputString(i,
+                           sfStrings.at(i),
+                           currThemes.at(i),
+                           maxCols,
+                           outputStrings.at(i));
     }
+} // end of "createSFOutputStrings"
+
+
+
+/*
+  Function:
+   updateSFOutputStrings
 
-  std::string dots = "...";
+  Description:
+   Applies current theme changes reported by the FileWatcher to currThemes and
+   reformats only the affected lines of outputStrings, so a change to one saved
+   file never rebuilds the entire saved files list.
+
+  Input/Output:
+   currThemes               - a reference to the vector of current themes for
+                              each saved file.
+
+   outputStrings            - a reference to the vector of formatted saved file
+                              lines previously built by createSFOutputStrings.
+  Input:
+   sfStringWins             - a reference to a constant vector of the allocated
+                              saved file line windows.
+
+   sfStrings                - a reference to a constant vector of strings
+                              containing the saved file paths.
+
+   deltas                   - a reference to a constant vector of theme changes
+                              taken from the FileWatcher.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                     - true if any of the changed lines are currently
+                              visible and the saved file lines should be
+                              reprinted.
+*/
+bool updateSFOutputStrings(const std::vector<CursesWindow*>& sfStringWins,
+                           const std::vector<std::string>& sfStrings,
+                           std::vector<std::string>& currThemes,
+                           std::vector<std::string>& outputStrings,
+                           const std::vector<FileThemeDelta>& deltas,
+                           const int& sfStringPos,
+                           std::ofstream& log)
+{
+  bool isVisible = false;
   int maxLines = 0;
   int maxCols = 0;
 
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+  if(!sfStringWins.empty() && sfStringWins.at(0)->getIsOpen())
     {
-      outputStrings.clear();
-      if(sfStringWins.at(0)->getWindow() != nullptr)
+      maxLines = sfStringWins.at(0)->getNumLines();
+      maxCols = sfStringWins.at(0)->getNumCols();
+    }
+
+  for(size_t i = 0; i < deltas.size(); i++)
+    {
+      const int fileIndex = deltas.at(i).fileIndex;
+
+      if(fileIndex < 0 || fileIndex >= currThemes.size())
         {
-          int maxPossible = maxCols - 6;
-          std::string tempString;
-          std::string fileString;
-          std::string themeString;
-          std::string countString;
+          continue;
+        }
 
-          getmaxyx(sfStringWins.at(0)->getWindow(), maxLines, maxCols);
-          int i = 0;
+      currThemes.at(fileIndex) = deltas.at(i).theme;
+      log << "Theme changed: " << sfStrings.at(fileIndex) << " -> "
+          << deltas.at(i).theme << std::endl;
 
-          for(i = 0; i < sfStrings.size(); i++)
+      if(fileIndex < outputStrings.size())
+        {
+          createSFOutputString(fileIndex,
+                               sfStrings.at(fileIndex),
+                               currThemes.at(fileIndex),
+                               maxCols,
+                               outputStrings.at(fileIndex));
+
+          if(fileIndex >= sfStringPos &&
+             fileIndex < sfStringPos + (int)sfStringWins.size())
             {
-              countString.clear();
-              fileString.clear();
-              themeString.clear();
-              tempString.clear();
-              countString = intToStr(i+1);
-              countString.append(". ");
-              fileString = sfStrings.at(i);
-              themeString = currThemes.at(i);
-              int totalFileLength = fileString.length() + dots.length() +
-                themeString.length() + countString.length();
-
-              if(totalFileLength > maxCols)
-                {
-                  int difference = totalFileLength - maxCols;
-                  tempString.append(dots);
-
-                  for(int j = difference + dots.length(); j < fileString.length(); j++)
-                    {
-                      char c = fileString.at(j);
-                      tempString.push_back(c);
-                    }
-
-                  tempString.append(dots);
-                  tempString.append(themeString);
-                  fileString = tempString;
-                }
-              else
-                {
-                  int dotCount = fileString.length();
-
-                  while(dotCount < maxCols - themeString.length() - countString.length())
-                    {
-                      fileString.push_back('.');
-                      dotCount++;
-                    }
-                  fileString.append(themeString);
-                }
-              countString.append(fileString);
-              outputStrings.push_back(countString);
+              isVisible = true;
             }
         }
     }
 
-  return outputStrings;
-} // end of "createSFOutputStrings"
+  return isVisible;
+} // end of "updateSFOutputStrings"
+
+
+
+/*
+  Function:
+   getSTPageSize
+
+  Description:
+   Returns the number of saved theme strings the _SAVEDTHEMESWIN can show at
+   once, laid out in columns the way the ThemeGrid places them.
 
+  Input:
+   wins                 - A reference to a const unordered map
+                          <int, CursesWindow*> type that contains pointers
+                          to all currently allocated CursesWindow objects
+                          that can be indexed by key values in the file
+                          _cursesWinConsts.hpp.
 
+  Output:
+   NONE
 
-std::vector<std::string> createSTOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
-                                               const std::vector<std::string>& stStrings,
-                                               const int& stStringPos,
-                                               std::ofstream& log)
+  Returns:
+   int                  - the number of strings on one page.
+*/
+static int getSTPageSize(const std::unordered_map<int, CursesWindow*>& wins)
 {
-  std::vector<std::string> outputStrings;
+  if(wins.at(_SAVEDTHEMESWIN)->getIsOpen() == false)
+    {
+      return 0;
+    }
+
+  int maxLines;
+  int maxCols;
 
-  if(stStrings.empty())
+  maxLines = wins.at(_SAVEDTHEMESWIN)->getNumLines();
+  maxCols = wins.at(_SAVEDTHEMESWIN)->getNumCols();
+
+  const int printableLines = maxLines - _STWINMINLINEOFFSET - _STWINMAXLINEOFFSET;
+  const int lastColOffset = maxCols - _STWINMAXCOLOFFSET - _STWINMINCOLOFFSET - _STWINMAXCOLS;
+
+  if(printableLines <= 0 || lastColOffset < 0)
     {
-      return outputStrings;
+      return 0;
     }
 
-  std::string dots = "...";
-  int maxLines = 0;
-  int maxCols = 30;
+  return printableLines * (lastColOffset / (_STWINMAXCOLS + 2) + 1);
+} // end of "getSTPageSize"
+
 
-  std::string tempString;
-  std::string fileString;
-  int i = 0;
-  int j = 0;
-  for(j = stStringPos; j < stStrings.size(); j++)
+
+/*
+  Function:
+   createSTOutputStrings
+
+  Description:
+   Formats the page of saved themes starting at stStringPos as numbered
+   strings that fit the _SAVEDTHEMESWIN columns. Only the names that are
+   visible are decoded from the library, so paging costs the same for a few
+   themes as for tens of thousands. When duplicates are collapsed, each group
+   of themes is listed once with the number of themes it hides. The strings
+   already in outputStrings are reused, so paging doesn't allocate once the
+   strings have grown to the page's lengths.
+
+  Input:
+   wins                 - A reference to a const unordered map
+                          <int, CursesWindow*> type that contains pointers
+                          to all currently allocated CursesWindow objects
+                          that can be indexed by key values in the file
+                          _cursesWinConsts.hpp.
+
+   clusters             - a reference to the constant groups of duplicate
+                          themes in the saved themes library.
+
+   stStringPos          - a reference to the list position of the first theme
+                          of the page.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   outputStrings        - a reference to a vector that receives the output
+                          strings of the page, the first one belonging to the
+                          theme at stStringPos; its strings are reused.
+
+  Returns:
+   NONE
+*/
+void createSTOutputStrings(const std::unordered_map<int, CursesWindow*>& wins,
+                           const ThemeClusters& clusters,
+                           const int& stStringPos,
+                           std::vector<std::string>& outputStrings,
+                           std::ofstream& log)
+{
+  const std::string_view dots = "...";
+  const size_t maxCols = _STWINMAXCOLS;
+
+  // the names are decoded straight into the output strings and formatted in place
+  clusters.getVisibleNames(stStringPos,
+                           getSTPageSize(wins),
+                           outputStrings);
+
+  for(size_t i = 0; i < outputStrings.size(); i++)
     {
-      fileString.clear();
-      tempString.clear();
-      fileString = intToStr(j+1);
-      fileString.append(". ");
-      fileString.append(stStrings.at(j));
+      const int clusterSize = clusters.getClusterSize(clusters.getVisible(stStringPos + i));
+      std::string& fileString = outputStrings.at(i);
+      char numberString[16];
+      char hiddenString[24];
+      size_t hiddenLength = 0;
 
-      if(maxCols < fileString.length())
+      // the number and hidden count are formatted on the stack, so only the
+      // reused output string holds the line
+      const size_t numberLength = snprintf(numberString, sizeof(numberString), "%d. ",
+                                           stStringPos + (int)i + 1);
+
+      if(clusterSize > 1)
         {
-          while( (maxCols - fileString.length()) != 3)
-            {
-              fileString.pop_back();
-            }
+          hiddenLength = snprintf(hiddenString, sizeof(hiddenString), " (+%d)", clusterSize - 1);
+        }
+
+      fileString.insert(0, numberString, numberLength);
+
+      if(fileString.length() + hiddenLength > maxCols)
+        {
+          fileString.resize(maxCols - hiddenLength - dots.length());
           fileString.append(dots);
         }
-      outputStrings.push_back(fileString);
-    }
 
-  return outputStrings;
+      fileString.append(hiddenString, hiddenLength);
+    }
 } // end of "createSTOutputStrings"
 
 
@@ -542,17 +701,13 @@ void createUserInputWin(std::unordered_map<int, CursesWindow*>& wins,
                         std::ofstream& log)
 {
   // if for some reason the _USERINPUT win exists, delete it
-  if(wins.at(_USERINPUTWIN)->getWindow() != nullptr)
+  if(wins.at(_USERINPUTWIN)->getIsOpen())
     {
       wins.at(_USERINPUTWIN)->deleteWindow();
     }
 
   // define the _USERINPUTWIN
-  wins.at(_USERINPUTWIN)->defineWindow(newwin(numLines,
-                                              numCols,
-                                              startY,
-                                              startX),
-                                       "_USERINPUTWIN",
+  wins.at(_USERINPUTWIN)->createWindow("_USERINPUTWIN",
                                        numLines,
                                        numCols,
                                        startY,
@@ -591,7 +746,7 @@ void drawBoxes(const std::unordered_map<int, CursesWindow*>& wins,
 
   for(it = wins.begin(); it != wins.end(); it++)
     {
-      wattron(it->second->getWindow(), COLOR_PAIR(_BLACK_TEXT));
+      it->second->attributesOn(COLOR_PAIR(_BLACK_TEXT));
       if((it->second->getWindowName() != "SAVEDFILE") &&
          (it->second->getWindowName() != "_PROMPTWIN")&&
          (it->second->getWindowName() != "_LARROWSAVEDFILESWIN") &&
@@ -606,12 +761,12 @@ void drawBoxes(const std::unordered_map<int, CursesWindow*>& wins,
 
           val++;
 
-          if(it->second->getWindow() != nullptr)
+          if(it->second->getIsOpen())
             {
-              box(it->second->getWindow(), ' ', ' ');
+              it->second->drawBox(' ', ' ');
             }
       }
-      wattron(it->second->getWindow(), COLOR_PAIR(_WHITE_TEXT));
+      it->second->attributesOn(COLOR_PAIR(_WHITE_TEXT));
     }
 } // end of "drawBoxes"
 
@@ -623,34 +778,13 @@ void drawSFStringBoxes(const std::unordered_map<int, CursesWindow*>& wins,
 {
   char val = '.';
 
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen())
     {
       for(int i = 0; i < sfStringWins.size(); i++)
         {
-          if(sfStringWins.at(i)->getWindow() != nullptr)
-            {
-              box(sfStringWins.at(i)->getWindow(), val, val);
-            }
-        }
-    }
-} // end of "drawBoxes"
-
-
-
-void drawSTStringBoxes(const std::unordered_map<int, CursesWindow*>& wins,
-                       const std::vector<CursesWindow*> & stStringWins,
-                       std::ofstream& log)
-{
-  char val = '.';
-
-
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
-    {
-      for(int i = 0; i < stStringWins.size(); i++)
-        {
-          if(stStringWins.at(i)->getWindow() != nullptr)
+          if(sfStringWins.at(i)->getIsOpen())
             {
-              box(stStringWins.at(i)->getWindow(), val, val);
+              sfStringWins.at(i)->drawBox(val, val);
             }
         }
     }
@@ -741,27 +875,27 @@ void definePromptTitle(std::vector<std::string>& promptStrings)
 
 /*
   Function:
-   definePromptWin
+   defineLayoutWin
 
   Description:
-   Uses the incoming numLines and numCols variable values, which contain
-   the current max number and columns of STDSCR, to determine if the
-   window being tested should be deleted or created.  This is to allow
-   dynamic window creation/deletion for any window resizing operations
-   done in the terminal.
+   Applies one solved widget of the layout table to its window. A window that
+   stays visible is resized and moved in place when its rectangle changed and
+   is only erased when it didn't, so a window is created or deleted only when
+   its visibility flips. Either way the window is left blank with normal
+   attributes, as a new window would be. A hidden widget keeps the start it
+   would have so other functions can utilize it.
 
   Input/Output:
-   wins                 - A reference to a const unordered map
+   wins                 - A reference to an unordered map
                           <int, CursesWindow*> type that contains pointers
                           to all currently allocated CursesWindow objects
                           that can be indexed by key values in the file
                           _cursesWinConsts.hpp.
   Input:
-   numLines             - a reference to a constant integer containing the current
-                          maximum number of lines of the main curses window.
+   widget               - a reference to the constant widget of the table.
 
-   numCols              - a reference to a constant integer containing the current
-                          maximum number of columns of the main curses window.
+   rect                 - a reference to the constant solved rectangle of
+                          the widget.
 
   Output:
    NONE
@@ -769,272 +903,57 @@ void definePromptTitle(std::vector<std::string>& promptStrings)
   Returns:
    NONE
 */
-void definePromptWin(std::unordered_map<int, CursesWindow*>& wins,
-                     const int& maxLines,
-                     const int& maxCols)
+static void defineLayoutWin(std::unordered_map<int, CursesWindow*>& wins,
+                            const WidgetLayout& widget,
+                            const LayoutRect& rect)
 {
-  int numLines = _PROMPTWINMAXLINES;
-  int numCols = maxCols - _PROMPTWINCOLOFFSET + 3;
-  int startY = _PROMPTWINSTARTY;
-  int startX = _PROMPTWINSTARTX;
-  bool define = true;
-
-  if(maxLines - _PROMPTWINLINEOFFSET <= _PROMPTWINMAXLINES)
-    {
-      define = false;
-    }
+  CursesWindow* win = wins.at(widget.id);
 
-  if(define == true)
+  if(rect.isVisible == false)
     {
-      // delete the current window if exists before creating a new one
-      if(wins.at(_PROMPTWIN)->getWindow() != nullptr)
+      if(win->getIsOpen())
         {
-          wins.at(_PROMPTWIN)->deleteWindow();
-          wins.at(_PROMPTWIN)->setWindow(nullptr);
+          win->deleteWindow();
         }
 
-      // create the new window
-      wins.at(_PROMPTWIN)->defineWindow(newwin(numLines,
-                                               numCols,
-                                               startY,
-                                               startX),
-                                        "_PROMPTWIN",
-                                        numLines,
-                                        numCols,
-                                        startY,
-                                        startX);
+      win->setStartY(rect.startY);
+      win->setStartX(rect.startX);
+      return;
     }
-  // the window has been resized to a bad dimension. delete it
-  else
-    {
-      if(wins.at(_PROMPTWIN)->getWindow() != nullptr)
-        {
-          wins.at(_PROMPTWIN)->deleteWindow();
-          wins.at(_PROMPTWIN)->setWindow(nullptr);
-        }
-    }
-} // end of "definePromptWin"
-
 
-
-
-/*
-  Function:
-   defineArrowWin
-
-  Description:
-   Creates windows that will function as a clickable buttons and in this case
-   will output a string that looks like a left or right arrow.
-
-  Input/Output:
-   wins                 - A reference to a const unordered map
-                          <int, CursesWindow*> type that contains pointers
-                          to all currently allocated CursesWindow objects
-                          that can be indexed by key values in the file
-                          _cursesWinConsts.hpp.
-  Input:
-   win                  - a const integer containing a string to set as the
-                          name of the objects window name variable.
-
-   startY               - a const int containing the starting line of the arrow
-                          window in respect to STDSCR.
-
-   startY               - a const int containing the starting column of the arrow
-                          window in respect to STDSCR.
-
-   numLines             - a reference to a constant integer containing the number
-                          of lines the button window should be created as.
-
-   numCols              - a reference to a constant integer containing the number
-                          of columns the button window should be crated as.
-
-
-  Output:
-   NONE
-
-  Returns:
-   NONE
-*/
-void defineArrowWin(std::unordered_map<int, CursesWindow*>& wins,
-                    const int mainWin,
-                    const int arrowWin,
-                    std::string winName,
-                    const int startY,
-                    const int startX,
-                    const int numLines,
-                    const int numCols,
-                    std::ofstream& log)
-{
-  if(wins.at(mainWin)->getWindow() != nullptr)
+  if(win->getIsOpen())
     {
-      // delete the current window if exists before creating a new one
-      if(wins.at(arrowWin)->getWindow() != nullptr)
-        {
-          wins.at(arrowWin)->deleteWindow();
-          wins.at(arrowWin)->setWindow(nullptr);
-        }
+      bool isPlaced = true;
 
-      // create the new window
-      wins.at(arrowWin)->defineWindow(newwin(numLines,
-                                             numCols,
-                                             startY,
-                                             startX),
-                                      winName,
-                                      numLines,
-                                      numCols,
-                                      startY,
-                                      startX);
-    }
-  else
-    {
-      // if for any reason the mainWin isnt allocated and an arrow is, delete it
-      if(wins.at(arrowWin)->getWindow() != nullptr)
+      // resize before moving, mvwin() fails if the old size doesn't fit at the new start
+      if(win->getNumLines() != rect.numLines || win->getNumCols() != rect.numCols)
         {
-          wins.at(arrowWin)->deleteWindow();
-          wins.at(arrowWin)->setWindow(nullptr);
+          isPlaced = win->resizeWindow(rect.numLines, rect.numCols);
         }
-    }
-} // end of "defineArrowWin"
-
-
-
-/*
-  Function:
-   defineSavedFilesWin
-
-  Description:
-   Uses the incoming numLines and numCols variable values, which contain
-   the current max number and columns of STDSCR, to determine if the
-   window being tested should be deleted or created.  This is to allow
-   dynamic window creation/deletion for any window resizing operations
-   done in the terminal.
 
-  Input/Output:
-   wins                 - A reference to a const unordered map
-                          <int, CursesWindow*> type that contains pointers
-                          to all currently allocated CursesWindow objects
-                          that can be indexed by key values in the file
-                          _cursesWinConsts.hpp.
-  Input:
-   maxLines             - a reference to a constant integer containing the current
-                          maximum number of lines of the main curses window STDSCR.
-
-   maxCols              - a reference to a constant integer containing the current
-                          maximum number of columns of the main curses window STDSCR.
-
-  Output:
-   NONE
-
-  Returns:
-   NONE
-*/
-void defineSavedFilesWin(std::unordered_map<int, CursesWindow*>& wins,
-                         const int& maxLines,
-                         const int& maxCols,
-                         std::ofstream& log)
-{
-  const int colOffset = 9;
-  const int lineOffset = 9;
-  int halfedLines = ((maxLines - _SAVEDFILESWINSTARTY) / 2) - 1;
-  int numLines = (maxLines - _PROMPTWINSTARTY) - lineOffset;
-  int startY = _SAVEDFILESWINSTARTY;
-  int startX = _SAVEDFILESWINSTARTX;
-  int numCols = maxCols - _HELPWINMINCOLS - colOffset;
-  bool colsCheck = false;
-  bool linesCheck = false;
-
-  if(numCols > _SAVEDFILESWINMINCOLS)
-    {
-      colsCheck= true;
-    }
-
-  if(_SAVEDFILESWINMINLINES < numLines - 1)
-    {
-      if(halfedLines - 1 > _SAVEDFILESWINMINLINES)
+      if(isPlaced == true &&
+         (win->getStartY() != rect.startY || win->getStartX() != rect.startX))
         {
-          linesCheck = true;
-          numLines = halfedLines;
+          isPlaced = win->moveWindow(rect.startY, rect.startX);
         }
-    }
 
-  // the window is within desired dimensions. allocate it
-  if((colsCheck == true) && (linesCheck == true))
-    {
-      // delete the current window if exists before creating a new one
-      if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+      if(isPlaced == true)
         {
-          wins.at(_SAVEDFILESWIN)->deleteWindow();
-          wins.at(_SAVEDFILESWIN)->setWindow(nullptr);
+          win->eraseWindow();
+          win->setAttributes(A_NORMAL);
+          return;
         }
-      if(wins.at(_SFPROMPTWIN)->getWindow() != nullptr)
-        {
-          wins.at(_SFPROMPTWIN)->deleteWindow();
-          wins.at(_SFPROMPTWIN)->setWindow(nullptr);
-        }
-
-      // create the new window _SAVEDFILESWIN
-      wins.at(_SAVEDFILESWIN)->defineWindow(newwin(numLines,
-                                               numCols,
-                                               startY,
-                                               startX),
-                                        "_SAVEDFILESWIN",
-                                        numLines,
-                                        numCols,
-                                        startY,
-                                        startX);
-
-      // create the new _LARROWSAVEDFILESWIN
-      defineArrowWin(wins,
-                     _SAVEDFILESWIN,
-                     _LARROWSAVEDFILESWIN,
-                     sfLeftArrow,
-                     _SAVEDFILESWINSTARTY + 2,
-                     _SAVEDFILESWINSTARTX + sfTitle.length() + 8,
-                     1,
-                     3,
-                     log);
 
-      // create the new _RARROWSAVEDFILESWIN
-      defineArrowWin(wins,
-                     _SAVEDFILESWIN,
-                     _RARROWSAVEDFILESWIN,
-                     sfRightArrow,
-                     _SAVEDFILESWINSTARTY + 2,
-                     wins.at(_LARROWSAVEDFILESWIN)->getStartX() + leftArrow.length() + 1,
-                     1,
-                     3,
-                     log);
+      win->deleteWindow();
     }
-  // the window has been resized to a bad dimension. delete it
-  else
-    {
-      wins.at(_SAVEDFILESWIN)->setStartX(startX);
-      wins.at(_SAVEDFILESWIN)->setStartY(startY);
 
-      if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
-        {
-          wins.at(_SAVEDFILESWIN)->deleteWindow();
-          wins.at(_SAVEDFILESWIN)->setWindow(nullptr);
-        }
-
-      if(wins.at(_LARROWSAVEDFILESWIN)->getWindow() != nullptr)
-        {
-          wins.at(_LARROWSAVEDFILESWIN)->deleteWindow();
-          wins.at(_LARROWSAVEDFILESWIN)->setWindow(nullptr);
-        }
+  win->createWindow(std::string(widget.name),
+                    rect.numLines,
+                    rect.numCols,
+                    rect.startY,
+                    rect.startX);
+} // end of "defineLayoutWin"
 
-      if(wins.at(_RARROWSAVEDFILESWIN)->getWindow() != nullptr)
-        {
-          wins.at(_RARROWSAVEDFILESWIN)->deleteWindow();
-          wins.at(_RARROWSAVEDFILESWIN)->setWindow(nullptr);
-        }
-      if(wins.at(_SFPROMPTWIN)->getWindow() != nullptr)
-        {
-          wins.at(_SFPROMPTWIN)->deleteWindow();
-          wins.at(_SFPROMPTWIN)->setWindow(nullptr);
-        }
-    }
-} // end of "defineSavedFilesWin"
 
 
 
@@ -1047,18 +966,17 @@ void defineSFStringWins(const std::unordered_map<int, CursesWindow*>& wins,
   // delete any windows if they exist
   for(int i = 0; i < sfStringWins.size(); i++)
     {
-      if(sfStringWins.at(i)->getWindow() != nullptr)
+      if(sfStringWins.at(i)->getIsOpen())
         {
-          werase(sfStringWins.at(i)->getWindow());
+          sfStringWins.at(i)->eraseWindow();
           sfStringWins.at(i)->deleteWindow();
-          sfStringWins.at(i)->setWindow(nullptr);
           delete sfStringWins.at(i);
         }
     }
 
   sfStringWins.clear();
 
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen())
     {
       int maxLines = wins.at(_SAVEDFILESWIN)->getNumLines();
       int maxCols = wins.at(_SAVEDFILESWIN)->getNumCols();
@@ -1073,7 +991,7 @@ void defineSFStringWins(const std::unordered_map<int, CursesWindow*>& wins,
       int i = 0;
       for(i = 0, j = outputStringPos; i < val && j < savedFileStrings.size(); i++, j++)
         {
-          CursesWindow* newWindow = new CursesWindow();
+          CursesWindow* newWindow = new CursesWindow(wins.at(_MAINWIN)->getBackend());
           sfStringWins.push_back(newWindow);
 
           int numLines = 1;
@@ -1081,11 +999,7 @@ void defineSFStringWins(const std::unordered_map<int, CursesWindow*>& wins,
           int startY = i + wins.at(_SAVEDFILESWIN)->getStartY() + _SFSWINMINLINEOFFSET;
           int startX = wins.at(_SAVEDFILESWIN)->getStartX() + _SFWINMINCOLOFFSET;
 
-          sfStringWins.at(i)->defineWindow(newwin(numLines,
-                                                  numCols,
-                                                  startY,
-                                                  startX),
-                                           "SAVEDFILE",
+          sfStringWins.at(i)->createWindow("SAVEDFILE",
                                            numLines,
                                            numCols,
                                            startY,
@@ -1104,14 +1018,11 @@ void defineSFStringWins(const std::unordered_map<int, CursesWindow*>& wins,
    defineSavedThemesWin
 
   Description:
-   Uses the incoming numLines and numCols variable values, which contain
-   the current max number and columns of STDSCR, to determine if the
-   window being tested should be deleted or created.  This is to allow
-   dynamic window creation/deletion for any window resizing operations
-   done in the terminal.
+   Defines _SAVEDTHEMESWIN and its arrow windows from the layout table for
+   a screen of the incoming size, leaving the other windows as they are.
 
   Input/Output:
-   wins                 - A reference to a const unordered map
+   wins                 - A reference to an unordered map
                           <int, CursesWindow*> type that contains pointers
                           to all currently allocated CursesWindow objects
                           that can be indexed by key values in the file
@@ -1134,484 +1045,23 @@ void defineSavedThemesWin(std::unordered_map<int, CursesWindow*>& wins,
                           const int& maxCols,
                           std::ofstream& log)
 {
-  const int colOffset = 9;
-  const int lineOffset = 9;
-  int halfedLines = ((maxLines - _SAVEDFILESWINSTARTY) / 2) - 1;
-  int numLines = ((maxLines - _SAVEDFILESWINSTARTY) / 2) - 1;
-  int startY = ((maxLines - _SAVEDFILESWINSTARTY)/2) + lineOffset;
-  int startX = _SAVEDFILESWINSTARTX;
-  int numCols = maxCols - _HELPWINMINCOLS - colOffset;;
-  bool colsCheck = false;
-  bool linesCheck = false;
-
-  if(numCols > _SAVEDTHEMESWINMINCOLS)
-    {
-      colsCheck= true;
-    }
-
-  if(_SAVEDTHEMESWINMINLINES < numLines - 1)
-    {
-      if(halfedLines > _SAVEDFILESWINMINLINES - 1)
-        {
-          linesCheck = true;
-          numLines = halfedLines;
-          if(numLines + startY == maxLines - 1)
-            {
-              numLines--;
-            }
-        }
-    }
+  LayoutRect rects[_NUMWINS];
 
-  // the window is within desired dimensions. allocate it
-  if((colsCheck == true) && (linesCheck == true))
-    {
-      // delete the current window if exists before creating a new one
-      if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
-        {
-          wins.at(_SAVEDTHEMESWIN)->deleteWindow();
-          wins.at(_SAVEDTHEMESWIN)->setWindow(nullptr);
-        }
-
-      // create the new window
-      wins.at(_SAVEDTHEMESWIN)->defineWindow(newwin(numLines,
-                                               numCols,
-                                               startY,
-                                               startX),
-                                        "_SAVEDTHEMESWIN",
-                                        numLines,
-                                        numCols,
-                                        startY,
-                                        startX);
-
-      // create the new _LARROWSAVEDFILESWIN
-      defineArrowWin(wins,
-                     _SAVEDTHEMESWIN,
-                     _LARROWSAVEDTHEMESWIN,
-                     stLeftArrow,
-                     wins.at(_SAVEDTHEMESWIN)->getStartY() + 2,
-                     wins.at(_SAVEDTHEMESWIN)->getStartX() + stTitle.length() + 8,
-                     1,
-                     3,
-                     log);
+  solveLayout(maxLines, maxCols, rects);
 
-      // create the new _RARROWSAVEDFILESWIN
-      defineArrowWin(wins,
-                     _SAVEDTHEMESWIN,
-                     _RARROWSAVEDTHEMESWIN,
-                     stRightArrow,
-                     wins.at(_SAVEDTHEMESWIN)->getStartY() + 2,
-                     wins.at(_LARROWSAVEDTHEMESWIN)->getStartX() + leftArrow.length() + 1,
-                     1,
-                     3,
-                     log);
-    }
-  // the window has been resized to a bad dimension. delete it
-  else
+  for(int i = 0; i < _NUMWIDGETS; i++)
     {
-      // update the new start positions anyway so other functions can utilize them
-      wins.at(_SAVEDTHEMESWIN)->setStartX(startX);
-      wins.at(_SAVEDTHEMESWIN)->setStartY(startY);
-
-      if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
-        {
-          wins.at(_SAVEDTHEMESWIN)->deleteWindow();
-          wins.at(_SAVEDTHEMESWIN)->setWindow(nullptr);
-        }
+      const int id = _WINLAYOUT[i].id;
 
-      if(wins.at(_LARROWSAVEDTHEMESWIN)->getWindow() != nullptr)
+      if(id == _SAVEDTHEMESWIN || id == _LARROWSAVEDTHEMESWIN || id == _RARROWSAVEDTHEMESWIN)
         {
-          wins.at(_LARROWSAVEDTHEMESWIN)->deleteWindow();
-          wins.at(_LARROWSAVEDTHEMESWIN)->setWindow(nullptr);
-        }
-
-      if(wins.at(_RARROWSAVEDTHEMESWIN)->getWindow() != nullptr)
-        {
-          wins.at(_RARROWSAVEDTHEMESWIN)->deleteWindow();
-          wins.at(_RARROWSAVEDTHEMESWIN)->setWindow(nullptr);
+          defineLayoutWin(wins, _WINLAYOUT[i], rects[id]);
         }
     }
 } // end of "defineSavedThemesWin"
 
 
 
-void defineSTStringWins(const std::unordered_map<int, CursesWindow*>& wins,
-                        std::vector<CursesWindow*>& stStringWins,
-                        const std::vector<std::string>& stStrings,
-                        const int& stStringPos,
-                        std::ofstream& log)
-{
-  // delete any stStringWins if they exist
-  for(int i = 0; i < stStringWins.size(); i++)
-    {
-      if(stStringWins.at(i)->getWindow() != nullptr)
-        {
-          werase(stStringWins.at(i)->getWindow());
-          stStringWins.at(i)->deleteWindow();
-          stStringWins.at(i)->setWindow(nullptr);
-          delete stStringWins.at(i);
-        }
-    }
-
-  stStringWins.clear();
-
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
-    {
-      int maxLines;
-      int maxCols;
-
-      getmaxyx(wins.at(_SAVEDTHEMESWIN)->getWindow(),
-               maxLines,
-               maxCols);
-
-      int printableLines = maxLines - _STWINMINLINEOFFSET - _STWINMAXLINEOFFSET;
-      int numLines = 1;
-      int numMaxCols = _STWINMAXCOLS;
-      int printColOffset = 0;
-      int printLineOffset = 0;
-      const int titleLineOffset = 4;
-
-      for(int i = 0, j = stStringPos; j < stStrings.size(); i++, j++, printLineOffset++)
-        {
-          int numCols = stStrings.at(j).length();
-
-          // reset the output line position if max printable line is reached
-          if(printLineOffset == printableLines)
-            {
-              printColOffset += numMaxCols + 2;
-              printLineOffset = 0;
-            }
-
-          // make sure not to print or create windows out of the max window range
-          if(printColOffset > maxCols  - _STWINMAXCOLOFFSET - _STWINMINCOLOFFSET - numMaxCols)
-            {
-              break;
-            }
-
-          // create the window
-          const int startY = wins.at(_SAVEDTHEMESWIN)->getStartY() + titleLineOffset +
-            printLineOffset;
-          const int startX = wins.at(_SAVEDTHEMESWIN)->getStartX() + printColOffset +
-            _STWINMINCOLOFFSET;
-
-          CursesWindow* newWindow = new CursesWindow();
-
-          stStringWins.push_back(newWindow);
-          stStringWins.at(i)->defineWindow(newwin(numLines,
-                                                  numCols,
-                                                  startY,
-                                                  startX),
-                                           "SAVEDTHEME",
-                                           numLines,
-                                           numCols,
-                                           startY,
-                                           startX);
-        }
-    }
-} // end of "defineSTStringWins"
-
-
-
-void define_HWButtons(std::unordered_map<int, CursesWindow*>& wins)
-{
-  // delete any button windows if they exist
-  for(int i = _HWSFADDFILE; i <= _HWSTVIEWTHEME; i++)
-    {
-      if(wins.at(i)->getWindow() != nullptr)
-        {
-          werase(wins.at(i)->getWindow());
-          wins.at(i)->deleteWindow();
-          wins.at(i)->setWindow(nullptr);
-        }
-    }
-
-  if(wins.at(_HELPWIN)->getWindow() != nullptr)
-    {
-      int numLines = _HWBUTTONLINES;
-      int numCols = _HWBUTTONCOLS;
-      int startY = wins.at(_HELPWIN)->getStartY() + 4;
-      int startX = wins.at(_HELPWIN)->getStartX() + 4;
-
-      // add file
-      wins.at(_HWSFADDFILE)->defineWindow(newwin(numLines,
-                                             numCols,
-                                             startY,
-                                             startX),
-                                          _hwSFAddFile,
-                                          numLines,
-                                          numCols,
-                                          startY,
-                                          startX);
-      // edd file path
-      startY += 2;
-      wins.at(_HWSFEDITFILEPATH)->defineWindow(newwin(numLines,
-                                                      numCols,
-                                                      startY,
-                                                      startX),
-                                               _hwSFEditFilePath,
-                                               numLines,
-                                               numCols,
-                                               startY,
-                                               startX);
-      // view file path
-      startY +=2;
-      wins.at(_HWSFVIEWFILEPATH)->defineWindow(newwin(numLines,
-                                                      numCols,
-                                                      startY,
-                                                      startX),
-                                             _hwSFViewFilePath,
-                                             numLines,
-                                             numCols,
-                                             startY,
-                                             startX);
-      // remove file
-      startY +=2;
-      wins.at(_HWSFREMOVEFILE)->defineWindow(newwin(numLines,
-                                                      numCols,
-                                                      startY,
-                                                      startX),
-                                             _hwSFRemoveFile,
-                                             numLines,
-                                             numCols,
-                                             startY,
-                                             startX);
-      // add theme
-      startY = wins.at(_HELPWIN)->getStartY() + 4;
-      startX = wins.at(_HWSFADDFILE)->getStartX() + wins.at(_HWSFADDFILE)->getNumCols() + 2;
-      wins.at(_HWSFADDTHEME)->defineWindow(newwin(numLines,
-                                                      numCols,
-                                                      startY,
-                                                      startX),
-                                             _hwSFAddTheme,
-                                             numLines,
-                                             numCols,
-                                             startY,
-                                             startX);
-      // edit theme
-      startY += 2;
-      wins.at(_HWSFEDITTHEME)->defineWindow(newwin(numLines,
-                                                  numCols,
-                                                  startY,
-                                                  startX),
-                                           _hwSFEditTheme,
-                                           numLines,
-                                           numCols,
-                                           startY,
-                                           startX);
-      // remove theme
-      startY += 2;
-      wins.at(_HWSFREMOVETHEME)->defineWindow(newwin(numLines,
-                                                   numCols,
-                                                   startY,
-                                                   startX),
-                                            _hwSFRemoveTheme,
-                                            numLines,
-                                            numCols,
-                                            startY,
-                                            startX);
-      // curr theme buttons
-      // add theme
-      startY = wins.at(_SAVEDTHEMESWIN)->getStartY() + 4;
-      startX = wins.at(_HELPWIN)->getStartX() + 4;
-      wins.at(_HWSTADDTHEME)->defineWindow(newwin(numLines,
-                                                   numCols,
-                                                   startY,
-                                                   startX),
-                                           _hwSTAddTheme,
-                                           numLines,
-                                           numCols,
-                                           startY,
-                                           startX);
-      // edit theme
-      startY += 2;
-      wins.at(_HWSTEDITTHEME)->defineWindow(newwin(numLines,
-                                                  numCols,
-                                                  startY,
-                                                  startX),
-                                           _hwSTEditTheme,
-                                           numLines,
-                                           numCols,
-                                           startY,
-                                           startX);
-      // remove theme
-      startY = wins.at(_SAVEDTHEMESWIN)->getStartY() + 4;
-      startX = wins.at(_HWSFADDFILE)->getStartX() + wins.at(_HWSFADDFILE)->getNumCols() + 2;
-      wins.at(_HWSTREMOVETHEME)->defineWindow(newwin(numLines,
-                                                     numCols,
-                                                     startY,
-                                                     startX),
-                                              _hwSTRemoveTheme,
-                                              numLines,
-                                              numCols,
-                                              startY,
-                                              startX);
-      // view theme
-      startY += 2;
-      wins.at(_HWSTVIEWTHEME)->defineWindow(newwin(numLines,
-                                                     numCols,
-                                                     startY,
-                                                     startX),
-                                              _hwSTViewTheme,
-                                              numLines,
-                                              numCols,
-                                              startY,
-                                              startX);
-  }
-} // end of "define_HWButtons"
-
-
-
-/*
-  Function:
-   defineHelpWin
-
-  Description:
-   Uses the incoming numLines and numCols variable values, which contain
-   the current max number and columns of STDSCR, to determine if the
-   window being tested should be deleted or created.  This is to allow
-   dynamic window creation/deletion for any window resizing operations
-   done in the terminal.
-
-  Input/Output:
-   wins                 - A reference to a const unordered map
-                          <int, CursesWindow*> type that contains pointers
-                          to all currently allocated CursesWindow objects
-                          that can be indexed by key values in the file
-                          _cursesWinConsts.hpp.
-  Input:
-   maxLines             - a reference to a constant integer containing the current
-                          maximum number of lines of the main curses window STDSCR.
-
-   maxCols              - a reference to a constant integer containing the current
-                          maximum number of columns of the main curses STDSCR.
-
-  Output:
-   NONE
-
-  Returns:
-   NONE
-*/
-void defineHelpWin(std::unordered_map<int, CursesWindow*>& wins,
-                   const int& maxLines,
-                   const int& maxCols)
-{
-  int numLines = (maxLines - _HELPWINSTARTY) - _HELPWINLINEOFFSET;
-  int numCols = _HELPWINMINCOLS;
-  int startY = _HELPWINSTARTY;
-  int startX =  maxCols - _HELPWINMINCOLS - _HELPWINCOLOFFSET;
-  bool colsCheck = false;
-  bool linesCheck = false;
-
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr &&
-     wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
-    {
-      if(_HELPWINSTARTY + _HELPWINMINLINES < maxLines - _HELPWINLINEOFFSET)
-        {
-          numLines = maxLines - _HELPWINLINEOFFSET - startY;
-          linesCheck = true;
-        }
-
-      if(maxCols > _HELPWINMINCOLS + _HELPWINCOLOFFSET)
-        {
-          colsCheck = true;
-        }
-    }
-
-  // the window is within desired dimensions. allocate it
-  if((linesCheck == true) && (colsCheck == true))
-    {
-      // delete the current window if exists before creating a new one
-      if(wins.at(_HELPWIN)->getWindow() != nullptr)
-        {
-          wins.at(_HELPWIN)->deleteWindow();
-          wins.at(_HELPWIN)->setWindow(nullptr);
-        }
-
-      // create the new window
-      wins.at(_HELPWIN)->defineWindow(newwin(numLines,
-                                             numCols,
-                                             startY,
-                                             startX),
-                                      "_HELPWIN",
-                                      numLines,
-                                      numCols,
-                                      startY,
-                                      startX);
-
-      // create the window buttons
-      define_HWButtons(wins);
-    }
-  // the window has been resized to a bad dimension. delete it
-  else
-    {
-      // update _HELPWIN start positions so other functions can utilize them
-      wins.at(_HELPWIN)->setStartX(startX);
-      wins.at(_HELPWIN)->setStartY(startY);
-
-      if(wins.at(_HELPWIN)->getWindow() != nullptr)
-        {
-          wins.at(_HELPWIN)->deleteWindow();
-          wins.at(_HELPWIN)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFADDFILE)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFADDFILE)->deleteWindow();
-          wins.at(_HWSFADDFILE)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFEDITFILEPATH)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFEDITFILEPATH)->deleteWindow();
-          wins.at(_HWSFEDITFILEPATH)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFVIEWFILEPATH)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFVIEWFILEPATH)->deleteWindow();
-          wins.at(_HWSFVIEWFILEPATH)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFREMOVEFILE)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFREMOVEFILE)->deleteWindow();
-          wins.at(_HWSFREMOVEFILE)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFADDTHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFADDTHEME)->deleteWindow();
-          wins.at(_HWSFADDTHEME)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFEDITTHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFEDITTHEME)->deleteWindow();
-          wins.at(_HWSFEDITTHEME)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSFREMOVETHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSFREMOVETHEME)->deleteWindow();
-          wins.at(_HWSFREMOVETHEME)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSTADDTHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSTADDTHEME)->deleteWindow();
-          wins.at(_HWSTADDTHEME)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSTREMOVETHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSTREMOVETHEME)->deleteWindow();
-          wins.at(_HWSTREMOVETHEME)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSTEDITTHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSTEDITTHEME)->deleteWindow();
-          wins.at(_HWSTEDITTHEME)->setWindow(nullptr);
-        }
-      if(wins.at(_HWSTVIEWTHEME)->getWindow() != nullptr)
-        {
-          wins.at(_HWSTVIEWTHEME)->deleteWindow();
-          wins.at(_HWSTVIEWTHEME)->setWindow(nullptr);
-        }
-    }
-} // end of "defineHelpWin"
-
-
-
 /*
   Function:
    defineWins
@@ -1619,7 +1069,8 @@ void defineHelpWin(std::unordered_map<int, CursesWindow*>& wins,
   Description:
    Defines the incoming wins object with starting dimension values.  This is
    intended to be used strictly with the "Main Wins" constants from the _WINS
-   enumeration structure from the _cursesWinConsts.hpp file.
+   enumeration structure from the _cursesWinConsts.hpp file.  The windows are
+   placed by solving the winLayout.hpp table for the size of STDSCR.
 
   Input/Output:
    wins                     - A reference to an unordered map <int, CursesWindow*>
@@ -1642,36 +1093,27 @@ void defineHelpWin(std::unordered_map<int, CursesWindow*>& wins,
 void defineWins(std::unordered_map<int, CursesWindow*>& wins,
                 std::ofstream& log)
 {
-  int numLines = 0;
-  int numCols = 0;
-  int startY = 0;
-  int startX = 0;
-
-  getmaxyx(stdscr, numLines, numCols);
-  wins.at(_MAINWIN)->defineWindow(stdscr,
-                                  "_MAINWIN",
-                                  numLines,
-                                  numCols,
-                                  startY,
-                                  startX);
-  wattron(wins.at(_MAINWIN)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-  box(wins.at(_MAINWIN)->getWindow(), ' ', ' ');
-  wattron(wins.at(_MAINWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-
-  definePromptWin(wins,
-                  numLines,
-                  numCols);
-  defineSavedFilesWin(wins,
-                      numLines,
-                      numCols,
-                      log);
-  defineSavedThemesWin(wins,
-                       numLines,
-                       numCols,
-                       log);
-  defineHelpWin(wins,
-                numLines,
-                numCols);
+  LayoutRect rects[_NUMWINS];
+
+  wins.at(_MAINWIN)->createScreenWindow("_MAINWIN");
+  wins.at(_MAINWIN)->attributesOn(COLOR_PAIR(_BLACK_TEXT));
+  wins.at(_MAINWIN)->drawBox(' ', ' ');
+  wins.at(_MAINWIN)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
+
+  solveLayout(wins.at(_MAINWIN)->getNumLines(),
+              wins.at(_MAINWIN)->getNumCols(),
+              rects);
+
+  for(int i = 0; i < _NUMWIDGETS; i++)
+    {
+      defineLayoutWin(wins, _WINLAYOUT[i], rects[_WINLAYOUT[i].id]);
+    }
+
+  // the saved file prompt is placed from _SAVEDFILESWIN, which was just redefined
+  if(wins.at(_SFPROMPTWIN)->getIsOpen())
+    {
+      wins.at(_SFPROMPTWIN)->deleteWindow();
+    }
 }  // end of "defineWins"
 
 
@@ -1680,31 +1122,26 @@ void defineSFPromptWin(std::unordered_map<int, CursesWindow*>& wins,
                        std::ofstream& log)
 {
   // check that the main windows are initialized
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr &&
-     wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen() &&
+     wins.at(_SAVEDTHEMESWIN)->getIsOpen())
     {
       int numLines = 4;
       int numCols = wins.at(_SAVEDFILESWIN)->getNumCols() - 4;
       int startY = wins.at(_SAVEDFILESWIN)->getStartY() + numLines;
       int startX = _SAVEDFILESWINSTARTX + 2;
       
-      wins.at(_SFPROMPTWIN)->defineWindow(newwin(numLines,
-                                                    numCols,
-                                                    startY,
-                                                    startX),
-                                             "_SFPROMPTWIN",
-                                             numLines,
-                                             numCols,
-                                             startY,
-                                             startX);
+      wins.at(_SFPROMPTWIN)->createWindow("_SFPROMPTWIN",
+                                          numLines,
+                                          numCols,
+                                          startY,
+                                          startX);
     }
   else 
     {
       // ensure the window doesn't exist if the main windows dont exist
-      if(wins.at(_SFPROMPTWIN)->getWindow() != nullptr)
+      if(wins.at(_SFPROMPTWIN)->getIsOpen())
         {
           wins.at(_SFPROMPTWIN)->deleteWindow();
-          wins.at(_SFPROMPTWIN)->setWindow(nullptr);
         }
     }
 
@@ -1713,9 +1150,66 @@ void defineSFPromptWin(std::unordered_map<int, CursesWindow*>& wins,
 
 
 
+/*
+  Function:
+   findPreviewPalette
+
+  Description:
+   Finds the palette of the saved theme at the incoming index. A palette
+   stored in the library, such as an imported theme's, is unpacked the first
+   time it is previewed and kept with the others.
+
+  Input/Output:
+   palettes             - a reference to a map of theme names to their
+                          palettes.
+
+  Input:
+   library              - a reference to the constant saved themes library.
+
+   stPreviewNum         - the index in the library of the theme to preview, or
+                          -1 if none is selected.
+
+  Output:
+   NONE
+
+  Returns:
+   const Palette*       - a pointer to the theme's palette, or nullptr if no
+                          theme is selected or the theme has no palette.
+*/
+const Palette* findPreviewPalette(std::unordered_map<std::string, Palette>& palettes,
+                                  const ThemeLibrary& library,
+                                  const int stPreviewNum)
+{
+  if(stPreviewNum < 0 || stPreviewNum >= library.getNumEntries())
+    {
+      return nullptr;
+    }
+
+  const std::string name = library.at(stPreviewNum);
+  std::unordered_map<std::string, Palette>::const_iterator it = palettes.find(name);
+  std::string packed;
+
+  if(it != palettes.end())
+    {
+      return &it->second;
+    }
+
+  Palette palette(name);
+
+  if(library.getValue(stPreviewNum, packed) == false || packed.empty() ||
+     palette.unpack(packed) == false)
+    {
+      return nullptr;
+    }
+
+  return &palettes.insert(std::make_pair(name, palette)).first->second;
+} // end of "findPreviewPalette"
+
+
+
 void flashButton(const std::unordered_map<int, CursesWindow*>& wins,
                  const int win,
-                 std::string outString,
+                 const std::string_view outString,
                  const int colorStart,
                  const int colorFlash,
                  std::ofstream& log)
@@ -1725,8 +1219,8 @@ void flashButton(const std::unordered_map<int, CursesWindow*>& wins,
                  outString,
                  colorFlash,
                  log);
-  wnoutrefresh(wins.at(win)->getWindow());
-  doupdate();
+  wins.at(win)->stageWindow();
+  wins.at(win)->getBackend()->update();
   usleep(40000);
   printButtonWin(wins,
                  win,
@@ -1796,7 +1290,8 @@ void initializeCurses()
    NONE
 
   Input:
-   NONE
+   backend                  - A reference to the RenderBackend every window
+                              draws through.
 
   Output:
    NONE
@@ -1805,11 +1300,12 @@ void initializeCurses()
    NONE
 */
 void initializeWins(std::unordered_map<int, CursesWindow*>& wins,
+                    RenderBackend& backend,
                     std::ofstream& log)
 {
   for(int i = _MAINWIN; i <= _USERINPUTWIN; i++)
     {
-      CursesWindow* newWindow = new CursesWindow();
+      CursesWindow* newWindow = new CursesWindow(&backend);
       wins.insert(std::make_pair(i, newWindow));
     }
 } // end of "initializeWins"
@@ -1819,15 +1315,14 @@ void initializeWins(std::unordered_map<int, CursesWindow*>& wins,
 
 void printButtonWin(const std::unordered_map<int, CursesWindow*>& wins,
                     const int win,
-                    std::string outString,
+                    const std::string_view outString,
                     const int colorPair,
                     std::ofstream& log)
 {
-  wattron(wins.at(win)->getWindow(), COLOR_PAIR(colorPair));
-  mvwaddstr(wins.at(win)->getWindow(),
-            0,
-            0,
-            outString.c_str());
+  wins.at(win)->attributesOn(COLOR_PAIR(colorPair));
+  wins.at(win)->printString(0,
+                            0,
+                            outString);
 } // end of "printButtonWin"
 
 
@@ -1835,16 +1330,15 @@ void printButtonWin(const std::unordered_map<int, CursesWindow*>& wins,
 void printHelpWin(std::unordered_map<int, CursesWindow*>& wins,
                   std::ofstream& log)
 {
-  if(wins.at(_HELPWIN)->getWindow() != nullptr)
+  if(wins.at(_HELPWIN)->getIsOpen())
     {
-      wattron(wins.at(_HELPWIN)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-      box(wins.at(_HELPWIN)->getWindow(), ' ', ' ');
-      wattron(wins.at(_HELPWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
+      wins.at(_HELPWIN)->attributesOn(COLOR_PAIR(_BLACK_TEXT));
+      wins.at(_HELPWIN)->drawBox(' ', ' ');
+      wins.at(_HELPWIN)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
       int maxWinLines;
       int maxWinCols;
-      getmaxyx(wins.at(_HELPWIN)->getWindow(),
-               maxWinLines,
-               maxWinCols);
+      maxWinLines = wins.at(_HELPWIN)->getNumLines();
+      maxWinCols = wins.at(_HELPWIN)->getNumCols();
 
       int printColPosition;
       std::string filesCount;
@@ -1852,108 +1346,191 @@ void printHelpWin(std::unordered_map<int, CursesWindow*>& wins,
       int linePosition = wins.at(_HELPWIN)->getStartY() + 2;
 
       std::vector<std::string>::const_iterator it;
-      std::string outString;
+      std::string_view outString;
 
       // print win title
-      if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+      if(wins.at(_SAVEDFILESWIN)->getIsOpen())
         {
           int sfLineOffset = 2;
           int sfColOffset = 3;
 
           // sf titles
-          wattron(wins.at(_HELPWIN)->getWindow(), A_BOLD);
+          wins.at(_HELPWIN)->attributesOn(A_BOLD);
           outString = sfTitle;
-          mvwaddstr(wins.at(_HELPWIN)->getWindow(),
-                    sfLineOffset,
-                    sfColOffset,
-                    outString.c_str());
+          wins.at(_HELPWIN)->printString(sfLineOffset,
+                                         sfColOffset,
+                                         outString);
           outString = sfThemeTitle;
           sfColOffset += _HWBUTTONCOLS + 2;
-          mvwaddstr(wins.at(_HELPWIN)->getWindow(),
-                    sfLineOffset,
-                    sfColOffset,
-                    outString.c_str());
-          wattroff(wins.at(_HELPWIN)->getWindow(), A_BOLD);
+          wins.at(_HELPWIN)->printString(sfLineOffset,
+                                         sfColOffset,
+                                         outString);
+          wins.at(_HELPWIN)->attributesOff(A_BOLD);
 
           // sf buttons
-          printButtonWin(wins,
-                         _HWSFADDFILE,
-                         _hwSFAddFile,
-                         _BLACK_TEXT,
-                         log);
-
-          printButtonWin(wins,
-                         _HWSFEDITFILEPATH,
-                         _hwSFEditFilePath,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSFVIEWFILEPATH,
-                         _hwSFViewFilePath,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSFREMOVEFILE,
-                         _hwSFRemoveFile,
-                         _BLACK_TEXT,
-                         log);
-
-          printButtonWin(wins,
-                         _HWSFADDTHEME,
-                         _hwSFAddTheme,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSFEDITTHEME,
-                         _hwSFEditTheme,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSFREMOVETHEME,
-                         _hwSFRemoveTheme,
-                         _BLACK_TEXT,
-                         log);
+          for(int i = _HWSFADDFILE; i <= _HWSFREMOVETHEME; i++)
+            {
+              printButtonWin(wins,
+                             i,
+                             findWidgetLabel(i),
+                             _BLACK_TEXT,
+                             log);
+            }
       }
 
-      if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
+      if(wins.at(_SAVEDTHEMESWIN)->getIsOpen())
         {
           int stLineOffset = wins.at(_SAVEDTHEMESWIN)->getStartY() - _HELPWINSTARTY + 2;
           int stColOffset = 3;
           // saved theme
-          wattron(wins.at(_HELPWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-          wattron(wins.at(_HELPWIN)->getWindow(), A_BOLD);
+          wins.at(_HELPWIN)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
+          wins.at(_HELPWIN)->attributesOn(A_BOLD);
           outString = stTitle;
-          mvwaddstr(wins.at(_HELPWIN)->getWindow(),
-                    stLineOffset,
-                    stColOffset,
-                    outString.c_str());
-          wattroff(wins.at(_HELPWIN)->getWindow(), A_BOLD);
-          printButtonWin(wins,
-                         _HWSTADDTHEME,
-                         _hwSTAddTheme,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSTREMOVETHEME,
-                         _hwSTRemoveTheme,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSTEDITTHEME,
-                         _hwSTEditTheme,
-                         _BLACK_TEXT,
-                         log);
-          printButtonWin(wins,
-                         _HWSTVIEWTHEME,
-                         _hwSTViewTheme,
-                         _BLACK_TEXT,
-                         log);
+          wins.at(_HELPWIN)->printString(stLineOffset,
+                                         stColOffset,
+                                         outString);
+          wins.at(_HELPWIN)->attributesOff(A_BOLD);
+          for(int i = _HWSTADDTHEME; i <= _HWSTVIEWTHEME; i++)
+            {
+              printButtonWin(wins,
+                             i,
+                             findWidgetLabel(i),
+                             _BLACK_TEXT,
+                             log);
+            }
         }
     }
 } // end of "printHelpWin"
 
 
 
+/*
+  Function:
+   printPreviewWin
+
+  Description:
+   Prints a preview of the incoming palette to the _PREVIEWWIN buffer: the
+   theme name in its default colors, a swatch of each of the 16 ANSI colors
+   and a few lines of sample terminal text. Color pairs come from colorPairs,
+   so previewing one theme after another reuses the pairs of colors the themes
+   share.
+
+  Input/Output:
+   wins                 - A reference to a const unordered map
+                          <int, CursesWindow*> type that contains pointers
+                          to all currently allocated CursesWindow objects
+                          that can be indexed by key values in the file
+                          _cursesWinConsts.hpp.
+
+   colorPairs           - a reference to the allocator the color pairs are
+                          taken from.
+  Input:
+   palette              - a pointer to the constant palette to preview, or
+                          nullptr if no theme is selected.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void printPreviewWin(const std::unordered_map<int, CursesWindow*>& wins,
+                     const Palette* palette,
+                     ColorPairAllocator& colorPairs,
+                     std::ofstream& log)
+{
+  if(wins.at(_PREVIEWWIN)->getIsOpen() == false)
+    {
+      return;
+    }
+
+  CursesWindow* win = wins.at(_PREVIEWWIN);
+  const int maxLines = win->getNumLines();
+  const int maxCols = win->getNumCols();
+
+  if(palette == nullptr || palette->getNumColors() < _ANSICOLORS)
+    {
+      win->setBackground(COLOR_PAIR(_WHITE_TEXT));
+      win->eraseWindow();
+      win->printString(0, 0, std::string_view("Select a saved theme to preview it.").substr(0, maxCols));
+      return;
+    }
+
+  // themes without default text colors use white on black
+  uint32_t foreground = palette->getColor(7);
+  uint32_t background = palette->getColor(0);
+
+  if(palette->getNumColors() >= _THEMEPALETTESIZE)
+    {
+      foreground = palette->getColor(_PALETTEFOREGROUND);
+      background = palette->getColor(_PALETTEBACKGROUND);
+    }
+
+  const int textPair = colorPairs.getPair(foreground, background);
+
+  win->setBackground(COLOR_PAIR(textPair));
+  win->eraseWindow();
+
+  // theme name
+  win->attributesOn(COLOR_PAIR(textPair) | A_BOLD);
+  win->printString(0, 1, std::string_view(palette->getName()).substr(0, maxCols - 1));
+  win->attributesOff(A_BOLD);
+
+  // normal and bright swatches
+  for(int i = 0; i < (int)_ANSICOLORS; i++)
+    {
+      const int line = 2 + i / 8;
+      const int col = 1 + (i % 8) * _PREVIEWSWATCHCOLS;
+
+      if(line >= maxLines || col + (int)_PREVIEWSWATCHCOLS > maxCols)
+        {
+          continue;
+        }
+
+      win->attributesOn(COLOR_PAIR(colorPairs.getPair(foreground, palette->getColor(i))));
+      win->printString(line, col, std::string_view("    ").substr(0, _PREVIEWSWATCHCOLS - 1));
+    }
+
+  // sample text, one run of text per palette color
+  const struct {
+    int line;
+    int color;
+    const char* text;
+  } samples[] = {
+    { 5, 2, "user@host" }, { 5, -1, ":" }, { 5, 4, "~/themes" }, { 5, -1, "$ ls" },
+    { 6, 12, "dotfiles/ " }, { 6, -1, "notes.txt " }, { 6, 10, "switch.sh" },
+    { 7, 1, "error: " }, { 7, -1, "no such theme" },
+    { 8, 3, "warning: " }, { 8, -1, "file changed on disk" },
+    { 9, 5, "const " }, { 9, 6, "int " }, { 9, -1, "lines = " }, { 9, 11, "42" },
+    { 9, 8, "; // comment" }
+  };
+  int col = 1;
+
+  for(size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+    {
+      if(i == 0 || samples[i].line != samples[i - 1].line)
+        {
+          col = 1;
+        }
+
+      if(samples[i].line >= maxLines || col >= maxCols)
+        {
+          continue;
+        }
+
+      const uint32_t color = samples[i].color < 0 ? foreground :
+        palette->getColor(samples[i].color);
+
+      win->attributesOn(COLOR_PAIR(colorPairs.getPair(color, background)));
+      win->printString(samples[i].line, col, std::string_view(samples[i].text).substr(0, maxCols - col));
+      col += strlen(samples[i].text);
+    }
+
+  win->attributesOn(COLOR_PAIR(textPair));
+} // end of "printPreviewWin"
+
+
+
 /*
   Function:
    printNumberedStrings
@@ -2000,13 +1577,12 @@ void printHelpWin(std::unordered_map<int, CursesWindow*>& wins,
 void printNumberedStrings(std::unordered_map<int, CursesWindow*>& wins,
                           std::ofstream& log)
 {
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen())
     {
       int maxWinLines;
       int maxWinCols;
-      getmaxyx(wins.at(_SAVEDFILESWIN)->getWindow(),
-               maxWinLines,
-               maxWinCols);
+      maxWinLines = wins.at(_SAVEDFILESWIN)->getNumLines();
+      maxWinCols = wins.at(_SAVEDFILESWIN)->getNumCols();
 
       std::string fileCount;
 
@@ -2016,10 +1592,9 @@ void printNumberedStrings(std::unordered_map<int, CursesWindow*>& wins,
           fileCount = intToStr(i + 1);
           fileCount.append(". ");
 
-          mvwaddstr(wins.at(_SAVEDFILESWIN)->getWindow(),
-                    i + _SFWINMINLINEOFFSET + 2,
-                    _SFWINMINCOLOFFSET,
-                    fileCount.c_str());
+          wins.at(_SAVEDFILESWIN)->printString(i + _SFWINMINLINEOFFSET + 2,
+                                               _SFWINMINCOLOFFSET,
+                                               fileCount);
         }
     }
 } // end of "printNumberedStrings"
@@ -2028,19 +1603,18 @@ void printNumberedStrings(std::unordered_map<int, CursesWindow*>& wins,
 
 void printPrompt(std::unordered_map<int, CursesWindow*>& wins,
                  const int win,
-                 const std::string& prompt,
+                 const std::string_view prompt,
                  std::ofstream& log)
 {
-  wattron(wins.at(win)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-  box(wins.at(win)->getWindow(), ' ', ' ');
-  wattron(wins.at(win)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-
-  mvwaddstr(wins.at(win)->getWindow(),
-            1,
-            1,
-            prompt.c_str());
-  wrefresh(wins.at(win)->getWindow());
-  doupdate;
+  wins.at(win)->attributesOn(COLOR_PAIR(_BLACK_TEXT));
+  wins.at(win)->drawBox(' ', ' ');
+  wins.at(win)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
+
+  wins.at(win)->printString(1,
+                            1,
+                            prompt);
+  wins.at(win)->stageWindow();
+  wins.at(win)->getBackend()->update();
 } // end of "printPrompt"
 
 
@@ -2083,30 +1657,23 @@ void printPromptWin(const std::unordered_map<int, CursesWindow*>& wins,
                     const int& mouseCol,
                     std::ofstream& log)
 {
-  if(wins.at(_PROMPTWIN)->getWindow() != nullptr)
+  if(wins.at(_PROMPTWIN)->getIsOpen())
     {
       int i = 0;
       std::vector<std::string>::const_iterator it;
-      std::string outString;
       const int offset = 6;
 
-      wattron(wins.at(_PROMPTWIN)->getWindow(), A_BOLD);
+      wins.at(_PROMPTWIN)->attributesOn(A_BOLD);
       for(it = promptStrings.begin(); it != promptStrings.end(); i++, it++)
         {
-          outString = *it;
-          const int temp = wins.at(_MAINWIN)->getStartX();
-
-          if(outString.length() >= currCols - offset)
-            {
-              outString.resize(currCols - offset);
-            }
+          // print the line cut to the screen width in place of a cut copy
+          const int length = std::min((int)it->length(), std::max(currCols - offset, 0));
 
-          mvwaddstr(wins.at(_PROMPTWIN)->getWindow(),
-                    i,
-                    0,
-                    outString.c_str());
+          wins.at(_PROMPTWIN)->printString(i,
+                                           0,
+                                           std::string_view(*it).substr(0, length));
         }
-      wattroff(wins.at(_PROMPTWIN)->getWindow(), A_BOLD);
+      wins.at(_PROMPTWIN)->attributesOff(A_BOLD);
     }
 } // end of "printPromptWin"
 
@@ -2138,32 +1705,31 @@ void printPromptWin(const std::unordered_map<int, CursesWindow*>& wins,
 */
 void printSavedFilesStrings(std::unordered_map<int, CursesWindow*>& wins,
                             std::vector<CursesWindow*>& sfStringWins,
-                            std::vector<std::string> sfStrings,
+                            const std::vector<std::string>& sfStrings,
                             const int& sfStringPos,
                             const int& currStartWin,
                             const int& highlightWinNum,
                             std::ofstream& log)
 {
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen())
     {
       int j = sfStringPos;
       for(int i = 0; i < sfStringWins.size() && j < sfStrings.size(); i++, j++)
         {
-          if(sfStringWins.at(i)->getWindow() != nullptr)
+          if(sfStringWins.at(i)->getIsOpen())
             {
               if(highlightWinNum == i)
                 {
-                  wattron(sfStringWins.at(i)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
+                  sfStringWins.at(i)->attributesOn(COLOR_PAIR(_BLACK_TEXT));
                 }
               else
                 {
-                  wattron(sfStringWins.at(i)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
+                  sfStringWins.at(i)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
                 }
 
-              mvwaddstr(sfStringWins.at(i)->getWindow(),
-                        0,
-                        0,
-                        sfStrings.at(j).c_str());
+              sfStringWins.at(i)->printString(0,
+                                              0,
+                                              sfStrings.at(j));
             }
         }
     }
@@ -2198,16 +1764,15 @@ void printSavedFilesStrings(std::unordered_map<int, CursesWindow*>& wins,
 void printSavedFilesWin(std::unordered_map<int, CursesWindow*>& wins,
                         std::ofstream& log)
 {
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen())
     {
-      wattron(wins.at(_SAVEDFILESWIN)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-      box(wins.at(_SAVEDFILESWIN)->getWindow(), ' ', ' ');
-      wattron(wins.at(_SAVEDFILESWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
+      wins.at(_SAVEDFILESWIN)->attributesOn(COLOR_PAIR(_BLACK_TEXT));
+      wins.at(_SAVEDFILESWIN)->drawBox(' ', ' ');
+      wins.at(_SAVEDFILESWIN)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
       int maxWinLines;
       int maxWinCols;
-      getmaxyx(wins.at(_SAVEDFILESWIN)->getWindow(),
-               maxWinLines,
-               maxWinCols);
+      maxWinLines = wins.at(_SAVEDFILESWIN)->getNumLines();
+      maxWinCols = wins.at(_SAVEDFILESWIN)->getNumCols();
 
       int printColPosition;
       std::string filesCount;
@@ -2215,26 +1780,24 @@ void printSavedFilesWin(std::unordered_map<int, CursesWindow*>& wins,
       int linePosition = wins.at(_SAVEDFILESWIN)->getStartY() + 2;
 
       std::vector<std::string>::const_iterator it;
-      std::string outString;
+      std::string_view outString;
       int i = 0;
 
       // print win title
-      wattron(wins.at(_SAVEDFILESWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-      wattron(wins.at(_SAVEDFILESWIN)->getWindow(), A_BOLD);
+      wins.at(_SAVEDFILESWIN)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
+      wins.at(_SAVEDFILESWIN)->attributesOn(A_BOLD);
       outString = sfTitle;
-      mvwaddstr(wins.at(_SAVEDFILESWIN)->getWindow(),
-                i + _SFWINMINLINEOFFSET,
-                _SFWINMINCOLOFFSET,
-                outString.c_str());
+      wins.at(_SAVEDFILESWIN)->printString(i + _SFWINMINLINEOFFSET,
+                                           _SFWINMINCOLOFFSET,
+                                           outString);
 
       // print current theme title
       outString = sfThemeTitle;
       printColPosition = maxWinCols - outString.length() - _SFWINMINCOLOFFSET;
-      mvwaddstr(wins.at(_SAVEDFILESWIN)->getWindow(),
-                i + _SFWINMINLINEOFFSET,
-                maxWinCols - outString.length() - _SFWINMINCOLOFFSET,
-                outString.c_str());
-      wattroff(wins.at(_SAVEDFILESWIN)->getWindow(), A_BOLD);
+      wins.at(_SAVEDFILESWIN)->printString(i + _SFWINMINLINEOFFSET,
+                                           maxWinCols - outString.length() - _SFWINMINCOLOFFSET,
+                                           outString);
+      wins.at(_SAVEDFILESWIN)->attributesOff(A_BOLD);
 
       // print the arrow windows for _SAVEDFILESWIN
       printButtonWin(wins,
@@ -2253,85 +1816,6 @@ void printSavedFilesWin(std::unordered_map<int, CursesWindow*>& wins,
 
 
 
-/*
-  Function:
-   printSavedThemeStrings
-
-  Description:
-   Prints the incoming vector of strings as a numbered list to the window buffer
-   based on the provided incoming offset values. If the maximum window length is
-   reached, the printing continues at a new column offset back at the starting
-   line number.
-
-  Input/Output:
-   wins                     - A reference to a const unordered map
-                              <int, CursesWindow*> type that contains pointers
-                              to all currently allocated CursesWindow objects
-                              that can be indexed by key values in the file
-                              _cursesWinConsts.hpp.
-  Input:
-   strings                  - a reference to to a constant vector of strings
-                              to be printed to the window buffer in numbered
-                              ascending order.
-
-   lineMaxOffest            - a reference to a constant int type that contains
-                              a value used as a offset to subtract from the
-                              current windows maximum number of lines
-                              available.
-
-   colMaxOffest             - a reference to a constant int type that contains
-                              a value used as a offset to subtract from the
-                              current windows maximum number of columns
-                              available.
-
-   lineMinOffest            - a reference to a constant int type that contains
-                              a value used as an offset to the starting line
-                              of the window (which should be zero).
-
-   colMinOffset             - a reference to a constant int type that contains
-                              a value used as an offset to the starting column
-                              of the window (which should be zero).
-
-  Output:
-   NONE
-
-  Returns:
-   NONE
-*/
-void printSavedThemesStrings(const std::unordered_map<int, CursesWindow*>& wins,
-                             std::vector<CursesWindow*>& stStringWins,
-                             const std::vector<std::string>& stStrings,
-                             const int& stStringPos,
-                             const int& stHighlightNum,
-                             std::ofstream& log)
-{
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
-    {
-      int j = stStringPos;
-      for(int i = 0; i < stStringWins.size() && j < stStrings.size(); i++, j++)
-        {
-          if(stStringWins.at(i)->getWindow() != nullptr)
-            {
-              if(stHighlightNum == i)
-                {
-                  wattron(stStringWins.at(i)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-                }
-              else
-                {
-                  wattron(stStringWins.at(i)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-                }
-
-              mvwaddstr(stStringWins.at(i)->getWindow(),
-                        0,
-                        0,
-                        stStrings.at(j).c_str());
-            }
-        }
-    }
-} // end of "printSavedThemesStrings"
-
-
-
 /*
   Function:
    printSavedThemesWin
@@ -2358,31 +1842,29 @@ void printSavedThemesStrings(const std::unordered_map<int, CursesWindow*>& wins,
 void printSavedThemesWin(const std::unordered_map<int, CursesWindow*>& wins,
                          std::ofstream& log)
 {
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr)
+  if(wins.at(_SAVEDTHEMESWIN)->getIsOpen())
     {
-      wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-      box(wins.at(_SAVEDTHEMESWIN)->getWindow(), ' ', ' ');
-      wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
+      wins.at(_SAVEDTHEMESWIN)->attributesOn(COLOR_PAIR(_BLACK_TEXT));
+      wins.at(_SAVEDTHEMESWIN)->drawBox(' ', ' ');
+      wins.at(_SAVEDTHEMESWIN)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
 
       const int maxStringSize = 31;
       const int lineCount = 0;
       int maxWinLines;
       int maxWinCols;
-      getmaxyx(wins.at(_SAVEDTHEMESWIN)->getWindow(),
-               maxWinLines,
-               maxWinCols);
+      maxWinLines = wins.at(_SAVEDTHEMESWIN)->getNumLines();
+      maxWinCols = wins.at(_SAVEDTHEMESWIN)->getNumCols();
 
       int linePosition = wins.at(_SAVEDTHEMESWIN)->getStartY() + 2 + lineCount;
       std::vector<std::string>::const_iterator it;
-      std::string outString;
+      std::string_view outString;
 
-      wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), A_BOLD);
+      wins.at(_SAVEDTHEMESWIN)->attributesOn(A_BOLD);
       outString = stTitle;
-      mvwaddstr(wins.at(_SAVEDTHEMESWIN)->getWindow(),
-                _STWINMINLINEOFFSET,
-                _STWINMINCOLOFFSET,
-                outString.c_str());
-      wattroff(wins.at(_SAVEDTHEMESWIN)->getWindow(), A_BOLD);
+      wins.at(_SAVEDTHEMESWIN)->printString(_STWINMINLINEOFFSET,
+                                            _STWINMINCOLOFFSET,
+                                            outString);
+      wins.at(_SAVEDTHEMESWIN)->attributesOff(A_BOLD);
       printButtonWin(wins,
                      _LARROWSAVEDTHEMESWIN,
                      leftArrow,
@@ -2406,9 +1888,10 @@ void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
                     const int& stringIndex,
                     const int& yOffset,
                     int& xOffset,
+                    FrameArena& arena,
                     std::ofstream& log)
 {
-  std::string tempString;
+  FrameString tempString(arena.getResource());
   int tempLen;
 
   // enter on ascii user input in range 32-126
@@ -2424,7 +1907,7 @@ void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
       else
         {
           // append the character to the beginning/middle of the string at offset
-          tempString  = outputString;
+          tempString.assign(outputString.begin(), outputString.end());
           tempLen = tempString.length() + stringIndex;
           tempString.resize(tempLen);
           tempString.push_back(userInput);
@@ -2435,7 +1918,7 @@ void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
               tempString.push_back(outputString.at(i));
             }
 
-          outputString = tempString;
+          outputString.assign(tempString.begin(), tempString.end());
       }
       xOffset++;
     }
@@ -2450,7 +1933,7 @@ void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
         }
       else
         {
-          tempString  = outputString;
+          tempString.assign(outputString.begin(), outputString.end());
           tempLen = tempString.length() + stringIndex;
 
           // enter if the offset is in the bounds of the string
@@ -2467,17 +1950,16 @@ void printUserInput(const std::unordered_map<int, CursesWindow*>& wins,
                   tempString.push_back(outputString.at(i));
                 }
 
-              outputString = tempString;
+              outputString.assign(tempString.begin(), tempString.end());
             }
         }
     }
 
-  werase(wins.at(_USERINPUTWIN)->getWindow());
-  mvwaddstr(wins.at(_USERINPUTWIN)->getWindow(),
-            0,
-            0,
-            outputString.c_str());
-  wmove(wins.at(_USERINPUTWIN)->getWindow(), 0, xOffset);
+  wins.at(_USERINPUTWIN)->eraseWindow();
+  wins.at(_USERINPUTWIN)->printString(0,
+                                      0,
+                                      outputString);
+  wins.at(_USERINPUTWIN)->moveCursor(0, xOffset);
 } // end of "printUserInput"
 
 
@@ -2487,23 +1969,9 @@ void refreshSFStringWins(const std::vector<CursesWindow*>& sfStringWins,
 {
   for(int i = 0; i < sfStringWins.size(); i++)
     {
-      if(sfStringWins.at(i)->getWindow() != nullptr)
-        {
-          wnoutrefresh(sfStringWins.at(i)->getWindow());
-        }
-    }
-} // end of "refreshSFStringWins"
-
-
-
-void refreshSTStringWins(const std::vector<CursesWindow*>& stStringWins,
-                         std::ofstream& log)
-{
-  for(int i = 0; i < stStringWins.size(); i++)
-    {
-      if(stStringWins.at(i)->getWindow() != nullptr)
+      if(sfStringWins.at(i)->getIsOpen())
         {
-          wnoutrefresh(stStringWins.at(i)->getWindow());
+          sfStringWins.at(i)->stageWindow();
         }
     }
 } // end of "refreshSFStringWins"
@@ -2536,42 +2004,151 @@ void refreshSTStringWins(const std::vector<CursesWindow*>& stStringWins,
 */
 void refreshWins(const std::unordered_map<int, CursesWindow*>& wins)
 {
+  // the keys are the whole _WINS range, so walking it refreshes the
+  // initialized windows in ascending order without gathering and sorting them
+  for(int i = _MAINWIN; i < _NUMWINS; i++)
+    {
+      if(wins.at(i)->getIsOpen())
+        {
+          wins.at(i)->stageWindow();
+        }
+    }
+} // end of "refreshWins"
 
-  // ##
-  std::unordered_map<int, CursesWindow*>::const_iterator it;
-  std::vector<int> tempMainWins;
 
-  // store all currently initialized window indexes
-  for(it = wins.begin(); it != wins.end(); it++)
+
+/*
+  Function:
+   scrollSFLines
+
+  Description:
+   Scrolls the saved file lines by a number of lines, stopping at the first
+   and last line. The line windows are moved up or down in place and only
+   the lines scrolled in are printed; the windows are rebuilt only when the
+   scroll is a page or more, or the page isn't full.
+
+  Input/Output:
+   sfStringWins             - a reference to the vector of the allocated
+                              saved file line windows.
+
+   sfStringPos              - a reference to the index of the saved file
+                              shown on the first line.
+
+  Input:
+   wins                     - A reference to a const unordered map
+                              <int, CursesWindow*> type that contains pointers
+                              to all currently allocated CursesWindow objects
+                              that can be indexed by key values in the file
+                              _cursesWinConsts.hpp.
+
+   outputStrings            - a reference to a constant vector of the
+                              formatted saved file lines.
+
+   numLines                 - the number of lines to scroll, negative to
+                              scroll toward the first line.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                     - true if the saved file lines moved.
+*/
+bool scrollSFLines(const std::unordered_map<int, CursesWindow*>& wins,
+                   std::vector<CursesWindow*>& sfStringWins,
+                   const std::vector<std::string>& outputStrings,
+                   int& sfStringPos,
+                   const int numLines,
+                   std::ofstream& log)
+{
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen() == false ||
+     outputStrings.empty() || numLines == 0)
+    {
+      return false;
+    }
+
+  const int startY = wins.at(_SAVEDFILESWIN)->getStartY() + _SFSWINMINLINEOFFSET;
+  const int startX = wins.at(_SAVEDFILESWIN)->getStartX() + _SFWINMINCOLOFFSET;
+
+  // get number of printable file windows
+  const int val = wins.at(_SAVEDFILESWIN)->getNumLines() -
+    _SFSWINMINLINEOFFSET - _SFSWINMAXLINEOFFSET;
+  const int lastPos = std::max((int)outputStrings.size() - val, 0);
+  int newPos = sfStringPos;
+
+  if(numLines < 0)
+    {
+      newPos = std::max(sfStringPos + numLines, 0);
+    }
+  else if(sfStringPos < lastPos)
+    {
+      newPos = std::min(sfStringPos + numLines, lastPos);
+    }
+
+  const int difference = newPos - sfStringPos;
+
+  if(difference == 0)
+    {
+      return false;
+    }
+
+  sfStringPos = newPos;
+
+  // a page or more, or a page that isn't full, is built again
+  if(std::abs(difference) >= (int)sfStringWins.size() ||
+     (int)sfStringWins.size() != val)
     {
-      if(it->second->getWindow() != nullptr)
+      defineSFStringWins(wins,
+                         sfStringWins,
+                         outputStrings,
+                         sfStringPos,
+                         log);
+
+      for(int i = 0; i < sfStringWins.size(); i++)
         {
-          tempMainWins.push_back(it->first);
+          sfStringWins.at(i)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
+          sfStringWins.at(i)->printString(0,
+                                          0,
+                                          outputStrings.at(sfStringPos + i));
         }
-    }
 
-  // sort them in ascending order
-  std::sort(tempMainWins.begin(), tempMainWins.end());
+      return true;
+    }
 
-  // refresh the initialized windows
-  for(std::vector<int>::iterator vecIt = tempMainWins.begin();
-      vecIt != tempMainWins.end();
-      vecIt++)
+  // the windows scrolled off one end are reused for the lines scrolled in at
+  // the other
+  if(difference > 0)
+    {
+      std::rotate(sfStringWins.begin(),
+                  sfStringWins.begin() + difference,
+                  sfStringWins.end());
+    }
+  else
     {
-      wnoutrefresh(wins.at(*vecIt)->getWindow());
+      std::rotate(sfStringWins.begin(),
+                  sfStringWins.end() + difference,
+                  sfStringWins.end());
     }
 
-  // ##
-  // for(int i = _MAINWIN; i <= _RARROWSAVEDFILESWIN; i++)
-  //   {
-  //     if(wins.at(i)->getWindow() != nullptr)
-  //       {
-  //         wnoutrefresh(wins.at(i)->getWindow());
-  //         doupdate();
-  //       }
-  //   }
+  const int firstNew = difference > 0 ? sfStringWins.size() - difference : 0;
+  const int lastNew = difference > 0 ? sfStringWins.size() : -difference;
 
-} // end of "refreshWins"
+  for(int i = 0; i < sfStringWins.size(); i++)
+    {
+      sfStringWins.at(i)->moveWindow(startY + i,
+                                     startX);
+
+      if(i >= firstNew && i < lastNew)
+        {
+          sfStringWins.at(i)->eraseWindow();
+          sfStringWins.at(i)->attributesOn(COLOR_PAIR(_WHITE_TEXT));
+          sfStringWins.at(i)->printString(0,
+                                          0,
+                                          outputStrings.at(sfStringPos + i));
+        }
+    }
+
+  return true;
+} // end of "scrollSFLines"
 
 
 
@@ -2581,7 +2158,7 @@ void shiftSFLeft(const std::unordered_map<int, CursesWindow*>& wins,
                     int& sfStringPos,
                     std::ofstream& log)
 {
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr &&
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen() &&
      !outputStrings.empty())
     {
       int maxLines = wins.at(_SAVEDFILESWIN)->getNumLines();
@@ -2622,7 +2199,7 @@ void shiftSFRight(const std::unordered_map<int, CursesWindow*>& wins,
                      int& sfStringPos,
                      std::ofstream& log)
 {
-  if(wins.at(_SAVEDFILESWIN)->getWindow() != nullptr &&
+  if(wins.at(_SAVEDFILESWIN)->getIsOpen() &&
      !outputStrings.empty())
     {
       int maxLines = wins.at(_SAVEDFILESWIN)->getNumLines();
@@ -2648,92 +2225,55 @@ void shiftSFRight(const std::unordered_map<int, CursesWindow*>& wins,
 
 
 
-void shiftSTLeft(std::unordered_map<int, CursesWindow*>& wins,
-                 std::vector<CursesWindow*>& stStringWins,
-                 const std::vector<std::string>& outputStrings,
+void shiftSTLeft(const std::unordered_map<int, CursesWindow*>& wins,
+                 ThemeGrid& stGrid,
+                 const ThemeClusters& clusters,
                  int& stStringPos,
                  std::ofstream& log)
 {
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr &&
-     !outputStrings.empty())
+  if(stGrid.getIsOpen() && clusters.getNumVisible() > 0)
     {
-      int maxLines = wins.at(_SAVEDTHEMESWIN)->getNumLines();
-      int maxCols = wins.at(_SAVEDTHEMESWIN)->getNumCols();
-      const int startY = wins.at(_SAVEDTHEMESWIN)->getStartY();
-      const int startX = wins.at(_SAVEDTHEMESWIN)->getStartX();
-
-      // get number of printable file windows
-      int val = maxLines - _STWINMINLINEOFFSET - _STWINMAXLINEOFFSET;
-
-      defineSavedThemesWin(wins,
-                           wins.at(_MAINWIN)->getNumLines(),
-                           wins.at(_MAINWIN)->getNumCols(),
-                           log);
-      wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-      box(wins.at(_SAVEDTHEMESWIN)->getWindow(), ' ', ' ');
-      wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-      printSavedThemesWin(wins,
-                          log);
+      // get number of printable theme lines
+      const int val = stGrid.getNumLines();
 
       // check if there is another list to 'scroll' to
       if(stStringPos - val >= 0)
         {
           stStringPos -= val;
-          defineSTStringWins(wins,
-                             stStringWins,
-                             outputStrings,
-                             stStringPos,
-                             log);
         }
       else
         {
           stStringPos = 0;
-          defineSTStringWins(wins,
-                             stStringWins,
-                             outputStrings,
-                             stStringPos,
-                             log);
         }
+
+      stGrid.showPage(wins,
+                      clusters,
+                      stStringPos,
+                      log);
     }
-}// end of "shiftSFLeft"
+} // end of "shiftSTLeft"
 
 
 
-void shiftSTRight(std::unordered_map<int, CursesWindow*>& wins,
-                  std::vector<CursesWindow*>& stStringWins,
-                  const std::vector<std::string>& outputStrings,
-                  int& outputStringPos,
+void shiftSTRight(const std::unordered_map<int, CursesWindow*>& wins,
+                  ThemeGrid& stGrid,
+                  const ThemeClusters& clusters,
+                  int& stStringPos,
                   std::ofstream& log)
 {
-  if(wins.at(_SAVEDTHEMESWIN)->getWindow() != nullptr &&
-     !outputStrings.empty())
+  if(stGrid.getIsOpen() && clusters.getNumVisible() > 0)
     {
-      int maxLines = wins.at(_SAVEDTHEMESWIN)->getNumLines();
-      int maxCols = wins.at(_SAVEDTHEMESWIN)->getNumCols();
-      const int startY = wins.at(_SAVEDTHEMESWIN)->getStartY();
-      const int startX = wins.at(_SAVEDTHEMESWIN)->getStartX();
-
-      // get number of printable file windows
-      int val = maxLines - _STWINMINLINEOFFSET - _STWINMAXLINEOFFSET;
+      // get number of printable theme lines
+      const int val = stGrid.getNumLines();
 
       // check if there is another list to 'scroll' to
-      if(outputStringPos + val < outputStrings.size())
+      if(stStringPos + val < clusters.getNumVisible())
         {
-          defineSavedThemesWin(wins,
-                               wins.at(_MAINWIN)->getNumLines(),
-                               wins.at(_MAINWIN)->getNumCols(),
-                               log);
-          wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), COLOR_PAIR(_BLACK_TEXT));
-          box(wins.at(_SAVEDTHEMESWIN)->getWindow(), ' ', ' ');
-          wattron(wins.at(_SAVEDTHEMESWIN)->getWindow(), COLOR_PAIR(_WHITE_TEXT));
-          printSavedThemesWin(wins,
-                              log);
-          outputStringPos += val;
-          defineSTStringWins(wins,
-                             stStringWins,
-                             outputStrings,
-                             outputStringPos,
-                             log);
+          stStringPos += val;
+          stGrid.showPage(wins,
+                          clusters,
+                          stStringPos,
+                          log);
         }
     }
 } // end of "shiftSTRight"
@@ -14,44 +14,25 @@
 
   Description:
    The base class constructor for creating CursesWindow objects and
-   initializing related calling object data.
+   initializing related calling object data. No window is opened until
+   createWindow() or createScreenWindow() is called.
 
   Input:
-   win                  - a pointer to a NCurses window that contains the
-                          address to the newly created Window.
-
-   windowName           - a const reference to the name to be stored in
-                          Window's private member variable m_window.
-
-   numLines             - a const int reference to the max number of lines of the
-                          created Window.
-
-   numCols              - a const int reference to the max number of columns of
-                          the created Window.
-
-   startY               - a const int reference that defines the logical starting
-                          line number of the Window.
-
-   startX               - a const int reference that defines the logical starting
-                          column number of the Window.
-
+   backend              - a pointer to the backend the window draws through;
+                          it must outlive the window.
 
   Output:
    None
 */
-CursesWindow::CursesWindow(WINDOW* win,
-			   const std::string& windowName,
-			   const int& numLines,
-			   const int& numCols,
-			   const int& startY,
-			   const int& startX)
-{
-  defineWindow(win,
-	       windowName,
-	       numLines,
-	       numCols,
-	       startY,
-	       startX);
+CursesWindow::CursesWindow(RenderBackend* backend)
+  : m_backend(backend),
+    m_window(nullptr),
+    m_numLines(0),
+    m_numCols(0),
+    m_startY(0),
+    m_startX(0),
+    m_isOpen(false)
+{
 } // end of "CursesWindow Constructor"
 
 
@@ -71,7 +52,7 @@ CursesWindow::CursesWindow(WINDOW* win,
 */
 CursesWindow::~CursesWindow()
 {
-  if(getWindow() != nullptr)
+  if(getIsOpen() == true)
     {
       deleteWindow();
     }
@@ -116,6 +97,7 @@ void CursesWindow::defineWindow(WINDOW* win,
 				const int& startX)
 {
   m_window = win;
+  m_isOpen = win != nullptr;
   m_windowName = windowName;
   m_numLines = numLines;
   m_numCols = numCols;
@@ -131,10 +113,13 @@ void CursesWindow::defineWindow(WINDOW* win,
    createWindow
 
   Description:
-   Creates a new window and stores it's address in the calling object's
-   private member data.
+   Opens a new window through the calling object's backend and stores its
+   name and place.
 
   Input:
+   windowName           - a const reference to the name to be stored in
+                          Window's private member variable m_window.
+
    numLines             - a const int reference to the max number of lines of the
                           created Window.
 
@@ -148,26 +133,260 @@ void CursesWindow::defineWindow(WINDOW* win,
                           column number of the Window.
 
   Output:
-   NONE
+   bool                 - true if the window was opened.
 */
-void CursesWindow::createWindow(const int& numLines,
-				const int& numCols,
-				const int& startY,
-				const int& startX)
+bool CursesWindow::createWindow(const std::string& windowName,
+                                const int& numLines,
+                                const int& numCols,
+                                const int& startY,
+                                const int& startX)
+{
+  m_windowName = windowName;
+  m_numLines = numLines;
+  m_numCols = numCols;
+  m_startY = startY;
+  m_startX = startX;
+  m_isOpen = m_backend->openWindow(*this,
+                                   numLines,
+                                   numCols,
+                                   startY,
+                                   startX);
+
+  return m_isOpen;
+} // end of "createWindow"
+
+
+
+/*
+  Function:
+   createPad
+
+  Description:
+   Opens a new pad through the calling object's backend. A pad has no place
+   on the screen; regions of it are shown with stagePad().
+
+  Input:
+   windowName           - a const reference to the name to be stored in
+                          Window's private member variable m_window.
+
+   numLines             - a const int reference to the number of lines of
+                          the created pad.
+
+   numCols              - a const int reference to the number of columns of
+                          the created pad.
+
+  Output:
+   bool                 - true if the pad was opened.
+*/
+bool CursesWindow::createPad(const std::string& windowName,
+                             const int& numLines,
+                             const int& numCols)
 {
-  if(m_window == nullptr)
+  m_windowName = windowName;
+  m_numLines = numLines;
+  m_numCols = numCols;
+  m_startY = 0;
+  m_startX = 0;
+  m_isOpen = m_backend->openPad(*this,
+                                numLines,
+                                numCols);
+
+  return m_isOpen;
+} // end of "createPad"
+
+
+
+/*
+  Function:
+   createScreenWindow
+
+  Description:
+   Opens the calling object as the whole screen, STDSCR for curses, through
+   its backend.
+
+  Input:
+   windowName           - a const reference to the name to be stored in
+                          Window's private member variable m_window.
+
+  Output:
+   bool                 - true if the window was opened.
+*/
+bool CursesWindow::createScreenWindow(const std::string& windowName)
+{
+  m_windowName = windowName;
+  m_backend->getScreenSize(m_numLines,
+                           m_numCols);
+  m_startY = 0;
+  m_startX = 0;
+  m_isOpen = m_backend->openScreen(*this);
+
+  return m_isOpen;
+} // end of "createScreenWindow"
+
+
+
+/*
+  Function:
+   resizeWindow
+
+  Description:
+   Resizes the calling object's open window in place.
+
+  Input:
+   numLines             - the new number of lines.
+
+   numCols              - the new number of columns.
+
+  Output:
+   bool                 - true if the window was resized.
+*/
+bool CursesWindow::resizeWindow(const int numLines,
+                                const int numCols)
+{
+  if(m_isOpen == false || m_backend->resizeWindow(*this, numLines, numCols) == false)
     {
-      m_window = newwin(numLines,
-			numCols,
-			startY,
-			startX);
+      return false;
     }
-  else
+
+  m_numLines = numLines;
+  m_numCols = numCols;
+
+  return true;
+} // end of "resizeWindow"
+
+
+
+/*
+  Function:
+   moveWindow
+
+  Description:
+   Moves the calling object's open window to a new start on the screen.
+
+  Input:
+   startY               - the new starting line.
+
+   startX               - the new starting column.
+
+  Output:
+   bool                 - true if the window was moved.
+*/
+bool CursesWindow::moveWindow(const int startY,
+                              const int startX)
+{
+  if(m_isOpen == false || m_backend->moveWindow(*this, startY, startX) == false)
     {
-      endwin();
-      exit(EXIT_FAILURE);
+      return false;
     }
-} // end of "createWindow"
+
+  m_startY = startY;
+  m_startX = startX;
+
+  return true;
+} // end of "moveWindow"
+
+
+
+// the drawing members pass straight through to the backend, which ignores
+// a window that isn't open
+void CursesWindow::attributesOff(const attr_t attributes)
+{
+  m_backend->attributesOff(*this, attributes);
+} // end of "attributesOff"
+
+
+
+void CursesWindow::attributesOn(const attr_t attributes)
+{
+  m_backend->attributesOn(*this, attributes);
+} // end of "attributesOn"
+
+
+
+void CursesWindow::drawBox(const chtype vertical,
+                           const chtype horizontal)
+{
+  m_backend->drawBox(*this, vertical, horizontal);
+} // end of "drawBox"
+
+
+
+void CursesWindow::eraseWindow()
+{
+  m_backend->eraseWindow(*this);
+} // end of "eraseWindow"
+
+
+
+void CursesWindow::moveCursor(const int line,
+                              const int col)
+{
+  m_backend->moveCursor(*this, line, col);
+} // end of "moveCursor"
+
+
+
+void CursesWindow::printString(const int line,
+                               const int col,
+                               const std::string_view text)
+{
+  m_backend->printString(*this, line, col, text);
+} // end of "printString"
+
+
+
+void CursesWindow::setAttributes(const attr_t attributes)
+{
+  m_backend->setAttributes(*this, attributes);
+} // end of "setAttributes"
+
+
+
+void CursesWindow::setBackground(const chtype background)
+{
+  m_backend->setBackground(*this, background);
+} // end of "setBackground"
+
+
+
+void CursesWindow::stagePad(const int padLine,
+                            const int padCol,
+                            const int startY,
+                            const int startX,
+                            const int numLines,
+                            const int numCols)
+{
+  m_backend->stagePad(*this, padLine, padCol, startY, startX, numLines, numCols);
+} // end of "stagePad"
+
+
+
+void CursesWindow::stageWindow()
+{
+  m_backend->stageWindow(*this);
+} // end of "stageWindow"
+
+
+
+void CursesWindow::touchLines(const int line,
+                              const int numLines)
+{
+  m_backend->touchLines(*this, line, numLines);
+} // end of "touchLines"
+
+
+
+RenderBackend* CursesWindow::getBackend() const
+{
+  return m_backend;
+} // end of "getBackend"
+
+
+
+bool CursesWindow::getIsOpen() const
+{
+  return m_isOpen;
+} // end of "getIsOpen"
 
 
 
@@ -290,6 +509,13 @@ const int& CursesWindow::getStartX() const
 
 
 
+void CursesWindow::setBackend(RenderBackend* backend)
+{
+  m_backend = backend;
+} // end of "setBackend"
+
+
+
 /*
   Function:
    setWindow
@@ -431,8 +657,13 @@ void CursesWindow::setStartX(const int& startX)
 */
 void CursesWindow::deleteWindow()
 {
-  delwin(getWindow());
+  if(m_isOpen == true)
+    {
+      m_backend->closeWindow(*this);
+    }
+
   setWindow(nullptr);
+  m_isOpen = false;
   m_windowName = "";
   m_numLines = 0;
   m_numCols = 0;
@@ -0,0 +1,498 @@
+/*
+  File:
+   daemonProtocol.cpp
+
+  Description:
+   The implementation of the daemonProtocol.hpp functions and class.
+*/
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "daemonProtocol.hpp"
+
+
+
+/*
+  Function:
+   readFully
+
+  Description:
+   Reads exactly length bytes, retrying short and interrupted reads.
+
+  Input:
+   fd                   - the descriptor to read from.
+
+   length               - the number of bytes to read.
+
+  Output:
+   buffer               - a pointer to at least length bytes that receive the
+                          data.
+
+  Returns:
+   bool                 - true if every byte was read, false on an error or end
+                          of file.
+*/
+static bool readFully(const int fd,
+                      char* buffer,
+                      size_t length)
+{
+  while(length > 0)
+    {
+      const ssize_t numRead = read(fd, buffer, length);
+
+      if(numRead < 0 && errno == EINTR)
+        {
+          continue;
+        }
+
+      if(numRead <= 0)
+        {
+          return false;
+        }
+
+      buffer += numRead;
+      length -= numRead;
+    }
+
+  return true;
+} // end of "readFully"
+
+
+
+/*
+  Function:
+   appendDaemonMessage
+
+  Description:
+   Appends one message, header and payload, to a buffer of messages waiting
+   to be sent.
+
+  Input:
+   code                 - the request or response code of the message.
+
+   payload              - a reference to a constant string containing the
+                          payload.
+
+  Output:
+   output               - a reference to the string the message is appended
+                          to.
+
+  Returns:
+   bool                 - false if the payload is too large to send.
+*/
+bool appendDaemonMessage(std::string& output,
+                         const int code,
+                         const std::string& payload)
+{
+  if(payload.length() > _DAEMONMAXPAYLOAD)
+    {
+      return false;
+    }
+
+  DaemonHeader header;
+
+  header.length = payload.length();
+  header.code = code;
+  header.reserved = 0;
+  output.append((const char*)&header, sizeof(header));
+  output.append(payload);
+
+  return true;
+} // end of "appendDaemonMessage"
+
+
+
+/*
+  Function:
+   checkDaemonPeer
+
+  Description:
+   Checks that the process at the other end of a connected socket runs as
+   this user, so neither side talks to another user's process that got to
+   the socket first.
+
+  Input:
+   fd                   - the connected socket.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the peer is this user.
+*/
+bool checkDaemonPeer(const int fd)
+{
+  struct ucred credentials;
+  socklen_t length = sizeof(credentials);
+
+  return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0 &&
+    length == sizeof(credentials) && credentials.uid == getuid();
+} // end of "checkDaemonPeer"
+
+
+
+/*
+  Function:
+   checkDaemonSocketDir
+
+  Description:
+   Checks that the directory holding the daemon's socket is a real directory
+   (not a link) owned by this user that no one else can enter, creating it
+   first if asked to. Anyone can create a directory in /tmp, so one left
+   there by another user must be refused, not used.
+
+  Input:
+   socketPath           - a reference to a constant string containing the path
+                          of the daemon's socket.
+
+   create               - true to create the directory if it is missing.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the directory is safe to use.
+*/
+bool checkDaemonSocketDir(const std::string& socketPath,
+                          const bool create)
+{
+  const size_t slash = socketPath.rfind('/');
+  const std::string dirPath = slash == std::string::npos ? "." :
+    slash == 0 ? "/" : socketPath.substr(0, slash);
+  struct stat dirStat;
+
+  if(create == true && mkdir(dirPath.c_str(), 0700) == -1 && errno != EEXIST)
+    {
+      return false;
+    }
+
+  return lstat(dirPath.c_str(), &dirStat) == 0 && S_ISDIR(dirStat.st_mode) &&
+    dirStat.st_uid == getuid() && (dirStat.st_mode & 077) == 0;
+} // end of "checkDaemonSocketDir"
+
+
+
+/*
+  Function:
+   daemonSocketPath
+
+  Description:
+   Returns the path of the daemon's socket, $XDG_RUNTIME_DIR/themeswitcher.sock,
+   falling back to a socket in a per user directory in /tmp that only its
+   user may enter (see checkDaemonSocketDir()).
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the socket path.
+*/
+std::string daemonSocketPath()
+{
+  const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+  std::string path;
+
+  if(runtimeDir != nullptr && runtimeDir[0] != '\0')
+    {
+      path = runtimeDir;
+      path.append("/themeswitcher.sock");
+    }
+  else
+    {
+      path = "/tmp/themeswitcher-";
+      path.append(std::to_string(getuid()));
+      path.append("/themeswitcher.sock");
+    }
+
+  return path;
+} // end of "daemonSocketPath"
+
+
+
+/*
+  Function:
+   readDaemonMessage
+
+  Description:
+   Reads one message, blocking until it has fully arrived.
+
+  Input:
+   fd                   - the connected socket to read from.
+
+  Output:
+   code                 - the request or response code of the message.
+
+   payload              - a reference to a string that receives the payload.
+
+  Returns:
+   bool                 - true if a whole, valid message was read.
+*/
+bool readDaemonMessage(const int fd,
+                       int& code,
+                       std::string& payload)
+{
+  DaemonHeader header;
+
+  if(readFully(fd, (char*)&header, sizeof(header)) == false ||
+     header.length > _DAEMONMAXPAYLOAD)
+    {
+      return false;
+    }
+
+  code = header.code;
+  payload.resize(header.length);
+
+  return header.length == 0 || readFully(fd, &payload[0], header.length);
+} // end of "readDaemonMessage"
+
+
+
+/*
+  Function:
+   writeDaemonMessage
+
+  Description:
+   Writes one message, gathering the header and payload into a single
+   sendmsg() call.
+
+  Input:
+   fd                   - the connected socket to write to.
+
+   code                 - the request or response code of the message.
+
+   payload              - a reference to a constant string containing the
+                          payload.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the whole message was written.
+*/
+bool writeDaemonMessage(const int fd,
+                        const int code,
+                        const std::string& payload)
+{
+  if(payload.length() > _DAEMONMAXPAYLOAD)
+    {
+      return false;
+    }
+
+  DaemonHeader header;
+  struct iovec iovs[2];
+  struct msghdr message;
+  size_t remaining = sizeof(header) + payload.length();
+
+  header.length = payload.length();
+  header.code = code;
+  header.reserved = 0;
+  iovs[0].iov_base = &header;
+  iovs[0].iov_len = sizeof(header);
+  iovs[1].iov_base = (void*)payload.data();
+  iovs[1].iov_len = payload.length();
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = iovs;
+  message.msg_iovlen = 2;
+
+  while(remaining > 0)
+    {
+      const ssize_t written = sendmsg(fd, &message, MSG_NOSIGNAL);
+
+      if(written < 0 && errno == EINTR)
+        {
+          continue;
+        }
+
+      if(written <= 0)
+        {
+          return false;
+        }
+
+      remaining -= written;
+
+      // skip what was sent in case of a partial write
+      size_t skip = written;
+
+      while(message.msg_iovlen > 0 && skip >= message.msg_iov[0].iov_len)
+        {
+          skip -= message.msg_iov[0].iov_len;
+          message.msg_iov++;
+          message.msg_iovlen--;
+        }
+
+      if(message.msg_iovlen > 0)
+        {
+          message.msg_iov[0].iov_base = (char*)message.msg_iov[0].iov_base + skip;
+          message.msg_iov[0].iov_len -= skip;
+        }
+    }
+
+  return true;
+} // end of "writeDaemonMessage"
+
+
+
+/*
+  Function:
+   DaemonClient Constructor
+
+  Description:
+   Creates an unconnected client.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+DaemonClient::DaemonClient()
+  : m_fd(-1)
+{
+} // end of "DaemonClient Constructor"
+
+
+
+/*
+  Function:
+   DaemonClient Destructor
+
+  Description:
+   Closes the connection if one is open.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+DaemonClient::~DaemonClient()
+{
+  disconnect();
+} // end of "DaemonClient Destructor"
+
+
+
+/*
+  Function:
+   connectTo
+
+  Description:
+   Connects to the daemon listening on the incoming socket path. The socket's
+   directory must be this user's alone and the listener must run as this
+   user, or no connection is made.
+
+  Input:
+   socketPath           - a reference to a constant string containing the path
+                          of the daemon's socket.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if connected, false if no daemon of this user
+                          is listening.
+*/
+bool DaemonClient::connectTo(const std::string& socketPath)
+{
+  struct sockaddr_un address;
+
+  disconnect();
+
+  if(socketPath.length() >= sizeof(address.sun_path) ||
+     checkDaemonSocketDir(socketPath, false) == false)
+    {
+      return false;
+    }
+
+  m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+  if(m_fd == -1)
+    {
+      return false;
+    }
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, socketPath.c_str(), socketPath.length());
+
+  if(connect(m_fd, (struct sockaddr*)&address, sizeof(address)) == -1 ||
+     checkDaemonPeer(m_fd) == false)
+    {
+      disconnect();
+      return false;
+    }
+
+  return true;
+} // end of "connectTo"
+
+
+
+void DaemonClient::disconnect()
+{
+  if(m_fd != -1)
+    {
+      close(m_fd);
+      m_fd = -1;
+    }
+} // end of "disconnect"
+
+
+
+/*
+  Function:
+   request
+
+  Description:
+   Sends one request and waits for its response. The connection stays open
+   for further requests.
+
+  Input:
+   code                 - a DaemonRequests value.
+
+   payload              - a reference to a constant string containing the
+                          request payload.
+
+  Output:
+   responseCode         - the DaemonResponses value of the response.
+
+   response             - a reference to a string that receives the response
+                          payload.
+
+  Returns:
+   bool                 - true if a response was received, false if the
+                          connection failed (it is closed in that case).
+*/
+bool DaemonClient::request(const int code,
+                           const std::string& payload,
+                           int& responseCode,
+                           std::string& response)
+{
+  if(m_fd == -1)
+    {
+      return false;
+    }
+
+  if(writeDaemonMessage(m_fd, code, payload) == false ||
+     readDaemonMessage(m_fd, responseCode, response) == false)
+    {
+      disconnect();
+      return false;
+    }
+
+  return true;
+} // end of "request"
+
+
+
+bool DaemonClient::isConnected() const
+{
+  return m_fd != -1;
+} // end of "isConnected"
@@ -0,0 +1,183 @@
+/*
+  File:
+   deviceScheduler.cpp
+
+  Description:
+   The implementation of the deviceScheduler.hpp class.
+*/
+#include <algorithm>
+#include "deviceScheduler.hpp"
+
+
+
+/*
+  Function:
+   DeviceScheduler Constructor
+
+  Description:
+   Creates a scheduler with no filesystems.
+
+  Input:
+   maxWindow            - the largest window any one filesystem may grow to.
+
+  Output:
+   NONE
+*/
+DeviceScheduler::DeviceScheduler(const int maxWindow)
+  : m_maxWindow(std::max(1, maxWindow))
+{
+} // end of "DeviceScheduler Constructor"
+
+
+
+/*
+  Function:
+   addDevice
+
+  Description:
+   Returns the index of the incoming filesystem, adding it with the starting
+   window if it hasn't been seen before.
+
+  Input:
+   device               - the st_dev of the filesystem.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the index used for the filesystem.
+*/
+int DeviceScheduler::addDevice(const dev_t device)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for(size_t i = 0; i < m_devices.size(); i++)
+    {
+      if(m_devices.at(i).device == device)
+        {
+          return i;
+        }
+    }
+
+  DeviceState state;
+  state.device = device;
+  state.inFlight = 0;
+  state.window = std::min(_DEVICESTARTWINDOW, (double)m_maxWindow);
+  state.fastestMs = -1;
+  state.sinceDecrease = 0;
+  m_devices.push_back(state);
+
+  return m_devices.size() - 1;
+} // end of "addDevice"
+
+
+
+/*
+  Function:
+   release
+
+  Description:
+   Ends an operation started with tryAcquire() and adapts the filesystem's
+   window to how long it took. Fast operations grow the window by 1/window,
+   about one slot per window of completions; a slow one halves it, at most
+   once per window of completions so a single burst isn't punished twice.
+
+  Input:
+   deviceIndex          - the index of the filesystem.
+
+   latencyMs            - how long the operation took.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void DeviceScheduler::release(const int deviceIndex,
+                              const double latencyMs)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  DeviceState& state = m_devices.at(deviceIndex);
+
+  state.inFlight--;
+  state.sinceDecrease++;
+
+  if(state.fastestMs < 0 || latencyMs < state.fastestMs)
+    {
+      state.fastestMs = latencyMs;
+    }
+
+  const bool isSlow = latencyMs > _DEVICEMINSLOWMS &&
+    latencyMs > state.fastestMs * _DEVICESLOWFACTOR;
+
+  if(isSlow == false)
+    {
+      state.window = std::min((double)m_maxWindow, state.window + 1.0 / state.window);
+    }
+  else if(state.sinceDecrease >= state.window)
+    {
+      state.window = std::max(1.0, state.window / 2);
+      state.sinceDecrease = 0;
+    }
+} // end of "release"
+
+
+
+/*
+  Function:
+   tryAcquire
+
+  Description:
+   Starts an operation on the filesystem if its window has room.
+
+  Input:
+   deviceIndex          - the index of the filesystem.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the operation may start; release() must be
+                          called when it ends.
+*/
+bool DeviceScheduler::tryAcquire(const int deviceIndex)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  DeviceState& state = m_devices.at(deviceIndex);
+
+  if(state.inFlight + 1 > (int)state.window)
+    {
+      return false;
+    }
+
+  state.inFlight++;
+
+  return true;
+} // end of "tryAcquire"
+
+
+
+dev_t DeviceScheduler::getDevice(const int deviceIndex) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_devices.at(deviceIndex).device;
+} // end of "getDevice"
+
+
+
+int DeviceScheduler::getNumDevices() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_devices.size();
+} // end of "getNumDevices"
+
+
+
+double DeviceScheduler::getWindow(const int deviceIndex) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  return m_devices.at(deviceIndex).window;
+} // end of "getWindow"
@@ -1,7 +1,282 @@
+#include <cctype>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "fileOperations.hpp"
+#include "themeDetector.hpp"
+
+
+
+/*
+  Function:
+   detectFileTheme
+
+  Description:
+   Returns the name of the theme the file at the incoming path currently
+   applies, as found by the shared ThemeDetector.
+
+  Input:
+   path                 - a reference to a constant string containing the full
+                          path to the configuration file to inspect.
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the base name of the theme referenced by the file, or
+                          an empty string if the file can't be read or no theme
+                          directive is found.
+*/
+std::string detectFileTheme(const std::string& path)
+{
+  std::string theme;
+
+  themeDetector().detectFile(path, theme);
+
+  return theme;
+} // end of "detectFileTheme"
+
 
 
 int hwSFAddFile(std::vector<std::string> sfStrings)
 {
 
 }
+
+
+
+/*
+  Function:
+   readSavedFiles
+
+  Description:
+   Reads the saved file store, one configuration file path per line. Spaces,
+   tabs and carriage returns around each path are trimmed, and blank lines and
+   lines starting with '#' are skipped.
+
+  Input:
+   storePath            - a reference to a constant string containing the path
+                          of the store.
+
+  Output:
+   savedFiles           - a reference to a vector the saved file paths are
+                          appended to.
+
+  Returns:
+   bool                 - true if the store was read, false if it doesn't exist
+                          or can't be read.
+*/
+bool readSavedFiles(const std::string& storePath,
+                    std::vector<std::string>& savedFiles)
+{
+  const int fd = open(storePath.c_str(), O_RDONLY | O_CLOEXEC);
+  std::string contents;
+  char buffer[4096];
+  ssize_t numRead;
+
+  if(fd == -1)
+    {
+      return false;
+    }
+
+  while((numRead = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+      contents.append(buffer, numRead);
+    }
+
+  close(fd);
+
+  if(numRead < 0)
+    {
+      return false;
+    }
+
+  size_t lineStart = 0;
+
+  while(lineStart < contents.length())
+    {
+      size_t lineEnd = contents.find('\n', lineStart);
+
+      if(lineEnd == std::string::npos)
+        {
+          lineEnd = contents.length();
+        }
+
+      const size_t nextLine = lineEnd + 1;
+
+      // stores edited on other systems may carry "\r\n" line ends and stray
+      // spaces around the path
+      while(lineStart < lineEnd && isspace((unsigned char)contents.at(lineStart)) != 0)
+        {
+          lineStart++;
+        }
+
+      while(lineEnd > lineStart && isspace((unsigned char)contents.at(lineEnd - 1)) != 0)
+        {
+          lineEnd--;
+        }
+
+      if(lineEnd > lineStart && contents.at(lineStart) != '#')
+        {
+          savedFiles.push_back(contents.substr(lineStart, lineEnd - lineStart));
+        }
+
+      lineStart = nextLine;
+    }
+
+  return true;
+} // end of "readSavedFiles"
+
+
+
+/*
+  Function:
+   appendSavedFile
+
+  Description:
+   Adds a configuration file path to the end of the saved file store,
+   creating the store and its directory if this is the first one.
+
+  Input:
+   storePath            - a reference to a constant string containing the path
+                          of the store.
+
+   path                 - a reference to a constant string containing the path
+                          to add.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the path was written to the store.
+*/
+bool appendSavedFile(const std::string& storePath,
+                     const std::string& path)
+{
+  const size_t dirEnd = storePath.rfind('/');
+
+  if(storePath.empty() || path.empty() || path.find('\n') != std::string::npos)
+    {
+      return false;
+    }
+
+  if(dirEnd != std::string::npos && dirEnd > 0)
+    {
+      mkdir(storePath.substr(0, dirEnd).c_str(), 0700);
+    }
+
+  const int fd = open(storePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+
+  if(fd == -1)
+    {
+      return false;
+    }
+
+  // one write, so the line lands whole after whatever is already there
+  const std::string line = path + "\n";
+  const bool isWritten = write(fd, line.data(), line.length()) == (ssize_t)line.length();
+
+  return close(fd) == 0 && isWritten == true;
+} // end of "appendSavedFile"
+
+
+
+/*
+  Function:
+   configStorePath
+
+  Description:
+   Returns the path of a file in the themeswitcher configuration directory,
+   $XDG_CONFIG_HOME/themeswitcher, falling back to
+   $HOME/.config/themeswitcher.
+
+  Input:
+   name                 - a pointer to the name of the file.
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the path of the file, or an empty string if neither
+                          variable is set.
+*/
+static std::string configStorePath(const char* name)
+{
+  const char* configHome = getenv("XDG_CONFIG_HOME");
+  std::string path;
+
+  if(configHome != nullptr && configHome[0] != '\0')
+    {
+      path = configHome;
+    }
+  else
+    {
+      const char* home = getenv("HOME");
+
+      if(home == nullptr || home[0] == '\0')
+        {
+          return path;
+        }
+
+      path = home;
+      path.append("/.config");
+    }
+
+  path.append("/themeswitcher/");
+  path.append(name);
+
+  return path;
+} // end of "configStorePath"
+
+
+
+/*
+  Function:
+   savedFilesStorePath
+
+  Description:
+   Returns the path of the saved file store,
+   $XDG_CONFIG_HOME/themeswitcher/savedFiles, falling back to
+   $HOME/.config/themeswitcher/savedFiles.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the path of the store, or an empty string if neither
+                          variable is set.
+*/
+std::string savedFilesStorePath()
+{
+  return configStorePath("savedFiles");
+} // end of "savedFilesStorePath"
+
+
+
+/*
+  Function:
+   themeLibraryStorePath
+
+  Description:
+   Returns the path of the saved themes library (see ThemeLibrary),
+   $XDG_CONFIG_HOME/themeswitcher/themes.lib, falling back to
+   $HOME/.config/themeswitcher/themes.lib.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the path of the library, or an empty string if
+                          neither variable is set.
+*/
+std::string themeLibraryStorePath()
+{
+  return configStorePath("themes.lib");
+} // end of "themeLibraryStorePath"
@@ -0,0 +1,584 @@
+/*
+  File:
+   fileWatcher.cpp
+
+  Description:
+   The implementation of the fileWatcher.hpp class.
+*/
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "fileWatcher.hpp"
+
+// events that can change the contents a saved file path refers to. the parent
+// directory is watched instead of the file itself so editors that save by
+// writing a temporary file and renaming it over the original are still seen.
+const uint32_t _WATCHEVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+  IN_CREATE | IN_DELETE | IN_ONLYDIR;
+
+// time to wait for more events after a change so a burst of writes to the same
+// file only triggers one theme detection
+const int _WATCHSETTLEMS = 20;
+
+// longest a burst may hold back its deltas, so a file written continuously is
+// still re-detected every so often
+const int _WATCHSETTLEMAXMS = 250;
+
+// how often files whose directory went away are watched again
+const int _WATCHRETRYMS = 500;
+
+
+
+/*
+  Function:
+   FileWatcher Constructor
+
+  Description:
+   Creates an idle FileWatcher. No inotify descriptor or thread exists until
+   start() is called.
+
+  Input:
+   detectFunc           - a pointer to the function used to detect the current
+                          theme of a saved file after it changes.
+
+  Output:
+   NONE
+*/
+FileWatcher::FileWatcher(ThemeDetectFunc detectFunc)
+  : m_detectFunc(detectFunc),
+    m_inotifyFd(-1),
+    m_running(false),
+    m_hasDeltas(false)
+{
+  m_wakeFd[0] = -1;
+  m_wakeFd[1] = -1;
+} // end of "FileWatcher Constructor"
+
+
+
+/*
+  Function:
+   FileWatcher Destructor
+
+  Description:
+   Stops the watcher thread and releases the inotify descriptor.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+FileWatcher::~FileWatcher()
+{
+  stop();
+} // end of "FileWatcher Destructor"
+
+
+
+/*
+  Function:
+   start
+
+  Description:
+   Adds a watch for the directory of every incoming saved file path and starts
+   the background thread that services them. Paths in the same directory share
+   a single inotify watch.
+
+  Input:
+   paths                - a reference to a constant vector of strings containing
+                          the saved file paths. The index of a path is the
+                          fileIndex reported in each FileThemeDelta.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the watcher thread was started, false if
+                          inotify is unavailable or the watcher is running.
+*/
+bool FileWatcher::start(const std::vector<std::string>& paths,
+                        std::ofstream& log)
+{
+  if(m_running == true)
+    {
+      return false;
+    }
+
+  m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if(m_inotifyFd == -1)
+    {
+      log << "FileWatcher: inotify unavailable, saved file themes will not "
+          << "update while running" << std::endl;
+      return false;
+    }
+
+  if(pipe2(m_wakeFd, O_CLOEXEC) == -1)
+    {
+      close(m_inotifyFd);
+      m_inotifyFd = -1;
+      return false;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+
+    m_paths = paths;
+    m_watches.clear();
+    m_orphans.clear();
+
+    for(int i = 0; i < (int)m_paths.size(); i++)
+      {
+        if(addPath(i, m_paths.at(i)) == false)
+          {
+            m_orphans.push_back(i);
+          }
+      }
+
+    log << "FileWatcher: watching " << m_paths.size() << " files in "
+        << m_watches.size() << " directories" << std::endl;
+  }
+
+  m_running = true;
+  m_thread = std::thread(&FileWatcher::watchLoop, this);
+
+  return true;
+} // end of "start"
+
+
+
+/*
+  Function:
+   stop
+
+  Description:
+   Wakes and joins the watcher thread, then closes all of its descriptors.
+   Deltas that have not been taken yet are discarded.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+void FileWatcher::stop()
+{
+  if(m_running == true)
+    {
+      const char wake = 0;
+
+      m_running = false;
+
+      if(write(m_wakeFd[1], &wake, 1) == -1)
+        {
+          // the thread also exits on its next wakeup with m_running cleared
+        }
+
+      m_thread.join();
+    }
+
+  for(int i = 0; i < 2; i++)
+    {
+      if(m_wakeFd[i] != -1)
+        {
+          close(m_wakeFd[i]);
+          m_wakeFd[i] = -1;
+        }
+    }
+
+  if(m_inotifyFd != -1)
+    {
+      close(m_inotifyFd);
+      m_inotifyFd = -1;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(m_watchMutex);
+
+    m_watches.clear();
+    m_orphans.clear();
+  }
+
+  std::lock_guard<std::mutex> lock(m_deltaMutex);
+  m_deltas.clear();
+  m_hasDeltas = false;
+} // end of "stop"
+
+
+
+/*
+  Function:
+   addFile
+
+  Description:
+   Adds a saved file after the watcher has started, such as one added from
+   the add file prompt, and watches its directory like the files passed to
+   start().
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the saved file.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the fileIndex reported in the file's deltas.
+*/
+int FileWatcher::addFile(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(m_watchMutex);
+  const int fileIndex = m_paths.size();
+
+  m_paths.push_back(path);
+
+  if(m_inotifyFd != -1 && addPath(fileIndex, path) == false)
+    {
+      m_orphans.push_back(fileIndex);
+    }
+
+  return fileIndex;
+} // end of "addFile"
+
+
+
+/*
+  Function:
+   takeDeltas
+
+  Description:
+   Moves every current theme change detected since the last call into the
+   outgoing vector. This is cheap to call every main loop iteration since it
+   only takes the lock when there is something to hand over.
+
+  Input:
+   NONE
+
+  Output:
+   deltas               - a reference to a vector that is cleared and filled
+                          with the pending theme changes, oldest first.
+
+  Returns:
+   bool                 - true if any deltas were taken.
+*/
+bool FileWatcher::takeDeltas(std::vector<FileThemeDelta>& deltas)
+{
+  deltas.clear();
+
+  if(m_hasDeltas == false)
+    {
+      return false;
+    }
+
+  std::lock_guard<std::mutex> lock(m_deltaMutex);
+  deltas.swap(m_deltas);
+  m_hasDeltas = false;
+
+  return !deltas.empty();
+} // end of "takeDeltas"
+
+
+
+int FileWatcher::getNumWatches() const
+{
+  std::lock_guard<std::mutex> lock(m_watchMutex);
+
+  return m_watches.size();
+} // end of "getNumWatches"
+
+
+
+bool FileWatcher::isRunning() const
+{
+  return m_running;
+} // end of "isRunning"
+
+
+
+/*
+  Function:
+   addPath
+
+  Description:
+   Adds (or reuses) the inotify watch on the directory containing the incoming
+   path and records which file in that directory maps to fileIndex. Symbolic
+   links are resolved so dotfiles linked into a repository are watched where
+   they are actually written. The caller holds m_watchMutex.
+
+  Input:
+   fileIndex            - the index of the path in the saved files list.
+
+   path                 - a reference to a constant string containing the path
+                          to watch.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - false if the directory can't be watched, such as
+                          while it doesn't exist.
+*/
+bool FileWatcher::addPath(const int fileIndex,
+                          const std::string& path)
+{
+  char resolved[PATH_MAX];
+  std::string fullPath = path;
+
+  if(realpath(path.c_str(), resolved) != nullptr)
+    {
+      fullPath = resolved;
+    }
+
+  size_t slash = fullPath.find_last_of('/');
+
+  // a path without a file name can never be watched, so it isn't retried
+  if(slash == std::string::npos || slash + 1 == fullPath.length())
+    {
+      return true;
+    }
+
+  std::string dir = slash == 0 ? "/" : fullPath.substr(0, slash);
+  int wd = inotify_add_watch(m_inotifyFd, dir.c_str(), _WATCHEVENTS);
+
+  if(wd == -1)
+    {
+      return false;
+    }
+
+  std::vector<int>& fileIndexes = m_watches[wd][fullPath.substr(slash + 1)];
+
+  if(std::find(fileIndexes.begin(), fileIndexes.end(), fileIndex) == fileIndexes.end())
+    {
+      fileIndexes.push_back(fileIndex);
+    }
+
+  return true;
+} // end of "addPath"
+
+
+
+/*
+  Function:
+   retryOrphans
+
+  Description:
+   Watches the directories of files whose directory went away again. A file
+   whose directory is back is marked dirty, since it was most likely
+   rewritten along with it. The caller holds m_watchMutex.
+
+  Input/Output:
+   isDirty              - a reference to the dirty flag of every file.
+
+   dirtyFiles           - a reference to the indexes of the dirty files.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void FileWatcher::retryOrphans(std::vector<char>& isDirty,
+                               std::vector<int>& dirtyFiles)
+{
+  std::vector<int> orphans;
+
+  for(size_t i = 0; i < m_orphans.size(); i++)
+    {
+      const int fileIndex = m_orphans.at(i);
+
+      if(addPath(fileIndex, m_paths.at(fileIndex)) == false)
+        {
+          orphans.push_back(fileIndex);
+        }
+      else if(isDirty.at(fileIndex) == 0)
+        {
+          isDirty.at(fileIndex) = 1;
+          dirtyFiles.push_back(fileIndex);
+        }
+    }
+
+  m_orphans.swap(orphans);
+} // end of "retryOrphans"
+
+
+
+/*
+  Function:
+   watchLoop
+
+  Description:
+   The watcher thread body. Blocks until inotify reports an event, drains and
+   coalesces every queued event into a set of changed files, re-detects the
+   theme of only those files, and queues the results for takeDeltas(). A
+   burst is settled for at most _WATCHSETTLEMS after its last event and
+   _WATCHSETTLEMAXMS in all. While a watched directory is missing the thread
+   also wakes every _WATCHRETRYMS to watch it again.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+void FileWatcher::watchLoop()
+{
+  alignas(struct inotify_event) char buffer[4096];
+  std::vector<char> isDirty;
+  std::vector<int> dirtyFiles;
+  std::vector<std::string> dirtyPaths;
+  std::vector<FileThemeDelta> newDeltas;
+
+  while(m_running == true)
+    {
+      struct pollfd fds[2];
+      fds[0].fd = m_inotifyFd;
+      fds[0].events = POLLIN;
+      fds[1].fd = m_wakeFd[0];
+      fds[1].events = POLLIN;
+
+      bool hasOrphans;
+
+      {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+        hasOrphans = !m_orphans.empty();
+      }
+
+      if(poll(fds, 2, hasOrphans == true ? _WATCHRETRYMS : -1) == -1)
+        {
+          continue;
+        }
+
+      if(fds[1].revents != 0)
+        {
+          break;
+        }
+
+      const std::chrono::steady_clock::time_point burstStart = std::chrono::steady_clock::now();
+      int settleMs = _WATCHSETTLEMS;
+
+      // drain everything queued, waiting briefly for the rest of a burst
+      do
+        {
+          std::lock_guard<std::mutex> lock(m_watchMutex);
+          ssize_t len;
+
+          isDirty.resize(m_paths.size(), 0);
+
+          while((len = read(m_inotifyFd, buffer, sizeof(buffer))) > 0)
+            {
+              const struct inotify_event* event;
+
+              for(char* ptr = buffer; ptr < buffer + len;
+                  ptr += sizeof(struct inotify_event) + event->len)
+                {
+                  event = (const struct inotify_event*)ptr;
+
+                  // the watched directory itself went away, its files are
+                  // watched again once it is back
+                  if(event->mask & IN_IGNORED)
+                    {
+                      std::unordered_map<int, std::unordered_map<std::string, std::vector<int>>>::const_iterator lostIt;
+                      lostIt = m_watches.find(event->wd);
+
+                      if(lostIt != m_watches.end())
+                        {
+                          for(const auto& file : lostIt->second)
+                            {
+                              m_orphans.insert(m_orphans.end(), file.second.begin(),
+                                               file.second.end());
+                            }
+
+                          m_watches.erase(lostIt);
+                        }
+
+                      continue;
+                    }
+
+                  if(event->len == 0)
+                    {
+                      continue;
+                    }
+
+                  std::unordered_map<int, std::unordered_map<std::string, std::vector<int>>>::const_iterator dirIt;
+                  dirIt = m_watches.find(event->wd);
+
+                  if(dirIt == m_watches.end())
+                    {
+                      continue;
+                    }
+
+                  std::unordered_map<std::string, std::vector<int>>::const_iterator fileIt;
+                  fileIt = dirIt->second.find(event->name);
+
+                  if(fileIt == dirIt->second.end())
+                    {
+                      continue;
+                    }
+
+                  for(size_t i = 0; i < fileIt->second.size(); i++)
+                    {
+                      const int fileIndex = fileIt->second.at(i);
+
+                      if(isDirty.at(fileIndex) == 0)
+                        {
+                          isDirty.at(fileIndex) = 1;
+                          dirtyFiles.push_back(fileIndex);
+                        }
+                    }
+                }
+            }
+
+          retryOrphans(isDirty, dirtyFiles);
+          fds[0].revents = 0;
+
+          // never wait past the end of the burst's settle time
+          const int elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - burstStart).count();
+
+          settleMs = std::min(_WATCHSETTLEMS, _WATCHSETTLEMAXMS - elapsedMs);
+        } while(settleMs > 0 && poll(fds, 1, settleMs) > 0 && m_running == true);
+
+      if(dirtyFiles.empty())
+        {
+          continue;
+        }
+
+      {
+        std::lock_guard<std::mutex> lock(m_watchMutex);
+
+        dirtyPaths.clear();
+
+        for(size_t i = 0; i < dirtyFiles.size(); i++)
+          {
+            dirtyPaths.push_back(m_paths.at(dirtyFiles.at(i)));
+          }
+      }
+
+      // detect outside of the locks so the UI thread never waits on file reads
+      newDeltas.clear();
+      for(size_t i = 0; i < dirtyFiles.size(); i++)
+        {
+          FileThemeDelta delta;
+          delta.fileIndex = dirtyFiles.at(i);
+          delta.theme = m_detectFunc(dirtyPaths.at(i));
+          newDeltas.push_back(delta);
+          isDirty.at(delta.fileIndex) = 0;
+        }
+      dirtyFiles.clear();
+
+      std::lock_guard<std::mutex> lock(m_deltaMutex);
+      m_deltas.insert(m_deltas.end(), newDeltas.begin(), newDeltas.end());
+      m_hasDeltas = true;
+    }
+} // end of "watchLoop"
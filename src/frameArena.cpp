@@ -0,0 +1,60 @@
+/*
+  File:
+   frameArena.cpp
+
+  Description:
+   The implementation of the frameArena.hpp class.
+*/
+#include "frameArena.hpp"
+
+
+
+/*
+  Function:
+   FrameArena Constructor
+
+  Description:
+   Creates an empty arena over its own buffer, with the heap behind it.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+FrameArena::FrameArena()
+  : m_resource(m_buffer, sizeof(m_buffer), std::pmr::new_delete_resource())
+{
+} // end of "FrameArena Constructor"
+
+
+
+/*
+  Function:
+   reset
+
+  Description:
+   Takes back everything allocated since the last reset, including anything
+   that spilled to the heap. Called once at the start of every frame.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void FrameArena::reset()
+{
+  m_resource.release();
+} // end of "reset"
+
+
+
+std::pmr::memory_resource* FrameArena::getResource()
+{
+  return &m_resource;
+} // end of "getResource"
+
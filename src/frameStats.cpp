@@ -0,0 +1,291 @@
+/*
+  File:
+   frameStats.cpp
+
+  Description:
+   The implementation of the frameStats.hpp accounting hooks.
+*/
+#include <cstdlib>
+#include <new>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "frameStats.hpp"
+
+// the counts of the calling thread since its last resetFrameStats()
+static thread_local FrameStats frameStats;
+
+// the file descriptor curses writes the screen to
+static int countedFd = STDOUT_FILENO;
+
+
+
+#if _FRAMESTATS
+/*
+  Function:
+   countAlloc
+
+  Description:
+   Allocates memory for the replaced operator new and counts it.
+
+  Input:
+   size                 - the number of bytes to allocate.
+
+   alignment            - the alignment of the memory, 0 for the malloc()
+                          default.
+
+  Output:
+   NONE
+
+  Returns:
+   void*                - the memory, or nullptr if there is none.
+*/
+static void* countAlloc(const size_t size,
+                        const size_t alignment)
+{
+  void* memory = nullptr;
+
+  if(alignment == 0)
+    {
+      memory = malloc(size == 0 ? 1 : size);
+    }
+  else if(posix_memalign(&memory, alignment, size == 0 ? 1 : size) != 0)
+    {
+      memory = nullptr;
+    }
+
+  if(memory != nullptr)
+    {
+      frameStats.numAllocs++;
+      frameStats.allocBytes += size;
+    }
+
+  return memory;
+} // end of "countAlloc"
+
+
+
+/*
+  Function:
+   countFree
+
+  Description:
+   Frees memory for the replaced operator delete and counts it.
+
+  Input:
+   memory               - a pointer to the memory, or nullptr.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void countFree(void* memory)
+{
+  if(memory != nullptr)
+    {
+      frameStats.numFrees++;
+      free(memory);
+    }
+} // end of "countFree"
+
+
+
+// the array and nothrow forms of the library call these
+void* operator new(size_t size)
+{
+  void* memory = countAlloc(size, 0);
+
+  if(memory == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+
+  return memory;
+}
+
+void* operator new(size_t size,
+                   std::align_val_t alignment)
+{
+  void* memory = countAlloc(size, (size_t)alignment);
+
+  if(memory == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+
+  return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+  countFree(memory);
+}
+
+void operator delete(void* memory,
+                     size_t) noexcept
+{
+  countFree(memory);
+}
+
+void operator delete(void* memory,
+                     std::align_val_t) noexcept
+{
+  countFree(memory);
+}
+
+void operator delete(void* memory,
+                     size_t,
+                     std::align_val_t) noexcept
+{
+  countFree(memory);
+}
+
+
+
+/*
+  Function:
+   write
+
+  Description:
+   Stands in for the C library write() so the writes curses makes to the
+   terminal are counted. The call goes straight to the system call; the
+   library's own buffered output doesn't come through here.
+
+  Input:
+   fd                   - the file descriptor to write to.
+
+   buffer               - a pointer to the bytes to write.
+
+   count                - the number of bytes to write.
+
+  Output:
+   NONE
+
+  Returns:
+   ssize_t              - the number of bytes written, or -1 with errno set.
+*/
+extern "C" ssize_t write(int fd,
+                         const void* buffer,
+                         size_t count)
+{
+  const ssize_t written = syscall(SYS_write, fd, buffer, count);
+
+  if(fd == countedFd)
+    {
+      frameStats.numWrites++;
+
+      if(written > 0)
+        {
+          frameStats.writeBytes += written;
+        }
+    }
+
+  return written;
+} // end of "write"
+#endif // _FRAMESTATS
+
+
+
+/*
+  Function:
+   getFrameStats
+
+  Description:
+   Returns the counts of the calling thread since its last reset.
+
+  Input:
+   NONE
+
+  Output:
+   stats                - a reference to the counts.
+
+  Returns:
+   NONE
+*/
+void getFrameStats(FrameStats& stats)
+{
+  stats = frameStats;
+} // end of "getFrameStats"
+
+
+
+/*
+  Function:
+   logFrameStats
+
+  Description:
+   Writes the counts of a frame to the log on one line.
+
+  Input:
+   frameNum             - the number of the frame, counted from the first
+                          draw.
+
+   stats                - a reference to the constant counts of the frame.
+
+   log                  - a reference to the log file.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void logFrameStats(const int frameNum,
+                   const FrameStats& stats,
+                   std::ofstream& log)
+{
+  log << "Frame " << frameNum << ": "
+      << stats.numAllocs << " allocs (" << stats.allocBytes << " bytes), "
+      << stats.numFrees << " frees, "
+      << stats.numWrites << " writes (" << stats.writeBytes << " bytes)"
+      << std::endl;
+} // end of "logFrameStats"
+
+
+
+/*
+  Function:
+   resetFrameStats
+
+  Description:
+   Starts the counts of the calling thread over from zero.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void resetFrameStats()
+{
+  frameStats = FrameStats();
+} // end of "resetFrameStats"
+
+
+
+/*
+  Function:
+   setFrameStatsFd
+
+  Description:
+   Sets the file descriptor whose writes are counted: the terminal curses
+   was started on, standard output for initscr() and the output file of a
+   screen started with newterm().
+
+  Input:
+   fd                   - the file descriptor.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void setFrameStatsFd(const int fd)
+{
+  countedFd = fd;
+} // end of "setFrameStatsFd"
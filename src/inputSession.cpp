@@ -0,0 +1,874 @@
+/*
+  File:
+   inputSession.cpp
+
+  Description:
+   The implementation of the inputSession.hpp class.
+*/
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "inputSession.hpp"
+
+// the most bytes an event takes in a recorded session file, six varints
+const size_t _MAXEVENTSIZE = 6 * 5;
+
+
+
+/*
+  Function:
+   putVarint
+
+  Description:
+   Writes the incoming value as a LEB128 varint.
+
+  Input:
+   value                - the value to write.
+
+  Output:
+   buffer               - a pointer to at least 5 bytes to write to.
+
+  Returns:
+   size_t               - the number of bytes written.
+*/
+static size_t putVarint(char* buffer,
+                        uint32_t value)
+{
+  size_t length = 0;
+
+  while(value >= 0x80)
+    {
+      buffer[length++] = (char)(value | 0x80);
+      value >>= 7;
+    }
+
+  buffer[length++] = (char)value;
+
+  return length;
+} // end of "putVarint"
+
+
+
+/*
+  Function:
+   readVarint
+
+  Description:
+   Reads a LEB128 varint starting at offset.
+
+  Input/Output:
+   offset               - a reference to the offset to read at, moved past
+                          the varint.
+
+  Input:
+   data                 - a reference to a constant string to read from.
+
+  Output:
+   value                - a reference to the value read.
+
+  Returns:
+   bool                 - false if the varint runs past the end of data.
+*/
+static bool readVarint(const std::string& data,
+                       size_t& offset,
+                       uint32_t& value)
+{
+  value = 0;
+
+  for(int shift = 0; shift < 35 && offset < data.length(); shift += 7)
+    {
+      const unsigned char byte = data[offset++];
+
+      value |= (uint32_t)(byte & 0x7f) << shift;
+
+      if((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+} // end of "readVarint"
+
+
+
+/*
+  Function:
+   numEventValues
+
+  Description:
+   Returns the number of values an event of the incoming type stores.
+
+  Input:
+   type                 - an InputEventTypes value.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the number of values, or -1 for an unknown type.
+*/
+static int numEventValues(const uint32_t type)
+{
+  switch(type)
+    {
+    case _EVENTKEY:
+      return 1;
+    case _EVENTMOUSE:
+      return 3;
+    case _EVENTSIZE:
+      return 2;
+    default:
+      return -1;
+    }
+} // end of "numEventValues"
+
+
+
+/*
+  Function:
+   InputSession Constructor
+
+  Description:
+   Creates a live session that reads curses until openRecord() or
+   openReplay() is called.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+InputSession::InputSession()
+  : m_mode(_SESSIONLIVE),
+    m_isFast(false),
+    m_nextEvent(0),
+    m_frame(0),
+    m_lastFrame(0),
+    m_lastTime(0),
+    m_numLines(0),
+    m_numCols(0),
+    m_isInputFrame(false),
+    m_numInputFrames(0),
+    m_inputFrameTime(0),
+    m_maxFrameTime(0)
+{
+  memset(m_frameBuckets, 0, sizeof(m_frameBuckets));
+} // end of "InputSession Constructor"
+
+
+
+/*
+  Function:
+   beginFrame
+
+  Description:
+   Ends the last frame and starts the next. A replay waits for the time the
+   frame's first input was recorded at, unless it's fast.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void InputSession::beginFrame()
+{
+  endFrame();
+  m_frame++;
+
+  if(m_mode == _SESSIONREPLAY)
+    {
+      // drop any input the frame it was recorded in didn't read here
+      while(m_nextEvent < m_events.size() && m_events.at(m_nextEvent).frame < m_frame)
+        {
+          m_nextEvent++;
+        }
+
+      if(m_isFast == false &&
+         m_nextEvent < m_events.size() &&
+         m_events.at(m_nextEvent).frame == m_frame)
+        {
+          std::this_thread::sleep_until(m_start +
+                                        std::chrono::microseconds(m_events.at(m_nextEvent).time));
+        }
+    }
+
+  m_frameStart = std::chrono::steady_clock::now();
+} // end of "beginFrame"
+
+
+
+/*
+  Function:
+   openRecord
+
+  Description:
+   Creates the file the session's input is recorded to.
+
+  Input:
+   path                 - a reference to a constant string containing the
+                          path of the file.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the file was created.
+*/
+bool InputSession::openRecord(const std::string& path)
+{
+  m_recordFile.open(path.c_str(), std::ios::binary | std::ios::trunc);
+
+  if(!m_recordFile.is_open())
+    {
+      return false;
+    }
+
+  m_recordFile.write(_RECORDMAGIC, 8);
+  m_mode = _SESSIONRECORD;
+
+  return true;
+} // end of "openRecord"
+
+
+
+/*
+  Function:
+   openReplay
+
+  Description:
+   Reads a recorded session to replay in place of the terminal's input.
+
+  Input:
+   path                 - a reference to a constant string containing the
+                          path of the file.
+
+   isFast               - true to run the frames without waiting, false to
+                          hand back each input at the time it was recorded.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - false if the file can't be read or isn't a
+                          recorded session.
+*/
+bool InputSession::openReplay(const std::string& path,
+                              const bool isFast)
+{
+  std::ifstream inFile(path.c_str(), std::ios::binary);
+  std::stringstream buffer;
+
+  if(!inFile.is_open())
+    {
+      return false;
+    }
+
+  buffer << inFile.rdbuf();
+
+  const std::string contents = buffer.str();
+  size_t offset = 8;
+  uint32_t numLines = 0;
+  uint32_t numCols = 0;
+  uint32_t frame = 0;
+  uint64_t time = 0;
+
+  if(contents.length() < 8 ||
+     contents.compare(0, 8, _RECORDMAGIC) != 0 ||
+     readVarint(contents, offset, numLines) == false ||
+     readVarint(contents, offset, numCols) == false)
+    {
+      return false;
+    }
+
+  m_events.clear();
+
+  while(offset < contents.length())
+    {
+      InputEvent event;
+      uint32_t frameDelta = 0;
+      uint32_t timeDelta = 0;
+      uint32_t type = 0;
+
+      if(readVarint(contents, offset, frameDelta) == false ||
+         readVarint(contents, offset, timeDelta) == false ||
+         readVarint(contents, offset, type) == false ||
+         numEventValues(type) == -1)
+        {
+          return false;
+        }
+
+      frame += frameDelta;
+      time += timeDelta;
+      event.frame = frame;
+      event.time = time;
+      event.type = type;
+      memset(event.values, 0, sizeof(event.values));
+
+      for(int i = 0; i < numEventValues(type); i++)
+        {
+          if(readVarint(contents, offset, event.values[i]) == false)
+            {
+              return false;
+            }
+        }
+
+      m_events.push_back(event);
+    }
+
+  m_numLines = numLines;
+  m_numCols = numCols;
+  m_nextEvent = 0;
+  m_isFast = isFast;
+  m_mode = _SESSIONREPLAY;
+
+  return true;
+} // end of "openReplay"
+
+
+
+/*
+  Function:
+   readFrame
+
+  Description:
+   Begins a frame and drains its input: every key and mouse event waiting,
+   up to _MAXFRAMEINPUT. A wheel step up or down becomes a KEY_SR or KEY_SF
+   at the cell it was made on, other mouse events than button 1 presses are
+   dropped, and a press or step on the cell of the last one of its kind adds
+   to its count.
+   A resize report is counted and ends the frame's input; curses would
+   redraw the resized screen on the next read, before the frame lays it
+   out, and whatever follows is meant for the new layout anyway.
+
+  Input:
+   window               - a pointer to the curses window to read from.
+
+  Output:
+   frameInput           - a reference to the frame's input, its events in
+                          the order they were read.
+
+  Returns:
+   NONE
+*/
+void InputSession::readFrame(WINDOW* window,
+                             FrameInput& frameInput)
+{
+  MEVENT mice[_MAXFRAMEINPUT];
+  int input = ERR;
+  int numInputs = 0;
+  int numMice = 0;
+
+  frameInput.events.clear();
+  frameInput.numResizes = 0;
+  beginFrame();
+
+  while(numInputs < _MAXFRAMEINPUT && (input = readInput(window)) != ERR)
+    {
+      numInputs++;
+
+      if(input == KEY_RESIZE)
+        {
+          frameInput.numResizes++;
+          break;
+        }
+      else if(input != KEY_MOUSE)
+        {
+          frameInput.events.push_back({input, -1, -1, 1});
+          continue;
+        }
+
+      // curses queues every mouse report it has decoded behind one KEY_MOUSE
+      // and hands them back newest first, so take them all and walk them
+      // back in the order they were made
+      for(numMice = 0; numInputs + numMice < _MAXFRAMEINPUT &&
+            readMouse(mice[numMice]) == OK; numMice++);
+
+      numInputs += numMice;
+
+      for(int i = numMice - 1; i >= 0; i--)
+        {
+          if((mice[i].bstate & BUTTON1_PRESSED) != 0)
+            {
+              input = KEY_MOUSE;
+            }
+          else if((mice[i].bstate & BUTTON4_PRESSED) != 0)
+            {
+              input = KEY_SR;
+            }
+          else if((mice[i].bstate & BUTTON5_PRESSED) != 0)
+            {
+              input = KEY_SF;
+            }
+          else
+            {
+              continue;
+            }
+
+          if(frameInput.events.empty() == false &&
+             frameInput.events.back().input == input &&
+             frameInput.events.back().mouseLine == mice[i].y &&
+             frameInput.events.back().mouseCol == mice[i].x)
+            {
+              frameInput.events.back().count++;
+            }
+          else
+            {
+              frameInput.events.push_back({input, mice[i].y, mice[i].x, 1});
+            }
+        }
+    }
+} // end of "readFrame"
+
+
+
+/*
+  Function:
+   readInput
+
+  Description:
+   Returns the next key of the frame, as wgetch() on the incoming window
+   would.
+
+  Input:
+   window               - a pointer to the curses window to read from.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the key, or ERR if there is none.
+*/
+int InputSession::readInput(WINDOW* window)
+{
+  InputEvent event;
+  int input = ERR;
+
+  if(m_mode == _SESSIONREPLAY)
+    {
+      if(takeEvent(_EVENTKEY, event) == true)
+        {
+          input = event.values[0];
+        }
+
+      return input;
+    }
+
+  input = wgetch(window);
+
+  if(input != ERR)
+    {
+      m_isInputFrame = true;
+
+      if(m_mode == _SESSIONRECORD)
+        {
+          writeEvent(_EVENTKEY, input, 0, 0);
+        }
+    }
+
+  return input;
+} // end of "readInput"
+
+
+
+/*
+  Function:
+   readMouse
+
+  Description:
+   Returns the frame's mouse event, as getmouse() would.
+
+  Input:
+   NONE
+
+  Output:
+   mouse                - a reference to the mouse event.
+
+  Returns:
+   int                  - OK if there was a mouse event, ERR otherwise.
+*/
+int InputSession::readMouse(MEVENT& mouse)
+{
+  InputEvent event;
+
+  if(m_mode == _SESSIONREPLAY)
+    {
+      if(takeEvent(_EVENTMOUSE, event) == false)
+        {
+          return ERR;
+        }
+
+      memset(&mouse, 0, sizeof(mouse));
+      mouse.y = event.values[0];
+      mouse.x = event.values[1];
+      mouse.bstate = event.values[2];
+
+      return OK;
+    }
+
+  if(getmouse(&mouse) != OK)
+    {
+      return ERR;
+    }
+
+  m_isInputFrame = true;
+
+  if(m_mode == _SESSIONRECORD)
+    {
+      writeEvent(_EVENTMOUSE, mouse.y, mouse.x, mouse.bstate);
+    }
+
+  return OK;
+} // end of "readMouse"
+
+
+
+/*
+  Function:
+   readScreenSize
+
+  Description:
+   Returns the size of the screen, as getmaxyx() on stdscr would. A replay
+   resizes the curses screen to each recorded size as it comes up.
+
+  Input:
+   NONE
+
+  Output:
+   numLines             - a reference to the number of lines.
+
+   numCols              - a reference to the number of columns.
+
+  Returns:
+   NONE
+*/
+void InputSession::readScreenSize(int& numLines,
+                                  int& numCols)
+{
+  InputEvent event;
+
+  if(m_mode == _SESSIONREPLAY && takeEvent(_EVENTSIZE, event) == true)
+    {
+      resize_term(event.values[0], event.values[1]);
+    }
+
+  getmaxyx(stdscr, numLines, numCols);
+
+  if(m_mode != _SESSIONREPLAY &&
+     (numLines != m_numLines || numCols != m_numCols))
+    {
+      m_numLines = numLines;
+      m_numCols = numCols;
+      m_isInputFrame = true;
+
+      if(m_mode == _SESSIONRECORD)
+        {
+          writeEvent(_EVENTSIZE, numLines, numCols, 0);
+        }
+    }
+} // end of "readScreenSize"
+
+
+
+/*
+  Function:
+   start
+
+  Description:
+   Starts the session's clock once curses is initialized. A recording
+   writes the starting screen size; a replay resizes the curses screen to
+   the recorded one.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void InputSession::start()
+{
+  m_start = std::chrono::steady_clock::now();
+  m_frameStart = m_start;
+
+  if(m_mode == _SESSIONREPLAY)
+    {
+      resize_term(m_numLines, m_numCols);
+      return;
+    }
+
+  getmaxyx(stdscr, m_numLines, m_numCols);
+
+  if(m_mode == _SESSIONRECORD)
+    {
+      char buffer[_MAXEVENTSIZE];
+      size_t length = 0;
+
+      length += putVarint(buffer + length, m_numLines);
+      length += putVarint(buffer + length, m_numCols);
+      m_recordFile.write(buffer, length);
+      m_recordFile.flush();
+    }
+} // end of "start"
+
+
+
+/*
+  Function:
+   waitFrame
+
+  Description:
+   Ends a frame and sleeps _FRAMEDELAY before the next, unless it's a fast
+   replay.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void InputSession::waitFrame()
+{
+  endFrame();
+
+  if(m_mode != _SESSIONREPLAY || m_isFast == false)
+    {
+      usleep(_FRAMEDELAY);
+    }
+} // end of "waitFrame"
+
+
+
+/*
+  Function:
+   writeFrameTimes
+
+  Description:
+   Writes the histogram of the times of the frames that read input, from
+   reading it to waiting for the next frame, and its percentiles.
+
+  Input:
+   NONE
+
+  Output:
+   out                  - a reference to the stream to write to.
+
+  Returns:
+   NONE
+*/
+void InputSession::writeFrameTimes(std::ostream& out) const
+{
+  int first = _NUMFRAMEBUCKETS;
+  int last = -1;
+
+  out << "Frames: " << m_frame << ", " << m_numInputFrames << " with input";
+
+  if(m_numInputFrames > 0)
+    {
+      out << ", mean " << m_inputFrameTime / m_numInputFrames << " us"
+          << ", max " << m_maxFrameTime << " us";
+    }
+
+  out << std::endl;
+
+  for(int i = 0; i < _NUMFRAMEBUCKETS; i++)
+    {
+      if(m_frameBuckets[i] != 0)
+        {
+          first = std::min(first, i);
+          last = i;
+        }
+    }
+
+  for(int i = first; i <= last; i++)
+    {
+      out << std::setw(10) << (i == 0 ? 0 : 1 << i) << " - "
+          << std::setw(10) << (1 << (i + 1)) << " us: "
+          << m_frameBuckets[i] << std::endl;
+    }
+
+  const int percentiles[] = {50, 90, 99};
+  uint64_t count = 0;
+  int bucket = 0;
+
+  for(int i = 0; i < 3 && m_numInputFrames > 0; i++)
+    {
+      // the bucket holding the frame at the percentile
+      while(count + m_frameBuckets[bucket] < (m_numInputFrames * percentiles[i] + 99) / 100)
+        {
+          count += m_frameBuckets[bucket];
+          bucket++;
+        }
+
+      out << (i == 0 ? "" : ", ") << "p" << percentiles[i] << " < " << (1 << (bucket + 1)) << " us";
+    }
+
+  if(m_numInputFrames > 0)
+    {
+      out << std::endl;
+    }
+} // end of "writeFrameTimes"
+
+
+
+/*
+  Function:
+   endFrame
+
+  Description:
+   Adds the time of the current frame to the histogram if it read input.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void InputSession::endFrame()
+{
+  if(m_isInputFrame == false)
+    {
+      return;
+    }
+
+  const uint64_t frameTime = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - m_frameStart).count();
+  int bucket = 0;
+
+  while(bucket < _NUMFRAMEBUCKETS - 1 && frameTime >= (2u << bucket))
+    {
+      bucket++;
+    }
+
+  m_frameBuckets[bucket]++;
+  m_numInputFrames++;
+  m_inputFrameTime += frameTime;
+  m_maxFrameTime = std::max(m_maxFrameTime, frameTime);
+  m_isInputFrame = false;
+} // end of "endFrame"
+
+
+
+/*
+  Function:
+   takeEvent
+
+  Description:
+   Takes the next recorded event if it's of the incoming type and was read
+   in the current frame.
+
+  Input:
+   type                 - an InputEventTypes value.
+
+  Output:
+   event                - a reference to the event.
+
+  Returns:
+   bool                 - true if the event was taken.
+*/
+bool InputSession::takeEvent(const int type,
+                             InputEvent& event)
+{
+  if(m_nextEvent >= m_events.size() ||
+     m_events.at(m_nextEvent).frame != m_frame ||
+     m_events.at(m_nextEvent).type != type)
+    {
+      return false;
+    }
+
+  event = m_events.at(m_nextEvent);
+  m_nextEvent++;
+  m_isInputFrame = true;
+
+  return true;
+} // end of "takeEvent"
+
+
+
+/*
+  Function:
+   writeEvent
+
+  Description:
+   Writes an event of the current frame to the recorded session file and
+   flushes it, so a session that ends in a crash can still be replayed.
+
+  Input:
+   type                 - an InputEventTypes value.
+
+   value0               - the first value of the event.
+
+   value1               - the second value of the event, if it has one.
+
+   value2               - the third value of the event, if it has one.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void InputSession::writeEvent(const int type,
+                              const uint32_t value0,
+                              const uint32_t value1,
+                              const uint32_t value2)
+{
+  const uint64_t time = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - m_start).count();
+  const uint32_t values[3] = {value0, value1, value2};
+  char buffer[_MAXEVENTSIZE];
+  size_t length = 0;
+
+  length += putVarint(buffer + length, m_frame - m_lastFrame);
+  length += putVarint(buffer + length, (uint32_t)(time - m_lastTime));
+  length += putVarint(buffer + length, type);
+
+  for(int i = 0; i < numEventValues(type); i++)
+    {
+      length += putVarint(buffer + length, values[i]);
+    }
+
+  m_recordFile.write(buffer, length);
+  m_recordFile.flush();
+  m_lastFrame = m_frame;
+  m_lastTime = time;
+} // end of "writeEvent"
+
+
+
+bool InputSession::getIsFinished() const
+{
+  // a replay is over once the frame after its last input has begun
+  return m_mode == _SESSIONREPLAY &&
+    m_nextEvent >= m_events.size() &&
+    (m_events.empty() == true || m_frame > m_events.back().frame);
+}
+
+
+
+int InputSession::getMode() const
+{
+  return m_mode;
+}
+
+
+
+int InputSession::getNumFrames() const
+{
+  return m_frame;
+}
@@ -15,7 +15,9 @@
   Changes the color theme for Linux Window Managers and/or Terminal
   Emulators.  A GUI is provided by the Ncurses library.
 */
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -27,12 +29,26 @@
 #include "_cursesWinConsts.hpp"
 #include "_progStateConsts.hpp"
 #include "_winStringConsts.hpp"
+#include "colorPairAllocator.hpp"
+#include "commandLine.hpp"
 #include "cursesFunctions.hpp"
 #include "cursesWindow.hpp"
 #include "fileOperations.hpp"
+#include "fileWatcher.hpp"
+#include "frameArena.hpp"
+#include "frameStats.hpp"
+#include "inputSession.hpp"
 #include "log.hpp"
+#include "overlayStack.hpp"
+#include "palette.hpp"
 #include "programStates.hpp"
+#include "renderBackends.hpp"
 #include "testingInterface.hpp"
+#include "themeClusters.hpp"
+#include "themeGrid.hpp"
+#include "themeLibrary.hpp"
+#include "themeDetector.hpp"
+#include "winLayout.hpp"
 
 #define _CURSES 1
 
@@ -41,8 +57,35 @@
 /*
   main()
 */
-int main()
+int main(int argc, char** argv)
 {
+  InputSession inputSession;
+
+  // record the input of the session to a file, or replay a recorded one
+  if(argc == 3 && strcmp(argv[1], "record") == 0)
+    {
+      if(inputSession.openRecord(argv[2]) == false)
+        {
+          std::cerr << "themeswitcher: can't create " << argv[2] << std::endl;
+          return _CLIFAILED;
+        }
+    }
+  else if((argc == 3 || (argc == 4 && strcmp(argv[3], "--fast") == 0)) &&
+          strcmp(argv[1], "replay") == 0)
+    {
+      if(inputSession.openReplay(argv[2], argc == 4) == false)
+        {
+          std::cerr << "themeswitcher: can't replay " << argv[2] << std::endl;
+          return _CLIFAILED;
+        }
+    }
+  // run a command line command headless, skipping the log and curses
+  else if(argc > 1)
+    {
+      return runCommandLine(argc,
+                            argv);
+    }
+
   // ## CREATE LOGGING SYSTEM
   time_t rawtime;
   struct tm* timeinfo;
@@ -105,60 +148,122 @@ int main()
   std::vector<std::string> sfOutput;
   int sfStringPos = 0;
   // saved theme variables
-  std::vector<std::string> stStrings;
-  std::vector<std::string> stOutput;
+  ThemeLibrary stLibrary;
+  ThemeClusters stClusters(stLibrary);
   int stStringPos = 0;
+  // theme preview variables, the library palettes unpacked so far
+  std::unordered_map<std::string, Palette> stPalettes;
+  int stPreviewNum = -1;
 
 
-  // for testing windows and visual button operations with dummy strings
-  const int numStrings = 100;
-  initTestFilesStringVector(sfStrings,
-                            numStrings,
-                            log);
-  initTestCurrThemesStringVector(sfThemes,
-                                 numStrings,
-                                 log);
-  initSTStrings(stStrings,
-                numStrings,
-                _STWINMAXCOLS,
-                log);
+  // the saved files, none until the first one is added
+  if(readSavedFiles(savedFilesStorePath(), sfStrings) == false)
+    {
+      log << "No saved files read from " << savedFilesStorePath() << std::endl;
+    }
+
+  // the saved themes library, test themes until one has been saved. the
+  // preview reads every palette from the library, so the test themes carry
+  // their generated palettes packed like imported ones.
+  if(stLibrary.load(themeLibraryStorePath()) == false)
+    {
+      const int numStrings = 100;
+      std::vector<std::string> stStrings;
+      std::unordered_map<std::string, Palette> testPalettes;
+      std::vector<LibraryEntry> stEntries;
+
+      initSTStrings(stStrings,
+                    numStrings,
+                    _STWINMAXCOLS,
+                    log);
+      initTestPalettes(stStrings,
+                       testPalettes,
+                       log);
+      stEntries.resize(stStrings.size());
+
+      for(size_t i = 0; i < stStrings.size(); i++)
+        {
+          stEntries.at(i).name = stStrings.at(i);
+          testPalettes.at(stStrings.at(i)).pack(stEntries.at(i).value);
+        }
+
+      stLibrary.buildEntries(stEntries);
+    }
+
+  // read the theme each saved file currently applies
+  detectFileThemes(sfStrings,
+                   sfThemes,
+                   log);
+
+  // keep the current theme of each saved file in sync with the files on disk
+  FileWatcher fileWatcher(detectFileTheme);
+  std::vector<FileThemeDelta> themeDeltas;
+  fileWatcher.start(sfStrings,
+                    log);
 
   // ## initialize curses and starting windows ##
 #if _CURSES
   std::unordered_map<int, CursesWindow*> wins;
   std::vector<CursesWindow*> sfStringWins;
-  std::vector<CursesWindow*> stStringWins;
-  MEVENT mouse;
+  ColorPairAllocator colorPairs;
+  FrameArena frameArena;
+  CursesBackend renderBackend;
+  ThemeGrid stGrid(&renderBackend);
+  FrameInput frameInput;
+  OverlayStack overlays(wins,
+                        sfStringWins,
+                        stGrid);
+  HWSFAddFileState hwSFAddFileState(frameArena,
+                                    overlays);
+  ProgramState* openState = nullptr;
+  bool isChanged = false;
+  bool isStateChanged = false;
+  bool isDismissed = false;
+  bool isClicked = false;
+  bool isPreviewChanged = false;
+  bool isQuit = false;
+  int lastButton = -1;
+#if _FRAMESTATS
+  FrameStats frameStats;
+  int frameNum = 0;
+#endif
 
   initializeCurses();
+#if _FRAMESTATS
+  // initscr() draws to standard output, count the writes of that terminal
+  setFrameStatsFd(fileno(stdout));
+#endif
+  inputSession.start();
+  colorPairs.initialize(_PREVIEWPAIRSTART);
   initializeWins(wins,
+                 renderBackend,
                  log);
-  stOutput = createSTOutputStrings(wins,
-                                   stStrings,
-                                   stStringPos,
-                                   log);
 
   // run once, defining the windows and printing initial starting data
   {
+#if _FRAMESTATS
+    resetFrameStats();
+#endif
     definePromptTitle(promptStrings);
     defineWins(wins,
                log);
     getmaxyx(wins.at(_MAINWIN)->getWindow(), currLines, currCols);
     defineSFStringWins(wins,
                        sfStringWins,
-                       stOutput,
+                       sfStrings,
                        sfStringPos,
                        log);
-    sfOutput = createSFOutputStrings(wins,
-                                     sfStringWins,
-                                     sfStrings,
-                                     sfThemes,
-                                     log);
-    defineSTStringWins(wins,
-                       stStringWins,
-                       stOutput,
-                       stStringPos,
-                       log);
+    createSFOutputStrings(wins,
+                          sfStringWins,
+                          sfStrings,
+                          sfThemes,
+                          sfOutput,
+                          log);
+    stGrid.defineGrid(wins);
+    stGrid.showPage(wins,
+                    stClusters,
+                    stStringPos,
+                    log);
     printPromptWin(wins,
                    promptStrings,
                    currLines,
@@ -179,17 +284,15 @@ int main()
                            log);
     printSavedThemesWin(wins,
                         log);
-    printSavedThemesStrings(wins,
-                            stStringWins,
-                            stOutput,
-                            stStringPos,
-                            stHighlightNum,
-                            log);
+    stGrid.printHighlight(stHighlightNum);
+    printPreviewWin(wins,
+                    nullptr,
+                    colorPairs,
+                    log);
     refreshWins(wins);
     refreshSFStringWins(sfStringWins,
                         log);
-    refreshSTStringWins(stStringWins,
-                        log);
+    stGrid.stageGrid();
     doupdate();
   }
 #endif // _CURSES
@@ -198,11 +301,30 @@ int main()
   while(true)
     {
 #if _CURSES
-      // get user input from mouse or keyboard
-      input = wgetch(wins.at(_MAINWIN)->getWindow());
-      input = toupper(input);
+      // the temporaries of the last frame are gone, take their memory back
+      frameArena.reset();
+
+#if _FRAMESTATS
+      // log the last frame if it allocated or drew anything, idle ones don't
+      getFrameStats(frameStats);
+
+      if(frameStats.numAllocs != 0 || frameStats.numFrees != 0 || frameStats.numWrites != 0)
+        {
+          logFrameStats(frameNum,
+                        frameStats,
+                        log);
+        }
+
+      frameNum++;
+      resetFrameStats();
+#endif
+
+      // get every key and click since the last frame
+      inputSession.readFrame(wins.at(_MAINWIN)->getWindow(),
+                             frameInput);
 
-      if(input == 'Q')
+      // a replay ends with its input
+      if(inputSession.getIsFinished() == true)
         {
           break;
         }
@@ -211,28 +333,32 @@ int main()
       stHighlightNum = -1;
       mouseLine = -1;
       mouseCol = -1;
+      isChanged = false;
+      isStateChanged = false;
+      isClicked = false;
+      isPreviewChanged = false;
+      isQuit = false;
+      lastButton = -1;
 
-      if(getmouse(&mouse) == OK)
-        {
-          if(mouse.bstate & BUTTON1_PRESSED)
-            {
-              mouseLine = mouse.y;
-              mouseCol = mouse.x;
-            }
-        }
-
-      // check if the window size has changed
-      getmaxyx(stdscr, currLines, currCols);
+      // check if the window size has changed, once for any number of resize
+      // reports
+      inputSession.readScreenSize(currLines, currCols);
 
       // if screen size changed, reprint a default screen with current
       // data positions
       if((currLines != wins.at(_MAINWIN)->getNumLines()) ||
           (currCols != wins.at(_MAINWIN)->getNumCols()))
         {
+          // an open state was laid out for the old size, close it first
+          if(openState != nullptr)
+            {
+              openState->closeState(wins);
+              openState = nullptr;
+            }
+
           arrowClickVal = 0;
           clearWins(wins);
           clearSFStringWins(sfStringWins);
-          clearSFStringWins(stStringWins);
 
           // the window size has changed. update window dimensions
           wins.at(_MAINWIN)->setNumLines(currLines);
@@ -246,16 +372,17 @@ int main()
                              sfStrings,
                              sfStringPos,
                              log);
-          defineSTStringWins(wins,
-                             stStringWins,
-                             stOutput,
-                             stStringPos,
-                             log);
-          sfOutput = createSFOutputStrings(wins,
-                                           sfStringWins,
-                                           sfStrings,
-                                           sfThemes,
-                                           log);
+          stGrid.defineGrid(wins);
+          stGrid.showPage(wins,
+                          stClusters,
+                          stStringPos,
+                          log);
+          createSFOutputStrings(wins,
+                                sfStringWins,
+                                sfStrings,
+                                sfThemes,
+                                sfOutput,
+                                log);
           // print the window data
           printPromptWin(wins,
                          promptStrings,
@@ -277,186 +404,303 @@ int main()
                                  log);
           printSavedThemesWin(wins,
                               log);
-          printSavedThemesStrings(wins,
-                                  stStringWins,
-                                  stOutput,
-                                  stStringPos,
-                                  stHighlightNum,
-                                  log);
+          stGrid.printHighlight(stHighlightNum);
+          printPreviewWin(wins,
+                          findPreviewPalette(stPalettes,
+                                             stLibrary,
+                                             stPreviewNum),
+                          colorPairs,
+                          log);
           refreshWins(wins);
 
           refreshSFStringWins(sfStringWins,
                               log);
-          refreshSTStringWins(stStringWins,
-                              log);
-          doupdate();
+          stGrid.stageGrid();
+          isChanged = true;
         }
 
-      // check for a mouse click and operate on the line/col values
-      if(mouseLine != -1 || mouseCol != -1)
+      // handle the frame's keys and clicks in order, drawing once after
+      for(size_t i = 0; i < frameInput.events.size(); i++)
         {
-          int buttonNum = -1;
+          const FrameEvent& event = frameInput.events.at(i);
 
-          // check if a button was clicked
-          buttonNum = checkButtonClick(wins,
-                                       mouseLine,
-                                       mouseCol,
-                                       log);
+          isDismissed = false;
 
-          // switch to button that was clicked and do operation(s)
-          switch(buttonNum)
+          // an open state takes the input until it closes
+          if(openState != nullptr)
             {
-            case _LARROWSAVEDFILESWIN:
-              flashButton(wins,
-                          _LARROWSAVEDFILESWIN,
-                          leftArrow,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              shiftSFLeft(wins,
-                          sfStringWins,
-                          sfOutput,
-                          sfStringPos,
-                          log);
-              break;
-            case _RARROWSAVEDFILESWIN:
-              flashButton(wins,
-                          _RARROWSAVEDFILESWIN,
-                          rightArrow,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              shiftSFRight(wins,
-                           sfStringWins,
+              isStateChanged = true;
+
+              if(openState->handleInput(wins,
+                                        event,
+                                        log) == true)
+                {
+                  continue;
+                }
+
+              openState->closeState(wins);
+
+              // a path entered in the add file prompt becomes a saved file,
+              // stored and watched like the others from now on
+              if(openState == &hwSFAddFileState && event.input != KEY_MOUSE &&
+                 !hwSFAddFileState.getOutputString().empty())
+                {
+                  const std::string& path = hwSFAddFileState.getOutputString();
+
+                  if(appendSavedFile(savedFilesStorePath(), path) == false)
+                    {
+                      log << "Can't store saved file: " << path << std::endl;
+                    }
+
+                  sfStrings.push_back(path);
+                  sfThemes.push_back(detectFileTheme(path));
+                  fileWatcher.addFile(path);
+                  createSFOutputStrings(wins,
+                                        sfStringWins,
+                                        sfStrings,
+                                        sfThemes,
+                                        sfOutput,
+                                        log);
+                  printSavedFilesStrings(wins,
+                                         sfStringWins,
+                                         sfOutput,
+                                         sfStringPos,
+                                         currStartWin,
+                                         sfHighlightNum,
+                                         log);
+                  refreshSFStringWins(sfStringWins,
+                                      log);
+                  log << "Added saved file: " << path << std::endl;
+                }
+
+              openState = nullptr;
+
+              // a click that closes the state still selects what it is on
+              if(event.input != KEY_MOUSE)
+                {
+                  continue;
+                }
+
+              isDismissed = true;
+            }
+
+          // check for a mouse click and operate on the line/col values
+          if(event.input == KEY_MOUSE)
+            {
+              int buttonNum = -1;
+
+              mouseLine = event.mouseLine;
+              mouseCol = event.mouseCol;
+              isClicked = true;
+
+              // check if a button was clicked
+              if(isDismissed == false)
+                {
+                  buttonNum = checkButtonClick(wins,
+                                               mouseLine,
+                                               mouseCol,
+                                               log);
+                }
+
+              // flash a button once for a run of clicks on it
+              if(buttonNum != -1 && buttonNum != _HWSFADDFILE && buttonNum != lastButton)
+                {
+                  flashButton(wins,
+                              buttonNum,
+                              findWidgetLabel(buttonNum),
+                              _BLACK_TEXT,
+                              _WHITE_TEXT,
+                              log);
+                }
+
+              lastButton = buttonNum;
+
+              // switch to button that was clicked and do operation(s), a page
+              // for each click of an arrow
+              switch(buttonNum)
+                {
+                case _LARROWSAVEDFILESWIN:
+                  for(int j = 0; j < event.count; j++)
+                    {
+                      shiftSFLeft(wins,
+                                  sfStringWins,
+                                  sfOutput,
+                                  sfStringPos,
+                                  log);
+                    }
+                  break;
+                case _RARROWSAVEDFILESWIN:
+                  for(int j = 0; j < event.count; j++)
+                    {
+                      shiftSFRight(wins,
+                                   sfStringWins,
+                                   sfOutput,
+                                   sfStringPos,
+                                   log);
+                    }
+                  break;
+                case _LARROWSAVEDTHEMESWIN:
+                  for(int j = 0; j < event.count; j++)
+                    {
+                      shiftSTLeft(wins,
+                                  stGrid,
+                                  stClusters,
+                                  stStringPos,
+                                  log);
+                    }
+                  break;
+                case _RARROWSAVEDTHEMESWIN:
+                  for(int j = 0; j < event.count; j++)
+                    {
+                      shiftSTRight(wins,
+                                   stGrid,
+                                   stClusters,
+                                   stStringPos,
+                                   log);
+                    }
+                  break;
+                case _HWSFADDFILE:
+                  openState = &hwSFAddFileState;
+                  openState->openState(wins,
+                                       log);
+                  isStateChanged = true;
+                  break;
+                default:
+                  break;
+                }
+
+              // check if a _SAVEDFILESWIN file was clicked (highlights SF string)
+              checkSFClick(wins,
                            sfOutput,
                            sfStringPos,
+                           mouseLine,
+                           mouseCol,
+                           sfHighlightNum,
                            log);
-              break;
-            case _LARROWSAVEDTHEMESWIN:
-              flashButton(wins,
-                          _LARROWSAVEDTHEMESWIN,
-                          leftArrow,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              shiftSTLeft(wins,
-                          stStringWins,
-                          stOutput,
-                          stStringPos,
-                          log);
-              break;
-            case _RARROWSAVEDTHEMESWIN:
-              flashButton(wins,
-                          _RARROWSAVEDTHEMESWIN,
-                          rightArrow,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              shiftSTRight(wins,
-                           stStringWins,
-                           stOutput,
-                           stStringPos,
-                           log);
-              break;
-            case _HWSFADDFILE:
-              enterHWSFAddFileState(wins,
-                                    mouse,
-                                    mouseLine,
-                                    mouseCol,
-                                    log);
-              break;
-            case _HWSFEDITFILEPATH:
-              flashButton(wins,
-                          _HWSFEDITFILEPATH,
-                          _hwSFEditFilePath,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSFVIEWFILEPATH:
-              flashButton(wins,
-                          _HWSFVIEWFILEPATH,
-                          _hwSFViewFilePath,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSFREMOVEFILE:
-              flashButton(wins,
-                          _HWSFREMOVEFILE,
-                          _hwSFRemoveFile,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSFADDTHEME:
-              flashButton(wins,
-                          _HWSFADDTHEME,
-                          _hwSFAddTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSFEDITTHEME:
-              flashButton(wins,
-                          _HWSFEDITTHEME,
-                          _hwSFEditTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSFREMOVETHEME:
-              flashButton(wins,
-                          _HWSFREMOVETHEME,
-                          _hwSFRemoveTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSTADDTHEME:
-              flashButton(wins,
-                          _HWSTADDTHEME,
-                          _hwSTAddTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSTREMOVETHEME:
-              flashButton(wins,
-                          _HWSTREMOVETHEME,
-                          _hwSTRemoveTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSTEDITTHEME:
-              flashButton(wins,
-                          _HWSTEDITTHEME,
-                          _hwSTEditTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            case _HWSTVIEWTHEME:
-              flashButton(wins,
-                          _HWSTVIEWTHEME,
-                          _hwSTViewTheme,
-                          _BLACK_TEXT,
-                          _WHITE_TEXT,
-                          log);
-              break;
-            default:
+
+              // check if a _SAVEDTHEMESWIN file was clicked (highlights ST string)
+              stHighlightNum = stGrid.checkClick(mouseLine,
+                                                 mouseCol);
+
+              // preview a saved theme when it is clicked
+              if(stHighlightNum != -1)
+                {
+                  stPreviewNum = stClusters.getVisible(stStringPos + stHighlightNum);
+                }
+
+              continue;
+            }
+
+          lastButton = -1;
+
+          // scroll the saved files a line for each arrow key, or each wheel
+          // step over them
+          if(event.input == KEY_UP || event.input == KEY_DOWN ||
+             ((event.input == KEY_SR || event.input == KEY_SF) &&
+              checkWindowClick(wins,
+                               _SAVEDFILESWIN,
+                               event.mouseLine,
+                               event.mouseCol,
+                               1,
+                               1,
+                               1,
+                               1,
+                               log) == true))
+            {
+              const int numLines = event.input == KEY_UP || event.input == KEY_SR ?
+                -event.count : event.count;
+
+              if(scrollSFLines(wins,
+                               sfStringWins,
+                               sfOutput,
+                               sfStringPos,
+                               numLines,
+                               log) == true)
+                {
+                  refreshSFStringWins(sfStringWins,
+                                      log);
+                  isChanged = true;
+                }
+
+              continue;
+            }
+
+          input = toupper(event.input);
+
+          if(input == 'Q')
+            {
+              isQuit = true;
               break;
             }
 
-          // check if a _SAVEDFILESWIN file was clicked (highlights SF string)
-          checkSFClick(wins,
-                       sfOutput,
-                       sfStringPos,
-                       mouseLine,
-                       mouseCol,
-                       sfHighlightNum,
-                       log);
+          // step the theme preview through the saved themes
+          if((input == 'J' || input == 'K') && stLibrary.getNumEntries() > 0)
+            {
+              if(input == 'J')
+                {
+                  stPreviewNum = std::min(stPreviewNum + 1, stLibrary.getNumEntries() - 1);
+                }
+              else
+                {
+                  stPreviewNum = std::max(stPreviewNum - 1, 0);
+                }
+
+              isPreviewChanged = true;
+            }
+
+          // show or hide the duplicates of each saved theme, grouping the themes
+          // the first time
+          if(input == 'D' && wins.at(_SAVEDTHEMESWIN)->getIsOpen())
+            {
+              if(stClusters.getIsClustered() == false)
+                {
+                  stClusters.buildClusters();
+                }
+
+              stClusters.setIsCollapsed(!stClusters.getIsCollapsed());
+              stStringPos = 0;
+              stGrid.resetGrid();
+              stGrid.showPage(wins,
+                              stClusters,
+                              stStringPos,
+                              log);
+              stGrid.printHighlight(-1);
+              stGrid.stageGrid();
+              isChanged = true;
+            }
+        }
+
+      if(isQuit == true)
+        {
+          break;
+        }
+
+      // print any current theme changes the file watcher has detected
+      if(fileWatcher.takeDeltas(themeDeltas))
+        {
+          if(updateSFOutputStrings(sfStringWins,
+                                   sfStrings,
+                                   sfThemes,
+                                   sfOutput,
+                                   themeDeltas,
+                                   sfStringPos,
+                                   log))
+            {
+              printSavedFilesStrings(wins,
+                                     sfStringWins,
+                                     sfOutput,
+                                     sfStringPos,
+                                     currStartWin,
+                                     sfHighlightNum,
+                                     log);
+              refreshSFStringWins(sfStringWins,
+                                  log);
+              isChanged = true;
+            }
+        }
+
+      if(isClicked == true)
+        {
           printSavedFilesStrings(wins,
                                  sfStringWins,
                                  sfOutput,
@@ -464,37 +708,64 @@ int main()
                                  currStartWin,
                                  sfHighlightNum,
                                  log);
-
-          // check if a _SAVEDTHEMESWIN file was clicked (highlights ST string)
-          checkSTClick(wins,
-                       stStringWins,
-                       mouseLine,
-                       mouseCol,
-                       stHighlightNum,
-                       log);
-          printSavedThemesStrings(wins,
-                                  stStringWins,
-                                  stOutput,
-                                  stStringPos,
-                                  stHighlightNum,
-                                  log);
+          stGrid.printHighlight(stHighlightNum);
           printHelpWin(wins,
                        log);
+          printPreviewWin(wins,
+                          findPreviewPalette(stPalettes,
+                                             stLibrary,
+                                             stPreviewNum),
+                          colorPairs,
+                          log);
 
           // print any changes to the windows
           refreshWins(wins);
           refreshSFStringWins(sfStringWins,
                               log);
-          refreshSTStringWins(stStringWins,
-                              log);
+          stGrid.stageGrid();
+          isChanged = true;
+        }
+      else if(isPreviewChanged == true)
+        {
+          printPreviewWin(wins,
+                          findPreviewPalette(stPalettes,
+                                             stLibrary,
+                                             stPreviewNum),
+                          colorPairs,
+                          log);
+
+          if(wins.at(_PREVIEWWIN)->getIsOpen())
+            {
+              wins.at(_PREVIEWWIN)->stageWindow();
+            }
+
+          isChanged = true;
+        }
+
+      // an open state is staged over whatever the frame redrew beneath it,
+      // and a closed one has staged what it covered
+      if(openState != nullptr && (isStateChanged == true || isChanged == true))
+        {
+          openState->stageState();
+          isChanged = true;
+        }
+      else if(isStateChanged == true)
+        {
+          isChanged = true;
+        }
+
+      // draw the whole frame at once
+      if(isChanged == true)
+        {
           doupdate();
         }
 #endif // _CURSES
 
-      usleep(15000);
+      inputSession.waitFrame();
     }
 
   // clean up
+  fileWatcher.stop();
 #if _CURSES
   endwin();
   for(std::unordered_map<int, CursesWindow*>::iterator it = wins.begin();
@@ -518,24 +789,20 @@ int main()
     }
 
   sfStringWins.clear();
+  stGrid.deleteGrid();
+  endwin();
+#endif // _CURSES
 
-  for(int i = 0; i < stStringWins.size(); i++)
+  // the frame times of a replay are what it's run for
+  if(inputSession.getMode() == _SESSIONREPLAY)
     {
-      if(stStringWins.at(i)->getWindow() != nullptr)
-        {
-          stStringWins.at(i)->deleteWindow();
-          stStringWins.at(i)->setWindow(nullptr);
-          delete stStringWins.at(i);
-        }
+      inputSession.writeFrameTimes(std::cout);
+      inputSession.writeFrameTimes(log);
     }
-  endwin();
-#endif // _CURSES
 
-  stStringWins.clear();
   promptStrings;
   sfStrings.clear();
   sfThemes.clear();
-  stStrings.clear();
   sfOutput.clear();
 
   return 0;
@@ -0,0 +1,236 @@
+/*
+  File:
+   overlayStack.cpp
+
+  Description:
+   The implementation of the overlayStack.hpp class.
+*/
+#include <algorithm>
+#include "_cursesWinConsts.hpp"
+#include "overlayStack.hpp"
+
+
+
+/*
+  Function:
+   OverlayStack Constructor
+
+  Description:
+   Creates an empty stack over the windows of the main screen.
+
+  Input:
+   wins                 - a reference to the map of CursesWindow objects.
+   sfStringWins         - a reference to the saved file string windows.
+   stGrid               - a reference to the saved themes grid.
+
+  Output:
+   NONE
+*/
+OverlayStack::OverlayStack(const std::unordered_map<int, CursesWindow*>& wins,
+                           const std::vector<CursesWindow*>& sfStringWins,
+                           ThemeGrid& stGrid)
+  : m_wins(wins),
+    m_sfStringWins(sfStringWins),
+    m_stGrid(stGrid)
+{
+} // end of "OverlayStack Constructor"
+
+
+
+/*
+  Function:
+   closeOverlay
+
+  Description:
+   Takes a window off the stack and deletes it, then stages the lines it
+   covered again from every window on them, in the order the main loop
+   draws them: the windows by index, the saved file strings, the saved
+   themes grid and then the overlays left, bottom to top. A touched line
+   is staged across the whole width of its window, so every window on the
+   lines is restaged, not just those under the overlay. The grid's
+   viewport is staged whole, as every cell of it is compared. Nothing is
+   reprinted.
+
+  Input/Output:
+   window               - a pointer to the overlay.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void OverlayStack::closeOverlay(CursesWindow* window)
+{
+  std::vector<CursesWindow*>::iterator it = std::find(m_overlays.begin(),
+                                                      m_overlays.end(),
+                                                      window);
+
+  if(it == m_overlays.end())
+    {
+      return;
+    }
+
+  m_overlays.erase(it);
+
+  if(window->getIsOpen() == false)
+    {
+      return;
+    }
+
+  const int startY = window->getStartY();
+  const int numLines = window->getNumLines();
+
+  window->deleteWindow();
+
+  for(int i = _MAINWIN; i < _NUMWINS; i++)
+    {
+      if(getIsOverlay(m_wins.at(i)) == false)
+        {
+          restoreLayer(m_wins.at(i), startY, numLines);
+        }
+    }
+
+  for(size_t i = 0; i < m_sfStringWins.size(); i++)
+    {
+      restoreLayer(m_sfStringWins.at(i), startY, numLines);
+    }
+
+  if(m_stGrid.getIsOpen() &&
+     startY < m_stGrid.getStartY() + m_stGrid.getNumLines() &&
+     m_stGrid.getStartY() < startY + numLines)
+    {
+      m_stGrid.stageGrid();
+    }
+
+  for(size_t i = 0; i < m_overlays.size(); i++)
+    {
+      restoreLayer(m_overlays.at(i), startY, numLines);
+    }
+} // end of "closeOverlay"
+
+
+
+/*
+  Function:
+   openOverlay
+
+  Description:
+   Puts an open window on top of the stack.
+
+  Input/Output:
+   window               - a pointer to the overlay.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void OverlayStack::openOverlay(CursesWindow* window)
+{
+  if(getIsOverlay(window) == false)
+    {
+      m_overlays.push_back(window);
+    }
+} // end of "openOverlay"
+
+
+
+/*
+  Function:
+   stageOverlays
+
+  Description:
+   Stages every open overlay whole, bottom to top, over whatever the frame
+   has staged beneath them. The top overlay is staged last, so its cursor
+   is the one shown.
+
+  Input/Output:
+   NONE
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void OverlayStack::stageOverlays()
+{
+  for(size_t i = 0; i < m_overlays.size(); i++)
+    {
+      if(m_overlays.at(i)->getIsOpen())
+        {
+          m_overlays.at(i)->touchLines(0, m_overlays.at(i)->getNumLines());
+          m_overlays.at(i)->stageWindow();
+        }
+    }
+} // end of "stageOverlays"
+
+
+
+/*
+  Function:
+   restoreLayer
+
+  Description:
+   Marks the lines of a window on a band of screen lines as changed and
+   stages the window, if it is open and on any of the lines.
+
+  Input/Output:
+   layer                - a pointer to the window.
+
+  Input:
+   startY               - the first line of the band on the screen.
+   numLines             - the number of lines of the band.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void OverlayStack::restoreLayer(CursesWindow* layer,
+                                const int startY,
+                                const int numLines)
+{
+  if(layer->getIsOpen() == false)
+    {
+      return;
+    }
+
+  const int firstLine = std::max(startY, layer->getStartY());
+  const int lastLine = std::min(startY + numLines,
+                                layer->getStartY() + layer->getNumLines());
+
+  if(firstLine >= lastLine)
+    {
+      return;
+    }
+
+  layer->touchLines(firstLine - layer->getStartY(), lastLine - firstLine);
+  layer->stageWindow();
+} // end of "restoreLayer"
+
+
+
+bool OverlayStack::getIsOverlay(const CursesWindow* window) const
+{
+  return std::find(m_overlays.begin(), m_overlays.end(), window) != m_overlays.end();
+} // end of "getIsOverlay"
+
+
+
+int OverlayStack::getNumOverlays() const
+{
+  return m_overlays.size();
+} // end of "getNumOverlays"
@@ -0,0 +1,698 @@
+/*
+  File:
+   palette.cpp
+
+  Description:
+   The implementation of the palette.hpp class.
+*/
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "palette.hpp"
+
+// the 240 xterm colors matched against. the first 16 are left out since every
+// terminal theme redefines them.
+const int _XTERMMATCHSTART = 16;
+const int _XTERMMATCHCOLORS = 240;
+
+static const char hexDigits[] = "0123456789abcdef";
+
+// linear light value of each 8 bit sRGB channel value, built once on first use
+struct SrgbToLinear {
+  SrgbToLinear()
+  {
+    for(int i = 0; i < 256; i++)
+      {
+        const float c = i / 255.0f;
+        values[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+      }
+  }
+
+  float values[256];
+};
+
+
+
+/*
+  Function:
+   hexValue
+
+  Description:
+   Converts a hexadecimal digit character to its value.
+
+  Input:
+   c                    - the character to convert.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the value of the digit, or -1 if c isn't a hex digit.
+*/
+static int hexValue(const char c)
+{
+  if(c >= '0' && c <= '9')
+    {
+      return c - '0';
+    }
+  else if(c >= 'a' && c <= 'f')
+    {
+      return c - 'a' + 10;
+    }
+  else if(c >= 'A' && c <= 'F')
+    {
+      return c - 'A' + 10;
+    }
+
+  return -1;
+} // end of "hexValue"
+
+
+
+/*
+  Function:
+   toOklab
+
+  Description:
+   Converts packed 8 bit sRGB channels to the OKLab perceptual color space, one
+   channel array at a time so the loop has no per color branches and can be
+   vectorized by the compiler.
+
+  Input:
+   reds, greens, blues  - pointers to numColors packed channel values.
+
+   numColors            - the number of colors to convert.
+
+  Output:
+   lightness, aAxis, bAxis
+                        - pointers to numColors floats that receive the OKLab
+                          coordinates.
+
+  Returns:
+   NONE
+*/
+static void toOklab(const uint8_t* reds,
+                    const uint8_t* greens,
+                    const uint8_t* blues,
+                    const size_t numColors,
+                    float* lightness,
+                    float* aAxis,
+                    float* bAxis)
+{
+  static const SrgbToLinear linear;
+
+  for(size_t i = 0; i < numColors; i++)
+    {
+      const float r = linear.values[reds[i]];
+      const float g = linear.values[greens[i]];
+      const float b = linear.values[blues[i]];
+      const float l = cbrtf(0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+      const float m = cbrtf(0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+      const float s = cbrtf(0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+
+      lightness[i] = 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s;
+      aAxis[i] = 1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s;
+      bAxis[i] = 0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s;
+    }
+} // end of "toOklab"
+
+
+
+// OKLab coordinates of the matched xterm colors, built once on first use
+struct XtermOklab {
+  XtermOklab()
+  {
+    uint8_t reds[_XTERMMATCHCOLORS];
+    uint8_t greens[_XTERMMATCHCOLORS];
+    uint8_t blues[_XTERMMATCHCOLORS];
+
+    for(int i = 0; i < _XTERMMATCHCOLORS; i++)
+      {
+        const uint32_t rgb = xterm256Color(i + _XTERMMATCHSTART);
+        reds[i] = rgb >> 16;
+        greens[i] = rgb >> 8;
+        blues[i] = rgb;
+      }
+
+    toOklab(reds, greens, blues, _XTERMMATCHCOLORS, lightness, aAxis, bAxis);
+  }
+
+  float lightness[_XTERMMATCHCOLORS];
+  float aAxis[_XTERMMATCHCOLORS];
+  float bAxis[_XTERMMATCHCOLORS];
+};
+
+
+
+/*
+  Function:
+   xterm256Color
+
+  Description:
+   Returns the RGB value xterm uses for the incoming 256 color index.
+
+  Input:
+   index                - the xterm color index, 0 through 255.
+
+  Output:
+   NONE
+
+  Returns:
+   uint32_t             - the color as 0xrrggbb.
+*/
+uint32_t xterm256Color(const int index)
+{
+  static const uint32_t systemColors[16] = {
+    0x000000, 0xcd0000, 0x00cd00, 0xcdcd00, 0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+    0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00, 0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff
+  };
+  static const uint32_t cubeLevels[6] = { 0x00, 0x5f, 0x87, 0xaf, 0xd7, 0xff };
+
+  if(index < 16)
+    {
+      return systemColors[index & 15];
+    }
+  else if(index < 232)
+    {
+      const int cube = index - 16;
+      return (cubeLevels[cube / 36] << 16) | (cubeLevels[(cube / 6) % 6] << 8) |
+        cubeLevels[cube % 6];
+    }
+
+  const uint32_t gray = 8 + (index - 232) * 10;
+  return (gray << 16) | (gray << 8) | gray;
+} // end of "xterm256Color"
+
+
+
+/*
+  Function:
+   Palette Constructor
+
+  Description:
+   Creates a palette of numColors black entries.
+
+  Input:
+   name                 - a reference to a constant string naming the theme.
+
+   numColors            - the number of colors in the palette.
+
+  Output:
+   NONE
+*/
+Palette::Palette(const std::string& name,
+                 const size_t numColors)
+  : m_name(name)
+{
+  setNumColors(numColors);
+} // end of "Palette Constructor"
+
+
+
+/*
+  Function:
+   parseColor
+
+  Description:
+   Parses a color written in any of the notations in ColorFormats except
+   _XTERM256COLOR, plus the short "#rgb" form, and stores it at index.
+
+  Input:
+   index                - the palette entry to set.
+
+   color                - a reference to a constant string containing the
+                          color, surrounding whitespace and quotes allowed.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the color was recognized and stored.
+*/
+bool Palette::parseColor(const size_t index,
+                         const std::string& color)
+{
+  size_t start = color.find_first_not_of(" \t\"'");
+  size_t end = color.find_last_not_of(" \t\"';,\r");
+
+  if(start == std::string::npos || end == std::string::npos || index >= getNumColors())
+    {
+      return false;
+    }
+
+  const char* str = color.c_str() + start;
+  const size_t length = end - start + 1;
+  int channels[3] = { -1, -1, -1 };
+
+  if(length > 4 && strncmp(str, "rgb(", 4) == 0)
+    {
+      const char* next = str + 4;
+
+      // each channel needs digits of its own, commas between channels and a
+      // closing parenthesis after the last one
+      for(int i = 0; i < 3; i++)
+        {
+          char* digitsEnd;
+          const long value = strtol(next, &digitsEnd, 10);
+
+          if(digitsEnd == next || value < 0 || value > 255)
+            {
+              return false;
+            }
+
+          channels[i] = value;
+          next = digitsEnd;
+
+          while(*next == ' ')
+            {
+              next++;
+            }
+
+          if(*next != (i < 2 ? ',' : ')'))
+            {
+              return false;
+            }
+
+          next++;
+        }
+
+      if(next != str + length)
+        {
+          return false;
+        }
+    }
+  else if(length == 12 && strncmp(str, "rgb:", 4) == 0)
+    {
+      for(int i = 0; i < 3; i++)
+        {
+          const int high = hexValue(str[4 + i * 3]);
+          const int low = hexValue(str[5 + i * 3]);
+          channels[i] = high < 0 || low < 0 ? -1 : high * 16 + low;
+        }
+    }
+  else
+    {
+      // strip a "#" or "0x" prefix and read the hex digits
+      if(str[0] == '#')
+        {
+          str++;
+        }
+      else if(length > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+        {
+          str += 2;
+        }
+
+      const size_t digits = length - (str - color.c_str() - start);
+
+      if(digits == 6)
+        {
+          for(int i = 0; i < 3; i++)
+            {
+              const int high = hexValue(str[i * 2]);
+              const int low = hexValue(str[i * 2 + 1]);
+              channels[i] = high < 0 || low < 0 ? -1 : high * 16 + low;
+            }
+        }
+      else if(digits == 3)
+        {
+          for(int i = 0; i < 3; i++)
+            {
+              const int value = hexValue(str[i]);
+              channels[i] = value < 0 ? -1 : value * 17;
+            }
+        }
+    }
+
+  for(int i = 0; i < 3; i++)
+    {
+      if(channels[i] < 0 || channels[i] > 255)
+        {
+          return false;
+        }
+    }
+
+  m_reds.at(index) = channels[0];
+  m_greens.at(index) = channels[1];
+  m_blues.at(index) = channels[2];
+
+  return true;
+} // end of "parseColor"
+
+
+
+/*
+  Function:
+   findXterm256
+
+  Description:
+   Finds the nearest xterm 256 color of every palette entry by distance in
+   OKLab, where equal distances look equally different, rather than in RGB.
+   The whole palette and the xterm table are converted once and the distances
+   to all candidates are computed in a single flat loop per color.
+
+  Input:
+   NONE
+
+  Output:
+   indexes              - a reference to a vector that receives the xterm index
+                          for each palette entry.
+
+  Returns:
+   NONE
+*/
+void Palette::findXterm256(std::vector<uint8_t>& indexes) const
+{
+  static const XtermOklab xterm;
+
+  const size_t numColors = getNumColors();
+  std::vector<float> lightness(numColors);
+  std::vector<float> aAxis(numColors);
+  std::vector<float> bAxis(numColors);
+  float distances[_XTERMMATCHCOLORS];
+
+  toOklab(m_reds.data(), m_greens.data(), m_blues.data(), numColors,
+          lightness.data(), aAxis.data(), bAxis.data());
+  indexes.resize(numColors);
+
+  for(size_t i = 0; i < numColors; i++)
+    {
+      const float l = lightness[i];
+      const float a = aAxis[i];
+      const float b = bAxis[i];
+
+      for(int j = 0; j < _XTERMMATCHCOLORS; j++)
+        {
+          const float dl = xterm.lightness[j] - l;
+          const float da = xterm.aAxis[j] - a;
+          const float db = xterm.bAxis[j] - b;
+          distances[j] = dl * dl + da * da + db * db;
+        }
+
+      int best = 0;
+
+      for(int j = 1; j < _XTERMMATCHCOLORS; j++)
+        {
+          if(distances[j] < distances[best])
+            {
+              best = j;
+            }
+        }
+
+      indexes[i] = best + _XTERMMATCHSTART;
+    }
+} // end of "findXterm256"
+
+
+
+/*
+  Function:
+   findOklab
+
+  Description:
+   Converts every palette entry to OKLab, the perceptual color space colors
+   are compared in.
+
+  Input:
+   NONE
+
+  Output:
+   lightness, aAxis, bAxis
+                        - references to vectors that receive the OKLab
+                          coordinates of each palette entry.
+
+  Returns:
+   NONE
+*/
+void Palette::findOklab(std::vector<float>& lightness,
+                        std::vector<float>& aAxis,
+                        std::vector<float>& bAxis) const
+{
+  const size_t numColors = getNumColors();
+
+  lightness.resize(numColors);
+  aAxis.resize(numColors);
+  bAxis.resize(numColors);
+  toOklab(m_reds.data(), m_greens.data(), m_blues.data(), numColors,
+          lightness.data(), aAxis.data(), bAxis.data());
+} // end of "findOklab"
+
+
+
+/*
+  Function:
+   format
+
+  Description:
+   Writes every palette entry in the incoming notation to output, separated by
+   separator. Fixed width notations are written straight into a buffer sized
+   once for the whole palette.
+
+  Input:
+   colorFormat          - a ColorFormats value.
+
+   separator            - the character written between colors.
+
+  Output:
+   output               - a reference to a string that receives the colors.
+
+  Returns:
+   NONE
+*/
+void Palette::format(const int colorFormat,
+                     std::string& output,
+                     const char separator) const
+{
+  const size_t numColors = getNumColors();
+  output.clear();
+
+  if(numColors == 0)
+    {
+      return;
+    }
+
+  if(colorFormat == _RGBCOLOR || colorFormat == _XTERM256COLOR)
+    {
+      std::vector<uint8_t> indexes;
+      char buffer[32];
+
+      if(colorFormat == _XTERM256COLOR)
+        {
+          findXterm256(indexes);
+        }
+
+      output.reserve(numColors * 20);
+
+      for(size_t i = 0; i < numColors; i++)
+        {
+          int length;
+
+          if(colorFormat == _RGBCOLOR)
+            {
+              length = snprintf(buffer, sizeof(buffer), "rgb(%d, %d, %d)",
+                                m_reds[i], m_greens[i], m_blues[i]);
+            }
+          else
+            {
+              length = snprintf(buffer, sizeof(buffer), "%d", indexes[i]);
+            }
+
+          output.append(buffer, length);
+          output.push_back(separator);
+        }
+
+      output.pop_back();
+      return;
+    }
+
+  // fixed width notations: prefix, two digits per channel with an optional
+  // divider between channels
+  const char* prefix = "";
+  const char* divider = "";
+
+  if(colorFormat == _HEXCOLOR)
+    {
+      prefix = "#";
+    }
+  else if(colorFormat == _0XHEXCOLOR)
+    {
+      prefix = "0x";
+    }
+  else if(colorFormat == _XRGBCOLOR)
+    {
+      prefix = "rgb:";
+      divider = "/";
+    }
+
+  const size_t prefixLength = strlen(prefix);
+  const size_t dividerLength = strlen(divider);
+  const size_t width = prefixLength + 6 + dividerLength * 2 + 1;
+  const uint8_t* channels[3] = { m_reds.data(), m_greens.data(), m_blues.data() };
+
+  output.resize(numColors * width - 1);
+  char* out = &output[0];
+
+  for(size_t i = 0; i < numColors; i++)
+    {
+      char* entry = out + i * width;
+
+      memcpy(entry, prefix, prefixLength);
+      entry += prefixLength;
+
+      for(int c = 0; c < 3; c++)
+        {
+          entry[0] = hexDigits[channels[c][i] >> 4];
+          entry[1] = hexDigits[channels[c][i] & 15];
+          entry += 2;
+
+          if(c < 2)
+            {
+              memcpy(entry, divider, dividerLength);
+              entry += dividerLength;
+            }
+        }
+
+      if(i + 1 < numColors)
+        {
+          *entry = separator;
+        }
+    }
+} // end of "format"
+
+
+
+/*
+  Function:
+   pack
+
+  Description:
+   Packs the colors as red, green, blue byte triples, the form palettes are
+   stored in the saved themes library and compared by when importing.
+
+  Input:
+   NONE
+
+  Output:
+   output               - a reference to a string that receives the packed
+                          colors.
+
+  Returns:
+   NONE
+*/
+void Palette::pack(std::string& output) const
+{
+  output.resize(m_reds.size() * 3);
+
+  for(size_t i = 0; i < m_reds.size(); i++)
+    {
+      output[i * 3] = (char)m_reds[i];
+      output[i * 3 + 1] = (char)m_greens[i];
+      output[i * 3 + 2] = (char)m_blues[i];
+    }
+} // end of "pack"
+
+
+
+/*
+  Function:
+   unpack
+
+  Description:
+   Replaces the colors with colors packed by pack().
+
+  Input:
+   packed               - a reference to a constant string containing the
+                          packed colors.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - false if packed isn't a whole number of colors.
+*/
+bool Palette::unpack(const std::string& packed)
+{
+  if(packed.length() % 3 != 0)
+    {
+      return false;
+    }
+
+  setNumColors(packed.length() / 3);
+
+  for(size_t i = 0; i < m_reds.size(); i++)
+    {
+      m_reds[i] = packed[i * 3];
+      m_greens[i] = packed[i * 3 + 1];
+      m_blues[i] = packed[i * 3 + 2];
+    }
+
+  return true;
+} // end of "unpack"
+
+
+
+const std::string& Palette::getName() const
+{
+  return m_name;
+} // end of "getName"
+
+
+
+size_t Palette::getNumColors() const
+{
+  return m_reds.size();
+} // end of "getNumColors"
+
+
+
+uint32_t Palette::getColor(const size_t index) const
+{
+  return (m_reds.at(index) << 16) | (m_greens.at(index) << 8) | m_blues.at(index);
+} // end of "getColor"
+
+
+
+const uint8_t* Palette::getReds() const
+{
+  return m_reds.data();
+} // end of "getReds"
+
+
+
+const uint8_t* Palette::getGreens() const
+{
+  return m_greens.data();
+} // end of "getGreens"
+
+
+
+const uint8_t* Palette::getBlues() const
+{
+  return m_blues.data();
+} // end of "getBlues"
+
+
+
+void Palette::setName(const std::string& name)
+{
+  m_name = name;
+} // end of "setName"
+
+
+
+void Palette::setNumColors(const size_t numColors)
+{
+  m_reds.resize(numColors, 0);
+  m_greens.resize(numColors, 0);
+  m_blues.resize(numColors, 0);
+} // end of "setNumColors"
+
+
+
+void Palette::setColor(const size_t index,
+                       const uint32_t rgb)
+{
+  m_reds.at(index) = (rgb >> 16) & 0xff;
+  m_greens.at(index) = (rgb >> 8) & 0xff;
+  m_blues.at(index) = rgb & 0xff;
+} // end of "setColor"
@@ -0,0 +1,488 @@
+/*
+  File:
+   paletteIndex.cpp
+
+  Description:
+   The implementation of the paletteIndex.hpp class.
+*/
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "paletteIndex.hpp"
+
+
+
+/*
+  Function:
+   isCloser
+
+  Description:
+   Orders matches by distance, then by id so equally distant matches are
+   always returned in the same order.
+
+  Input:
+   first, second        - references to the constant matches to compare.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if first is closer to the query than second.
+*/
+static bool isCloser(const IndexMatch& first,
+                     const IndexMatch& second)
+{
+  if(first.distance != second.distance)
+    {
+      return first.distance < second.distance;
+    }
+
+  return first.id < second.id;
+} // end of "isCloser"
+
+
+
+/*
+  Function:
+   fingerprintPalette
+
+  Description:
+   Computes the fingerprint of a theme palette: the OKLab coordinates of its
+   18 colors scaled by _FINGERPRINTSCALE and rounded. A 16 color palette
+   takes the default text colors the importer gives themes without them,
+   white on black.
+
+  Input:
+   palette              - a reference to the constant palette.
+
+  Output:
+   fingerprint          - a pointer to _FINGERPRINTSIZE values that receive
+                          the fingerprint.
+
+  Returns:
+   bool                 - true if the palette has at least the 16 ANSI colors
+                          and was fingerprinted.
+*/
+bool fingerprintPalette(const Palette& palette,
+                        int8_t* fingerprint)
+{
+  if(palette.getNumColors() < _ANSICOLORS)
+    {
+      return false;
+    }
+
+  Palette colors(palette);
+  std::vector<float> lightness;
+  std::vector<float> aAxis;
+  std::vector<float> bAxis;
+
+  if(colors.getNumColors() < _THEMEPALETTESIZE)
+    {
+      colors.setNumColors(_THEMEPALETTESIZE);
+      colors.setColor(_PALETTEFOREGROUND, palette.getColor(15));
+      colors.setColor(_PALETTEBACKGROUND, palette.getColor(0));
+    }
+
+  colors.findOklab(lightness, aAxis, bAxis);
+
+  for(size_t i = 0; i < _THEMEPALETTESIZE; i++)
+    {
+      fingerprint[i * 3] = (int8_t)lroundf(lightness[i] * _FINGERPRINTSCALE);
+      fingerprint[i * 3 + 1] = (int8_t)lroundf(aAxis[i] * _FINGERPRINTSCALE);
+      fingerprint[i * 3 + 2] = (int8_t)lroundf(bAxis[i] * _FINGERPRINTSCALE);
+    }
+
+  for(int i = _FINGERPRINTCOORDS; i < _FINGERPRINTSIZE; i++)
+    {
+      fingerprint[i] = 0;
+    }
+
+  return true;
+} // end of "fingerprintPalette"
+
+
+
+/*
+  Function:
+   PaletteIndex Constructor
+
+  Description:
+   Creates an empty index.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+PaletteIndex::PaletteIndex()
+  : m_root(-1),
+    m_numVisited(0)
+{
+} // end of "PaletteIndex Constructor"
+
+
+
+/*
+  Function:
+   build
+
+  Description:
+   Builds the tree over the incoming fingerprints. The id of a fingerprint is
+   its position in the vector.
+
+  Input:
+   fingerprints         - a reference to a constant vector of fingerprints,
+                          _FINGERPRINTSIZE values each.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void PaletteIndex::build(const std::vector<int8_t>& fingerprints)
+{
+  const int numFingerprints = fingerprints.size() / _FINGERPRINTSIZE;
+  std::vector<IndexMatch> items(numFingerprints);
+
+  m_fingerprints.assign(fingerprints.begin(),
+                        fingerprints.begin() + numFingerprints * _FINGERPRINTSIZE);
+  m_nodes.clear();
+  m_nodes.reserve(numFingerprints);
+
+  for(int i = 0; i < numFingerprints; i++)
+    {
+      items.at(i).id = i;
+      items.at(i).distance = 0;
+    }
+
+  m_root = buildNode(items, 0, numFingerprints);
+} // end of "build"
+
+
+
+/*
+  Function:
+   buildNode
+
+  Description:
+   Builds the subtree over items first through last - 1. The middle item is
+   made the vantage point, the rest are split at their median distance from
+   it, and each half becomes a subtree.
+
+  Input/Output:
+   items                - a reference to the items being built; the distance
+                          of each is used as scratch space.
+
+  Input:
+   first                - the first item of the subtree.
+
+   last                 - one past the last item of the subtree.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the node of the subtree's root, or -1 if it's empty.
+*/
+int PaletteIndex::buildNode(std::vector<IndexMatch>& items,
+                            const int first,
+                            const int last)
+{
+  if(first >= last)
+    {
+      return -1;
+    }
+
+  // the library is sorted by name, so the middle item is as good as a random one
+  std::swap(items.at(first), items.at(first + (last - first) / 2));
+
+  const int node = m_nodes.size();
+  const int vantage = items.at(first).id;
+  const int median = first + 1 + (last - first - 1) / 2;
+  Node newNode;
+
+  for(int i = first + 1; i < last; i++)
+    {
+      items.at(i).distance = distance(getFingerprint(vantage), items.at(i).id);
+    }
+
+  newNode.id = vantage;
+  newNode.threshold = 0;
+  newNode.inside = -1;
+  newNode.outside = -1;
+
+  if(median < last)
+    {
+      std::nth_element(items.begin() + first + 1,
+                       items.begin() + median,
+                       items.begin() + last,
+                       isCloser);
+      newNode.threshold = items.at(median).distance;
+    }
+
+  m_nodes.push_back(newNode);
+
+  const int inside = buildNode(items, first + 1, median);
+  const int outside = buildNode(items, median, last);
+
+  m_nodes.at(node).inside = inside;
+  m_nodes.at(node).outside = outside;
+
+  return node;
+} // end of "buildNode"
+
+
+
+/*
+  Function:
+   distance
+
+  Description:
+   Returns the Euclidean distance between the query and an indexed
+   fingerprint, and counts it toward getNumVisited().
+
+  Input:
+   query                - a pointer to the constant query fingerprint.
+
+   id                   - the id of the indexed fingerprint.
+
+  Output:
+   NONE
+
+  Returns:
+   float                - the distance in fingerprint steps.
+*/
+float PaletteIndex::distance(const int8_t* query,
+                             const int id) const
+{
+  const int8_t* fingerprint = getFingerprint(id);
+  int sum = 0;
+
+  for(int i = 0; i < _FINGERPRINTSIZE; i++)
+    {
+      const int difference = query[i] - fingerprint[i];
+      sum += difference * difference;
+    }
+
+  m_numVisited++;
+
+  return sqrtf((float)sum);
+} // end of "distance"
+
+
+
+/*
+  Function:
+   findNearest
+
+  Description:
+   Finds the indexed fingerprints nearest to the query.
+
+  Input:
+   query                - a pointer to the constant query fingerprint.
+
+   count                - the number of matches to find.
+
+  Output:
+   matches              - a reference to a vector that receives up to count
+                          matches, nearest first.
+
+  Returns:
+   NONE
+*/
+void PaletteIndex::findNearest(const int8_t* query,
+                               const int count,
+                               std::vector<IndexMatch>& matches) const
+{
+  matches.clear();
+  m_numVisited = 0;
+
+  if(count > 0)
+    {
+      searchNearest(m_root, query, count, matches);
+      std::sort_heap(matches.begin(), matches.end(), isCloser);
+    }
+} // end of "findNearest"
+
+
+
+/*
+  Function:
+   findWithinRadius
+
+  Description:
+   Finds every indexed fingerprint within radius of the query.
+
+  Input:
+   query                - a pointer to the constant query fingerprint.
+
+   radius               - the largest distance to match.
+
+  Output:
+   matches              - a reference to a vector that receives the matches,
+                          nearest first.
+
+  Returns:
+   NONE
+*/
+void PaletteIndex::findWithinRadius(const int8_t* query,
+                                    const float radius,
+                                    std::vector<IndexMatch>& matches) const
+{
+  matches.clear();
+  m_numVisited = 0;
+  searchRadius(m_root, query, radius, matches);
+  std::sort(matches.begin(), matches.end(), isCloser);
+} // end of "findWithinRadius"
+
+
+
+/*
+  Function:
+   searchNearest
+
+  Description:
+   Searches the subtree at node for matches nearer than the farthest of the
+   count found so far, which are kept as a max heap. The side of the vantage
+   point the query is on is searched first, and the other side only if the
+   query is closer to the threshold than to the farthest match.
+
+  Input/Output:
+   matches              - a reference to the heap of matches found so far.
+
+  Input:
+   node                 - the root of the subtree, or -1.
+
+   query                - a pointer to the constant query fingerprint.
+
+   count                - the number of matches to find.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void PaletteIndex::searchNearest(const int node,
+                                 const int8_t* query,
+                                 const int count,
+                                 std::vector<IndexMatch>& matches) const
+{
+  if(node < 0)
+    {
+      return;
+    }
+
+  const Node& current = m_nodes.at(node);
+  IndexMatch match;
+
+  match.id = current.id;
+  match.distance = distance(query, current.id);
+
+  if((int)matches.size() < count)
+    {
+      matches.push_back(match);
+      std::push_heap(matches.begin(), matches.end(), isCloser);
+    }
+  else if(isCloser(match, matches.front()))
+    {
+      std::pop_heap(matches.begin(), matches.end(), isCloser);
+      matches.back() = match;
+      std::push_heap(matches.begin(), matches.end(), isCloser);
+    }
+
+  const bool isInside = match.distance <= current.threshold;
+  const int nearSide = isInside ? current.inside : current.outside;
+  const int farSide = isInside ? current.outside : current.inside;
+
+  searchNearest(nearSide, query, count, matches);
+
+  const float farthest = (int)matches.size() < count ?
+    std::numeric_limits<float>::max() : matches.front().distance;
+
+  if(fabsf(match.distance - current.threshold) <= farthest)
+    {
+      searchNearest(farSide, query, count, matches);
+    }
+} // end of "searchNearest"
+
+
+
+/*
+  Function:
+   searchRadius
+
+  Description:
+   Searches the subtree at node for fingerprints within radius of the query,
+   skipping each side of a vantage point the radius can't reach.
+
+  Input/Output:
+   matches              - a reference to the matches found so far.
+
+  Input:
+   node                 - the root of the subtree, or -1.
+
+   query                - a pointer to the constant query fingerprint.
+
+   radius               - the largest distance to match.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void PaletteIndex::searchRadius(const int node,
+                                const int8_t* query,
+                                const float radius,
+                                std::vector<IndexMatch>& matches) const
+{
+  if(node < 0)
+    {
+      return;
+    }
+
+  const Node& current = m_nodes.at(node);
+  IndexMatch match;
+
+  match.id = current.id;
+  match.distance = distance(query, current.id);
+
+  if(match.distance <= radius)
+    {
+      matches.push_back(match);
+    }
+
+  if(match.distance - radius <= current.threshold)
+    {
+      searchRadius(current.inside, query, radius, matches);
+    }
+
+  if(match.distance + radius >= current.threshold)
+    {
+      searchRadius(current.outside, query, radius, matches);
+    }
+} // end of "searchRadius"
+
+
+
+const int8_t* PaletteIndex::getFingerprint(const int id) const
+{
+  return &m_fingerprints.at(id * _FINGERPRINTSIZE);
+} // end of "getFingerprint"
+
+
+
+int PaletteIndex::getNumFingerprints() const
+{
+  return m_fingerprints.size() / _FINGERPRINTSIZE;
+} // end of "getNumFingerprints"
+
+
+
+int PaletteIndex::getNumVisited() const
+{
+  return m_numVisited;
+} // end of "getNumVisited"
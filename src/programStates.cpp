@@ -1,10 +1,181 @@
+/*
+  File:
+   programStates.cpp
+
+  Description:
+   The implementation of the programStates.hpp classes.
+*/
 #include "programStates.hpp"
 
-void enterHWSFAddFileState(std::unordered_map<int, CursesWindow*>& wins,
-                           MEVENT& mouse,
-                           int& mouseLine,
-                           int& mouseCol,
-                           std::ofstream& log)
+
+
+/*
+  Function:
+   HWSFAddFileState Constructor
+
+  Description:
+   Creates a closed add file prompt.
+
+  Input:
+   arena                - a reference to the frame arena the prompt's
+                          temporaries are taken from.
+   overlays             - a reference to the stack the prompt's windows are
+                          opened on.
+
+  Output:
+   NONE
+*/
+HWSFAddFileState::HWSFAddFileState(FrameArena& arena,
+                                   OverlayStack& overlays)
+  : m_arena(arena),
+    m_overlays(overlays),
+    m_stringIndex(0),
+    m_startY(0),
+    m_xOffset(0),
+    m_numCols(0)
+{
+} // end of "HWSFAddFileState Constructor"
+
+
+
+/*
+  Function:
+   closeState
+
+  Description:
+   Closes the prompt's windows, staging the part of the screen they covered
+   again from the windows under them.
+
+  Input/Output:
+   wins                 - a reference to the map of CursesWindow objects.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void HWSFAddFileState::closeState(std::unordered_map<int, CursesWindow*>& wins)
+{
+  // close _USERINPUTWIN and _SFPROMPTWIN and return to starting program state
+  m_overlays.closeOverlay(wins.at(_USERINPUTWIN));
+  m_overlays.closeOverlay(wins.at(_SFPROMPTWIN));
+  curs_set(0);
+} // end of "closeState"
+
+
+
+/*
+  Function:
+   handleInput
+
+  Description:
+   Edits the prompt's string with a key of the frame. Enter, or a click
+   outside of the _SFPROMPTWIN, closes the prompt.
+
+  Input/Output:
+   wins                 - a reference to the map of CursesWindow objects.
+
+  Input:
+   event                - a reference to the constant key or click.
+
+  Output:
+   log                  - a reference to the log file.
+
+  Returns:
+   bool                 - true if the prompt is still open.
+*/
+bool HWSFAddFileState::handleInput(std::unordered_map<int, CursesWindow*>& wins,
+                                   const FrameEvent& event,
+                                   std::ofstream& log)
+{
+  int stringLen = 0;
+
+  // exit state if user clicked outside of _SFPROMTWIN
+  if(event.input == KEY_MOUSE)
+    {
+      return checkWindowClick(wins,
+                              _SFPROMPTWIN,
+                              event.mouseLine,
+                              event.mouseCol,
+                              1,
+                              1,
+                              1,
+                              1,
+                              log);
+    }
+
+  switch(event.input)
+    {
+    case '\n':
+      return false;
+    case KEY_ENTER:
+      return false;
+    case KEY_LEFT: // shift the cursor left on the output string
+      stringLen = m_outputString.length() + m_stringIndex - 1;
+      if(stringLen >= 0)
+        {
+          // update the offsets of the cursor and index and move the cursor
+          m_stringIndex--;
+          m_xOffset--;
+          wins.at(_USERINPUTWIN)->moveCursor(0, m_xOffset);
+        }
+      break;
+    case KEY_RIGHT: // shift the cursor right on the outputstring
+      stringLen = m_outputString.length() + m_stringIndex + 1;
+      if((stringLen < m_outputString.length() + 1) &&
+         m_outputString.length() < m_numCols)
+        {
+          // update the offsets of the cursor and index and move the cursor
+          m_stringIndex++;
+          m_xOffset++;
+          wins.at(_USERINPUTWIN)->moveCursor(0, m_xOffset);
+        }
+      break;
+    default:
+      break;
+    }
+
+  printUserInput(wins,
+                 _USERINPUTWIN,
+                 event.input,
+                 m_outputString,
+                 m_stringIndex,
+                 m_startY,
+                 m_xOffset,
+                 m_arena,
+                 log);
+
+  return true;
+} // end of "handleInput"
+
+
+
+/*
+  Function:
+   openState
+
+  Description:
+   Flashes the add file button and prints the prompt over the saved files
+   window, with an empty input window under the cursor.
+
+  Input/Output:
+   wins                 - a reference to the map of CursesWindow objects.
+
+  Input:
+   NONE
+
+  Output:
+   log                  - a reference to the log file.
+
+  Returns:
+   NONE
+*/
+void HWSFAddFileState::openState(std::unordered_map<int, CursesWindow*>& wins,
+                                 std::ofstream& log)
 {
   flashButton(wins,
               _HWSFADDFILE,
@@ -22,117 +193,64 @@ void enterHWSFAddFileState(std::unordered_map<int, CursesWindow*>& wins,
   // create user input window
   int yOffset = 2;
   int xOffset = 2;
-  int startY = wins.at(_SFPROMPTWIN)->getStartY() + yOffset;
   int startX = wins.at(_SFPROMPTWIN)->getStartX() + xOffset;
-  int numLines = 1;
-  int numCols = wins.at(_SFPROMPTWIN)->getNumCols() - xOffset - xOffset;
+  m_startY = wins.at(_SFPROMPTWIN)->getStartY() + yOffset;
+  m_numCols = wins.at(_SFPROMPTWIN)->getNumCols() - xOffset - xOffset;
   createUserInputWin(wins,
-                     startY,
+                     m_startY,
                      startX,
-                     numLines,
-                     numCols,
+                     1,
+                     m_numCols,
                      log);
+  m_overlays.openOverlay(wins.at(_SFPROMPTWIN));
+  m_overlays.openOverlay(wins.at(_USERINPUTWIN));
 
-  // get user input, dynamically print it, and store in string object
-  bool isInWindow = false;
-  int userInput = 0;
-  std::string outputString;
-  int stringIndex = 0;
-  int stringLen = 0;
-  xOffset = 0;
+  // start from an empty string with the cursor at its beginning
+  m_outputString.clear();
+  m_stringIndex = 0;
+  m_xOffset = 0;
   curs_set(1);
-  bool exitLoop = false;
-  int currLines;
-  int currCols;
+  printUserInput(wins,
+                 _USERINPUTWIN,
+                 ERR,
+                 m_outputString,
+                 m_stringIndex,
+                 m_startY,
+                 m_xOffset,
+                 m_arena,
+                 log);
+} // end of "openState"
 
-  while(true)
-    {
-      getmaxyx(stdscr, currLines, currCols);
 
-      // check for window resize event
-      if((currLines != wins.at(_MAINWIN)->getNumLines()) ||
-         (currCols != wins.at(_MAINWIN)->getNumCols()))
-        {
-          break;
-        }
 
-      isInWindow = checkWindowClick(wins,
-                                    _SFPROMPTWIN,
-                                    mouse,
-                                    mouseLine,
-                                    mouseCol,
-                                    1,
-                                    1,
-                                    1,
-                                    1,
-                                    log);
-
-      // exit state if user clicked outside of _SFPROMTWIN
-      if(isInWindow == false)
-        {
-          break;
-        }
+/*
+  Function:
+   stageState
 
-      // get user input
-      userInput = getch();
-      flushinp();
+  Description:
+   Stages the prompt's windows over the rest of the frame for the next
+   doupdate(), the input window, and so the cursor, last.
 
-      switch(userInput)
-        {
-        case '\n':
-          exitLoop = true;
-          break;
-        case KEY_ENTER:
-          exitLoop = true;
-          break;
-        case KEY_LEFT: // shift the cursor left on the output string
-          stringLen = outputString.length() + stringIndex - 1;
-          if(stringLen >= 0)
-            {
-              // update the offsets of the cursor and index and move the cursor
-              stringIndex--;
-              xOffset--;
-              wmove(wins.at(_USERINPUTWIN)->getWindow(), 0, xOffset);
-            }
-          break;
-        case KEY_RIGHT: // shift the cursor right on the outputstring
-          stringLen = outputString.length() + stringIndex + 1;
-          if((stringLen < outputString.length() + 1) &&
-             outputString.length() < numCols)
-            {
-              // update the offsets of the cursor and index and move the cursor
-              stringIndex++;
-              xOffset++;
-              wmove(wins.at(_USERINPUTWIN)->getWindow(), 0, xOffset);
-            }
-          break;
-        default:
-          break;
-        }
+  Input/Output:
+   NONE
 
-      if(exitLoop == true)
-        {
-          break;
-        }
+  Input:
+   NONE
 
-      printUserInput(wins,
-                     _USERINPUTWIN,
-                     userInput,
-                     outputString,
-                     stringIndex,
-                     startY,
-                     xOffset,
-                     log);
-      refreshWins(wins);
-      doupdate();
-      usleep(15000);
-    }
+  Output:
+   NONE
 
-  // delete _USERINPUTWIN and return to starting program state
-  wins.at(_USERINPUTWIN)->deleteWindow();
-  curs_set(0);
-  printSavedFilesWin(wins,
-                     log);
-  refreshWins(wins);
-  doupdate();
-} // end of "enterHWSFAddFileState"
+  Returns:
+   NONE
+*/
+void HWSFAddFileState::stageState()
+{
+  m_overlays.stageOverlays();
+} // end of "stageState"
+
+
+
+const std::string& HWSFAddFileState::getOutputString() const
+{
+  return m_outputString;
+}
@@ -0,0 +1,1139 @@
+/*
+  File:
+   renderBackends.cpp
+
+  Description:
+   The implementation of the renderBackends.hpp classes.
+*/
+#include <algorithm>
+#include "cursesWindow.hpp"
+#include "renderBackends.hpp"
+
+// an empty cell of a memory window or screen
+static const MemoryCell blankCell = { ' ', A_NORMAL };
+
+
+
+// the curses backend passes each call through to ncurses, which ignores a
+// window that isn't open
+void CursesBackend::attributesOff(CursesWindow& window,
+                                  const attr_t attributes)
+{
+  wattroff(window.getWindow(), attributes);
+} // end of "attributesOff"
+
+
+
+void CursesBackend::attributesOn(CursesWindow& window,
+                                 const attr_t attributes)
+{
+  wattron(window.getWindow(), attributes);
+} // end of "attributesOn"
+
+
+
+void CursesBackend::closeWindow(CursesWindow& window)
+{
+  delwin(window.getWindow());
+  window.setWindow(nullptr);
+} // end of "closeWindow"
+
+
+
+void CursesBackend::drawBox(CursesWindow& window,
+                            const chtype vertical,
+                            const chtype horizontal)
+{
+  box(window.getWindow(), vertical, horizontal);
+} // end of "drawBox"
+
+
+
+void CursesBackend::eraseWindow(CursesWindow& window)
+{
+  werase(window.getWindow());
+} // end of "eraseWindow"
+
+
+
+bool CursesBackend::moveWindow(CursesWindow& window,
+                               const int startY,
+                               const int startX)
+{
+  return mvwin(window.getWindow(), startY, startX) == OK;
+} // end of "moveWindow"
+
+
+
+void CursesBackend::moveCursor(CursesWindow& window,
+                               const int line,
+                               const int col)
+{
+  wmove(window.getWindow(), line, col);
+} // end of "moveCursor"
+
+
+
+bool CursesBackend::openPad(CursesWindow& window,
+                            const int numLines,
+                            const int numCols)
+{
+  window.setWindow(newpad(numLines,
+                          numCols));
+
+  return window.getWindow() != nullptr;
+} // end of "openPad"
+
+
+
+bool CursesBackend::openScreen(CursesWindow& window)
+{
+  window.setWindow(stdscr);
+
+  return stdscr != nullptr;
+} // end of "openScreen"
+
+
+
+bool CursesBackend::openWindow(CursesWindow& window,
+                               const int numLines,
+                               const int numCols,
+                               const int startY,
+                               const int startX)
+{
+  window.setWindow(newwin(numLines,
+                          numCols,
+                          startY,
+                          startX));
+
+  return window.getWindow() != nullptr;
+} // end of "openWindow"
+
+
+
+void CursesBackend::printString(CursesWindow& window,
+                                const int line,
+                                const int col,
+                                const std::string_view text)
+{
+  mvwaddnstr(window.getWindow(),
+             line,
+             col,
+             text.data(),
+             text.length());
+} // end of "printString"
+
+
+
+bool CursesBackend::resizeWindow(CursesWindow& window,
+                                 const int numLines,
+                                 const int numCols)
+{
+  return wresize(window.getWindow(), numLines, numCols) == OK;
+} // end of "resizeWindow"
+
+
+
+void CursesBackend::setAttributes(CursesWindow& window,
+                                  const attr_t attributes)
+{
+  wattrset(window.getWindow(), attributes);
+} // end of "setAttributes"
+
+
+
+void CursesBackend::setBackground(CursesWindow& window,
+                                  const chtype background)
+{
+  wbkgd(window.getWindow(), background);
+} // end of "setBackground"
+
+
+
+void CursesBackend::stagePad(CursesWindow& window,
+                             const int padLine,
+                             const int padCol,
+                             const int startY,
+                             const int startX,
+                             const int numLines,
+                             const int numCols)
+{
+  pnoutrefresh(window.getWindow(),
+               padLine,
+               padCol,
+               startY,
+               startX,
+               startY + numLines - 1,
+               startX + numCols - 1);
+} // end of "stagePad"
+
+
+
+void CursesBackend::stageWindow(CursesWindow& window)
+{
+  wnoutrefresh(window.getWindow());
+} // end of "stageWindow"
+
+
+
+void CursesBackend::touchLines(CursesWindow& window,
+                               const int line,
+                               const int numLines)
+{
+  touchline(window.getWindow(), line, numLines);
+} // end of "touchLines"
+
+
+
+void CursesBackend::update()
+{
+  doupdate();
+} // end of "update"
+
+
+
+void CursesBackend::getScreenSize(int& numLines,
+                                  int& numCols) const
+{
+  getmaxyx(stdscr, numLines, numCols);
+} // end of "getScreenSize"
+
+
+
+/*
+  Function:
+   renderAttributes
+
+  Description:
+   Returns the attributes a character is drawn in on a memory window: the
+   window's attributes, with its background's added as curses adds them. A
+   color pair set on the window takes the place of the background's.
+
+  Input:
+   attributes           - the attributes of the window.
+
+   background           - the background of the window.
+
+  Output:
+   NONE
+
+  Returns:
+   attr_t               - the attributes of the drawn character.
+*/
+static attr_t renderAttributes(const attr_t attributes,
+                               const chtype background)
+{
+  attr_t backgroundAttributes = background & A_ATTRIBUTES;
+
+  if((attributes & A_COLOR) != 0)
+    {
+      backgroundAttributes &= ~A_COLOR;
+    }
+
+  return attributes | backgroundAttributes;
+} // end of "renderAttributes"
+
+
+
+/*
+  Function:
+   MemoryBackend Constructor
+
+  Description:
+   Creates a backend with a blank screen of the incoming size and no
+   windows.
+
+  Input:
+   numLines             - the number of lines of the screen.
+
+   numCols              - the number of columns of the screen.
+
+  Output:
+   NONE
+*/
+MemoryBackend::MemoryBackend(const int numLines,
+                             const int numCols)
+  : m_numLines(0),
+    m_numCols(0),
+    m_numUpdates(0)
+{
+  setScreenSize(numLines,
+                numCols);
+} // end of "MemoryBackend Constructor"
+
+
+
+void MemoryBackend::attributesOff(CursesWindow& window,
+                                  const attr_t attributes)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr)
+    {
+      return;
+    }
+
+  // turning off a color pair turns off whichever pair is set
+  if((attributes & A_COLOR) != 0)
+    {
+      memoryWindow->attributes &= ~(attributes | A_COLOR);
+    }
+  else
+    {
+      memoryWindow->attributes &= ~attributes;
+    }
+
+  recordCall(window, _DRAWATTRIBUTES, 0, 0, 0);
+} // end of "attributesOff"
+
+
+
+void MemoryBackend::attributesOn(CursesWindow& window,
+                                 const attr_t attributes)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr)
+    {
+      return;
+    }
+
+  // a color pair replaces the pair that is set
+  if((attributes & A_COLOR) != 0)
+    {
+      memoryWindow->attributes = (memoryWindow->attributes & ~A_COLOR) | attributes;
+    }
+  else
+    {
+      memoryWindow->attributes |= attributes;
+    }
+
+  recordCall(window, _DRAWATTRIBUTES, 0, 0, 0);
+} // end of "attributesOn"
+
+
+
+void MemoryBackend::clearCalls()
+{
+  m_calls.clear();
+} // end of "clearCalls"
+
+
+
+void MemoryBackend::closeWindow(CursesWindow& window)
+{
+  if(m_windows.erase(&window) != 0)
+    {
+      recordCall(window, _DRAWCLOSE, 0, 0, 0);
+    }
+} // end of "closeWindow"
+
+
+
+/*
+  Function:
+   drawBox
+
+  Description:
+   Draws a border around the edge of a memory window in its attributes.
+   Where curses draws line drawing characters, the corners and any side
+   given as 0, plain '+', '|' and '-' are drawn.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   vertical             - the character of the left and right sides, or 0.
+
+   horizontal           - the character of the top and bottom sides, or 0.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::drawBox(CursesWindow& window,
+                            const chtype vertical,
+                            const chtype horizontal)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr)
+    {
+      return;
+    }
+
+  const int numLines = memoryWindow->numLines;
+  const int numCols = memoryWindow->numCols;
+  const attr_t attributes = renderAttributes(memoryWindow->attributes,
+                                             memoryWindow->background);
+  const char side = vertical == 0 ? '|' : (char)(vertical & A_CHARTEXT);
+  const char top = horizontal == 0 ? '-' : (char)(horizontal & A_CHARTEXT);
+
+  for(int i = 0; i < numLines; i++)
+    {
+      for(int j = 0; j < numCols; j++)
+        {
+          const bool isSide = j == 0 || j == numCols - 1;
+          const bool isTop = i == 0 || i == numLines - 1;
+
+          if(isSide == false && isTop == false)
+            {
+              continue;
+            }
+
+          MemoryCell& cell = memoryWindow->cells.at(i * numCols + j);
+
+          cell.ch = isSide && isTop ? '+' : (isSide ? side : top);
+          cell.attributes = attributes;
+        }
+    }
+
+  markWindowChanged(*memoryWindow);
+  recordCall(window, _DRAWBOX, 0, 0, 0);
+} // end of "drawBox"
+
+
+
+void MemoryBackend::eraseWindow(CursesWindow& window)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr)
+    {
+      return;
+    }
+
+  MemoryCell cell;
+
+  cell.ch = (memoryWindow->background & A_CHARTEXT) == 0 ? ' ' :
+    (char)(memoryWindow->background & A_CHARTEXT);
+  cell.attributes = memoryWindow->background & A_ATTRIBUTES;
+  std::fill(memoryWindow->cells.begin(), memoryWindow->cells.end(), cell);
+  memoryWindow->cursorY = 0;
+  memoryWindow->cursorX = 0;
+  markWindowChanged(*memoryWindow);
+  recordCall(window, _DRAWERASE, 0, 0, 0);
+} // end of "eraseWindow"
+
+
+
+/*
+  Function:
+   moveWindow
+
+  Description:
+   Moves a memory window. As with curses, the window must fit on the screen
+   at its new start.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   startY               - the new starting line.
+
+   startX               - the new starting column.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the window was moved.
+*/
+bool MemoryBackend::moveWindow(CursesWindow& window,
+                               const int startY,
+                               const int startX)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr || startY < 0 || startX < 0 ||
+     startY + memoryWindow->numLines > m_numLines ||
+     startX + memoryWindow->numCols > m_numCols)
+    {
+      return false;
+    }
+
+  memoryWindow->startY = startY;
+  memoryWindow->startX = startX;
+  markWindowChanged(*memoryWindow);
+  recordCall(window, _DRAWMOVE, startY, startX, 0);
+
+  return true;
+} // end of "moveWindow"
+
+
+
+void MemoryBackend::moveCursor(CursesWindow& window,
+                               const int line,
+                               const int col)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow != nullptr && line >= 0 && line < memoryWindow->numLines &&
+     col >= 0 && col < memoryWindow->numCols)
+    {
+      memoryWindow->cursorY = line;
+      memoryWindow->cursorX = col;
+    }
+} // end of "moveCursor"
+
+
+
+/*
+  Function:
+   openPad
+
+  Description:
+   Opens a blank memory pad. As with curses, a pad may be larger than the
+   screen and is never staged whole, only through stagePad().
+
+  Input/Output:
+   window               - a reference to the window to open as a pad.
+
+  Input:
+   numLines             - the number of lines.
+
+   numCols              - the number of columns.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the pad was opened.
+*/
+bool MemoryBackend::openPad(CursesWindow& window,
+                            const int numLines,
+                            const int numCols)
+{
+  if(openWindow(window,
+                numLines,
+                numCols,
+                0,
+                0) == false)
+    {
+      return false;
+    }
+
+  m_windows[&window].isPad = true;
+
+  return true;
+} // end of "openPad"
+
+
+
+bool MemoryBackend::openScreen(CursesWindow& window)
+{
+  return openWindow(window,
+                    m_numLines,
+                    m_numCols,
+                    0,
+                    0);
+} // end of "openScreen"
+
+
+
+/*
+  Function:
+   openWindow
+
+  Description:
+   Opens a blank memory window. As with curses, a size of 0 reaches to the
+   edge of the screen, and a window may reach past the screen, whose part
+   off the screen is never shown.
+
+  Input/Output:
+   window               - a reference to the window to open.
+
+  Input:
+   numLines             - the number of lines, or 0.
+
+   numCols              - the number of columns, or 0.
+
+   startY               - the starting line on the screen.
+
+   startX               - the starting column on the screen.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the window was opened.
+*/
+bool MemoryBackend::openWindow(CursesWindow& window,
+                               const int numLines,
+                               const int numCols,
+                               const int startY,
+                               const int startX)
+{
+  const int lines = numLines == 0 ? m_numLines - startY : numLines;
+  const int cols = numCols == 0 ? m_numCols - startX : numCols;
+
+  if(startY < 0 || startX < 0 || lines <= 0 || cols <= 0)
+    {
+      return false;
+    }
+
+  MemoryWindow& memoryWindow = m_windows[&window];
+
+  memoryWindow.isPad = false;
+  memoryWindow.numLines = lines;
+  memoryWindow.numCols = cols;
+  memoryWindow.startY = startY;
+  memoryWindow.startX = startX;
+  memoryWindow.cursorY = 0;
+  memoryWindow.cursorX = 0;
+  memoryWindow.attributes = A_NORMAL;
+  memoryWindow.background = ' ';
+  memoryWindow.cells.assign(lines * cols, blankCell);
+  markWindowChanged(memoryWindow);
+  recordCall(window, _DRAWOPEN, startY, startX, cols);
+
+  return true;
+} // end of "openWindow"
+
+
+
+/*
+  Function:
+   printString
+
+  Description:
+   Prints a string to a memory window in its attributes. As with curses,
+   nothing is printed if the start is outside the window, a string that
+   reaches the end of a line goes on at the start of the next, and printing
+   stops at the end of the window.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   line                 - the line of the window to start at.
+
+   col                  - the column of the window to start at.
+
+   text                 - a view of the string.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::printString(CursesWindow& window,
+                                const int line,
+                                const int col,
+                                const std::string_view text)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr || line < 0 || line >= memoryWindow->numLines ||
+     col < 0 || col >= memoryWindow->numCols)
+    {
+      return;
+    }
+
+  const attr_t attributes = renderAttributes(memoryWindow->attributes,
+                                             memoryWindow->background);
+  int y = line;
+  int x = col;
+
+  for(size_t i = 0; i < text.length() && text[i] != '\0' && y < memoryWindow->numLines; i++)
+    {
+      MemoryCell& cell = memoryWindow->cells.at(y * memoryWindow->numCols + x);
+
+      cell.ch = text[i];
+      cell.attributes = attributes;
+      markChanged(*memoryWindow, y, x, x);
+
+      if(++x == memoryWindow->numCols)
+        {
+          x = 0;
+          y++;
+        }
+    }
+
+  memoryWindow->cursorY = std::min(y, memoryWindow->numLines - 1);
+  memoryWindow->cursorX = y < memoryWindow->numLines ? x : memoryWindow->numCols - 1;
+  recordCall(window, _DRAWPRINT, line, col, text.length());
+} // end of "printString"
+
+
+
+/*
+  Function:
+   resizeWindow
+
+  Description:
+   Resizes a memory window, keeping the cells the old and new sizes share
+   and blanking the rest.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   numLines             - the new number of lines.
+
+   numCols              - the new number of columns.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the window was resized.
+*/
+bool MemoryBackend::resizeWindow(CursesWindow& window,
+                                 const int numLines,
+                                 const int numCols)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr || numLines <= 0 || numCols <= 0)
+    {
+      return false;
+    }
+
+  std::vector<MemoryCell> cells(numLines * numCols, blankCell);
+
+  for(int i = 0; i < std::min(numLines, memoryWindow->numLines); i++)
+    {
+      for(int j = 0; j < std::min(numCols, memoryWindow->numCols); j++)
+        {
+          cells.at(i * numCols + j) = memoryWindow->cells.at(i * memoryWindow->numCols + j);
+        }
+    }
+
+  memoryWindow->cells.swap(cells);
+  memoryWindow->numLines = numLines;
+  memoryWindow->numCols = numCols;
+  memoryWindow->cursorY = std::min(memoryWindow->cursorY, numLines - 1);
+  memoryWindow->cursorX = std::min(memoryWindow->cursorX, numCols - 1);
+  markWindowChanged(*memoryWindow);
+  recordCall(window, _DRAWRESIZE, numLines, numCols, 0);
+
+  return true;
+} // end of "resizeWindow"
+
+
+
+void MemoryBackend::setAttributes(CursesWindow& window,
+                                  const attr_t attributes)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow != nullptr)
+    {
+      memoryWindow->attributes = attributes;
+      recordCall(window, _DRAWATTRIBUTES, 0, 0, 0);
+    }
+} // end of "setAttributes"
+
+
+
+/*
+  Function:
+   setBackground
+
+  Description:
+   Sets the background of a memory window as curses does: blank cells take
+   the new background, drawn cells trade the old background's attributes
+   for the new one's, and the window's attributes become the background's.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   background           - the background character and attributes; a
+                          character of 0 is a space.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::setBackground(CursesWindow& window,
+                                  const chtype background)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr)
+    {
+      return;
+    }
+
+  const chtype oldBackground = memoryWindow->background;
+  const char oldCh = (oldBackground & A_CHARTEXT) == 0 ? ' ' : (char)(oldBackground & A_CHARTEXT);
+  const char newCh = (background & A_CHARTEXT) == 0 ? ' ' : (char)(background & A_CHARTEXT);
+  const attr_t oldAttributes = oldBackground & A_ATTRIBUTES;
+  const attr_t newAttributes = background & A_ATTRIBUTES;
+
+  for(size_t i = 0; i < memoryWindow->cells.size(); i++)
+    {
+      MemoryCell& cell = memoryWindow->cells.at(i);
+
+      if(cell.ch == oldCh && cell.attributes == oldAttributes)
+        {
+          cell.ch = newCh;
+          cell.attributes = newAttributes;
+        }
+      else
+        {
+          cell.attributes = (cell.attributes & ~oldAttributes) | newAttributes;
+        }
+    }
+
+  memoryWindow->background = background;
+  memoryWindow->attributes = newAttributes;
+  markWindowChanged(*memoryWindow);
+  recordCall(window, _DRAWATTRIBUTES, 0, 0, 0);
+} // end of "setBackground"
+
+
+
+/*
+  Function:
+   setScreenSize
+
+  Description:
+   Resizes the screen and blanks it, as a terminal resize would. The windows
+   keep their sizes and places until they are redefined.
+
+  Input:
+   numLines             - the number of lines of the screen.
+
+   numCols              - the number of columns of the screen.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::setScreenSize(const int numLines,
+                                  const int numCols)
+{
+  m_numLines = std::max(numLines, 0);
+  m_numCols = std::max(numCols, 0);
+  m_screen.assign(m_numLines * m_numCols, blankCell);
+} // end of "setScreenSize"
+
+
+
+/*
+  Function:
+   stagePad
+
+  Description:
+   Copies a region of a memory pad onto a region of the screen, every cell
+   of it whether it changed or not, then marks the pad unchanged, as
+   pnoutrefresh() does. The part off the pad or the screen is left out.
+
+  Input/Output:
+   window               - a reference to the pad.
+
+  Input:
+   padLine              - the first line of the pad copied.
+   padCol               - the first column of the pad copied.
+   startY               - the line of the screen it's copied to.
+   startX               - the column of the screen it's copied to.
+   numLines             - the number of lines copied.
+   numCols              - the number of columns copied.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::stagePad(CursesWindow& window,
+                             const int padLine,
+                             const int padCol,
+                             const int startY,
+                             const int startX,
+                             const int numLines,
+                             const int numCols)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr || memoryWindow->isPad == false ||
+     padLine < 0 || padCol < 0 || startY < 0 || startX < 0)
+    {
+      return;
+    }
+
+  const int lines = std::min({numLines, memoryWindow->numLines - padLine, m_numLines - startY});
+  const int cols = std::min({numCols, memoryWindow->numCols - padCol, m_numCols - startX});
+
+  for(int i = 0; i < lines && cols > 0; i++)
+    {
+      const MemoryCell* row = &memoryWindow->cells.at((padLine + i) * memoryWindow->numCols);
+
+      std::copy(row + padCol,
+                row + padCol + cols,
+                m_screen.begin() + (startY + i) * m_numCols + startX);
+    }
+
+  std::fill(memoryWindow->firstChanged.begin(), memoryWindow->firstChanged.end(), -1);
+  std::fill(memoryWindow->lastChanged.begin(), memoryWindow->lastChanged.end(), -1);
+  recordCall(window, _DRAWSTAGEPAD, padLine, padCol, numCols);
+} // end of "stagePad"
+
+
+
+/*
+  Function:
+   stageWindow
+
+  Description:
+   Copies the cells of a memory window changed since it was last staged
+   onto the screen over whatever is under it, then marks them unchanged,
+   as wnoutrefresh() does. The part off the screen is left out, and a pad
+   is left alone.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::stageWindow(CursesWindow& window)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr || memoryWindow->isPad == true)
+    {
+      return;
+    }
+
+  const int lastLine = std::min(memoryWindow->startY + memoryWindow->numLines, m_numLines);
+  const int lastCol = std::min(memoryWindow->startX + memoryWindow->numCols, m_numCols);
+
+  for(int i = memoryWindow->startY; i < lastLine; i++)
+    {
+      const int line = i - memoryWindow->startY;
+      const int firstChanged = memoryWindow->firstChanged.at(line);
+      const int lastChanged = std::min(memoryWindow->lastChanged.at(line),
+                                       lastCol - memoryWindow->startX - 1);
+
+      if(firstChanged < 0 || firstChanged > lastChanged)
+        {
+          continue;
+        }
+
+      const MemoryCell* row = &memoryWindow->cells.at(line * memoryWindow->numCols);
+
+      std::copy(row + firstChanged,
+                row + lastChanged + 1,
+                m_screen.begin() + i * m_numCols + memoryWindow->startX + firstChanged);
+    }
+
+  std::fill(memoryWindow->firstChanged.begin(), memoryWindow->firstChanged.end(), -1);
+  std::fill(memoryWindow->lastChanged.begin(), memoryWindow->lastChanged.end(), -1);
+
+  recordCall(window, _DRAWSTAGE, 0, 0, 0);
+} // end of "stageWindow"
+
+
+
+/*
+  Function:
+   touchLines
+
+  Description:
+   Marks whole lines of a memory window as changed, so the next stage
+   copies them whether or not they were drawn to, as touchline() does.
+
+  Input/Output:
+   window               - a reference to the window.
+
+  Input:
+   line                 - the first line of the window marked.
+   numLines             - the number of lines marked.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::touchLines(CursesWindow& window,
+                               const int line,
+                               const int numLines)
+{
+  MemoryWindow* memoryWindow = findWindow(window);
+
+  if(memoryWindow == nullptr)
+    {
+      return;
+    }
+
+  for(int i = std::max(line, 0); i < std::min(line + numLines, memoryWindow->numLines); i++)
+    {
+      markChanged(*memoryWindow, i, 0, memoryWindow->numCols - 1);
+    }
+
+  recordCall(window, _DRAWTOUCH, line, 0, numLines);
+} // end of "touchLines"
+
+
+
+void MemoryBackend::update()
+{
+  m_numUpdates++;
+  m_calls.push_back({ _DRAWUPDATE, nullptr, 0, 0, 0 });
+} // end of "update"
+
+
+
+/*
+  Function:
+   findWindow
+
+  Description:
+   Finds the memory window of a CursesWindow.
+
+  Input:
+   window               - a reference to the constant window.
+
+  Output:
+   NONE
+
+  Returns:
+   MemoryWindow*        - a pointer to its memory window, or nullptr if it
+                          isn't open.
+*/
+MemoryBackend::MemoryWindow* MemoryBackend::findWindow(const CursesWindow& window)
+{
+  std::unordered_map<const CursesWindow*, MemoryWindow>::iterator it = m_windows.find(&window);
+
+  return it == m_windows.end() ? nullptr : &it->second;
+} // end of "findWindow"
+
+
+
+/*
+  Function:
+   markChanged
+
+  Description:
+   Widens the changed part of a line of a memory window to take in a span
+   of its columns.
+
+  Input/Output:
+   memoryWindow         - a reference to the memory window.
+
+  Input:
+   line                 - the line of the window.
+   firstCol             - the first column of the span.
+   lastCol              - the last column of the span.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::markChanged(MemoryWindow& memoryWindow,
+                                const int line,
+                                const int firstCol,
+                                const int lastCol)
+{
+  int& firstChanged = memoryWindow.firstChanged.at(line);
+  int& lastChanged = memoryWindow.lastChanged.at(line);
+
+  firstChanged = firstChanged < 0 ? firstCol : std::min(firstChanged, firstCol);
+  lastChanged = std::max(lastChanged, lastCol);
+} // end of "markChanged"
+
+
+
+void MemoryBackend::markWindowChanged(MemoryWindow& memoryWindow)
+{
+  memoryWindow.firstChanged.assign(memoryWindow.numLines, 0);
+  memoryWindow.lastChanged.assign(memoryWindow.numLines, memoryWindow.numCols - 1);
+} // end of "markWindowChanged"
+
+
+
+void MemoryBackend::recordCall(const CursesWindow& window,
+                               const int op,
+                               const int line,
+                               const int col,
+                               const int length)
+{
+  m_calls.push_back({ op, &window, line, col, length });
+} // end of "recordCall"
+
+
+
+const std::vector<DrawCall>& MemoryBackend::getCalls() const
+{
+  return m_calls;
+} // end of "getCalls"
+
+
+
+const MemoryCell& MemoryBackend::getCell(const int line,
+                                         const int col) const
+{
+  return m_screen.at(line * m_numCols + col);
+} // end of "getCell"
+
+
+
+/*
+  Function:
+   getLine
+
+  Description:
+   Returns the characters of a line of the screen.
+
+  Input:
+   line                 - the line of the screen.
+
+  Output:
+   text                 - a reference to a string that receives the line.
+
+  Returns:
+   NONE
+*/
+void MemoryBackend::getLine(const int line,
+                            std::string& text) const
+{
+  text.clear();
+
+  for(int i = 0; i < m_numCols; i++)
+    {
+      text.push_back(m_screen.at(line * m_numCols + i).ch);
+    }
+} // end of "getLine"
+
+
+
+int MemoryBackend::getNumUpdates() const
+{
+  return m_numUpdates;
+} // end of "getNumUpdates"
+
+
+
+int MemoryBackend::getNumWindows() const
+{
+  return m_windows.size();
+} // end of "getNumWindows"
+
+
+
+void MemoryBackend::getScreenSize(int& numLines,
+                                  int& numCols) const
+{
+  numLines = m_numLines;
+  numCols = m_numCols;
+} // end of "getScreenSize"
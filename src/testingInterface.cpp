@@ -171,3 +171,44 @@ void printTestStringVectorToLog(const std::vector<std::string>& strings,
       i++;
     }
 } // end of "printTestStringVector"
+
+
+
+void initTestPalettes(const std::vector<std::string>& themeNames,
+                      std::unordered_map<std::string, Palette>& palettes,
+                      std::ofstream& log)
+{
+  for(size_t i = 0; i < themeNames.size(); i++)
+    {
+      if(palettes.count(themeNames.at(i)) != 0)
+        {
+          continue;
+        }
+
+      // seed the colors from the theme name so each theme keeps its look
+      unsigned long seed = std::hash<std::string>()(themeNames.at(i));
+      Palette palette(themeNames.at(i), _THEMEPALETTESIZE);
+
+      for(int j = 0; j < (int)_ANSICOLORS; j++)
+        {
+          const int high = (j < 8 ? 150 : 190) + seed % 60;
+          const int low = (j < 8 ? 0 : 60) + (seed >> 8) % 50;
+          int red = (j & 1) ? high : low;
+          int green = (j & 2) ? high : low;
+          int blue = (j & 4) ? high : low;
+
+          // black and white are grays
+          if((j & 7) == 0)
+            {
+              red = green = blue = j == 0 ? (seed >> 16) % 40 : 80 + (seed >> 16) % 40;
+            }
+
+          palette.setColor(j, (red << 16) | (green << 8) | blue);
+          seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+        }
+
+      palette.setColor(_PALETTEFOREGROUND, palette.getColor(15));
+      palette.setColor(_PALETTEBACKGROUND, palette.getColor(0));
+      palettes.insert(std::make_pair(themeNames.at(i), palette));
+    }
+} // end of "initTestPalettes"
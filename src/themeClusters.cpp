@@ -0,0 +1,450 @@
+/*
+  File:
+   themeClusters.cpp
+
+  Description:
+   The implementation of the themeClusters.hpp class.
+*/
+#include <algorithm>
+#include <cmath>
+#include "themeClusters.hpp"
+
+
+
+/*
+  Function:
+   toDelta
+
+  Description:
+   Converts a distance between fingerprints to the average OKLab difference
+   per color it stands for.
+
+  Input:
+   distance             - the distance in fingerprint steps.
+
+  Output:
+   NONE
+
+  Returns:
+   float                - the average OKLab difference per color.
+*/
+static float toDelta(const float distance)
+{
+  return distance / _FINGERPRINTSCALE / sqrtf((float)_THEMEPALETTESIZE);
+} // end of "toDelta"
+
+
+
+/*
+  Function:
+   ThemeClusters Constructor
+
+  Description:
+   Creates the clusters of a library, not yet built and not collapsed.
+
+  Input:
+   library              - a reference to the constant saved themes library;
+                          it must outlive the clusters.
+
+  Output:
+   NONE
+*/
+ThemeClusters::ThemeClusters(const ThemeLibrary& library)
+  : m_library(&library),
+    m_numClusters(0),
+    m_numExact(0),
+    m_numNear(0),
+    m_isIndexed(false),
+    m_isClustered(false),
+    m_isCollapsed(false)
+{
+} // end of "ThemeClusters Constructor"
+
+
+
+/*
+  Function:
+   buildClusters
+
+  Description:
+   Walks the themes in name order: a theme no group has claimed yet starts a
+   group of itself and every unclaimed theme within maxDelta of it. Each
+   theme is compared with the first theme of its group only, so groups can't
+   chain into one another. Themes without a palette are groups of one. The
+   index is built first if it hasn't been.
+
+  Input:
+   maxDelta             - the largest average OKLab difference per color of
+                          themes in the same group.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeClusters::buildClusters(const float maxDelta)
+{
+  const int numEntries = m_library->getNumEntries();
+  const float radius = maxDelta * _FINGERPRINTSCALE * sqrtf((float)_THEMEPALETTESIZE);
+  std::vector<IndexMatch> matches;
+  std::string leaderValue;
+  std::string memberValue;
+
+  if(m_isIndexed == false)
+    {
+      buildIndex();
+    }
+
+  m_leaders.assign(numEntries, -1);
+  m_deltas.assign(numEntries, 0);
+  m_isExact.assign(numEntries, 0);
+  m_clusterSizes.assign(numEntries, 1);
+  m_representatives.clear();
+  m_numClusters = 0;
+  m_numExact = 0;
+  m_numNear = 0;
+
+  for(int i = 0; i < numEntries; i++)
+    {
+      if(m_leaders.at(i) != -1)
+        {
+          continue;
+        }
+
+      m_leaders.at(i) = i;
+      m_representatives.push_back(i);
+
+      if(m_entryFingerprints.at(i) == -1)
+        {
+          continue;
+        }
+
+      m_index.findWithinRadius(m_index.getFingerprint(m_entryFingerprints.at(i)),
+                               radius,
+                               matches);
+
+      for(size_t j = 0; j < matches.size(); j++)
+        {
+          const int member = m_fingerprintEntries.at(matches.at(j).id);
+
+          if(m_leaders.at(member) != -1)
+            {
+              continue;
+            }
+
+          m_leaders.at(member) = i;
+          m_deltas.at(member) = toDelta(matches.at(j).distance);
+          m_clusterSizes.at(i)++;
+
+          // only themes with equal fingerprints can have identical colors
+          if(matches.at(j).distance == 0 &&
+             m_library->getValue(i, leaderValue) &&
+             m_library->getValue(member, memberValue) &&
+             leaderValue == memberValue)
+            {
+              m_isExact.at(member) = 1;
+              m_numExact++;
+            }
+          else
+            {
+              m_numNear++;
+            }
+        }
+
+      if(m_clusterSizes.at(i) > 1)
+        {
+          m_numClusters++;
+        }
+    }
+
+  m_isClustered = true;
+} // end of "buildClusters"
+
+
+
+/*
+  Function:
+   buildIndex
+
+  Description:
+   Fingerprints every theme in the library that has a palette and indexes
+   the fingerprints, which is all findSimilar() needs.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeClusters::buildIndex()
+{
+  const int numEntries = m_library->getNumEntries();
+  std::vector<LibraryEntry> entries;
+  std::vector<int8_t> fingerprints;
+  Palette palette;
+
+  m_library->getEntries(0, numEntries, entries);
+  m_fingerprintEntries.clear();
+  m_entryFingerprints.assign(numEntries, -1);
+
+  for(size_t i = 0; i < entries.size(); i++)
+    {
+      if(entries.at(i).value.empty() || palette.unpack(entries.at(i).value) == false)
+        {
+          continue;
+        }
+
+      fingerprints.resize((m_fingerprintEntries.size() + 1) * _FINGERPRINTSIZE);
+
+      if(fingerprintPalette(palette, &fingerprints.at(m_fingerprintEntries.size() *
+                                                      _FINGERPRINTSIZE)))
+        {
+          m_entryFingerprints.at(i) = m_fingerprintEntries.size();
+          m_fingerprintEntries.push_back(i);
+        }
+    }
+
+  fingerprints.resize(m_fingerprintEntries.size() * _FINGERPRINTSIZE);
+  m_index.build(fingerprints);
+  m_isIndexed = true;
+} // end of "buildIndex"
+
+
+
+/*
+  Function:
+   findSimilar
+
+  Description:
+   Finds the themes whose palettes look most like the palette of the incoming
+   theme.
+
+  Input:
+   entry                - the library index of the theme.
+
+   count                - the number of themes to find.
+
+  Output:
+   similar              - a reference to a vector that receives up to count
+                          themes, most similar first, not including entry.
+
+  Returns:
+   bool                 - false if the theme has no palette to compare.
+*/
+bool ThemeClusters::findSimilar(const int entry,
+                                const int count,
+                                std::vector<ClusterMember>& similar) const
+{
+  similar.clear();
+
+  if(entry < 0 || entry >= (int)m_entryFingerprints.size() ||
+     m_entryFingerprints.at(entry) == -1)
+    {
+      return false;
+    }
+
+  std::vector<IndexMatch> matches;
+  ClusterMember member;
+
+  m_index.findNearest(m_index.getFingerprint(m_entryFingerprints.at(entry)),
+                      count + 1,
+                      matches);
+
+  for(size_t i = 0; i < matches.size() && (int)similar.size() < count; i++)
+    {
+      member.entry = m_fingerprintEntries.at(matches.at(i).id);
+      member.delta = toDelta(matches.at(i).distance);
+
+      if(member.entry != entry)
+        {
+          similar.push_back(member);
+        }
+    }
+
+  return true;
+} // end of "findSimilar"
+
+
+
+/*
+  Function:
+   getClusters
+
+  Description:
+   Lists every group of more than one theme found by buildClusters().
+
+  Input:
+   NONE
+
+  Output:
+   clusters             - a reference to a vector that receives the groups
+                          in name order, each starting with the theme that
+                          represents it.
+
+  Returns:
+   NONE
+*/
+void ThemeClusters::getClusters(std::vector<std::vector<ClusterMember> >& clusters) const
+{
+  std::vector<int> clusterNums(m_leaders.size(), -1);
+  ClusterMember member;
+
+  clusters.clear();
+  clusters.reserve(m_numClusters);
+
+  for(size_t i = 0; i < m_leaders.size(); i++)
+    {
+      const int leader = m_leaders.at(i);
+
+      if(m_clusterSizes.at(leader) < 2)
+        {
+          continue;
+        }
+
+      if(clusterNums.at(leader) == -1)
+        {
+          clusterNums.at(leader) = clusters.size();
+          clusters.push_back(std::vector<ClusterMember>());
+        }
+
+      member.entry = i;
+      member.delta = m_deltas.at(i);
+      clusters.at(clusterNums.at(leader)).push_back(member);
+    }
+} // end of "getClusters"
+
+
+
+/*
+  Function:
+   getVisibleNames
+
+  Description:
+   Decodes the names of the themes listed in the _SAVEDTHEMESWIN at
+   positions first through first + count - 1: every theme when not collapsed,
+   otherwise the theme that represents each group. The strings already in
+   names are reused.
+
+  Input:
+   first                - the first list position.
+
+   count                - the largest number of names to decode.
+
+  Output:
+   names                - a reference to a vector that receives the names.
+
+  Returns:
+   NONE
+*/
+void ThemeClusters::getVisibleNames(const int first,
+                                    const int count,
+                                    std::vector<std::string>& names) const
+{
+  const int last = std::min(getNumVisible(), first + count);
+
+  if(first < 0 || first >= last)
+    {
+      names.clear();
+      return;
+    }
+
+  if(getNumVisible() == m_library->getNumEntries())
+    {
+      m_library->getRange(first, last - first, names);
+    }
+  else
+    {
+      names.resize(last - first);
+
+      for(int i = first; i < last; i++)
+        {
+          m_library->getName(m_representatives.at(i), names.at(i - first));
+        }
+    }
+} // end of "getVisibleNames"
+
+
+
+int ThemeClusters::getClusterSize(const int entry) const
+{
+  if(m_isCollapsed == false || entry < 0 || entry >= (int)m_clusterSizes.size())
+    {
+      return 1;
+    }
+
+  return m_clusterSizes.at(entry);
+} // end of "getClusterSize"
+
+
+
+bool ThemeClusters::getIsClustered() const
+{
+  return m_isClustered;
+} // end of "getIsClustered"
+
+
+
+bool ThemeClusters::getIsCollapsed() const
+{
+  return m_isCollapsed;
+} // end of "getIsCollapsed"
+
+
+
+bool ThemeClusters::getIsExact(const int entry) const
+{
+  return m_isExact.at(entry) != 0;
+} // end of "getIsExact"
+
+
+
+int ThemeClusters::getNumClusters() const
+{
+  return m_numClusters;
+} // end of "getNumClusters"
+
+
+
+int ThemeClusters::getNumExact() const
+{
+  return m_numExact;
+} // end of "getNumExact"
+
+
+
+int ThemeClusters::getNumNear() const
+{
+  return m_numNear;
+} // end of "getNumNear"
+
+
+
+int ThemeClusters::getNumVisible() const
+{
+  return m_isCollapsed ? m_representatives.size() : m_library->getNumEntries();
+} // end of "getNumVisible"
+
+
+
+int ThemeClusters::getNumVisited() const
+{
+  return m_index.getNumVisited();
+} // end of "getNumVisited"
+
+
+
+int ThemeClusters::getVisible(const int visibleIndex) const
+{
+  return m_isCollapsed ? m_representatives.at(visibleIndex) : visibleIndex;
+} // end of "getVisible"
+
+
+
+void ThemeClusters::setIsCollapsed(const bool isCollapsed)
+{
+  m_isCollapsed = isCollapsed && m_isClustered;
+} // end of "setIsCollapsed"
@@ -0,0 +1,639 @@
+/*
+  File:
+   themeDaemon.cpp
+
+  Description:
+   The implementation of the themeDaemon.hpp class.
+*/
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "applyEngine.hpp"
+#include "daemonProtocol.hpp"
+#include "fileOperations.hpp"
+#include "themeDaemon.hpp"
+#include "themeDetector.hpp"
+
+// pending connections the listening socket queues
+const int _DAEMONBACKLOG = 16;
+
+// set by SIGINT/SIGTERM to stop run()
+static volatile sig_atomic_t daemonStopSignal = 0;
+
+
+
+static void handleStopSignal(int signal)
+{
+  daemonStopSignal = signal;
+} // end of "handleStopSignal"
+
+
+
+/*
+  Function:
+   ThemeDaemon Constructor
+
+  Description:
+   Creates an idle daemon. Nothing is loaded or bound until start() is called.
+
+  Input:
+   socketPath           - a reference to a constant string containing the path
+                          of the Unix socket to listen on.
+
+   storePath            - a reference to a constant string containing the path
+                          of the saved file store.
+
+  Output:
+   NONE
+*/
+ThemeDaemon::ThemeDaemon(const std::string& socketPath,
+                         const std::string& storePath)
+  : m_socketPath(socketPath),
+    m_storePath(storePath),
+    m_listenFd(-1),
+    m_running(false),
+    m_fileWatcher(detectFileTheme)
+{
+} // end of "ThemeDaemon Constructor"
+
+
+
+/*
+  Function:
+   ThemeDaemon Destructor
+
+  Description:
+   Disconnects every client and removes the socket.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+ThemeDaemon::~ThemeDaemon()
+{
+  stop();
+} // end of "ThemeDaemon Destructor"
+
+
+
+/*
+  Function:
+   start
+
+  Description:
+   Loads the saved file store and the current theme of every saved file, then
+   binds the socket. A socket file left behind by a daemon that is no longer
+   running is replaced; a live daemon is never displaced. The socket's
+   directory is created for this user alone, and one that isn't is refused.
+
+  Input:
+   log                  - a reference to the log file output stream.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the daemon is ready to run().
+*/
+bool ThemeDaemon::start(std::ofstream& log)
+{
+  struct sockaddr_un address;
+
+  if(m_socketPath.length() >= sizeof(address.sun_path))
+    {
+      log << "Daemon: socket path too long " << m_socketPath << std::endl;
+      return false;
+    }
+
+  if(checkDaemonSocketDir(m_socketPath, true) == false)
+    {
+      log << "Daemon: socket directory isn't private to this user " << m_socketPath
+          << std::endl;
+      return false;
+    }
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.length());
+
+  m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+  if(m_listenFd == -1)
+    {
+      return false;
+    }
+
+  // the socket only accepts connections from this user
+  const mode_t oldMask = umask(0077);
+  int bound = bind(m_listenFd, (struct sockaddr*)&address, sizeof(address));
+
+  if(bound == -1 && errno == EADDRINUSE)
+    {
+      DaemonClient client;
+
+      if(client.connectTo(m_socketPath) == false)
+        {
+          unlink(m_socketPath.c_str());
+          bound = bind(m_listenFd, (struct sockaddr*)&address, sizeof(address));
+        }
+    }
+
+  umask(oldMask);
+
+  if(bound == -1 || listen(m_listenFd, _DAEMONBACKLOG) == -1)
+    {
+      log << "Daemon: can't listen on " << m_socketPath << std::endl;
+      close(m_listenFd);
+      m_listenFd = -1;
+      return false;
+    }
+
+  loadStore(log);
+  m_running = true;
+
+  log << "Daemon: listening on " << m_socketPath << std::endl;
+
+  return true;
+} // end of "start"
+
+
+
+/*
+  Function:
+   run
+
+  Description:
+   Serves clients until a _DAEMONQUIT request, SIGINT or SIGTERM. Each client
+   may send any number of requests over one connection; they are answered in
+   order. Client sockets never block: responses a client doesn't read yet
+   wait in its output buffer, and its requests aren't read until the buffer
+   drains, so a stuck client only holds up itself.
+
+  Input:
+   log                  - a reference to the log file output stream.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeDaemon::run(std::ofstream& log)
+{
+  struct sigaction action;
+  struct sigaction oldInt;
+  struct sigaction oldTerm;
+  std::vector<struct pollfd> pollFds;
+
+  // no SA_RESTART, so a signal interrupts poll()
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = handleStopSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, &oldInt);
+  sigaction(SIGTERM, &action, &oldTerm);
+  daemonStopSignal = 0;
+
+  while(m_running == true && daemonStopSignal == 0)
+    {
+      struct pollfd pollFd;
+
+      pollFds.clear();
+      pollFd.fd = m_listenFd;
+      pollFd.events = POLLIN;
+      pollFd.revents = 0;
+      pollFds.push_back(pollFd);
+
+      for(std::unordered_map<int, DaemonConnection>::iterator it = m_clients.begin();
+          it != m_clients.end(); it++)
+        {
+          pollFd.fd = it->first;
+          pollFd.events = it->second.output.empty() ? POLLIN : POLLOUT;
+          pollFds.push_back(pollFd);
+        }
+
+      if(poll(pollFds.data(), pollFds.size(), -1) == -1)
+        {
+          if(errno == EINTR)
+            {
+              continue;
+            }
+
+          break;
+        }
+
+      for(size_t i = 1; i < pollFds.size() && m_running == true; i++)
+        {
+          const int fd = pollFds.at(i).fd;
+          bool isOpen = true;
+
+          if(pollFds.at(i).revents & POLLOUT)
+            {
+              isOpen = writeClient(fd);
+            }
+          else if(pollFds.at(i).revents != 0)
+            {
+              isOpen = readClient(fd, log);
+            }
+
+          if(isOpen == false)
+            {
+              close(fd);
+              m_clients.erase(fd);
+            }
+        }
+
+      if(pollFds.at(0).revents & POLLIN)
+        {
+          acceptClient();
+        }
+    }
+
+  sigaction(SIGINT, &oldInt, nullptr);
+  sigaction(SIGTERM, &oldTerm, nullptr);
+
+  log << "Daemon: stopped" << std::endl;
+} // end of "run"
+
+
+
+/*
+  Function:
+   stop
+
+  Description:
+   Disconnects every client, stops the file watcher and removes the socket.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeDaemon::stop()
+{
+  m_running = false;
+
+  for(std::unordered_map<int, DaemonConnection>::iterator it = m_clients.begin();
+      it != m_clients.end(); it++)
+    {
+      close(it->first);
+    }
+
+  m_clients.clear();
+  m_fileWatcher.stop();
+
+  if(m_listenFd != -1)
+    {
+      close(m_listenFd);
+      unlink(m_socketPath.c_str());
+      m_listenFd = -1;
+    }
+} // end of "stop"
+
+
+
+const std::vector<std::string>& ThemeDaemon::getSavedFiles() const
+{
+  return m_savedFiles;
+} // end of "getSavedFiles"
+
+
+
+const std::vector<std::string>& ThemeDaemon::getCurrThemes() const
+{
+  return m_currThemes;
+} // end of "getCurrThemes"
+
+
+
+void ThemeDaemon::acceptClient()
+{
+  const int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+
+  if(fd == -1)
+    {
+      return;
+    }
+
+  // only this user's processes may drive the daemon
+  if(checkDaemonPeer(fd) == false)
+    {
+      close(fd);
+      return;
+    }
+
+  m_clients.insert(std::make_pair(fd, DaemonConnection()));
+} // end of "acceptClient"
+
+
+
+/*
+  Function:
+   readClient
+
+  Description:
+   Reads what a client has sent and answers every complete request in it.
+   Partial requests stay buffered until the rest arrives, and the responses
+   are queued and sent as far as the client's socket takes them.
+
+  Input:
+   fd                   - the client's socket.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - false if the client disconnected or broke the
+                          protocol and should be closed.
+*/
+bool ThemeDaemon::readClient(const int fd,
+                             std::ofstream& log)
+{
+  DaemonConnection& connection = m_clients.at(fd);
+  std::string& buffer = connection.input;
+  char chunk[4096];
+  const ssize_t numRead = read(fd, chunk, sizeof(chunk));
+
+  if(numRead < 0 && (errno == EINTR || errno == EAGAIN))
+    {
+      return true;
+    }
+
+  if(numRead <= 0)
+    {
+      return false;
+    }
+
+  buffer.append(chunk, numRead);
+
+  size_t pos = 0;
+
+  while(buffer.length() - pos >= sizeof(DaemonHeader))
+    {
+      DaemonHeader header;
+
+      memcpy(&header, buffer.data() + pos, sizeof(header));
+
+      if(header.length > _DAEMONMAXPAYLOAD)
+        {
+          return false;
+        }
+
+      if(buffer.length() - pos - sizeof(header) < header.length)
+        {
+          break;
+        }
+
+      const std::string payload = buffer.substr(pos + sizeof(header), header.length);
+      int responseCode;
+      std::string response;
+
+      pos += sizeof(header) + header.length;
+      handleRequest(header.code, payload, responseCode, response, log);
+
+      if(appendDaemonMessage(connection.output, responseCode, response) == false)
+        {
+          return false;
+        }
+    }
+
+  buffer.erase(0, pos);
+
+  return connection.output.empty() || writeClient(fd);
+} // end of "readClient"
+
+
+
+/*
+  Function:
+   handleRequest
+
+  Description:
+   Answers a single request from the resident state.
+
+  Input:
+   code                 - a DaemonRequests value.
+
+   payload              - a reference to a constant string containing the
+                          request payload.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   responseCode         - the DaemonResponses value to answer with.
+
+   response             - a reference to a string that receives the response
+                          payload.
+
+  Returns:
+   NONE
+*/
+void ThemeDaemon::handleRequest(const int code,
+                                const std::string& payload,
+                                int& responseCode,
+                                std::string& response,
+                                std::ofstream& log)
+{
+  responseCode = _DAEMONOK;
+  response.clear();
+  takeThemeDeltas();
+
+  switch(code)
+    {
+    case _DAEMONPING:
+      break;
+    case _DAEMONAPPLY:
+      {
+        // counts of each ApplyResults value, then the paths that failed
+        int counts[_APPLYFAILED + 1] = { 0 };
+        std::vector<int> results;
+        std::string failed;
+
+        if(payload.empty())
+          {
+            responseCode = _DAEMONERROR;
+            response = "no theme given";
+            break;
+          }
+
+        if(checkThemeName(payload) == false)
+          {
+            responseCode = _DAEMONERROR;
+            response = "invalid theme name";
+            break;
+          }
+
+        applyThemeToFiles(m_savedFiles, payload, results, log);
+
+        for(size_t i = 0; i < m_savedFiles.size(); i++)
+          {
+            const int result = results.at(i);
+
+            counts[result]++;
+
+            if(result == _APPLYWRITTEN)
+              {
+                m_currThemes.at(i) = detectFileTheme(m_savedFiles.at(i));
+              }
+            else if(result == _APPLYFAILED)
+              {
+                failed.append(m_savedFiles.at(i));
+                failed.push_back('\n');
+              }
+          }
+
+        for(int i = 0; i <= _APPLYFAILED; i++)
+          {
+            response.append(std::to_string(counts[i]));
+            response.push_back(i == _APPLYFAILED ? '\n' : ' ');
+          }
+
+        response.append(failed);
+        break;
+      }
+    case _DAEMONSTATUS:
+      for(size_t i = 0; i < m_savedFiles.size(); i++)
+        {
+          response.append(m_currThemes.at(i));
+          response.push_back('\t');
+          response.append(m_savedFiles.at(i));
+          response.push_back('\n');
+        }
+      break;
+    case _DAEMONRELOAD:
+      if(loadStore(log) == false)
+        {
+          responseCode = _DAEMONERROR;
+          response = "can't read " + m_storePath;
+        }
+      break;
+    case _DAEMONQUIT:
+      m_running = false;
+      break;
+    default:
+      responseCode = _DAEMONERROR;
+      response = "unknown request";
+      break;
+    }
+} // end of "handleRequest"
+
+
+
+/*
+  Function:
+   loadStore
+
+  Description:
+   Reads the saved file store, detects the current theme of every saved file
+   and (re)starts the file watcher that keeps those themes current.
+
+  Input:
+   log                  - a reference to the log file output stream.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the store was read.
+*/
+bool ThemeDaemon::loadStore(std::ofstream& log)
+{
+  std::vector<std::string> savedFiles;
+
+  if(readSavedFiles(m_storePath, savedFiles) == false)
+    {
+      log << "Daemon: can't read " << m_storePath << std::endl;
+      return false;
+    }
+
+  m_fileWatcher.stop();
+  m_savedFiles.swap(savedFiles);
+  detectFileThemes(m_savedFiles,
+                   m_currThemes,
+                   log);
+  m_fileWatcher.start(m_savedFiles,
+                      log);
+
+  return true;
+} // end of "loadStore"
+
+
+
+void ThemeDaemon::takeThemeDeltas()
+{
+  if(m_fileWatcher.takeDeltas(m_deltas))
+    {
+      for(size_t i = 0; i < m_deltas.size(); i++)
+        {
+          if(m_deltas.at(i).fileIndex < (int)m_currThemes.size())
+            {
+              m_currThemes.at(m_deltas.at(i).fileIndex) = m_deltas.at(i).theme;
+            }
+        }
+    }
+} // end of "takeThemeDeltas"
+
+
+
+/*
+  Function:
+   writeClient
+
+  Description:
+   Sends as much of a client's queued responses as its socket takes without
+   blocking. The rest is sent once poll() reports room for it.
+
+  Input:
+   fd                   - the client's socket.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - false if the client disconnected and should be
+                          closed.
+*/
+bool ThemeDaemon::writeClient(const int fd)
+{
+  std::string& output = m_clients.at(fd).output;
+  size_t sent = 0;
+
+  while(sent < output.length())
+    {
+      const ssize_t written = send(fd, output.data() + sent, output.length() - sent,
+                                   MSG_NOSIGNAL);
+
+      if(written < 0 && errno == EINTR)
+        {
+          continue;
+        }
+
+      if(written < 0 && errno == EAGAIN)
+        {
+          break;
+        }
+
+      if(written <= 0)
+        {
+          return false;
+        }
+
+      sent += written;
+    }
+
+  output.erase(0, sent);
+
+  return true;
+} // end of "writeClient"
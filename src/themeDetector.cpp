@@ -0,0 +1,453 @@
+/*
+  File:
+   themeDetector.cpp
+
+  Description:
+   The implementation of the themeDetector.hpp class.
+*/
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include "themeDetector.hpp"
+
+// files at or below this size are read into a reused buffer, larger files are
+// mapped so they are never copied into user space
+const size_t _DETECTREADMAX = 64 * 1024;
+
+
+
+/*
+  Function:
+   ThemeDetector Constructor
+
+  Description:
+   Compiles the key of every theme directive in ThemeDirectives into the
+   detector's automaton.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+ThemeDetector::ThemeDetector()
+  : m_numStates(0)
+{
+  m_patterns.resize(_NUMTHEMEDIRECTIVES);
+  addPattern("import", _ALACRITTYIMPORT);
+  addPattern("include", _KITTYINCLUDE);
+  addPattern("#include", _XRESOURCESINCLUDE);
+  addPattern("(load-theme", _EMACSLOADTHEME);
+  addPattern("colors", _QTILECOLORS);
+  build();
+} // end of "ThemeDetector Constructor"
+
+
+
+void ThemeDetector::addPattern(const std::string& pattern,
+                               const int directive)
+{
+  m_patterns.at(directive) = pattern;
+} // end of "addPattern"
+
+
+
+/*
+  Function:
+   build
+
+  Description:
+   Builds a trie of the directive keys, computes the Aho-Corasick failure links
+   breadth first, and folds them into a dense transition table so that scanning
+   a file costs exactly one table lookup per byte with no failure link walks.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+void ThemeDetector::build()
+{
+  std::vector<int> trie(256, -1);
+  std::vector<int8_t> output(1, -1);
+  int numStates = 1;
+
+  // build the trie
+  for(int d = 0; d < (int)m_patterns.size(); d++)
+    {
+      int state = 0;
+
+      for(size_t i = 0; i < m_patterns.at(d).length(); i++)
+        {
+          const unsigned char c = m_patterns.at(d).at(i);
+
+          if(trie.at(state * 256 + c) == -1)
+            {
+              trie.at(state * 256 + c) = numStates++;
+              trie.resize(numStates * 256, -1);
+              output.push_back(-1);
+            }
+
+          state = trie.at(state * 256 + c);
+        }
+
+      output.at(state) = d;
+    }
+
+  // resolve failure links into the dense table in breadth first order
+  std::vector<int> fail(numStates, 0);
+  std::vector<int> queue;
+  m_next.assign(numStates * 256, 0);
+  m_output = output;
+
+  for(int c = 0; c < 256; c++)
+    {
+      if(trie.at(c) != -1)
+        {
+          m_next.at(c) = trie.at(c);
+          queue.push_back(trie.at(c));
+        }
+    }
+
+  for(size_t head = 0; head < queue.size(); head++)
+    {
+      const int state = queue.at(head);
+
+      for(int c = 0; c < 256; c++)
+        {
+          const int child = trie.at(state * 256 + c);
+
+          if(child != -1)
+            {
+              fail.at(child) = m_next.at(fail.at(state) * 256 + c);
+
+              // a state without its own directive reports the longest
+              // directive that is a suffix of it
+              if(m_output.at(child) == -1)
+                {
+                  m_output.at(child) = m_output.at(fail.at(child));
+                }
+
+              m_next.at(state * 256 + c) = child;
+              queue.push_back(child);
+            }
+          else
+            {
+              m_next.at(state * 256 + c) = m_next.at(fail.at(state) * 256 + c);
+            }
+        }
+    }
+
+  m_numStates = numStates;
+} // end of "build"
+
+
+
+/*
+  Function:
+   detect
+
+  Description:
+   Runs the automaton over the incoming buffer and stops at the first directive
+   key that begins a line and is followed by a theme value.
+
+  Input:
+   data                 - a pointer to the file contents to scan.
+
+   length               - the number of bytes in data.
+
+  Output:
+   theme                - a reference to a string that receives the detected
+                          theme name.
+
+  Returns:
+   int                  - the ThemeDirectives value of the directive found, or
+                          -1 if the buffer contains no theme directive.
+*/
+int ThemeDetector::detect(const char* data,
+                          const size_t length,
+                          std::string& theme) const
+{
+  const uint16_t* next = m_next.data();
+  const int8_t* output = m_output.data();
+  unsigned int state = 0;
+
+  for(size_t i = 0; i < length; i++)
+    {
+      state = next[state * 256 + (unsigned char)data[i]];
+
+      if(output[state] >= 0)
+        {
+          const int directive = output[state];
+          const size_t keyStart = i + 1 - m_patterns[directive].length();
+
+          if(extractTheme(data, length, keyStart, directive, theme) == true)
+            {
+              return directive;
+            }
+        }
+    }
+
+  return -1;
+} // end of "detect"
+
+
+
+/*
+  Function:
+   detectFile
+
+  Description:
+   Detects the theme of the file at the incoming path. Small files are read
+   with a single read() into a per thread buffer, larger files are mapped.
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the file to scan.
+
+  Output:
+   theme                - a reference to a string that receives the detected
+                          theme name. Cleared if no theme is found.
+
+  Returns:
+   int                  - the ThemeDirectives value of the directive found, or
+                          -1 if the file can't be read or contains none.
+*/
+int ThemeDetector::detectFile(const std::string& path,
+                              std::string& theme) const
+{
+  static thread_local std::vector<char> buffer(_DETECTREADMAX);
+  struct stat fileStat;
+  int directive = -1;
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+  theme.clear();
+
+  if(fd == -1)
+    {
+      return directive;
+    }
+
+  if(fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+    {
+      const size_t fileSize = fileStat.st_size;
+
+      if(fileSize <= _DETECTREADMAX)
+        {
+          ssize_t numRead = read(fd, buffer.data(), buffer.size());
+
+          if(numRead > 0)
+            {
+              directive = detect(buffer.data(), numRead, theme);
+            }
+        }
+      else
+        {
+          void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+          if(mapped != MAP_FAILED)
+            {
+              madvise(mapped, fileSize, MADV_SEQUENTIAL);
+              directive = detect((const char*)mapped, fileSize, theme);
+              munmap(mapped, fileSize);
+            }
+        }
+    }
+
+  close(fd);
+
+  return directive;
+} // end of "detectFile"
+
+
+
+/*
+  Function:
+   extractTheme
+
+  Description:
+   Validates a directive key match found by the automaton and extracts the
+   theme name from the rest of its line. A key only counts if nothing but
+   whitespace comes before it on the line, so commented out directives and keys
+   inside other words are skipped.
+
+  Input:
+   data                 - a pointer to the scanned buffer.
+
+   length               - the number of bytes in data.
+
+   keyStart             - the offset of the first byte of the matched key.
+
+   directive            - the ThemeDirectives value of the matched key.
+
+  Output:
+   theme                - a reference to a string that receives the theme name.
+
+  Returns:
+   bool                 - true if the match is a directive with a theme value.
+*/
+bool ThemeDetector::extractTheme(const char* data,
+                                 const size_t length,
+                                 const size_t keyStart,
+                                 const int directive,
+                                 std::string& theme) const
+{
+  // the key must begin the line
+  for(size_t i = keyStart; i > 0 && data[i - 1] != '\n'; i--)
+    {
+      if(data[i - 1] != ' ' && data[i - 1] != '\t')
+        {
+          return false;
+        }
+    }
+
+  size_t pos = keyStart + m_patterns[directive].length();
+  const char* newline = (const char*)memchr(data + pos, '\n', length - pos);
+  const size_t lineEnd = newline == nullptr ? length : newline - data;
+
+  // the key must be a whole word
+  if(pos >= lineEnd || std::strchr(" \t=\"<'", data[pos]) == nullptr)
+    {
+      return false;
+    }
+
+  // qtile colors must be an assignment
+  if(directive == _QTILECOLORS)
+    {
+      while(pos < lineEnd && (data[pos] == ' ' || data[pos] == '\t'))
+        {
+          pos++;
+        }
+
+      if(pos + 1 >= lineEnd || data[pos] != '=' || data[pos + 1] == '=')
+        {
+          return false;
+        }
+    }
+
+  while(pos < lineEnd && std::strchr(" \t=[\"'<", data[pos]) != nullptr)
+    {
+      pos++;
+    }
+
+  size_t end = pos;
+
+  while(end < lineEnd && std::strchr(" \t\"'],()>#\r", data[end]) == nullptr)
+    {
+      end++;
+    }
+
+  // only the last path component (or attribute for qtile) names the theme
+  size_t start = end;
+
+  while(start > pos && data[start - 1] != '/' &&
+        (directive != _QTILECOLORS || data[start - 1] != '.'))
+    {
+      start--;
+    }
+
+  if(start == end)
+    {
+      return false;
+    }
+
+  theme.assign(data + start, end - start);
+
+  return true;
+} // end of "extractTheme"
+
+
+
+/*
+  Function:
+   themeDetector
+
+  Description:
+   Returns the program wide ThemeDetector so the automaton is only compiled
+   once no matter how many files are scanned.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   const ThemeDetector& - a reference to the shared detector.
+*/
+const ThemeDetector& themeDetector()
+{
+  static const ThemeDetector detector;
+
+  return detector;
+} // end of "themeDetector"
+
+
+
+/*
+  Function:
+   detectFileThemes
+
+  Description:
+   Detects the current theme of every incoming saved file. Files are handed
+   out to one worker per hardware thread from a shared counter so a large
+   inventory is limited by how fast the files can be read rather than by the
+   scanning itself.
+
+  Input:
+   paths                - a reference to a constant vector of strings containing
+                          the saved file paths.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   themes               - a reference to a vector of strings that is resized to
+                          match paths and receives each file's current theme.
+
+  Returns:
+   NONE
+*/
+void detectFileThemes(const std::vector<std::string>& paths,
+                      std::vector<std::string>& themes,
+                      std::ofstream& log)
+{
+  const ThemeDetector& detector = themeDetector();
+  std::atomic<size_t> nextFile(0);
+  std::vector<std::thread> workers;
+  const size_t filesPerWorker = 64;
+  size_t numWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+  themes.assign(paths.size(), std::string());
+  numWorkers = std::min(numWorkers, paths.size() / filesPerWorker + 1);
+
+  // each worker claims the next unscanned file until none are left
+  auto worker = [&]() {
+    size_t i;
+
+    while((i = nextFile++) < paths.size())
+      {
+        detector.detectFile(paths.at(i), themes.at(i));
+      }
+  };
+
+  for(size_t i = 1; i < numWorkers; i++)
+    {
+      workers.push_back(std::thread(worker));
+    }
+
+  worker();
+
+  for(size_t i = 0; i < workers.size(); i++)
+    {
+      workers.at(i).join();
+    }
+
+  log << "Detected themes for " << paths.size() << " files using "
+      << numWorkers << " threads" << std::endl;
+} // end of "detectFileThemes"
@@ -0,0 +1,453 @@
+/*
+  File:
+   themeGrid.cpp
+
+  Description:
+   The implementation of the themeGrid.hpp class.
+*/
+#include <algorithm>
+#include "_cursesWinConsts.hpp"
+#include "cursesFunctions.hpp"
+#include "themeGrid.hpp"
+
+// the columns from the start of one grid column to the start of the next
+static const int _STGRIDCOLWIDTH = _STWINMAXCOLS + _STGRIDCOLGAP;
+
+
+
+/*
+  Function:
+   ThemeGrid Constructor
+
+  Description:
+   Creates a grid with no pad and no place on the screen until it is
+   defined and a page is shown.
+
+  Input:
+   backend              - a pointer to the backend the pad draws through; it
+                          must outlive the grid.
+
+  Output:
+   NONE
+*/
+ThemeGrid::ThemeGrid(RenderBackend* backend)
+  : m_pad(backend),
+    m_bandPos(-1),
+    m_bandEnd(0),
+    m_pagePos(0),
+    m_highlightPos(-1),
+    m_startY(0),
+    m_startX(0),
+    m_numLines(0),
+    m_numGridCols(0)
+{
+} // end of "ThemeGrid Constructor"
+
+
+
+/*
+  Function:
+   checkClick
+
+  Description:
+   Finds the theme of the page shown that a click is on. As with the theme
+   strings, a click after the end of a theme's string is on no theme.
+
+  Input:
+   mouseLine            - the line of the click on the screen.
+   mouseCol             - the column of the click on the screen.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the index of the theme on the page, or -1.
+*/
+int ThemeGrid::checkClick(const int mouseLine,
+                          const int mouseCol) const
+{
+  if(getIsOpen() == false)
+    {
+      return -1;
+    }
+
+  const int line = mouseLine - m_startY;
+  const int col = mouseCol - m_startX;
+
+  if(line < 0 || line >= m_numLines || col < 0 || col >= getNumCols())
+    {
+      return -1;
+    }
+
+  const int pos = m_pagePos + (col / _STGRIDCOLWIDTH) * m_numLines + line;
+
+  if(pos < m_bandPos || pos >= m_bandEnd ||
+     col % _STGRIDCOLWIDTH >= (int)m_bandStrings.at(pos - m_bandPos).length())
+    {
+      return -1;
+    }
+
+  return pos - m_pagePos;
+} // end of "checkClick"
+
+
+
+/*
+  Function:
+   defineGrid
+
+  Description:
+   Lays the grid's viewport out in the _SAVEDTHEMESWIN: as many columns as
+   fit across it, and a theme per line of each, under its title. A grid of
+   a new shape is printed again when a page is next shown; one that has
+   only moved is not.
+
+  Input:
+   wins                 - A reference to a const unordered map
+                          <int, CursesWindow*> type that contains pointers
+                          to all currently allocated CursesWindow objects
+                          that can be indexed by key values in the file
+                          _cursesWinConsts.hpp.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeGrid::defineGrid(const std::unordered_map<int, CursesWindow*>& wins)
+{
+  int numLines = 0;
+  int numGridCols = 0;
+
+  if(wins.at(_SAVEDTHEMESWIN)->getIsOpen())
+    {
+      const int maxLines = wins.at(_SAVEDTHEMESWIN)->getNumLines();
+      const int maxCols = wins.at(_SAVEDTHEMESWIN)->getNumCols();
+      const int lastColOffset = maxCols - _STWINMAXCOLOFFSET - _STWINMINCOLOFFSET - _STWINMAXCOLS;
+
+      numLines = maxLines - _STWINMINLINEOFFSET - _STWINMAXLINEOFFSET;
+
+      if(numLines > 0 && lastColOffset >= 0)
+        {
+          numGridCols = lastColOffset / _STGRIDCOLWIDTH + 1;
+        }
+
+      m_startY = wins.at(_SAVEDTHEMESWIN)->getStartY() + _STGRIDLINEOFFSET;
+      m_startX = wins.at(_SAVEDTHEMESWIN)->getStartX() + _STWINMINCOLOFFSET;
+    }
+
+  if(numGridCols == 0 || numLines != m_numLines || numGridCols != m_numGridCols)
+    {
+      resetGrid();
+    }
+
+  m_numLines = numLines;
+  m_numGridCols = numGridCols;
+} // end of "defineGrid"
+
+
+
+void ThemeGrid::deleteGrid()
+{
+  if(m_pad.getIsOpen())
+    {
+      m_pad.deleteWindow();
+    }
+
+  resetGrid();
+} // end of "deleteGrid"
+
+
+
+/*
+  Function:
+   printHighlight
+
+  Description:
+   Highlights a theme of the page shown, and no other.
+
+  Input:
+   highlightNum         - the index of the theme on the page, or -1 for none.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeGrid::printHighlight(const int highlightNum)
+{
+  const int pos = highlightNum == -1 ? -1 : m_pagePos + highlightNum;
+
+  if(pos == m_highlightPos)
+    {
+      return;
+    }
+
+  if(m_highlightPos != -1)
+    {
+      printTheme(m_highlightPos,
+                 _WHITE_TEXT);
+      m_highlightPos = -1;
+    }
+
+  if(m_bandPos != -1 && pos >= m_bandPos && pos < m_bandEnd)
+    {
+      printTheme(pos,
+                 _BLACK_TEXT);
+      m_highlightPos = pos;
+    }
+} // end of "printHighlight"
+
+
+
+// forgets the band, so the next page shown prints it again
+void ThemeGrid::resetGrid()
+{
+  m_bandPos = -1;
+  m_bandEnd = 0;
+  m_highlightPos = -1;
+} // end of "resetGrid"
+
+
+
+/*
+  Function:
+   showPage
+
+  Description:
+   Moves the viewport to the page of themes starting at stStringPos. A page
+   the band holds in whole columns is only a move; any other prints a new
+   band around it, with up to half of its pages before the page, so paging
+   back is a move as well.
+
+  Input:
+   wins                 - A reference to a const unordered map
+                          <int, CursesWindow*> type that contains pointers
+                          to all currently allocated CursesWindow objects
+                          that can be indexed by key values in the file
+                          _cursesWinConsts.hpp.
+
+   clusters             - a reference to the constant groups of duplicate
+                          themes in the saved themes library.
+
+   stStringPos          - the list position of the first theme of the page.
+
+  Output:
+   log                  - a reference to the log file.
+
+  Returns:
+   NONE
+*/
+void ThemeGrid::showPage(const std::unordered_map<int, CursesWindow*>& wins,
+                         const ThemeClusters& clusters,
+                         const int stStringPos,
+                         std::ofstream& log)
+{
+  m_pagePos = stStringPos;
+
+  if(m_numLines <= 0 || m_numGridCols <= 0)
+    {
+      return;
+    }
+
+  const int pageEnd = stStringPos + m_numLines * m_numGridCols;
+
+  if(m_bandPos == -1 || stStringPos < m_bandPos ||
+     (stStringPos - m_bandPos) % m_numLines != 0 ||
+     (pageEnd > m_bandEnd && m_bandEnd < clusters.getNumVisible()))
+    {
+      const int numBackCols = std::min(stStringPos / m_numLines,
+                                       (int)(_STPADMAXPAGES / 2) * m_numGridCols);
+
+      printBand(wins,
+                clusters,
+                stStringPos - numBackCols * m_numLines,
+                log);
+    }
+} // end of "showPage"
+
+
+
+/*
+  Function:
+   stageGrid
+
+  Description:
+   Stages the viewport's region of the pad onto the screen for the next
+   doupdate(). Every cell of it is compared and copied, so it shows the
+   page whatever was staged under it.
+
+  Input/Output:
+   NONE
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeGrid::stageGrid()
+{
+  if(getIsOpen() == false)
+    {
+      return;
+    }
+
+  m_pad.stagePad(0,
+                 (m_pagePos - m_bandPos) / m_numLines * _STGRIDCOLWIDTH,
+                 m_startY,
+                 m_startX,
+                 m_numLines,
+                 getNumCols());
+} // end of "stageGrid"
+
+
+
+/*
+  Function:
+   printBand
+
+  Description:
+   Prints the band of the grid starting at bandPos into the pad, up to
+   _STPADMAXPAGES pages of it or the end of the themes, formatting a page at
+   a time. The pad is sized to the band and a page more, so a viewport on
+   any of its columns stays on the pad, and is only opened again when that
+   size changes.
+
+  Input:
+   wins                 - A reference to a const unordered map
+                          <int, CursesWindow*> type that contains pointers
+                          to all currently allocated CursesWindow objects
+                          that can be indexed by key values in the file
+                          _cursesWinConsts.hpp.
+
+   clusters             - a reference to the constant groups of duplicate
+                          themes in the saved themes library.
+
+   bandPos              - the list position of the first theme of the band,
+                          at the top of a grid column.
+
+  Output:
+   log                  - a reference to the log file.
+
+  Returns:
+   NONE
+*/
+void ThemeGrid::printBand(const std::unordered_map<int, CursesWindow*>& wins,
+                          const ThemeClusters& clusters,
+                          const int bandPos,
+                          std::ofstream& log)
+{
+  const int numVisible = clusters.getNumVisible();
+  const int pageSize = m_numLines * m_numGridCols;
+  const int numContentCols = (std::max(numVisible - bandPos, 0) + m_numLines - 1) / m_numLines;
+  const int numBandCols = std::min(numContentCols, (int)_STPADMAXPAGES * m_numGridCols);
+  const int numPadCols = (numBandCols + m_numGridCols) * _STGRIDCOLWIDTH;
+
+  if(m_pad.getIsOpen() &&
+     (m_pad.getNumLines() != m_numLines || m_pad.getNumCols() != numPadCols))
+    {
+      m_pad.deleteWindow();
+    }
+
+  if(m_pad.getIsOpen())
+    {
+      m_pad.eraseWindow();
+    }
+  else if(m_pad.createPad("SAVEDTHEMESPAD",
+                          m_numLines,
+                          numPadCols) == false)
+    {
+      resetGrid();
+      return;
+    }
+
+  m_bandPos = bandPos;
+  m_bandEnd = std::max(std::min(bandPos + numBandCols * m_numLines, numVisible), bandPos);
+  m_highlightPos = -1;
+  m_bandStrings.resize(m_bandEnd - m_bandPos);
+
+  for(int pos = m_bandPos; pos < m_bandEnd; pos += pageSize)
+    {
+      createSTOutputStrings(wins,
+                            clusters,
+                            pos,
+                            m_pageStrings,
+                            log);
+
+      for(int i = 0; i < (int)m_pageStrings.size() && pos + i < m_bandEnd; i++)
+        {
+          m_bandStrings.at(pos + i - m_bandPos).assign(m_pageStrings.at(i));
+          printTheme(pos + i,
+                     _WHITE_TEXT);
+        }
+    }
+} // end of "printBand"
+
+
+
+// prints a theme of the band at its place in the pad
+void ThemeGrid::printTheme(const int pos,
+                           const int colorPair)
+{
+  const int index = pos - m_bandPos;
+
+  m_pad.attributesOn(COLOR_PAIR(colorPair));
+  m_pad.printString(index % m_numLines,
+                    index / m_numLines * _STGRIDCOLWIDTH,
+                    m_bandStrings.at(index));
+} // end of "printTheme"
+
+
+
+int ThemeGrid::getBandPos() const
+{
+  return m_bandPos;
+} // end of "getBandPos"
+
+
+
+bool ThemeGrid::getIsOpen() const
+{
+  return m_bandPos != -1 && m_pad.getIsOpen();
+} // end of "getIsOpen"
+
+
+
+int ThemeGrid::getNumLines() const
+{
+  return m_numLines;
+} // end of "getNumLines"
+
+
+
+int ThemeGrid::getNumCols() const
+{
+  return m_numGridCols == 0 ? 0 : m_numGridCols * _STGRIDCOLWIDTH - _STGRIDCOLGAP;
+} // end of "getNumCols"
+
+
+
+const CursesWindow& ThemeGrid::getPad() const
+{
+  return m_pad;
+} // end of "getPad"
+
+
+
+int ThemeGrid::getStartY() const
+{
+  return m_startY;
+} // end of "getStartY"
+
+
+
+int ThemeGrid::getStartX() const
+{
+  return m_startX;
+} // end of "getStartX"
@@ -0,0 +1,1132 @@
+/*
+  File:
+   themeImport.cpp
+
+  Description:
+   The implementation of the themeImport.hpp class and functions.
+*/
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+#include "themeImport.hpp"
+
+// the tar header block size
+const size_t _TARBLOCKSIZE = 512;
+
+// most threads an import uses unless told otherwise
+const unsigned _IMPORTMAXTHREADS = 16;
+
+// a directory or file waiting to be read
+struct ImportTask {
+  std::string path;
+  bool isDirectory;
+};
+
+// a theme parsed by a worker; key orders themes by where they were found so
+// the result doesn't depend on which thread parsed what
+struct ImportedTheme {
+  std::string key;
+  std::string name;
+  std::string packed;
+};
+
+// state shared by the workers of one importThemes() call
+struct ImportShared {
+  std::vector<ImportTask> tasks;
+  int numBusy;
+  std::vector<ImportedTheme> themes;
+  int numFiles;
+  int numUnparsed;
+  std::vector<std::string> errors;
+  std::mutex mutex;
+  std::condition_variable changed;
+};
+
+// a buffered reader over an archive
+struct ArchiveReader {
+  int fd;
+  std::vector<char> buffer;
+  size_t pos;
+  size_t end;
+};
+
+// the ANSI colors each base16 slot provides, -1 for none
+struct Base16Slot {
+  const char* key;
+  int first;
+  int second;
+};
+
+
+
+/*
+  Function:
+   PaletteParser Constructor
+
+  Description:
+   Creates a parser ready for the first chunk of a file.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+PaletteParser::PaletteParser()
+  : m_scratch("", 1)
+{
+  reset();
+} // end of "PaletteParser Constructor"
+
+
+
+/*
+  Function:
+   feed
+
+  Description:
+   Parses the incoming chunk of a file. Complete lines are parsed straight
+   from the chunk; only a line split across chunks is copied.
+
+  Input:
+   data                 - a pointer to the bytes of the chunk.
+
+   length               - the number of bytes in data.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void PaletteParser::feed(const char* data,
+                         const size_t length)
+{
+  size_t pos = 0;
+
+  while(pos < length)
+    {
+      const char* newline = (const char*)memchr(data + pos, '\n', length - pos);
+      const size_t lineEnd = newline == nullptr ? length : newline - data;
+
+      if(newline != nullptr && m_line.empty() && m_isLineTooLong == false)
+        {
+          parseLine(data + pos, lineEnd - pos);
+        }
+      else if(m_isLineTooLong == false)
+        {
+          if(m_line.length() + (lineEnd - pos) > _IMPORTMAXLINE)
+            {
+              m_isLineTooLong = true;
+              m_line.clear();
+            }
+          else
+            {
+              m_line.append(data + pos, lineEnd - pos);
+
+              if(newline != nullptr)
+                {
+                  parseLine(m_line.data(), m_line.length());
+                  m_line.clear();
+                }
+            }
+        }
+
+      if(newline != nullptr)
+        {
+          m_isLineTooLong = false;
+        }
+
+      pos = lineEnd + 1;
+    }
+} // end of "feed"
+
+
+
+/*
+  Function:
+   finish
+
+  Description:
+   Parses what is left of the file and returns its palette. A theme needs all
+   16 ANSI colors; the text colors default to bright white on black.
+
+  Input:
+   NONE
+
+  Output:
+   palette              - a reference to the palette that receives the colors.
+
+  Returns:
+   bool                 - true if the file defined a whole palette. The parser
+                          is reset for the next file either way.
+*/
+bool PaletteParser::finish(Palette& palette)
+{
+  if(!m_line.empty() && m_isLineTooLong == false)
+    {
+      parseLine(m_line.data(), m_line.length());
+    }
+
+  const uint32_t ansiMask = (1u << _ANSICOLORS) - 1;
+  const bool isPalette = (m_foundMask & ansiMask) == ansiMask;
+
+  if(isPalette == true)
+    {
+      palette.setNumColors(_THEMEPALETTESIZE);
+
+      for(size_t i = 0; i < _ANSICOLORS; i++)
+        {
+          palette.setColor(i, m_colors[i]);
+        }
+
+      palette.setColor(_PALETTEFOREGROUND, (m_foundMask & (1u << _PALETTEFOREGROUND)) != 0 ?
+                       m_colors[_PALETTEFOREGROUND] : m_colors[15]);
+      palette.setColor(_PALETTEBACKGROUND, (m_foundMask & (1u << _PALETTEBACKGROUND)) != 0 ?
+                       m_colors[_PALETTEBACKGROUND] : m_colors[0]);
+    }
+
+  reset();
+
+  return isPalette;
+} // end of "finish"
+
+
+
+/*
+  Function:
+   reset
+
+  Description:
+   Forgets everything parsed so far.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void PaletteParser::reset()
+{
+  m_line.clear();
+  m_isLineTooLong = false;
+  m_sectionOffset = -1;
+  m_foundMask = 0;
+} // end of "reset"
+
+
+
+/*
+  Function:
+   parseLine
+
+  Description:
+   Finds a color assignment in one line. The notations of the common theme
+   collections are understood:
+
+     color4 #0000ff                 kitty
+     *.color4: #0000ff              Xresources
+     base0D: "0000ff"               base16 schemes
+     [colors.bright] blue = '#..'   alacritty toml (yaml by indentation)
+     foreground / background        all of the above
+
+   Section headers select the normal or bright half of the ANSI colors for
+   the color names that follow.
+
+  Input:
+   line                 - a pointer to the first byte of the line.
+
+   length               - the number of bytes in the line, without the
+                          newline.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void PaletteParser::parseLine(const char* line,
+                              size_t length)
+{
+  static const char* ansiNames[8] = {
+    "black", "red", "green", "yellow", "blue", "magenta", "cyan", "white"
+  };
+  static const Base16Slot base16Slots[] = {
+    {"base00", 0, _PALETTEBACKGROUND}, {"base03", 8, -1},
+    {"base05", 7, _PALETTEFOREGROUND}, {"base07", 15, -1},
+    {"base08", 1, 9}, {"base09", -1, -1}, {"base0a", 3, 11}, {"base0b", 2, 10},
+    {"base0c", 6, 14}, {"base0d", 4, 12}, {"base0e", 5, 13}
+  };
+  size_t pos = 0;
+
+  while(pos < length && isspace((unsigned char)line[pos]))
+    {
+      pos++;
+    }
+
+  while(length > pos && isspace((unsigned char)line[length - 1]))
+    {
+      length--;
+    }
+
+  if(pos == length || line[pos] == '#' || line[pos] == '!' || line[pos] == ';' ||
+     (line[pos] == '/' && pos + 1 < length && line[pos + 1] == '/'))
+    {
+      return;
+    }
+
+  // [colors.normal], [colors.bright], [colors.primary]
+  if(line[pos] == '[')
+    {
+      std::string section(line + pos, length - pos);
+
+      std::transform(section.begin(), section.end(), section.begin(), ::tolower);
+      m_sectionOffset = section.find("bright") != std::string::npos ? 8 :
+        section.find("normal") != std::string::npos ? 0 : -1;
+      return;
+    }
+
+  const size_t keyStart = pos;
+
+  while(pos < length && line[pos] != ':' && line[pos] != '=' &&
+        !isspace((unsigned char)line[pos]))
+    {
+      pos++;
+    }
+
+  std::string key(line + keyStart, pos - keyStart);
+  const size_t keyBase = key.find_last_of("*.");
+
+  // *.color4, URxvt*color4 and "color4"
+  if(keyBase != std::string::npos)
+    {
+      key.erase(0, keyBase + 1);
+    }
+
+  key.erase(std::remove(key.begin(), key.end(), '"'), key.end());
+  std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+  while(pos < length && (isspace((unsigned char)line[pos]) || line[pos] == ':' ||
+                         line[pos] == '='))
+    {
+      pos++;
+    }
+
+  // "normal:" and "bright:" open a section in yaml
+  if(pos == length)
+    {
+      if(key == "normal" || key == "bright")
+        {
+          m_sectionOffset = key == "bright" ? 8 : 0;
+        }
+      else if(key == "primary" || key == "colors")
+        {
+          m_sectionOffset = -1;
+        }
+
+      return;
+    }
+
+  int indexes[2] = {-1, -1};
+
+  if(key.compare(0, 5, "color") == 0 && key.length() > 5)
+    {
+      const size_t digits = key.at(5) == '_' ? 6 : 5;
+      char* end;
+      const long number = strtol(key.c_str() + digits, &end, 10);
+
+      if(*end == '\0' && end != key.c_str() + digits && number >= 0 &&
+         number < (long)_ANSICOLORS)
+        {
+          indexes[0] = number;
+        }
+    }
+  else if(key == "foreground" || key == "fg")
+    {
+      indexes[0] = _PALETTEFOREGROUND;
+    }
+  else if(key == "background" || key == "bg")
+    {
+      indexes[0] = _PALETTEBACKGROUND;
+    }
+  else if(key.compare(0, 4, "base") == 0)
+    {
+      for(size_t i = 0; i < sizeof(base16Slots) / sizeof(base16Slots[0]); i++)
+        {
+          if(key == base16Slots[i].key)
+            {
+              indexes[0] = base16Slots[i].first;
+              indexes[1] = base16Slots[i].second;
+            }
+        }
+    }
+  else if(m_sectionOffset != -1)
+    {
+      for(int i = 0; i < 8; i++)
+        {
+          if(key == ansiNames[i])
+            {
+              indexes[0] = m_sectionOffset + i;
+            }
+        }
+    }
+
+  if(indexes[0] == -1 && indexes[1] == -1)
+    {
+      return;
+    }
+
+  // the value is a quoted string, an rgb(...) or a single token
+  size_t valueStart = pos;
+  size_t valueEnd;
+
+  if(line[pos] == '"' || line[pos] == '\'')
+    {
+      const char* quote = (const char*)memchr(line + pos + 1, line[pos], length - pos - 1);
+
+      valueStart = pos + 1;
+      valueEnd = quote == nullptr ? length : quote - line;
+    }
+  else if(length - pos > 4 && strncmp(line + pos, "rgb(", 4) == 0)
+    {
+      const char* close = (const char*)memchr(line + pos, ')', length - pos);
+
+      valueEnd = close == nullptr ? length : close - line + 1;
+    }
+  else
+    {
+      valueEnd = pos;
+
+      while(valueEnd < length && !isspace((unsigned char)line[valueEnd]) &&
+            line[valueEnd] != ',' && line[valueEnd] != ';' && line[valueEnd] != '}')
+        {
+          valueEnd++;
+        }
+    }
+
+  if(m_scratch.parseColor(0, std::string(line + valueStart, valueEnd - valueStart)) == false)
+    {
+      return;
+    }
+
+  for(int i = 0; i < 2; i++)
+    {
+      if(indexes[i] != -1)
+        {
+          m_colors[indexes[i]] = m_scratch.getColor(0);
+          m_foundMask |= 1u << indexes[i];
+        }
+    }
+} // end of "parseLine"
+
+
+
+/*
+  Function:
+   themeNameFromPath
+
+  Description:
+   Returns the theme name of a file: its base name without the extension.
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the file.
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the theme name.
+*/
+static std::string themeNameFromPath(const std::string& path)
+{
+  const size_t slash = path.find_last_of('/');
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  const size_t dot = name.find_last_of('.');
+
+  if(dot != std::string::npos && dot > 0)
+    {
+      name.erase(dot);
+    }
+
+  return name;
+} // end of "themeNameFromPath"
+
+
+
+/*
+  Function:
+   fillArchive
+
+  Description:
+   Moves the unread bytes of the archive buffer to its start and reads as
+   much of the archive as fits after them.
+
+  Input/Output:
+   reader               - a reference to the archive reader.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - false at the end of the archive or on a read error.
+*/
+static bool fillArchive(ArchiveReader& reader)
+{
+  if(reader.pos > 0)
+    {
+      memmove(reader.buffer.data(), reader.buffer.data() + reader.pos, reader.end - reader.pos);
+      reader.end -= reader.pos;
+      reader.pos = 0;
+    }
+
+  while(true)
+    {
+      const ssize_t numRead = read(reader.fd, reader.buffer.data() + reader.end,
+                                   reader.buffer.size() - reader.end);
+
+      if(numRead < 0 && errno == EINTR)
+        {
+          continue;
+        }
+
+      if(numRead <= 0)
+        {
+          return false;
+        }
+
+      reader.end += numRead;
+      return true;
+    }
+} // end of "fillArchive"
+
+
+
+/*
+  Function:
+   readArchiveMember
+
+  Description:
+   Passes the next size bytes of the archive, and the padding that rounds
+   them to a whole block, to the incoming parser or skips them.
+
+  Input/Output:
+   reader               - a reference to the archive reader.
+
+   parser               - a pointer to the parser to feed, or nullptr to skip
+                          the member.
+
+  Input:
+   size                 - the size of the member.
+
+  Output:
+   contents             - a pointer to a string that receives the member, or
+                          nullptr.
+
+  Returns:
+   bool                 - false if the archive ends inside the member.
+*/
+static bool readArchiveMember(ArchiveReader& reader,
+                              PaletteParser* parser,
+                              const size_t size,
+                              std::string* contents)
+{
+  size_t remaining = size + (_TARBLOCKSIZE - size % _TARBLOCKSIZE) % _TARBLOCKSIZE;
+  size_t dataLeft = size;
+
+  while(remaining > 0)
+    {
+      if(reader.pos == reader.end && fillArchive(reader) == false)
+        {
+          return false;
+        }
+
+      const size_t available = std::min(remaining, reader.end - reader.pos);
+      const size_t dataBytes = std::min(available, dataLeft);
+
+      if(parser != nullptr && dataBytes > 0)
+        {
+          parser->feed(reader.buffer.data() + reader.pos, dataBytes);
+        }
+
+      if(contents != nullptr && dataBytes > 0)
+        {
+          contents->append(reader.buffer.data() + reader.pos, dataBytes);
+        }
+
+      reader.pos += available;
+      remaining -= available;
+      dataLeft -= dataBytes;
+    }
+
+  return true;
+} // end of "readArchiveMember"
+
+
+
+/*
+  Function:
+   importArchive
+
+  Description:
+   Streams a plain (uncompressed) ustar or GNU tar archive, parsing every
+   regular member as a theme file as it goes by. GNU long names and pax path
+   records are honored.
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the archive.
+
+  Output:
+   themes               - a reference to a vector that receives the parsed
+                          themes.
+
+   numFiles             - a reference to the number of members read.
+
+   numUnparsed          - a reference to the number of members without a
+                          palette.
+
+   errors               - a reference to a vector that receives a message if
+                          the archive is unreadable.
+
+  Returns:
+   NONE
+*/
+static void importArchive(const std::string& path,
+                          std::vector<ImportedTheme>& themes,
+                          int& numFiles,
+                          int& numUnparsed,
+                          std::vector<std::string>& errors)
+{
+  ArchiveReader reader;
+  PaletteParser parser;
+  Palette palette;
+  std::string longName;
+
+  reader.fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  reader.buffer.resize(_IMPORTCHUNKSIZE);
+  reader.pos = 0;
+  reader.end = 0;
+
+  if(reader.fd == -1)
+    {
+      errors.push_back("can't open " + path);
+      return;
+    }
+
+  while(true)
+    {
+      if(reader.end - reader.pos < _TARBLOCKSIZE && fillArchive(reader) == false &&
+         reader.end - reader.pos < _TARBLOCKSIZE)
+        {
+          errors.push_back(path + " ends without an end of archive marker");
+          break;
+        }
+
+      const unsigned char* header = (const unsigned char*)reader.buffer.data() + reader.pos;
+      unsigned checksum = 0;
+      bool isZeroBlock = true;
+
+      for(size_t i = 0; i < _TARBLOCKSIZE; i++)
+        {
+          checksum += (i >= 148 && i < 156) ? ' ' : header[i];
+          isZeroBlock = isZeroBlock && header[i] == 0;
+        }
+
+      if(isZeroBlock == true)
+        {
+          break;
+        }
+
+      if(checksum != strtoul(std::string((const char*)header + 148, 8).c_str(), nullptr, 8))
+        {
+          errors.push_back(path + " isn't a tar archive");
+          break;
+        }
+
+      const char type = header[156];
+      const size_t size = strtoull(std::string((const char*)header + 124, 12).c_str(),
+                                   nullptr, 8);
+      std::string name = std::string((const char*)header, strnlen((const char*)header, 100));
+
+      if(memcmp(header + 257, "ustar", 5) == 0 && header[345] != '\0')
+        {
+          name = std::string((const char*)header + 345, strnlen((const char*)header + 345, 155)) +
+            "/" + name;
+        }
+
+      if(!longName.empty())
+        {
+          name.swap(longName);
+          longName.clear();
+        }
+
+      reader.pos += _TARBLOCKSIZE;
+
+      bool isRead = true;
+
+      if((type == 'L' || type == 'x') && size > _IMPORTMAXLINE)
+        {
+          // too large to hold only a name, such as pax records carrying
+          // long comments; the member that follows keeps its own name
+          isRead = readArchiveMember(reader, nullptr, size, nullptr);
+        }
+      else if(type == 'L' || type == 'x')
+        {
+          std::string contents;
+
+          isRead = readArchiveMember(reader, nullptr, size, &contents);
+
+          if(type == 'L')
+            {
+              longName = contents.c_str();
+            }
+          else
+            {
+              // "<length> path=<name>\n" records
+              const size_t record = contents.find(" path=");
+
+              if(record != std::string::npos)
+                {
+                  const size_t end = contents.find('\n', record);
+
+                  longName = contents.substr(record + 6, end == std::string::npos ?
+                                             std::string::npos : end - record - 6);
+                }
+            }
+        }
+      else if((type == '0' || type == '\0') && size <= _IMPORTMAXFILESIZE)
+        {
+          isRead = readArchiveMember(reader, &parser, size, nullptr);
+          numFiles++;
+
+          if(isRead == true && parser.finish(palette) == true)
+            {
+              ImportedTheme theme;
+
+              theme.key = path + "/" + name;
+              theme.name = themeNameFromPath(name);
+              palette.pack(theme.packed);
+              themes.push_back(theme);
+            }
+          else
+            {
+              numUnparsed++;
+            }
+        }
+      else
+        {
+          isRead = readArchiveMember(reader, nullptr, size, nullptr);
+        }
+
+      if(isRead == false)
+        {
+          errors.push_back(path + " is truncated");
+          break;
+        }
+    }
+
+  close(reader.fd);
+} // end of "importArchive"
+
+
+
+/*
+  Function:
+   importFile
+
+  Description:
+   Reads a theme file in fixed size chunks through the parser.
+
+  Input/Output:
+   parser               - a reference to the worker's parser.
+
+   buffer               - a reference to the worker's read buffer.
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the file.
+
+  Output:
+   themes               - a reference to a vector that receives the theme.
+
+  Returns:
+   bool                 - true if the file held a palette.
+*/
+static bool importFile(PaletteParser& parser,
+                       std::vector<char>& buffer,
+                       const std::string& path,
+                       std::vector<ImportedTheme>& themes)
+{
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat fileStat;
+  Palette palette;
+  ssize_t numRead = 0;
+
+  if(fd == -1)
+    {
+      return false;
+    }
+
+  if(fstat(fd, &fileStat) == -1 || fileStat.st_size > (off_t)_IMPORTMAXFILESIZE)
+    {
+      close(fd);
+      return false;
+    }
+
+  while((numRead = read(fd, buffer.data(), buffer.size())) > 0 ||
+        (numRead == -1 && errno == EINTR))
+    {
+      if(numRead > 0)
+        {
+          parser.feed(buffer.data(), numRead);
+        }
+    }
+
+  close(fd);
+
+  if(parser.finish(palette) == false || numRead == -1)
+    {
+      return false;
+    }
+
+  ImportedTheme theme;
+
+  theme.key = path;
+  theme.name = themeNameFromPath(path);
+  palette.pack(theme.packed);
+  themes.push_back(theme);
+
+  return true;
+} // end of "importFile"
+
+
+
+/*
+  Function:
+   importWorker
+
+  Description:
+   Takes directories and files off the shared task list until every one has
+   been read. A directory's entries are added to the list in one go, so the
+   walk of a large collection spreads over every worker.
+
+  Input/Output:
+   shared               - a reference to the state shared by the workers.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void importWorker(ImportShared& shared)
+{
+  PaletteParser parser;
+  std::vector<char> buffer(_IMPORTCHUNKSIZE);
+  std::vector<ImportTask> newTasks;
+  std::vector<ImportedTheme> themes;
+  std::vector<std::string> errors;
+  std::unique_lock<std::mutex> lock(shared.mutex);
+
+  while(true)
+    {
+      if(shared.tasks.empty())
+        {
+          if(shared.numBusy == 0)
+            {
+              break;
+            }
+
+          shared.changed.wait(lock);
+          continue;
+        }
+
+      const ImportTask task = shared.tasks.back();
+      int numFiles = 0;
+      int numUnparsed = 0;
+
+      shared.tasks.pop_back();
+      shared.numBusy++;
+      lock.unlock();
+
+      if(task.isDirectory == true)
+        {
+          DIR* dir = opendir(task.path.c_str());
+          struct dirent* entry;
+
+          if(dir == nullptr)
+            {
+              errors.push_back("can't read " + task.path);
+            }
+
+          while(dir != nullptr && (entry = readdir(dir)) != nullptr)
+            {
+              // theme files are often dotfiles (.Xresources, .Xdefaults),
+              // only the directory itself, its parent and VCS metadata are
+              // skipped
+              if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0 ||
+                 strcmp(entry->d_name, ".git") == 0 || strcmp(entry->d_name, ".hg") == 0 ||
+                 strcmp(entry->d_name, ".svn") == 0)
+                {
+                  continue;
+                }
+
+              ImportTask child;
+              unsigned char type = entry->d_type;
+
+              child.path = task.path + "/" + entry->d_name;
+
+              // links to files are followed, links to directories aren't so
+              // a link loop can't walk forever
+              if(type == DT_UNKNOWN || type == DT_LNK)
+                {
+                  struct stat childStat;
+
+                  type = DT_UNKNOWN;
+
+                  if(stat(child.path.c_str(), &childStat) == 0)
+                    {
+                      type = S_ISREG(childStat.st_mode) ? DT_REG :
+                        S_ISDIR(childStat.st_mode) && entry->d_type != DT_LNK ? DT_DIR :
+                        DT_UNKNOWN;
+                    }
+                }
+
+              if(type == DT_DIR || type == DT_REG)
+                {
+                  child.isDirectory = type == DT_DIR;
+                  newTasks.push_back(child);
+                }
+            }
+
+          if(dir != nullptr)
+            {
+              closedir(dir);
+            }
+        }
+      else if(task.path.length() > 4 &&
+              task.path.compare(task.path.length() - 4, 4, ".tar") == 0)
+        {
+          importArchive(task.path, themes, numFiles, numUnparsed, errors);
+        }
+      else
+        {
+          numFiles++;
+
+          if(importFile(parser, buffer, task.path, themes) == false)
+            {
+              numUnparsed++;
+            }
+        }
+
+      lock.lock();
+      shared.numBusy--;
+      shared.numFiles += numFiles;
+      shared.numUnparsed += numUnparsed;
+      shared.tasks.insert(shared.tasks.end(), newTasks.begin(), newTasks.end());
+      newTasks.clear();
+      shared.changed.notify_all();
+    }
+
+  shared.themes.insert(shared.themes.end(), themes.begin(), themes.end());
+  shared.errors.insert(shared.errors.end(), errors.begin(), errors.end());
+} // end of "importWorker"
+
+
+
+/*
+  Function:
+   formatImportReport
+
+  Description:
+   Formats an import report for the command line.
+
+  Input:
+   report               - a reference to a constant import report.
+
+  Output:
+   output               - a reference to a string that receives the report.
+
+  Returns:
+   NONE
+*/
+void formatImportReport(const ImportReport& report,
+                        std::string& output)
+{
+  char line[256];
+
+  snprintf(line, sizeof(line),
+           "imported %d themes from %d files in %.1f ms\n"
+           "  %d duplicate palettes, %d names already saved, %d files without a palette\n",
+           report.numThemes, report.numFiles, report.elapsedMs, report.numDuplicates,
+           report.numExisting, report.numUnparsed);
+  output = line;
+} // end of "formatImportReport"
+
+
+
+/*
+  Function:
+   importThemes
+
+  Description:
+   Imports every theme found in the incoming directories, archives and files
+   into the library. The sources are read by a pool of threads; the themes
+   found are then ordered by where they were found, a palette whose colors
+   are already in the library or earlier in the import is skipped, and a
+   name that is already taken keeps its saved palette. The library is rebuilt
+   once with every new theme; saving it is left to the caller so the whole
+   import is written in one atomic save.
+
+  Input:
+   sources              - a reference to a constant vector of the paths of
+                          theme directories, .tar archives and theme files.
+
+   numThreads           - the number of threads to use, 0 for one per core.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   library              - a reference to the library that receives the themes.
+
+   report               - a reference to the report of the import.
+
+  Returns:
+   NONE
+*/
+void importThemes(const std::vector<std::string>& sources,
+                  const int numThreads,
+                  ThemeLibrary& library,
+                  ImportReport& report,
+                  std::ofstream& log)
+{
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  ImportShared shared;
+
+  shared.numBusy = 0;
+  shared.numFiles = 0;
+  shared.numUnparsed = 0;
+
+  for(size_t i = 0; i < sources.size(); i++)
+    {
+      struct stat sourceStat;
+      ImportTask task;
+
+      if(stat(sources.at(i).c_str(), &sourceStat) == -1)
+        {
+          shared.errors.push_back("can't find " + sources.at(i));
+          continue;
+        }
+
+      task.path = sources.at(i);
+      task.isDirectory = S_ISDIR(sourceStat.st_mode);
+
+      while(task.path.length() > 1 && task.path.back() == '/')
+        {
+          task.path.pop_back();
+        }
+
+      shared.tasks.push_back(task);
+    }
+
+  unsigned threadCount = numThreads > 0 ? numThreads :
+    std::min(_IMPORTMAXTHREADS, std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+
+  for(unsigned i = 1; i < threadCount; i++)
+    {
+      threads.push_back(std::thread(importWorker, std::ref(shared)));
+    }
+
+  importWorker(shared);
+
+  for(size_t i = 0; i < threads.size(); i++)
+    {
+      threads.at(i).join();
+    }
+
+  std::sort(shared.themes.begin(), shared.themes.end(),
+            [](const ImportedTheme& left, const ImportedTheme& right)
+            { return left.key < right.key; });
+
+  // the palettes and names already saved
+  std::vector<LibraryEntry> entries;
+  std::unordered_set<std::string> palettes;
+  std::unordered_set<std::string> names;
+
+  library.getEntries(0, library.getNumEntries(), entries);
+
+  for(size_t i = 0; i < entries.size(); i++)
+    {
+      names.insert(entries.at(i).name);
+
+      if(!entries.at(i).value.empty())
+        {
+          palettes.insert(entries.at(i).value);
+        }
+    }
+
+  report.numFiles = shared.numFiles;
+  report.numThemes = 0;
+  report.numDuplicates = 0;
+  report.numExisting = 0;
+  report.numUnparsed = shared.numUnparsed;
+  report.errors.swap(shared.errors);
+
+  for(size_t i = 0; i < shared.themes.size(); i++)
+    {
+      ImportedTheme& theme = shared.themes.at(i);
+
+      if(palettes.count(theme.packed) != 0)
+        {
+          report.numDuplicates++;
+        }
+      else if(names.insert(theme.name).second == false)
+        {
+          report.numExisting++;
+        }
+      else
+        {
+          LibraryEntry entry;
+
+          palettes.insert(theme.packed);
+          entry.name.swap(theme.name);
+          entry.value.swap(theme.packed);
+          entries.push_back(entry);
+          report.numThemes++;
+        }
+    }
+
+  if(report.numThemes > 0)
+    {
+      library.buildEntries(entries);
+    }
+
+  report.elapsedMs = std::chrono::duration<double, std::milli>(
+    std::chrono::steady_clock::now() - start).count();
+
+  log << "Import: " << report.numThemes << " themes from " << report.numFiles
+      << " files using " << threadCount << " threads in " << report.elapsedMs << " ms"
+      << std::endl;
+} // end of "importThemes"
@@ -0,0 +1,926 @@
+/*
+  File:
+   themeLibrary.cpp
+
+  Description:
+   The implementation of the themeLibrary.hpp class.
+*/
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include "applyEngine.hpp"
+#include "themeLibrary.hpp"
+
+// magic, entry count, block count and data size
+const size_t _LIBRARYHEADERSIZE = 8 + 3 * sizeof(uint32_t);
+
+
+
+/*
+  Function:
+   appendVarint
+
+  Description:
+   Appends the incoming value as a LEB128 varint.
+
+  Input/Output:
+   data                 - a reference to the string to append to.
+
+  Input:
+   value                - the value to append.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void appendVarint(std::string& data,
+                         uint32_t value)
+{
+  while(value >= 0x80)
+    {
+      data.push_back((char)(value | 0x80));
+      value >>= 7;
+    }
+
+  data.push_back((char)value);
+} // end of "appendVarint"
+
+
+
+/*
+  Function:
+   readVarint
+
+  Description:
+   Reads a LEB128 varint starting at offset.
+
+  Input/Output:
+   offset               - a reference to the offset to read at, moved past
+                          the varint.
+
+  Input:
+   data                 - a reference to a constant string to read from.
+
+  Output:
+   value                - a reference to the value read.
+
+  Returns:
+   bool                 - false if the varint runs past the end of data.
+*/
+static bool readVarint(const std::string& data,
+                       size_t& offset,
+                       uint32_t& value)
+{
+  value = 0;
+
+  for(int shift = 0; shift < 35 && offset < data.length(); shift += 7)
+    {
+      const unsigned char byte = data[offset++];
+
+      value |= (uint32_t)(byte & 0x7f) << shift;
+
+      if((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+} // end of "readVarint"
+
+
+
+/*
+  Function:
+   ThemeLibrary Constructor
+
+  Description:
+   Creates an empty library.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+ThemeLibrary::ThemeLibrary()
+  : m_numEntries(0)
+{
+} // end of "ThemeLibrary Constructor"
+
+
+
+/*
+  Function:
+   at
+
+  Description:
+   Returns the name at the incoming index, decoding from the start of its
+   block.
+
+  Input:
+   index                - the index of the name, 0 to getNumEntries() - 1.
+
+  Output:
+   NONE
+
+  Returns:
+   std::string          - the name, or an empty string if index is out of
+                          range.
+*/
+std::string ThemeLibrary::at(const int index) const
+{
+  std::string name;
+
+  getName(index, name);
+
+  return name;
+} // end of "at"
+
+
+
+/*
+  Function:
+   build
+
+  Description:
+   Replaces the library with the incoming names, with no values.
+
+  Input:
+   names                - the theme names, in any order.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeLibrary::build(std::vector<std::string> names)
+{
+  std::vector<LibraryEntry> entries(names.size());
+
+  for(size_t i = 0; i < names.size(); i++)
+    {
+      entries.at(i).name.swap(names.at(i));
+    }
+
+  buildEntries(entries);
+} // end of "build"
+
+
+
+/*
+  Function:
+   buildEntries
+
+  Description:
+   Replaces the library with the incoming entries, sorted by name. Of
+   entries with the same name the first one is kept.
+
+  Input:
+   entries              - the theme entries, in any order.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+void ThemeLibrary::buildEntries(std::vector<LibraryEntry> entries)
+{
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const LibraryEntry& left, const LibraryEntry& right)
+                   { return left.name < right.name; });
+  entries.erase(std::unique(entries.begin(), entries.end(),
+                            [](const LibraryEntry& left, const LibraryEntry& right)
+                            { return left.name == right.name; }),
+                entries.end());
+
+  m_data.clear();
+  m_blockOffsets.clear();
+  m_numEntries = entries.size();
+
+  for(size_t i = 0; i < entries.size(); i++)
+    {
+      const std::string& name = entries.at(i).name;
+      size_t shared = 0;
+
+      if(i % _LIBRARYRESTART == 0)
+        {
+          m_blockOffsets.push_back(m_data.length());
+        }
+      else
+        {
+          const std::string& previous = entries.at(i - 1).name;
+          const size_t maxShared = std::min(previous.length(), name.length());
+
+          while(shared < maxShared && previous[shared] == name[shared])
+            {
+              shared++;
+            }
+        }
+
+      appendVarint(m_data, shared);
+      appendVarint(m_data, name.length() - shared);
+      appendVarint(m_data, entries.at(i).value.length());
+      m_data.append(name, shared, std::string::npos);
+      m_data.append(entries.at(i).value);
+    }
+} // end of "buildEntries"
+
+
+
+/*
+  Function:
+   find
+
+  Description:
+   Looks up a name with a binary search of the sparse index and a scan of at
+   most one block.
+
+  Input:
+   name                 - a reference to a constant string containing the
+                          name to find.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the index of the name, or -1 if it isn't in the
+                          library.
+*/
+int ThemeLibrary::find(const std::string& name) const
+{
+  std::string found;
+
+  // an empty name sorts before the first block, where seek() returns 0
+  // without decoding a name to compare
+  if(name.empty())
+    {
+      return -1;
+    }
+
+  const int index = seek(name, found);
+
+  if(index >= m_numEntries)
+    {
+      return -1;
+    }
+
+  return found == name ? index : -1;
+} // end of "find"
+
+
+
+/*
+  Function:
+   findPrefix
+
+  Description:
+   Finds the range of names that start with the incoming prefix.
+
+  Input:
+   prefix               - a reference to a constant string containing the
+                          prefix; an empty prefix matches every name.
+
+  Output:
+   first                - a reference to the index of the first match.
+
+   last                 - a reference to one past the index of the last
+                          match; first == last if nothing matches.
+
+  Returns:
+   NONE
+*/
+void ThemeLibrary::findPrefix(const std::string& prefix,
+                              int& first,
+                              int& last) const
+{
+  first = lowerBound(prefix);
+  last = m_numEntries;
+
+  // the smallest string greater than every string starting with prefix
+  std::string upper = prefix;
+
+  while(!upper.empty() && (unsigned char)upper.back() == 0xff)
+    {
+      upper.pop_back();
+    }
+
+  if(!upper.empty())
+    {
+      upper.back()++;
+      last = lowerBound(upper);
+    }
+} // end of "findPrefix"
+
+
+
+/*
+  Function:
+   getEntries
+
+  Description:
+   Decodes count entries, names and values, starting at first.
+
+  Input:
+   first                - the index of the first entry.
+
+   count                - the largest number of entries to decode.
+
+  Output:
+   entries              - a reference to a vector that receives the entries.
+
+  Returns:
+   NONE
+*/
+void ThemeLibrary::getEntries(const int first,
+                              const int count,
+                              std::vector<LibraryEntry>& entries) const
+{
+  entries.clear();
+
+  if(first < 0 || first >= m_numEntries || count <= 0)
+    {
+      return;
+    }
+
+  const int last = std::min(m_numEntries, first + count);
+  size_t offset = m_blockOffsets.at(first / _LIBRARYRESTART);
+  LibraryEntry entry;
+
+  entries.reserve(last - first);
+
+  for(int i = first - first % _LIBRARYRESTART; i < last; i++)
+    {
+      if(decodeEntry(offset, entry.name, i >= first ? &entry.value : nullptr) == false)
+        {
+          return;
+        }
+
+      if(i >= first)
+        {
+          entries.push_back(entry);
+        }
+    }
+} // end of "getEntries"
+
+
+
+/*
+  Function:
+   getRange
+
+  Description:
+   Decodes count names starting at first, e.g. the names of one page of the
+   saved themes window. Only the block the range starts in is searched;
+   every other name is decoded in order. The strings already in names are
+   reused.
+
+  Input:
+   first                - the index of the first name.
+
+   count                - the largest number of names to decode.
+
+  Output:
+   names                - a reference to a vector that receives the names.
+
+  Returns:
+   NONE
+*/
+void ThemeLibrary::getRange(const int first,
+                            const int count,
+                            std::vector<std::string>& names) const
+{
+  if(first < 0 || first >= m_numEntries || count <= 0)
+    {
+      names.clear();
+      return;
+    }
+
+  const int last = std::min(m_numEntries, first + count);
+  size_t offset = m_blockOffsets.at(first / _LIBRARYRESTART);
+
+  // each name is decoded over the string already in its place, so a caller
+  // that keeps names between pages doesn't allocate once they are long enough
+  names.resize(last - first);
+  names.at(0).clear();
+
+  for(int i = first - first % _LIBRARYRESTART; i < last; i++)
+    {
+      std::string& name = names.at(std::max(i - first, 0));
+
+      if(i > first)
+        {
+          name = names.at(i - first - 1);
+        }
+
+      if(decodeEntry(offset, name, nullptr) == false)
+        {
+          names.resize(std::max(i - first, 0));
+          return;
+        }
+    }
+} // end of "getRange"
+
+
+
+/*
+  Function:
+   getName
+
+  Description:
+   Decodes the name at the incoming index, from the start of its block, over
+   the incoming string.
+
+  Input:
+   index                - the index of the name.
+
+  Output:
+   name                 - a reference to a string that receives the name.
+
+  Returns:
+   bool                 - false if index is out of range.
+*/
+bool ThemeLibrary::getName(const int index,
+                           std::string& name) const
+{
+  if(index < 0 || index >= m_numEntries)
+    {
+      name.clear();
+      return false;
+    }
+
+  size_t offset = m_blockOffsets.at(index / _LIBRARYRESTART);
+
+  name.clear();
+
+  for(int i = index - index % _LIBRARYRESTART; i <= index; i++)
+    {
+      if(decodeEntry(offset, name, nullptr) == false)
+        {
+          name.clear();
+          return false;
+        }
+    }
+
+  return true;
+} // end of "getName"
+
+
+
+/*
+  Function:
+   getValue
+
+  Description:
+   Returns the value stored with the name at the incoming index.
+
+  Input:
+   index                - the index of the entry.
+
+  Output:
+   value                - a reference to a string that receives the value.
+
+  Returns:
+   bool                 - false if index is out of range.
+*/
+bool ThemeLibrary::getValue(const int index,
+                            std::string& value) const
+{
+  std::vector<LibraryEntry> entries;
+
+  getEntries(index, 1, entries);
+
+  if(entries.empty())
+    {
+      return false;
+    }
+
+  value.swap(entries.at(0).value);
+
+  return true;
+} // end of "getValue"
+
+
+
+/*
+  Function:
+   load
+
+  Description:
+   Replaces the library with the one stored at path. The file is the header
+   followed by the sparse index and the encoded names, exactly as they are
+   held in memory, so nothing is decoded until it is looked up or shown.
+
+  Input:
+   path                 - a reference to a constant string containing the
+                          path of the library file.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the library was loaded; on failure the
+                          library is left unchanged.
+*/
+bool ThemeLibrary::load(const std::string& path)
+{
+  std::ifstream inFile(path.c_str(), std::ios::binary);
+  std::stringstream buffer;
+
+  if(!inFile.is_open())
+    {
+      return false;
+    }
+
+  buffer << inFile.rdbuf();
+
+  const std::string contents = buffer.str();
+  uint32_t header[3];
+
+  if(contents.length() < _LIBRARYHEADERSIZE ||
+     contents.compare(0, 8, _LIBRARYMAGIC) != 0)
+    {
+      return false;
+    }
+
+  memcpy(header, contents.data() + 8, sizeof(header));
+
+  const uint32_t numEntries = header[0];
+  const uint32_t numBlocks = header[1];
+  const uint32_t dataSize = header[2];
+  const size_t indexSize = (size_t)numBlocks * sizeof(uint32_t);
+
+  if(numBlocks != (numEntries + _LIBRARYRESTART - 1) / _LIBRARYRESTART ||
+     contents.length() != _LIBRARYHEADERSIZE + indexSize + dataSize)
+    {
+      return false;
+    }
+
+  std::vector<uint32_t> blockOffsets(numBlocks);
+
+  if(numBlocks > 0)
+    {
+      memcpy(blockOffsets.data(), contents.data() + _LIBRARYHEADERSIZE, indexSize);
+    }
+
+  for(uint32_t i = 0; i < numBlocks; i++)
+    {
+      if(blockOffsets.at(i) >= dataSize || (i > 0 && blockOffsets.at(i) <= blockOffsets.at(i - 1)))
+        {
+          return false;
+        }
+    }
+
+  m_data = contents.substr(_LIBRARYHEADERSIZE + indexSize);
+  m_blockOffsets.swap(blockOffsets);
+  m_numEntries = numEntries;
+
+  return true;
+} // end of "load"
+
+
+
+/*
+  Function:
+   lowerBound
+
+  Description:
+   Returns the index of the first name not less than key.
+
+  Input:
+   key                  - a reference to a constant string containing the key.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - the index, getNumEntries() if every name is less
+                          than key.
+*/
+int ThemeLibrary::lowerBound(const std::string& key) const
+{
+  std::string name;
+
+  return seek(key, name);
+} // end of "lowerBound"
+
+
+
+/*
+  Function:
+   writeAll
+
+  Description:
+   Writes every byte of the incoming buffer, retrying short and interrupted
+   writes.
+
+  Input:
+   fd                   - the descriptor to write to.
+
+   data                 - a pointer to the bytes to write.
+
+   length               - the number of bytes to write.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if every byte was written.
+*/
+static bool writeAll(const int fd,
+                     const char* data,
+                     size_t length)
+{
+  while(length > 0)
+    {
+      const ssize_t written = write(fd, data, length);
+
+      if(written < 0 && errno == EINTR)
+        {
+          continue;
+        }
+
+      if(written <= 0)
+        {
+          return false;
+        }
+
+      data += written;
+      length -= written;
+    }
+
+  return true;
+} // end of "writeAll"
+
+
+
+/*
+  Function:
+   save
+
+  Description:
+   Writes the library to a temporary file beside path and renames it over
+   path, so readers only ever see a whole library. As in the apply engine the
+   temporary file is created exclusively under a random name (see
+   openApplyTempFile()), and both it and the directory are synced around the
+   rename, so a crash leaves either the old library or the new one.
+
+  Input:
+   path                 - a reference to a constant string containing the
+                          path of the library file.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the library was saved.
+*/
+bool ThemeLibrary::save(const std::string& path) const
+{
+  const size_t nameStart = path.rfind('/') + 1;
+  const std::string dirPath = nameStart == 0 ? "." : nameStart == 1 ? "/" :
+    path.substr(0, nameStart - 1);
+  const std::string name = path.substr(nameStart);
+  const uint32_t header[3] = {(uint32_t)m_numEntries, (uint32_t)m_blockOffsets.size(),
+                              (uint32_t)m_data.length()};
+  std::string tempName;
+
+  if(name.empty())
+    {
+      return false;
+    }
+
+  const int dirFd = open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+  if(dirFd == -1)
+    {
+      return false;
+    }
+
+  const int fd = openApplyTempFile(dirFd, name, tempName);
+
+  if(fd == -1)
+    {
+      close(dirFd);
+      return false;
+    }
+
+  bool isSaved = writeAll(fd, _LIBRARYMAGIC, 8) &&
+    writeAll(fd, (const char*)header, sizeof(header)) &&
+    writeAll(fd, (const char*)m_blockOffsets.data(), m_blockOffsets.size() * sizeof(uint32_t)) &&
+    writeAll(fd, m_data.data(), m_data.length()) &&
+    fsync(fd) == 0;
+
+  if(close(fd) == -1)
+    {
+      isSaved = false;
+    }
+
+  if(isSaved == true && renameat(dirFd, tempName.c_str(), dirFd, name.c_str()) == 0)
+    {
+      // the rename itself is only durable once the directory is synced
+      fsync(dirFd);
+    }
+  else
+    {
+      unlinkat(dirFd, tempName.c_str(), 0);
+      isSaved = false;
+    }
+
+  close(dirFd);
+
+  return isSaved;
+} // end of "save"
+
+
+
+int ThemeLibrary::getNumEntries() const
+{
+  return m_numEntries;
+} // end of "getNumEntries"
+
+
+
+/*
+  Function:
+   compareBlockKey
+
+  Description:
+   Compares the first name of a block, which is stored whole, with key
+   without decoding it into a string.
+
+  Input:
+   block                - the index of the block.
+
+   key                  - a reference to a constant string containing the key.
+
+  Output:
+   NONE
+
+  Returns:
+   int                  - less than, equal to or greater than 0 as the block's
+                          first name is less than, equal to or greater than
+                          key.
+*/
+int ThemeLibrary::compareBlockKey(const int block,
+                                  const std::string& key) const
+{
+  size_t offset = m_blockOffsets.at(block);
+  uint32_t shared;
+  uint32_t length;
+
+  uint32_t valueLength;
+
+  if(readVarint(m_data, offset, shared) == false ||
+     readVarint(m_data, offset, length) == false ||
+     readVarint(m_data, offset, valueLength) == false ||
+     offset + length > m_data.length())
+    {
+      return 1;
+    }
+
+  const int compared = memcmp(m_data.data() + offset, key.data(),
+                              std::min((size_t)length, key.length()));
+
+  if(compared != 0)
+    {
+      return compared;
+    }
+
+  return (int)(length > key.length()) - (int)(length < key.length());
+} // end of "compareBlockKey"
+
+
+
+/*
+  Function:
+   decodeEntry
+
+  Description:
+   Decodes the entry at offset over the name before it, which name must
+   still hold (nothing is needed for the first name of a block).
+
+  Input/Output:
+   offset               - a reference to the offset of the entry, moved to
+                          the next entry.
+
+   name                 - a reference to the previous name, replaced by the
+                          decoded name.
+
+  Input:
+   NONE
+
+  Output:
+   value                - a pointer to a string that receives the entry's
+                          value, or nullptr to skip it.
+
+  Returns:
+   bool                 - false if the entry is corrupt.
+*/
+bool ThemeLibrary::decodeEntry(size_t& offset,
+                               std::string& name,
+                               std::string* value) const
+{
+  uint32_t shared;
+  uint32_t length;
+  uint32_t valueLength;
+
+  if(readVarint(m_data, offset, shared) == false ||
+     readVarint(m_data, offset, length) == false ||
+     readVarint(m_data, offset, valueLength) == false ||
+     shared > name.length() || offset + length + valueLength > m_data.length())
+    {
+      return false;
+    }
+
+  name.resize(shared);
+  name.append(m_data, offset, length);
+  offset += length;
+
+  if(value != nullptr)
+    {
+      value->assign(m_data, offset, valueLength);
+    }
+
+  offset += valueLength;
+
+  return true;
+} // end of "decodeEntry"
+
+
+
+/*
+  Function:
+   seek
+
+  Description:
+   Finds the first name not less than key: a binary search of the sparse
+   index for the last block starting at or before key, then a scan of that
+   block.
+
+  Input:
+   key                  - a reference to a constant string containing the key.
+
+  Output:
+   name                 - a reference to a string that receives the name
+                          found, if any.
+
+  Returns:
+   int                  - the index of the name, getNumEntries() if every name
+                          is less than key.
+*/
+int ThemeLibrary::seek(const std::string& key,
+                       std::string& name) const
+{
+  int low = 0;
+  int high = m_blockOffsets.size();
+
+  // find the first block whose first name is greater than key
+  while(low < high)
+    {
+      const int middle = low + (high - low) / 2;
+
+      if(compareBlockKey(middle, key) <= 0)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+
+  if(low == 0)
+    {
+      return 0;
+    }
+
+  const int block = low - 1;
+  const int blockEnd = std::min(m_numEntries, (block + 1) * _LIBRARYRESTART);
+  size_t offset = m_blockOffsets.at(block);
+
+  name.clear();
+
+  for(int i = block * _LIBRARYRESTART; i < blockEnd; i++)
+    {
+      if(decodeEntry(offset, name, nullptr) == false || name >= key)
+        {
+          return i;
+        }
+    }
+
+  // key is past every name of its block, the next block's first name is
+  // greater than key
+  name.clear();
+
+  return blockEnd;
+} // end of "seek"
@@ -0,0 +1,410 @@
+/*
+  File:
+   themeRewriters.cpp
+
+  Description:
+   The implementation of the themeRewriters.hpp classes.
+*/
+#include <cctype>
+#include <cstring>
+#include "themeRewriters.hpp"
+
+
+
+/*
+  Function:
+   KeyValueRewriter Constructor
+
+  Description:
+   Defines which files the rewriter handles and how its theme line looks.
+
+  Input:
+   name                 - a reference to a constant string naming the format.
+
+   fileSuffixes         - a reference to a constant vector of path endings
+                          (extensions or file names) the rewriter handles.
+
+   key                  - a reference to a constant string containing the key
+                          that holds the theme value.
+
+   separator            - the character between the key and its value. A space
+                          means any run of whitespace.
+
+   componentSeparators  - a reference to a constant string containing the
+                          characters that separate the theme name from the rest
+                          of the value (e.g. "/" for paths).
+
+   section              - a reference to a constant string naming the [section]
+                          the key must be in, or empty to match anywhere.
+
+  Output:
+   NONE
+*/
+KeyValueRewriter::KeyValueRewriter(const std::string& name,
+                                   const std::vector<std::string>& fileSuffixes,
+                                   const std::string& key,
+                                   const char separator,
+                                   const std::string& componentSeparators,
+                                   const std::string& section)
+  : m_name(name),
+    m_fileSuffixes(fileSuffixes),
+    m_key(key),
+    m_separator(separator),
+    m_componentSeparators(componentSeparators),
+    m_section(section)
+{
+} // end of "KeyValueRewriter Constructor"
+
+
+
+const std::string& KeyValueRewriter::getName() const
+{
+  return m_name;
+} // end of "getName"
+
+
+
+bool KeyValueRewriter::handlesFile(const std::string& path) const
+{
+  for(size_t i = 0; i < m_fileSuffixes.size(); i++)
+    {
+      const std::string& suffix = m_fileSuffixes.at(i);
+
+      if(path.length() >= suffix.length() &&
+         path.compare(path.length() - suffix.length(), suffix.length(), suffix) == 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+} // end of "handlesFile"
+
+
+
+/*
+  Function:
+   findEdits
+
+  Description:
+   Finds the first line assigning the rewriter's key (inside its section if
+   one is set) and reports a single span replacing the theme name in its value.
+   The directory and extension around the theme name are left untouched, so
+   "themes/dracula.toml" becomes "themes/<theme>.toml". Nothing is reported if
+   the file already uses the theme.
+
+  Input:
+   data                 - a pointer to the original file contents.
+
+   length               - the number of bytes in data.
+
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+  Output:
+   spans                - a reference to a vector the edit is appended to.
+
+  Returns:
+   bool                 - true if the file has the rewriter's theme key, even
+                          if no edit was needed.
+*/
+bool KeyValueRewriter::findEdits(const char* data,
+                                 const size_t length,
+                                 const std::string& theme,
+                                 std::vector<RewriteSpan>& spans) const
+{
+  bool inSection = m_section.empty();
+  size_t lineStart = 0;
+
+  while(lineStart < length)
+    {
+      const char* newline = (const char*)memchr(data + lineStart, '\n', length - lineStart);
+      const size_t lineEnd = newline == nullptr ? length : newline - data;
+      size_t pos = lineStart;
+
+      while(pos < lineEnd && (data[pos] == ' ' || data[pos] == '\t'))
+        {
+          pos++;
+        }
+
+      // track the current section for keys that must be inside one
+      if(!m_section.empty() && pos < lineEnd && data[pos] == '[')
+        {
+          const char* close = (const char*)memchr(data + pos, ']', lineEnd - pos);
+
+          if(close != nullptr)
+            {
+              inSection = (size_t)(close - data - pos - 1) == m_section.length() &&
+                m_section.compare(0, m_section.length(), data + pos + 1,
+                                  m_section.length()) == 0;
+            }
+        }
+
+      size_t valueStart;
+      size_t valueEnd;
+
+      if(inSection == true &&
+         findValue(data + pos, lineEnd - pos, valueStart, valueEnd) == true)
+        {
+          valueStart += pos;
+          valueEnd += pos;
+
+          // the theme name is the last component of the value
+          size_t nameStart = valueEnd;
+
+          while(nameStart > valueStart &&
+                m_componentSeparators.find(data[nameStart - 1]) == std::string::npos)
+            {
+              nameStart--;
+            }
+
+          // keep the old extension unless the new theme brings its own
+          size_t nameEnd = valueEnd;
+
+          if(m_componentSeparators.find('.') == std::string::npos &&
+             theme.find('.') == std::string::npos)
+            {
+              const char* dot = (const char*)memchr(data + nameStart, '.', valueEnd - nameStart);
+
+              if(dot != nullptr && dot != data + nameStart)
+                {
+                  nameEnd = dot - data;
+                }
+            }
+
+          if(theme.length() != nameEnd - nameStart ||
+             theme.compare(0, theme.length(), data + nameStart, theme.length()) != 0)
+            {
+              RewriteSpan span;
+              span.offset = nameStart;
+              span.length = nameEnd - nameStart;
+              span.replacement = theme;
+              spans.push_back(span);
+            }
+
+          return true;
+        }
+
+      lineStart = lineEnd + 1;
+    }
+
+  return false;
+} // end of "findEdits"
+
+
+
+/*
+  Function:
+   findValue
+
+  Description:
+   Checks if the incoming line (starting at its first non-whitespace
+   character) assigns the rewriter's key and finds the value. Quoted values
+   exclude their quotes and a TOML array uses its first quoted element.
+
+  Input:
+   line                 - a pointer to the first non-whitespace character of
+                          the line.
+
+   lineLength           - the number of bytes left in the line.
+
+  Output:
+   valueStart           - the offset in line of the first byte of the value.
+
+   valueEnd             - the offset in line one past the last byte of the value.
+
+  Returns:
+   bool                 - true if the line assigns the key a non-empty value.
+*/
+bool KeyValueRewriter::findValue(const char* line,
+                                 const size_t lineLength,
+                                 size_t& valueStart,
+                                 size_t& valueEnd) const
+{
+  if(lineLength <= m_key.length() ||
+     m_key.compare(0, m_key.length(), line, m_key.length()) != 0)
+    {
+      return false;
+    }
+
+  size_t pos = m_key.length();
+  const size_t wsStart = pos;
+
+  while(pos < lineLength && (line[pos] == ' ' || line[pos] == '\t'))
+    {
+      pos++;
+    }
+
+  if(m_separator == ' ')
+    {
+      if(pos == wsStart)
+        {
+          return false;
+        }
+    }
+  else if(pos < lineLength && line[pos] == m_separator)
+    {
+      pos++;
+
+      while(pos < lineLength && (line[pos] == ' ' || line[pos] == '\t'))
+        {
+          pos++;
+        }
+    }
+  else
+    {
+      return false;
+    }
+
+  // use the first element of an array value
+  if(pos < lineLength && line[pos] == '[')
+    {
+      pos++;
+
+      while(pos < lineLength && (line[pos] == ' ' || line[pos] == '\t'))
+        {
+          pos++;
+        }
+    }
+
+  if(pos < lineLength && (line[pos] == '"' || line[pos] == '\''))
+    {
+      const char* close = (const char*)memchr(line + pos + 1, line[pos], lineLength - pos - 1);
+
+      if(close == nullptr)
+        {
+          return false;
+        }
+
+      valueStart = pos + 1;
+      valueEnd = close - line;
+    }
+  else
+    {
+      valueStart = pos;
+      valueEnd = pos;
+
+      while(valueEnd < lineLength && strchr(" \t#;,]\r", line[valueEnd]) == nullptr)
+        {
+          valueEnd++;
+        }
+    }
+
+  return valueEnd > valueStart;
+} // end of "findValue"
+
+
+
+/*
+  Function:
+   checkThemeName
+
+  Description:
+   Checks that a theme name is safe to write into configuration files: letters,
+   digits, '.', '_', '+' and '-', starting with a letter or digit, with no
+   ".." and at most _THEMENAMEMAX characters. Rewriters splice the name into
+   paths such as "themes/<name>.conf", so a '/', a ".." or a newline would
+   point the file elsewhere or add lines to it.
+
+  Input:
+   theme                - a reference to a constant string containing the name.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the name may be applied.
+*/
+bool checkThemeName(const std::string& theme)
+{
+  if(theme.empty() || theme.length() > _THEMENAMEMAX ||
+     isalnum((unsigned char)theme.at(0)) == 0 ||
+     theme.find("..") != std::string::npos)
+    {
+      return false;
+    }
+
+  for(size_t i = 0; i < theme.length(); i++)
+    {
+      const unsigned char c = theme.at(i);
+
+      if(isalnum(c) == 0 && c != '.' && c != '_' && c != '+' && c != '-')
+        {
+          return false;
+        }
+    }
+
+  return true;
+} // end of "checkThemeName"
+
+
+
+/*
+  Function:
+   themeRewriters
+
+  Description:
+   Returns the registered rewriter plugins, in the order they are tried.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   const std::vector<const ThemeRewriter*>&
+                        - a reference to the registered rewriters.
+*/
+const std::vector<const ThemeRewriter*>& themeRewriters()
+{
+  static const KeyValueRewriter alacritty("TOML", {".toml"}, "import", '=', "/");
+  static const KeyValueRewriter yaml("YAML", {".yml", ".yaml"}, "theme", ':', "/");
+  static const KeyValueRewriter gtk("INI", {".ini"}, "gtk-theme-name", '=', "/",
+                                    "Settings");
+  static const KeyValueRewriter xresources("Xresources", {".Xresources", ".Xdefaults"},
+                                           "#include", ' ', "/");
+  static const KeyValueRewriter kitty("kitty", {".conf"}, "include", ' ', "/");
+  static const KeyValueRewriter lua("Lua", {".lua"}, "theme", '=', "/.");
+  static const KeyValueRewriter python("Python", {".py"}, "colors", '=', "/.");
+  static const std::vector<const ThemeRewriter*> rewriters = {
+    &alacritty, &yaml, &gtk, &xresources, &kitty, &lua, &python
+  };
+
+  return rewriters;
+} // end of "themeRewriters"
+
+
+
+/*
+  Function:
+   findThemeRewriter
+
+  Description:
+   Returns the first registered rewriter that handles the incoming path.
+
+  Input:
+   path                 - a reference to a constant string containing the path
+                          of the file to rewrite.
+
+  Output:
+   NONE
+
+  Returns:
+   const ThemeRewriter* - a pointer to the rewriter, or nullptr if the file's
+                          format isn't supported.
+*/
+const ThemeRewriter* findThemeRewriter(const std::string& path)
+{
+  const std::vector<const ThemeRewriter*>& rewriters = themeRewriters();
+
+  for(size_t i = 0; i < rewriters.size(); i++)
+    {
+      if(rewriters.at(i)->handlesFile(path))
+        {
+          return rewriters.at(i);
+        }
+    }
+
+  return nullptr;
+} // end of "findThemeRewriter"
@@ -0,0 +1,1148 @@
+/*
+  File:
+   uringBackend.cpp
+
+  Description:
+   The implementation of the uringBackend.hpp class and functions.
+*/
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <linux/io_uring.h>
+#include <linux/openat2.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include "applyEngine.hpp"
+#include "deviceScheduler.hpp"
+#include "themeRewriters.hpp"
+#include "uringBackend.hpp"
+
+// the steps queued for one file, kept in the low bits of user_data
+enum UringSteps {
+  _URINGSTATX,
+  _URINGOPEN,
+  _URINGREAD,
+  _URINGCLOSE,
+  _URINGTEMPOPEN,
+  _URINGWRITE,
+  _URINGFSYNC,
+  _URINGTEMPCLOSE,
+  _URINGRENAME,
+  _URINGUNLINK,
+  _NUMURINGSTEPS
+};
+
+const unsigned _URINGSTEPBITS = 4;
+
+// submissions queued to write one file
+const unsigned _URINGWRITESTEPS = 5;
+
+// one file of the batch in flight
+struct UringFile {
+  size_t index;
+  const ThemeRewriter* rewriter;
+  struct statx fileStat;
+  size_t readOffset;
+  int stepResults[_NUMURINGSTEPS];
+  std::string tempPath;
+  struct open_how tempHow;
+  std::string rewritten;
+};
+
+// the files of one filesystem and the ring that applies them
+struct UringDevice {
+  std::vector<size_t> files;
+  std::vector<size_t> fallbackFiles;
+  std::unique_ptr<IoUring> ring;
+};
+
+
+
+/*
+  Function:
+   IoUring Constructor
+
+  Description:
+   Creates a ring that isn't set up yet.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+IoUring::IoUring()
+  : m_fd(-1),
+    m_sqRing(MAP_FAILED),
+    m_sqRingSize(0),
+    m_cqRing(MAP_FAILED),
+    m_cqRingSize(0),
+    m_sqes((io_uring_sqe*)MAP_FAILED),
+    m_sqesSize(0),
+    m_sqTail(nullptr),
+    m_sqArray(nullptr),
+    m_sqMask(0),
+    m_numSqes(0),
+    m_cqHead(nullptr),
+    m_cqTail(nullptr),
+    m_cqMask(0),
+    m_cqes(nullptr),
+    m_sqPending(0),
+    m_numFileSlots(0),
+    m_numSubmits(0)
+{
+} // end of "IoUring Constructor"
+
+
+
+/*
+  Function:
+   IoUring Destructor
+
+  Description:
+   Unmaps the rings and closes the ring, which also closes any direct
+   descriptors still registered.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+*/
+IoUring::~IoUring()
+{
+  if(m_sqes != MAP_FAILED)
+    {
+      munmap(m_sqes, m_sqesSize);
+    }
+
+  if(m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+    {
+      munmap(m_cqRing, m_cqRingSize);
+    }
+
+  if(m_sqRing != MAP_FAILED)
+    {
+      munmap(m_sqRing, m_sqRingSize);
+    }
+
+  if(m_fd != -1)
+    {
+      close(m_fd);
+    }
+} // end of "IoUring Destructor"
+
+
+
+/*
+  Function:
+   setup
+
+  Description:
+   Creates the ring, maps its queues and registers a table of empty direct
+   descriptor slots. Fails unless the kernel supports every operation the
+   apply pipeline needs and assigns the files of linked submissions when they
+   run (IORING_FEAT_LINKED_FILE, Linux 6.0), which a read on a slot opened
+   earlier in the same chain depends on.
+
+  Input:
+   entries              - the number of submission queue entries.
+
+   numFileSlots         - the number of direct descriptor slots.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if the ring is ready to use.
+*/
+bool IoUring::setup(const unsigned entries,
+                    const unsigned numFileSlots)
+{
+  static const int requiredOps[] = {
+    IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_OPENAT2, IORING_OP_READ,
+    IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_CLOSE, IORING_OP_RENAMEAT, IORING_OP_UNLINKAT
+  };
+  struct io_uring_params params;
+
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = entries * 2;
+  m_fd = syscall(__NR_io_uring_setup, entries, &params);
+
+  if(m_fd == -1 || (params.features & IORING_FEAT_LINKED_FILE) == 0)
+    {
+      return false;
+    }
+
+  m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+  if((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+      m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+    }
+
+  m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  m_fd, IORING_OFF_SQ_RING);
+
+  if(m_sqRing == MAP_FAILED)
+    {
+      return false;
+    }
+
+  if((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+      m_cqRing = m_sqRing;
+    }
+  else
+    {
+      m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      m_fd, IORING_OFF_CQ_RING);
+
+      if(m_cqRing == MAP_FAILED)
+        {
+          return false;
+        }
+    }
+
+  m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+  m_sqes = (io_uring_sqe*)mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+  if(m_sqes == MAP_FAILED)
+    {
+      return false;
+    }
+
+  char* sqRing = (char*)m_sqRing;
+  char* cqRing = (char*)m_cqRing;
+
+  m_sqTail = (unsigned*)(sqRing + params.sq_off.tail);
+  m_sqArray = (unsigned*)(sqRing + params.sq_off.array);
+  m_sqMask = *(unsigned*)(sqRing + params.sq_off.ring_mask);
+  m_numSqes = params.sq_entries;
+  m_cqHead = (unsigned*)(cqRing + params.cq_off.head);
+  m_cqTail = (unsigned*)(cqRing + params.cq_off.tail);
+  m_cqMask = *(unsigned*)(cqRing + params.cq_off.ring_mask);
+  m_cqes = (io_uring_cqe*)(cqRing + params.cq_off.cqes);
+
+  // make sure every operation is supported before anything is queued
+  const size_t probeSize = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+  std::vector<char> probeBuffer(probeSize, 0);
+  struct io_uring_probe* probe = (struct io_uring_probe*)probeBuffer.data();
+
+  if(syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, 256) < 0)
+    {
+      return false;
+    }
+
+  for(size_t i = 0; i < sizeof(requiredOps) / sizeof(requiredOps[0]); i++)
+    {
+      if(requiredOps[i] > probe->last_op ||
+         (probe->ops[requiredOps[i]].flags & IO_URING_OP_SUPPORTED) == 0)
+        {
+          return false;
+        }
+    }
+
+  std::vector<int> emptySlots(numFileSlots, -1);
+
+  if(syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_FILES,
+             emptySlots.data(), numFileSlots) < 0)
+    {
+      return false;
+    }
+
+  m_numFileSlots = numFileSlots;
+
+  return true;
+} // end of "setup"
+
+
+
+/*
+  Function:
+   getSqe
+
+  Description:
+   Returns a zeroed submission queue entry to fill in. The entry is submitted
+   by the next submitAndWait().
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   io_uring_sqe*        - the entry, or nullptr if the queue is full.
+*/
+io_uring_sqe* IoUring::getSqe()
+{
+  if(m_sqPending == m_numSqes)
+    {
+      return nullptr;
+    }
+
+  // the kernel only reads the tail inside io_uring_enter(), which runs after
+  // the entry is filled in
+  const unsigned tail = *m_sqTail;
+  const unsigned index = tail & m_sqMask;
+  io_uring_sqe* sqe = &m_sqes[index];
+
+  memset(sqe, 0, sizeof(*sqe));
+  m_sqArray[index] = index;
+  __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+  m_sqPending++;
+
+  return sqe;
+} // end of "getSqe"
+
+
+
+/*
+  Function:
+   popCqe
+
+  Description:
+   Takes the oldest completion off the completion queue.
+
+  Input:
+   NONE
+
+  Output:
+   userData             - a reference to the user_data of the submission.
+
+   res                  - a reference to its result, a negated errno on
+                          failure.
+
+  Returns:
+   bool                 - true if a completion was taken.
+*/
+bool IoUring::popCqe(uint64_t& userData,
+                     int& res)
+{
+  const unsigned head = *m_cqHead;
+
+  if(head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+    {
+      return false;
+    }
+
+  const io_uring_cqe* cqe = &m_cqes[head & m_cqMask];
+
+  userData = cqe->user_data;
+  res = cqe->res;
+  __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+
+  return true;
+} // end of "popCqe"
+
+
+
+/*
+  Function:
+   submitAndWait
+
+  Description:
+   Submits every queued entry and waits until the incoming number of
+   completions is ready, normally with a single io_uring_enter().
+
+  Input:
+   numCompletions       - the number of completions to wait for, at most the
+                          completion queue size.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if everything was submitted and completed.
+*/
+bool IoUring::submitAndWait(const unsigned numCompletions)
+{
+  while(true)
+    {
+      const unsigned numReady = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE) - *m_cqHead;
+
+      if(m_sqPending == 0 && numReady >= numCompletions)
+        {
+          return true;
+        }
+
+      const int submitted = syscall(__NR_io_uring_enter, m_fd, m_sqPending, numCompletions,
+                                    IORING_ENTER_GETEVENTS, nullptr, 0);
+
+      m_numSubmits++;
+
+      if(submitted < 0)
+        {
+          if(errno == EINTR)
+            {
+              continue;
+            }
+
+          return false;
+        }
+
+      if(submitted == 0 && m_sqPending > 0)
+        {
+          return false;
+        }
+
+      m_sqPending -= submitted;
+    }
+} // end of "submitAndWait"
+
+
+
+unsigned IoUring::getNumFileSlots() const
+{
+  return m_numFileSlots;
+} // end of "getNumFileSlots"
+
+
+
+unsigned IoUring::getNumSqes() const
+{
+  return m_numSqes;
+} // end of "getNumSqes"
+
+
+
+unsigned IoUring::getNumSubmits() const
+{
+  return m_numSubmits;
+} // end of "getNumSubmits"
+
+
+
+/*
+  Function:
+   reapBatch
+
+  Description:
+   Submits the queued entries of a batch, waits for all of them and records
+   each completion's result in its file.
+
+  Input/Output:
+   ring                 - a reference to the ring.
+
+   batch                - a reference to the files of the batch.
+
+  Input:
+   numQueued            - the number of entries queued for the batch.
+
+  Output:
+   NONE
+
+  Returns:
+   bool                 - true if every completion arrived.
+*/
+static bool reapBatch(IoUring& ring,
+                      std::vector<UringFile>& batch,
+                      const unsigned numQueued)
+{
+  if(ring.submitAndWait(numQueued) == false)
+    {
+      return false;
+    }
+
+  uint64_t userData;
+  int res;
+
+  for(unsigned i = 0; i < numQueued && ring.popCqe(userData, res) == true; i++)
+    {
+      const unsigned step = userData & ((1 << _URINGSTEPBITS) - 1);
+
+      batch.at(userData >> _URINGSTEPBITS).stepResults[step] = res;
+    }
+
+  return true;
+} // end of "reapBatch"
+
+
+
+/*
+  Function:
+   queueStatx
+
+  Description:
+   Queues the statx() of a file, which decides whether and how much of it is
+   read.
+
+  Input/Output:
+   ring                 - a reference to the ring.
+
+   file                 - a reference to the file, which receives the result.
+
+  Input:
+   batchIndex           - the position of the file in its batch.
+
+   path                 - a reference to a constant string containing the
+                          path of the file.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void queueStatx(IoUring& ring,
+                       UringFile& file,
+                       const unsigned batchIndex,
+                       const std::string& path)
+{
+  io_uring_sqe* sqe = ring.getSqe();
+
+  sqe->opcode = IORING_OP_STATX;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uint64_t)path.c_str();
+  sqe->len = STATX_TYPE | STATX_MODE | STATX_UID | STATX_GID | STATX_SIZE;
+  sqe->statx_flags = AT_SYMLINK_NOFOLLOW;
+  sqe->off = (uint64_t)&file.fileStat;
+  sqe->user_data = ((uint64_t)batchIndex << _URINGSTEPBITS) | _URINGSTATX;
+} // end of "queueStatx"
+
+
+
+/*
+  Function:
+   queueRead
+
+  Description:
+   Queues a hard linked open, read and close of a file on a direct descriptor
+   slot. Hard links keep the close queued after a short read, which is how
+   every small file reads. When isLinked is true the close is hard linked to
+   the next file queued, so the files of one lane run one after another.
+
+  Input/Output:
+   ring                 - a reference to the ring.
+
+  Input:
+   batchIndex           - the position of the file in its batch, which is
+                          also its slot.
+
+   path                 - a reference to a constant string containing the
+                          path of the file.
+
+   buffer               - the length bytes to read into.
+
+   length               - the number of bytes to read.
+
+   isLinked             - whether the next file queued waits for this one.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void queueRead(IoUring& ring,
+                      const unsigned batchIndex,
+                      const std::string& path,
+                      char* buffer,
+                      const unsigned length,
+                      const bool isLinked)
+{
+  const uint64_t tag = (uint64_t)batchIndex << _URINGSTEPBITS;
+
+  // direct descriptors don't take O_CLOEXEC, they never reach the fd table
+  io_uring_sqe* sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_OPENAT;
+  sqe->flags = IOSQE_IO_HARDLINK;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uint64_t)path.c_str();
+  sqe->open_flags = O_RDONLY | O_NOFOLLOW;
+  sqe->file_index = batchIndex + 1;
+  sqe->user_data = tag | _URINGOPEN;
+
+  sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_READ;
+  sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+  sqe->fd = batchIndex;
+  sqe->addr = (uint64_t)buffer;
+  sqe->len = length;
+  sqe->user_data = tag | _URINGREAD;
+
+  sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_CLOSE;
+  sqe->flags = isLinked == true ? IOSQE_IO_HARDLINK : 0;
+  sqe->file_index = batchIndex + 1;
+  sqe->user_data = tag | _URINGCLOSE;
+} // end of "queueRead"
+
+
+
+/*
+  Function:
+   queueWrite
+
+  Description:
+   Queues the linked open, write, fsync, close and rename that replace a file
+   with its rewritten contents. A failed step cancels the rest of the chain,
+   so the original is only replaced once the temporary file is safely on
+   disk. The temporary file is created exclusively under a name of its own
+   and without following any link (openat2() with RESOLVE_NO_SYMLINKS), so
+   nothing planted beside the file is ever written through.
+
+  Input/Output:
+   ring                 - a reference to the ring.
+
+  Input:
+   file                 - a reference to a constant file with its rewritten
+                          contents.
+
+   batchIndex           - the position of the file in its batch.
+
+   slot                 - the direct descriptor slot to use.
+
+   path                 - a reference to a constant string containing the
+                          path of the file.
+
+  Output:
+   NONE
+
+  Returns:
+   NONE
+*/
+static void queueWrite(IoUring& ring,
+                       const UringFile& file,
+                       const unsigned batchIndex,
+                       const unsigned slot,
+                       const std::string& path)
+{
+  const uint64_t tag = (uint64_t)batchIndex << _URINGSTEPBITS;
+  io_uring_sqe* sqe = ring.getSqe();
+
+  sqe->opcode = IORING_OP_OPENAT2;
+  sqe->flags = IOSQE_IO_LINK;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uint64_t)file.tempPath.c_str();
+  sqe->addr2 = (uint64_t)&file.tempHow;
+  sqe->len = sizeof(file.tempHow);
+  sqe->file_index = slot + 1;
+  sqe->user_data = tag | _URINGTEMPOPEN;
+
+  sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_WRITE;
+  sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+  sqe->fd = slot;
+  sqe->addr = (uint64_t)file.rewritten.data();
+  sqe->len = file.rewritten.length();
+  sqe->user_data = tag | _URINGWRITE;
+
+  sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_FSYNC;
+  sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+  sqe->fd = slot;
+  sqe->user_data = tag | _URINGFSYNC;
+
+  sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_CLOSE;
+  sqe->flags = IOSQE_IO_LINK;
+  sqe->file_index = slot + 1;
+  sqe->user_data = tag | _URINGTEMPCLOSE;
+
+  sqe = ring.getSqe();
+  sqe->opcode = IORING_OP_RENAMEAT;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = (uint64_t)file.tempPath.c_str();
+  sqe->len = AT_FDCWD;
+  sqe->addr2 = (uint64_t)path.c_str();
+  sqe->user_data = tag | _URINGRENAME;
+} // end of "queueWrite"
+
+
+
+/*
+  Function:
+   readUmask
+
+  Description:
+   Reads the process umask from /proc without changing it, as umask() would
+   for every thread at once.
+
+  Input:
+   NONE
+
+  Output:
+   NONE
+
+  Returns:
+   mode_t               - the umask, or every permission bit if it can't be
+                          read so that no file's mode is left to it.
+*/
+static mode_t readUmask()
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+
+  while(std::getline(status, line))
+    {
+      if(line.compare(0, 6, "Umask:") == 0)
+        {
+          return strtoul(line.c_str() + 6, nullptr, 8) & 0777;
+        }
+    }
+
+  return 07777;
+} // end of "readUmask"
+
+
+
+/*
+  Function:
+   applyDeviceFiles
+
+  Description:
+   Applies the theme to the files of one filesystem through its own ring.
+   Each batch takes as many files as the ring has descriptor slots, stats
+   them in one submission and reads the regular files that are small enough
+   into one buffer sized from their statx() sizes. The reads are queued as
+   one lane of linked files per slot of the filesystem's concurrency window
+   (see DeviceScheduler), so a slow NFS or FUSE mount has only a few files in
+   flight at a time while the number of submissions doesn't depend on the
+   window. The latency per file of each lane feeds the window back.
+
+  Input/Output:
+   device               - a reference to the files and ring of the
+                          filesystem, which receives its fallback files.
+
+   scheduler            - a reference to the scheduler holding the window.
+
+  Input:
+   paths                - a reference to a constant vector of the paths of the
+                          files to rewrite.
+
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+   deviceIndex          - the index of the filesystem in the scheduler.
+
+  Output:
+   results              - a reference to a vector sized to paths that
+                          receives the ApplyResults value of each file this
+                          ring applied.
+
+  Returns:
+   NONE
+*/
+static void applyDeviceFiles(UringDevice& device,
+                             DeviceScheduler& scheduler,
+                             const std::vector<std::string>& paths,
+                             const std::string& theme,
+                             const int deviceIndex,
+                             std::vector<int>& results)
+{
+  IoUring& ring = *device.ring;
+  const unsigned filesPerWrite = std::min(ring.getNumSqes() / _URINGWRITESTEPS,
+                                          ring.getNumFileSlots());
+  const uid_t uid = geteuid();
+  const gid_t gid = getegid();
+  const mode_t mask = readUmask();
+  std::vector<char> readBuffer;
+  std::vector<unsigned> toRead;
+  std::vector<UringFile> batch;
+  bool isRingUsable = true;
+  size_t nextFile = 0;
+  size_t batchFallbacks = 0;
+
+  while(nextFile < device.files.size() && isRingUsable == true)
+    {
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      batch.clear();
+      toRead.clear();
+      batchFallbacks = device.fallbackFiles.size();
+
+      for(; nextFile < device.files.size() && batch.size() < _URINGFILESLOTS; nextFile++)
+        {
+          UringFile file;
+
+          file.index = device.files.at(nextFile);
+          file.rewriter = findThemeRewriter(paths.at(file.index));
+
+          if(file.rewriter == nullptr)
+            {
+              results.at(file.index) = _APPLYUNSUPPORTED;
+              continue;
+            }
+
+          for(int i = 0; i < _NUMURINGSTEPS; i++)
+            {
+              file.stepResults[i] = -ECANCELED;
+            }
+
+          batch.push_back(file);
+        }
+
+      if(batch.empty())
+        {
+          continue;
+        }
+
+      // the window bounds the files in flight, one per lane, not the batch
+      int numLanes = 0;
+
+      while(numLanes < (int)batch.size() && scheduler.tryAcquire(deviceIndex) == true)
+        {
+          numLanes++;
+        }
+
+      const int numAcquired = numLanes;
+
+      numLanes = std::max(numLanes, 1);
+
+      for(size_t i = 0; i < batch.size(); i++)
+        {
+          queueStatx(ring, batch.at(i), i, paths.at(batch.at(i).index));
+        }
+
+      if(reapBatch(ring, batch, batch.size()) == false)
+        {
+          isRingUsable = false;
+          break;
+        }
+
+      // a byte past each file's size shows a file that grew since its statx()
+      size_t bufferSize = 0;
+
+      for(size_t i = 0; i < batch.size(); i++)
+        {
+          UringFile& file = batch.at(i);
+
+          if(file.stepResults[_URINGSTATX] < 0 || !S_ISREG(file.fileStat.stx_mode) ||
+             file.fileStat.stx_size == 0 || file.fileStat.stx_size >= _URINGREADSIZE)
+            {
+              device.fallbackFiles.push_back(file.index);
+              continue;
+            }
+
+          file.readOffset = bufferSize;
+          bufferSize += file.fileStat.stx_size + 1;
+          toRead.push_back(i);
+        }
+
+      readBuffer.resize(bufferSize);
+
+      for(int lane = 0; lane < numLanes; lane++)
+        {
+          for(size_t r = lane; r < toRead.size(); r += numLanes)
+            {
+              const UringFile& file = batch.at(toRead.at(r));
+
+              queueRead(ring, toRead.at(r), paths.at(file.index),
+                        readBuffer.data() + file.readOffset, file.fileStat.stx_size + 1,
+                        r + numLanes < toRead.size());
+            }
+        }
+
+      if(reapBatch(ring, batch, toRead.size() * 3) == false)
+        {
+          isRingUsable = false;
+          break;
+        }
+
+      // find the edits and decide what this path can write itself
+      std::vector<unsigned> toWrite;
+
+      for(size_t r = 0; r < toRead.size(); r++)
+        {
+          const unsigned i = toRead.at(r);
+          UringFile& file = batch.at(i);
+          const int numRead = file.stepResults[_URINGREAD];
+          std::vector<RewriteSpan> spans;
+
+          if(file.stepResults[_URINGOPEN] < 0 || numRead < 0 ||
+             file.fileStat.stx_size != (uint64_t)numRead)
+            {
+              device.fallbackFiles.push_back(file.index);
+              continue;
+            }
+
+          const char* data = readBuffer.data() + file.readOffset;
+
+          if(file.rewriter->findEdits(data, numRead, theme, spans) == false)
+            {
+              results.at(file.index) = _APPLYUNSUPPORTED;
+              continue;
+            }
+
+          if(spans.empty())
+            {
+              results.at(file.index) = _APPLYUNCHANGED;
+              continue;
+            }
+
+          if(file.fileStat.stx_uid != uid || file.fileStat.stx_gid != gid ||
+             (file.fileStat.stx_mode & mask) != 0)
+            {
+              device.fallbackFiles.push_back(file.index);
+              continue;
+            }
+
+          size_t pos = 0;
+
+          for(size_t j = 0; j < spans.size(); j++)
+            {
+              file.rewritten.append(data + pos, spans.at(j).offset - pos);
+              file.rewritten.append(spans.at(j).replacement);
+              pos = spans.at(j).offset + spans.at(j).length;
+            }
+
+          if(makeApplyTempName(paths.at(file.index), file.tempPath) == false)
+            {
+              device.fallbackFiles.push_back(file.index);
+              continue;
+            }
+
+          file.rewritten.append(data + pos, numRead - pos);
+          memset(&file.tempHow, 0, sizeof(file.tempHow));
+          file.tempHow.flags = O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW;
+          file.tempHow.mode = file.fileStat.stx_mode & 07777;
+          file.tempHow.resolve = RESOLVE_NO_SYMLINKS;
+          toWrite.push_back(i);
+        }
+
+      for(size_t first = 0; first < toWrite.size() && isRingUsable == true; first += filesPerWrite)
+        {
+          const size_t last = std::min(toWrite.size(), first + filesPerWrite);
+          unsigned numCleanups = 0;
+
+          for(size_t j = first; j < last; j++)
+            {
+              queueWrite(ring, batch.at(toWrite.at(j)), toWrite.at(j), j - first,
+                         paths.at(batch.at(toWrite.at(j)).index));
+            }
+
+          if(reapBatch(ring, batch, (last - first) * _URINGWRITESTEPS) == false)
+            {
+              isRingUsable = false;
+              break;
+            }
+
+          // close the slots of broken chains and remove their temporary files
+          for(size_t j = first; j < last; j++)
+            {
+              UringFile& file = batch.at(toWrite.at(j));
+              const uint64_t tag = (uint64_t)toWrite.at(j) << _URINGSTEPBITS;
+
+              if(file.stepResults[_URINGRENAME] == 0 || file.stepResults[_URINGTEMPOPEN] < 0)
+                {
+                  continue;
+                }
+
+              if(file.stepResults[_URINGTEMPCLOSE] < 0)
+                {
+                  io_uring_sqe* sqe = ring.getSqe();
+
+                  sqe->opcode = IORING_OP_CLOSE;
+                  sqe->flags = IOSQE_IO_HARDLINK;
+                  sqe->file_index = j - first + 1;
+                  sqe->user_data = tag | _URINGTEMPCLOSE;
+                  numCleanups++;
+                }
+
+              io_uring_sqe* sqe = ring.getSqe();
+
+              sqe->opcode = IORING_OP_UNLINKAT;
+              sqe->fd = AT_FDCWD;
+              sqe->addr = (uint64_t)file.tempPath.c_str();
+              sqe->user_data = tag | _URINGUNLINK;
+              numCleanups++;
+            }
+
+          if(numCleanups > 0 && reapBatch(ring, batch, numCleanups) == false)
+            {
+              isRingUsable = false;
+            }
+
+          for(size_t j = first; j < last; j++)
+            {
+              const UringFile& file = batch.at(toWrite.at(j));
+
+              if(file.stepResults[_URINGRENAME] == 0)
+                {
+                  results.at(file.index) = _APPLYWRITTEN;
+                }
+              else
+                {
+                  device.fallbackFiles.push_back(file.index);
+                }
+            }
+        }
+
+      // the latency of a lane is the time per file it read, so long lanes
+      // don't look like congestion
+      const double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+      const size_t filesPerLane = (batch.size() + numLanes - 1) / numLanes;
+
+      for(int i = 0; i < numAcquired; i++)
+        {
+          scheduler.release(deviceIndex, elapsedMs / filesPerLane);
+        }
+    }
+
+  // a failed ring leaves the rest of the files, and whatever of the batch in
+  // flight wasn't written, to the synchronous path
+  if(isRingUsable == false)
+    {
+      device.fallbackFiles.resize(batchFallbacks);
+
+      for(size_t i = 0; i < batch.size(); i++)
+        {
+          if(results.at(batch.at(i).index) != _APPLYWRITTEN)
+            {
+              device.fallbackFiles.push_back(batch.at(i).index);
+            }
+        }
+
+      for(; nextFile < device.files.size(); nextFile++)
+        {
+          device.fallbackFiles.push_back(device.files.at(nextFile));
+        }
+    }
+} // end of "applyDeviceFiles"
+
+
+
+/*
+  Function:
+   applyThemeToFilesUring
+
+  Description:
+   Applies the incoming theme to every incoming file through io_uring. The
+   files of each filesystem get a ring and a thread of their own and are
+   applied in batches of up to _URINGFILESLOTS files with as many in flight as
+   that filesystem's concurrency window allows (see applyDeviceFiles()), so a
+   slow mount never holds up files on local disks. Each batch is stated with
+   one submission and read with another: lanes of linked opens, reads and
+   closes on direct descriptors that never enter the process's fd table. The
+   edits are then found in memory and every changed file is replaced through a
+   linked open, write, fsync, close and rename of a temporary file beside it.
+   Applying 2,000 small files on a local disk takes a few dozen
+   io_uring_enter() calls instead of about 12,000 syscalls.
+
+   Files this path can't handle exactly like applyThemeToFile() does (links,
+   files over _URINGREADSIZE, files owned by someone else or with mode bits
+   the umask would clear, which would need a fchown() or fchmod() io_uring
+   doesn't have) and files that hit any error are returned as fallback files
+   for the caller to apply synchronously, so the results match that path.
+
+  Input:
+   paths                - a reference to a constant vector of the paths of the
+                          files to rewrite.
+
+   devices              - a reference to a constant vector sized to paths of
+                          the filesystem (st_dev) each file lives on.
+
+   theme                - a reference to a constant string containing the name
+                          of the theme to apply.
+
+   log                  - a reference to the log file output stream.
+
+  Output:
+   results              - a reference to a vector sized to paths that
+                          receives the ApplyResults value of each file
+                          applied here.
+
+   fallbackFiles        - a reference to a vector that receives the indexes
+                          of the files left to the synchronous path.
+
+  Returns:
+   bool                 - false if io_uring isn't available here, in which
+                          case nothing was applied.
+*/
+bool applyThemeToFilesUring(const std::vector<std::string>& paths,
+                            const std::vector<dev_t>& devices,
+                            const std::string& theme,
+                            std::vector<int>& results,
+                            std::vector<size_t>& fallbackFiles,
+                            std::ofstream& log)
+{
+  DeviceScheduler scheduler(_URINGFILESLOTS);
+  std::vector<UringDevice> deviceFiles;
+
+  for(size_t i = 0; i < paths.size(); i++)
+    {
+      const size_t deviceIndex = scheduler.addDevice(devices.at(i));
+
+      if(deviceIndex == deviceFiles.size())
+        {
+          deviceFiles.push_back(UringDevice());
+        }
+
+      deviceFiles.at(deviceIndex).files.push_back(i);
+    }
+
+  // set every ring up front, a filesystem whose ring fails is left whole to
+  // the synchronous path
+  bool isAnyRing = false;
+
+  for(size_t i = 0; i < deviceFiles.size(); i++)
+    {
+      deviceFiles.at(i).ring.reset(new IoUring());
+
+      if(deviceFiles.at(i).ring->setup(_URINGENTRIES, _URINGFILESLOTS) == true)
+        {
+          isAnyRing = true;
+        }
+      else
+        {
+          deviceFiles.at(i).ring.reset();
+        }
+    }
+
+  if(isAnyRing == false)
+    {
+      log << "Apply: io_uring unavailable, using the thread pool" << std::endl;
+      return false;
+    }
+
+  std::vector<std::thread> threads;
+
+  for(size_t i = 0; i < deviceFiles.size(); i++)
+    {
+      if(deviceFiles.at(i).ring == nullptr)
+        {
+          deviceFiles.at(i).fallbackFiles = deviceFiles.at(i).files;
+          continue;
+        }
+
+      threads.push_back(std::thread(applyDeviceFiles, std::ref(deviceFiles.at(i)),
+                                    std::ref(scheduler), std::cref(paths), std::cref(theme),
+                                    (int)i, std::ref(results)));
+    }
+
+  for(size_t i = 0; i < threads.size(); i++)
+    {
+      threads.at(i).join();
+    }
+
+  for(size_t i = 0; i < deviceFiles.size(); i++)
+    {
+      const UringDevice& device = deviceFiles.at(i);
+
+      log << "Apply: device " << scheduler.getDevice(i) << " " << device.files.size()
+          << " files, io_uring took "
+          << (device.ring == nullptr ? 0 : device.ring->getNumSubmits())
+          << " submissions, final window " << scheduler.getWindow(i) << ", "
+          << device.fallbackFiles.size() << " files left to applyThemeToFile()" << std::endl;
+
+      fallbackFiles.insert(fallbackFiles.end(), device.fallbackFiles.begin(),
+                           device.fallbackFiles.end());
+    }
+
+  return true;
+} // end of "applyThemeToFilesUring"
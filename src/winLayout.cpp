@@ -0,0 +1,173 @@
+/*
+  File:
+   winLayout.cpp
+
+  Description:
+   The solver for the winLayout.hpp layout table.
+*/
+#include "winLayout.hpp"
+
+
+
+/*
+  Function:
+   solveSpan
+
+  Description:
+   Places one span of a widget along an axis of the screen.
+
+  Input:
+   span                 - a reference to the constant span.
+
+   anchorStart          - the start of the span's anchor on this axis.
+
+   anchorSize           - the length of the span's anchor on this axis.
+
+   screenSize           - the length of the screen on this axis.
+
+  Output:
+   start                - a reference to the start of the span.
+
+   size                 - a reference to the length of the span.
+
+  Returns:
+   bool                 - true if the span is at least its minimum length and
+                          ends inside the screen.
+*/
+static bool solveSpan(const LayoutSpan& span,
+                      const int anchorStart,
+                      const int anchorSize,
+                      const int screenSize,
+                      int& start,
+                      int& size)
+{
+  switch(span.position)
+    {
+    case _ANCHOREND:
+      start = anchorStart + anchorSize + span.offset;
+      break;
+    case _SCREENEND:
+      start = screenSize - span.size - span.offset;
+      break;
+    default:
+      start = anchorStart + span.offset;
+      break;
+    }
+
+  switch(span.sizeRule)
+    {
+    case _HALFSIZE:
+      size = (screenSize - start) / 2 - span.size;
+      break;
+    case _FILLSIZE:
+      size = screenSize - start - span.size;
+      break;
+    default:
+      size = span.size;
+      break;
+    }
+
+  if(span.maxSize > 0 && size > span.maxSize)
+    {
+      size = span.maxSize;
+    }
+
+  return start >= 0 && size >= span.minSize && start + size < screenSize;
+} // end of "solveSpan"
+
+
+
+/*
+  Function:
+   findWidgetLabel
+
+  Description:
+   Returns the label of a widget in the layout table.
+
+  Input:
+   id                   - a _WINS value.
+
+  Output:
+   NONE
+
+  Returns:
+   std::string_view     - the label, empty if the widget has none.
+*/
+std::string_view findWidgetLabel(const int id)
+{
+  for(int i = 0; i < _NUMWIDGETS; i++)
+    {
+      if(_WINLAYOUT[i].id == id)
+        {
+          return _WINLAYOUT[i].label;
+        }
+    }
+
+  return std::string_view();
+} // end of "findWidgetLabel"
+
+
+
+/*
+  Function:
+   solveLayout
+
+  Description:
+   Solves every widget of the layout table for a screen of the incoming
+   size, in table order so each anchor is solved before the widgets placed
+   from it. A hidden widget still gets the start it would have, which the
+   saved file and theme windows use to place their prompts.
+
+  Input:
+   maxLines             - the number of lines of the screen.
+
+   maxCols              - the number of columns of the screen.
+
+  Output:
+   rects                - a pointer to _NUMWINS rectangles indexed by _WINS
+                          value; windows not in the table are hidden, and
+                          _MAINWIN is the screen.
+
+  Returns:
+   NONE
+*/
+void solveLayout(const int maxLines,
+                 const int maxCols,
+                 LayoutRect* rects)
+{
+  for(int i = 0; i < _NUMWINS; i++)
+    {
+      rects[i].startY = 0;
+      rects[i].startX = 0;
+      rects[i].numLines = 0;
+      rects[i].numCols = 0;
+      rects[i].isVisible = false;
+    }
+
+  rects[_MAINWIN].numLines = maxLines;
+  rects[_MAINWIN].numCols = maxCols;
+  rects[_MAINWIN].isVisible = true;
+
+  for(int i = 0; i < _NUMWIDGETS; i++)
+    {
+      const WidgetLayout& widget = _WINLAYOUT[i];
+      const LayoutRect& lineAnchor = rects[widget.lines.anchor];
+      const LayoutRect& colAnchor = rects[widget.cols.anchor];
+      LayoutRect& rect = rects[widget.id];
+      const bool linesFit = solveSpan(widget.lines,
+                                      lineAnchor.startY,
+                                      lineAnchor.numLines,
+                                      maxLines,
+                                      rect.startY,
+                                      rect.numLines);
+      const bool colsFit = solveSpan(widget.cols,
+                                     colAnchor.startX,
+                                     colAnchor.numCols,
+                                     maxCols,
+                                     rect.startX,
+                                     rect.numCols);
+
+      rect.isVisible = linesFit && colsFit && lineAnchor.isVisible && colAnchor.isVisible &&
+        (widget.dependency == -1 || rects[widget.dependency].isVisible);
+    }
+} // end of "solveLayout"